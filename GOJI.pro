@@ -53,6 +53,10 @@ SOURCES += \
     mainwindow.cpp \
     basefilesystemmanager.cpp \
     configmanager.cpp \
+    csvcombiner.cpp \
+    csvscanner.cpp \
+    csvsplitter.cpp \
+    databaseexecutor.cpp \
     databasemanager.cpp \
     errormanager.cpp \
     fhcontroller.cpp \
@@ -60,14 +64,26 @@ SOURCES += \
     fhfilemanager.cpp \
     filelocationsdialog.cpp \
     filesystemmanager.cpp \
+    filetransfer.cpp \
     fileutils.cpp \
+    hashservice.cpp \
+    inflater.cpp \
+    jobindex.cpp \
     logger.cpp \
     monthcomboboxhelper.cpp \
     openjobmenuhelper.cpp \
     meterrateservice.cpp \
     naslinkdialog.cpp \
     pathcopydialog.cpp \
+    printdirwatcher.cpp \
+    printmanifeststore.cpp \
+    querystats.cpp \
+    recordcounter.cpp \
     scriptrunner.cpp \
+    scripttreecache.cpp \
+    terminallogqueue.cpp \
+    tracer.cpp \
+    trackertablemodel.cpp \
     yearcomboboxhelper.cpp \
     tmcacontroller.cpp \
     tmcadbmanager.cpp \
@@ -127,6 +143,10 @@ HEADERS += \
     mainwindow.h \
     basefilesystemmanager.h \
     configmanager.h \
+    csvcombiner.h \
+    csvscanner.h \
+    csvsplitter.h \
+    databaseexecutor.h \
     databasemanager.h \
     errorhandling.h \
     errormanager.h \
@@ -137,14 +157,27 @@ HEADERS += \
     filelocationsdialog.h \
     filesystemmanager.h \
     filesystemmanagerfactory.h \
+    filetransfer.h \
     fileutils.h \
+    hashservice.h \
+    inflater.h \
+    jobindex.h \
     logger.h \
     monthcomboboxhelper.h \
     openjobmenuhelper.h \
     meterrateservice.h \
+    mpscringbuffer.h \
     naslinkdialog.h \
     pathcopydialog.h \
+    printdirwatcher.h \
+    printmanifeststore.h \
+    querystats.h \
+    recordcounter.h \
     scriptrunner.h \
+    scripttreecache.h \
+    terminallogqueue.h \
+    tracer.h \
+    trackertablemodel.h \
     yearcomboboxhelper.h \
     tmcacontroller.h \
     tmcadbmanager.h \
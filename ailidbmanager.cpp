@@ -1,5 +1,6 @@
 #include "ailidbmanager.h"
 #include "databasemanager.h"
+#include "tracer.h"
 
 #include <QSqlDatabase>
 #include <QSqlQuery>
@@ -25,7 +26,14 @@ AILIDBManager::AILIDBManager(QObject* parent)
 
 bool AILIDBManager::initializeTables()
 {
-    return createTables();
+    TRACE_FUNCTION("db");
+    if (!m_dbManager || !m_dbManager->isInitialized()) {
+        qWarning() << "AILI DB: DatabaseManager not initialized";
+        return false;
+    }
+    return m_dbManager->applyMigrations("aili", {
+        {1, "aili_jobs table, legacy aili_terminal_logs dropped", [this]() { return createTables(); }}
+    });
 }
 
 bool AILIDBManager::createTables()
@@ -115,12 +123,6 @@ bool AILIDBManager::saveJob(const QString& jobNumber,
         return false;
     }
 
-    const QString dropLegacyLogsTable = "DROP TABLE IF EXISTS aili_terminal_logs;";
-    if (!query.exec(dropLegacyLogsTable)) {
-        qWarning() << "AILI DB: failed dropping legacy aili_terminal_logs table:" << query.lastError().text();
-        return false;
-    }
-
     return true;
 }
 
@@ -167,11 +169,6 @@ bool AILIDBManager::loadJob(const QString& jobNumber,
     pageCountOut = query.value(0).toString();
     postageOut = query.value(1).toString();
     countOut = query.value(2).toString();
-    const QString dropLegacyLogsTable = "DROP TABLE IF EXISTS aili_terminal_logs;";
-    if (!query.exec(dropLegacyLogsTable)) {
-        qWarning() << "AILI DB: failed dropping legacy aili_terminal_logs table:" << query.lastError().text();
-        return false;
-    }
 
     return true;
 }
@@ -350,12 +347,6 @@ bool AILIDBManager::saveJobState(const QString& jobNumber,
         return false;
     }
 
-    const QString dropLegacyLogsTable = "DROP TABLE IF EXISTS aili_terminal_logs;";
-    if (!query.exec(dropLegacyLogsTable)) {
-        qWarning() << "AILI DB: failed dropping legacy aili_terminal_logs table:" << query.lastError().text();
-        return false;
-    }
-
     return true;
 }
 
@@ -418,12 +409,6 @@ bool AILIDBManager::loadJobState(const QString& jobNumber,
     countOut = query.value(5).toString();
     lastExecutedScriptOut = query.value(6).toString();
 
-    const QString dropLegacyLogsTable = "DROP TABLE IF EXISTS aili_terminal_logs;";
-    if (!query.exec(dropLegacyLogsTable)) {
-        qWarning() << "AILI DB: failed dropping legacy aili_terminal_logs table:" << query.lastError().text();
-        return false;
-    }
-
     return true;
 }
 
@@ -469,13 +454,7 @@ bool AILIDBManager::savePostageData(const QString& jobNumber,
     }
 
     if (query.numRowsAffected() > 0) {
-        const QString dropLegacyLogsTable = "DROP TABLE IF EXISTS aili_terminal_logs;";
-    if (!query.exec(dropLegacyLogsTable)) {
-        qWarning() << "AILI DB: failed dropping legacy aili_terminal_logs table:" << query.lastError().text();
-        return false;
-    }
-
-    return true;
+        return true;
     }
 
     QSqlQuery upsertQuery(m_dbManager->getDatabase());
@@ -509,12 +488,6 @@ bool AILIDBManager::savePostageData(const QString& jobNumber,
         return false;
     }
 
-    const QString dropLegacyLogsTable = "DROP TABLE IF EXISTS aili_terminal_logs;";
-    if (!query.exec(dropLegacyLogsTable)) {
-        qWarning() << "AILI DB: failed dropping legacy aili_terminal_logs table:" << query.lastError().text();
-        return false;
-    }
-
     return true;
 }
 
@@ -561,11 +534,6 @@ bool AILIDBManager::loadPostageData(const QString& jobNumber,
     postageOut = query.value(0).toString();
     countOut = query.value(1).toString();
     lockedOut = query.value(2).toInt() != 0;
-    const QString dropLegacyLogsTable = "DROP TABLE IF EXISTS aili_terminal_logs;";
-    if (!query.exec(dropLegacyLogsTable)) {
-        qWarning() << "AILI DB: failed dropping legacy aili_terminal_logs table:" << query.lastError().text();
-        return false;
-    }
 
     return true;
 }
@@ -1,77 +1,378 @@
 #include "archiveutils.h"
-#include <QFileInfo>
-#include <QProcess>
+#include "inflater.h"
+#include <QDateTime>
 #include <QDir>
-#include <QStandardPaths>
-#include <QTextStream>
-
-static QString psEscape(const QString& s) {
-    // Escape for PowerShell single-quoted string: double any single quote
-    QString out = s;
-    out.replace("'", "''");
-    return out;
-}
+#include <QFile>
+#include <QFileInfo>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QSet>
+#include <QtConcurrent/QtConcurrent>
+#include <QtEndian>
 
-bool isZip(const QString& filePath) {
-    QFileInfo fi(filePath);
-    return fi.exists() && fi.isFile() && fi.suffix().compare("zip", Qt::CaseInsensitive) == 0;
-}
+namespace {
 
-QVector<ZipEntry> listZipEntries(const QString& zipPath, QString* err) {
-    QVector<ZipEntry> entries;
+constexpr quint32 kLocalHeaderSig = 0x04034b50;
+constexpr quint32 kCentralHeaderSig = 0x02014b50;
+constexpr quint32 kEndOfCentralDirSig = 0x06054b50;
+constexpr quint32 kZip64EndOfCentralDirSig = 0x06064b50;
+constexpr quint32 kZip64LocatorSig = 0x07064b50;
+constexpr quint16 kZip64ExtraId = 0x0001;
+constexpr quint16 kMethodStored = 0;
+constexpr quint16 kMethodDeflated = 8;
+constexpr quint16 kFlagEncrypted = 0x0001;
+constexpr quint16 kFlagUtf8 = 0x0800;
+constexpr int kEndOfCentralDirSize = 22;
+constexpr int kCentralHeaderSize = 46;
+constexpr int kLocalHeaderSize = 30;
+constexpr qint64 kStoredCopyChunk = 1024 * 1024;
 
-    if (!isZip(zipPath)) {
-        if (err) *err = "Not a .zip file or file missing.";
-        return entries;
+quint16 readU16(const uchar* p) { return qFromLittleEndian<quint16>(p); }
+quint32 readU32(const uchar* p) { return qFromLittleEndian<quint32>(p); }
+quint64 readU64(const uchar* p) { return qFromLittleEndian<quint64>(p); }
+
+struct CentralEntry {
+    QString name;
+    quint64 compressedSize = 0;
+    quint64 uncompressedSize = 0;
+    quint64 localHeaderOffset = 0;
+    quint32 crc = 0;
+    quint16 method = 0;
+    quint16 flags = 0;
+    quint16 dosTime = 0;
+    quint16 dosDate = 0;
+    bool isDir = false;
+};
+
+/**
+ * Read-only view of a ZIP archive: memory-maps the file and parses the
+ * central directory once. Entry extraction is const and safe to run from
+ * several threads at the same time.
+ */
+class ZipArchive
+{
+public:
+    bool open(const QString& path, QString* err)
+    {
+        m_file.setFileName(path);
+        if (!m_file.open(QIODevice::ReadOnly)) {
+            if (err) *err = QString("Could not open ZIP: %1").arg(m_file.errorString());
+            return false;
+        }
+
+        m_size = static_cast<quint64>(m_file.size());
+        m_data = m_size > 0 ? m_file.map(0, m_file.size()) : nullptr;
+        if (!m_data && m_size > 0) {
+            // Mapping can fail on 32-bit builds; fall back to reading into memory
+            m_fallback = m_file.readAll();
+            m_data = reinterpret_cast<const uchar*>(m_fallback.constData());
+        }
+
+        return readCentralDirectory(err);
     }
 
-    // Use .NET ZipFile to enumerate entries without extracting.
-    // Output format: "<FullName>|<Length>|<IsDir>"
-    const QString script =
-        "$ErrorActionPreference='Stop';"
-        "Add-Type -AssemblyName System.IO.Compression.FileSystem;"
-        "$z=[IO.Compression.ZipFile]::OpenRead('" + psEscape(zipPath) + "');"
-        "foreach($e in $z.Entries){"
-        "  $isDir=$e.FullName.EndsWith('/');"
-        "  $len= if($isDir){0}else{$e.Length};"
-        "  Write-Output ($e.FullName + '|' + $len + '|' + $isDir)"
-        "};"
-        "$z.Dispose();";
-
-    QProcess p;
-    p.start("powershell.exe", {"-NoProfile", "-ExecutionPolicy", "Bypass", "-Command", script});
-    if (!p.waitForFinished(30000)) {
-        if (err) *err = "PowerShell timed out while enumerating ZIP.";
-        return entries;
+    const QVector<CentralEntry>& entries() const { return m_entries; }
+
+    bool extractEntry(const CentralEntry& entry, const QString& targetPath,
+                      std::atomic<bool>* cancelled, std::atomic<quint64>* bytesDone,
+                      QString* err) const
+    {
+        if (entry.flags & kFlagEncrypted) {
+            if (err) *err = QString("Encrypted entries are not supported: %1").arg(entry.name);
+            return false;
+        }
+        if (entry.method != kMethodStored && entry.method != kMethodDeflated) {
+            if (err) *err = QString("Unsupported compression method %1: %2").arg(entry.method).arg(entry.name);
+            return false;
+        }
+
+        const uchar* data = entryData(entry, err);
+        if (!data) {
+            return false;
+        }
+
+        QFile out(targetPath);
+        if (!out.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            if (err) *err = QString("Could not create %1: %2").arg(targetPath, out.errorString());
+            return false;
+        }
+
+        quint32 crc = 0;
+        quint64 written = 0;
+        bool writeFailed = false;
+
+        auto sink = [&](const unsigned char* chunk, size_t size) -> bool {
+            if (cancelled && cancelled->load(std::memory_order_relaxed)) {
+                return false;
+            }
+            if (out.write(reinterpret_cast<const char*>(chunk), static_cast<qint64>(size)) != static_cast<qint64>(size)) {
+                writeFailed = true;
+                return false;
+            }
+            crc = Inflater::crc32(crc, chunk, size);
+            written += size;
+            if (bytesDone) {
+                bytesDone->fetch_add(size, std::memory_order_relaxed);
+            }
+            return true;
+        };
+
+        bool ok = true;
+        if (entry.method == kMethodStored) {
+            quint64 offset = 0;
+            while (ok && offset < entry.compressedSize) {
+                const quint64 n = qMin<quint64>(kStoredCopyChunk, entry.compressedSize - offset);
+                ok = sink(data + offset, static_cast<size_t>(n));
+                offset += n;
+            }
+        } else {
+            const Inflater::Status status = Inflater::inflate(data, static_cast<size_t>(entry.compressedSize), sink);
+            ok = (status == Inflater::Status::Ok);
+            if (!ok && status != Inflater::Status::Aborted && err) {
+                *err = QString("Corrupt compressed data: %1").arg(entry.name);
+            }
+        }
+
+        if (ok && (written != entry.uncompressedSize || crc != entry.crc)) {
+            if (err) *err = QString("CRC mismatch: %1").arg(entry.name);
+            ok = false;
+        } else if (!ok && writeFailed && err) {
+            *err = QString("Write failed for %1: %2").arg(targetPath, out.errorString());
+        } else if (!ok && cancelled && cancelled->load() && err) {
+            *err = "Extraction cancelled.";
+        }
+
+        if (ok) {
+            const QDateTime modified = dosDateTime(entry);
+            if (modified.isValid()) {
+                out.setFileTime(modified, QFileDevice::FileModificationTime);
+            }
+            out.close();
+        } else {
+            out.close();
+            out.remove();
+        }
+        return ok;
     }
 
-    const QByteArray out = p.readAllStandardOutput();
-    const QByteArray outErr = p.readAllStandardError();
-    if (p.exitStatus() != QProcess::NormalExit || p.exitCode() != 0) {
-        if (err) *err = QString("PowerShell failed: %1").arg(QString::fromUtf8(outErr));
-        return entries;
+    /**
+     * Decode an entry into sink without writing it to disk. Stops quietly
+     * when the sink returns false; CRCs are not checked since callers may
+     * stop early.
+     */
+    bool readEntry(const CentralEntry& entry, const Inflater::Sink& sink, QString* err) const
+    {
+        if (entry.flags & kFlagEncrypted) {
+            if (err) *err = QString("Encrypted entries are not supported: %1").arg(entry.name);
+            return false;
+        }
+        if (entry.method != kMethodStored && entry.method != kMethodDeflated) {
+            if (err) *err = QString("Unsupported compression method %1: %2").arg(entry.method).arg(entry.name);
+            return false;
+        }
+
+        const uchar* data = entryData(entry, err);
+        if (!data) {
+            return false;
+        }
+
+        if (entry.method == kMethodStored) {
+            quint64 offset = 0;
+            while (offset < entry.compressedSize) {
+                const quint64 n = qMin<quint64>(kStoredCopyChunk, entry.compressedSize - offset);
+                if (!sink(data + offset, static_cast<size_t>(n))) {
+                    break;
+                }
+                offset += n;
+            }
+            return true;
+        }
+
+        const Inflater::Status status = Inflater::inflate(data, static_cast<size_t>(entry.compressedSize), sink);
+        if (status != Inflater::Status::Ok && status != Inflater::Status::Aborted) {
+            if (err) *err = QString("Corrupt compressed data: %1").arg(entry.name);
+            return false;
+        }
+        return true;
     }
 
-    const QStringList lines = QString::fromUtf8(out).split('\n', Qt::SkipEmptyParts);
-    entries.reserve(lines.size());
-    for (const QString& lineRaw : lines) {
-        QString line = lineRaw.trimmed();
-        const int p1 = line.indexOf('|');
-        const int p2 = (p1 >= 0) ? line.indexOf('|', p1 + 1) : -1;
-        if (p1 < 0 || p2 < 0) continue;
+private:
+    bool readCentralDirectory(QString* err)
+    {
+        if (m_size < static_cast<quint64>(kEndOfCentralDirSize)) {
+            if (err) *err = "File is too small to be a ZIP archive.";
+            return false;
+        }
 
-        ZipEntry e;
-        e.pathInArchive = line.left(p1);
-        e.size = line.mid(p1 + 1, p2 - p1 - 1).toULongLong();
-        const QString isDirStr = line.mid(p2 + 1);
-        e.isDir = (isDirStr.compare("True", Qt::CaseInsensitive) == 0);
-        entries.push_back(e);
+        // The end-of-central-directory record sits before an optional comment of up to 64 KB
+        qint64 eocd = -1;
+        const qint64 last = static_cast<qint64>(m_size) - kEndOfCentralDirSize;
+        const qint64 first = qMax<qint64>(0, last - 0xFFFF);
+        for (qint64 pos = last; pos >= first; --pos) {
+            if (readU32(m_data + pos) == kEndOfCentralDirSig) {
+                eocd = pos;
+                break;
+            }
+        }
+        if (eocd < 0) {
+            if (err) *err = "ZIP end-of-central-directory record not found.";
+            return false;
+        }
+
+        const uchar* e = m_data + eocd;
+        quint64 entryCount = readU16(e + 10);
+        quint64 cdSize = readU32(e + 12);
+        quint64 cdOffset = readU32(e + 16);
+
+        if (entryCount == 0xFFFF || cdSize == 0xFFFFFFFF || cdOffset == 0xFFFFFFFF) {
+            if (eocd < 20 || readU32(m_data + eocd - 20) != kZip64LocatorSig) {
+                if (err) *err = "ZIP64 locator missing.";
+                return false;
+            }
+            const quint64 zip64Offset = readU64(m_data + eocd - 20 + 8);
+            if (zip64Offset + 56 > m_size || readU32(m_data + zip64Offset) != kZip64EndOfCentralDirSig) {
+                if (err) *err = "ZIP64 end-of-central-directory record is invalid.";
+                return false;
+            }
+            const uchar* z = m_data + zip64Offset;
+            entryCount = readU64(z + 32);
+            cdSize = readU64(z + 40);
+            cdOffset = readU64(z + 48);
+        }
+
+        if (cdOffset > m_size || cdSize > m_size - cdOffset) {
+            if (err) *err = "ZIP central directory is out of bounds.";
+            return false;
+        }
+
+        m_entries.clear();
+        m_entries.reserve(static_cast<int>(qMin<quint64>(entryCount, 1u << 20)));
+
+        quint64 pos = cdOffset;
+        const quint64 end = cdOffset + cdSize;
+        for (quint64 i = 0; i < entryCount; ++i) {
+            if (pos + kCentralHeaderSize > end || readU32(m_data + pos) != kCentralHeaderSig) {
+                if (err) *err = "ZIP central directory is corrupt.";
+                return false;
+            }
+
+            const uchar* h = m_data + pos;
+            CentralEntry entry;
+            entry.flags = readU16(h + 8);
+            entry.method = readU16(h + 10);
+            entry.dosTime = readU16(h + 12);
+            entry.dosDate = readU16(h + 14);
+            entry.crc = readU32(h + 16);
+            entry.compressedSize = readU32(h + 20);
+            entry.uncompressedSize = readU32(h + 24);
+            const quint16 nameLen = readU16(h + 28);
+            const quint16 extraLen = readU16(h + 30);
+            const quint16 commentLen = readU16(h + 32);
+            entry.localHeaderOffset = readU32(h + 42);
+
+            const quint64 recordSize = static_cast<quint64>(kCentralHeaderSize) + nameLen + extraLen + commentLen;
+            if (pos + recordSize > end) {
+                if (err) *err = "ZIP central directory is corrupt.";
+                return false;
+            }
+
+            const char* name = reinterpret_cast<const char*>(h + kCentralHeaderSize);
+            entry.name = (entry.flags & kFlagUtf8) ? QString::fromUtf8(name, nameLen)
+                                                   : QString::fromLocal8Bit(name, nameLen);
+            entry.isDir = entry.name.endsWith('/') || entry.name.endsWith('\\');
+
+            applyZip64Extra(h + kCentralHeaderSize + nameLen, extraLen, entry);
+
+            m_entries.append(entry);
+            pos += recordSize;
+        }
+
+        return true;
     }
 
-    return entries;
+    static void applyZip64Extra(const uchar* extra, quint16 extraLen, CentralEntry& entry)
+    {
+        quint16 offset = 0;
+        while (offset + 4 <= extraLen) {
+            const quint16 id = readU16(extra + offset);
+            const quint16 size = readU16(extra + offset + 2);
+            const uchar* field = extra + offset + 4;
+            if (offset + 4 + size > extraLen) {
+                return;
+            }
+
+            if (id == kZip64ExtraId) {
+                // Only the header fields that overflowed are present, in this order
+                quint16 f = 0;
+                if (entry.uncompressedSize == 0xFFFFFFFF && f + 8 <= size) {
+                    entry.uncompressedSize = readU64(field + f);
+                    f += 8;
+                }
+                if (entry.compressedSize == 0xFFFFFFFF && f + 8 <= size) {
+                    entry.compressedSize = readU64(field + f);
+                    f += 8;
+                }
+                if (entry.localHeaderOffset == 0xFFFFFFFF && f + 8 <= size) {
+                    entry.localHeaderOffset = readU64(field + f);
+                }
+                return;
+            }
+            offset += 4 + size;
+        }
+    }
+
+    const uchar* entryData(const CentralEntry& entry, QString* err) const
+    {
+        const quint64 offset = entry.localHeaderOffset;
+        if (offset + kLocalHeaderSize > m_size || readU32(m_data + offset) != kLocalHeaderSig) {
+            if (err) *err = QString("Local header is invalid: %1").arg(entry.name);
+            return nullptr;
+        }
+
+        const quint64 dataOffset = offset + kLocalHeaderSize + readU16(m_data + offset + 26) + readU16(m_data + offset + 28);
+        if (dataOffset > m_size || entry.compressedSize > m_size - dataOffset) {
+            if (err) *err = QString("Entry data is out of bounds: %1").arg(entry.name);
+            return nullptr;
+        }
+        return m_data + dataOffset;
+    }
+
+    static QDateTime dosDateTime(const CentralEntry& entry)
+    {
+        const QDate date(1980 + (entry.dosDate >> 9), (entry.dosDate >> 5) & 0x0F, entry.dosDate & 0x1F);
+        const QTime time(entry.dosTime >> 11, (entry.dosTime >> 5) & 0x3F, (entry.dosTime & 0x1F) * 2);
+        return QDateTime(date, time);
+    }
+
+    QFile m_file;
+    QByteArray m_fallback;
+    const uchar* m_data = nullptr;
+    quint64 m_size = 0;
+    QVector<CentralEntry> m_entries;
+};
+
+// Reject absolute paths, drive letters and ".." so entries cannot escape the destination
+QString safeRelativePath(const QString& name)
+{
+    QString path = name;
+    path.replace('\\', '/');
+    if (path.startsWith('/') || path.contains(':')) {
+        return QString();
+    }
+
+    const QStringList parts = path.split('/', Qt::SkipEmptyParts);
+    for (const QString& part : parts) {
+        if (part == "..") {
+            return QString();
+        }
+    }
+    return parts.join('/');
 }
 
-bool extractZipToDirectory(const QString& zipPath, const QString& destDir, QString* err) {
+bool extractArchive(const QString& zipPath, const QString& destDir,
+                    std::atomic<bool>* cancelled, std::atomic<quint64>* bytesDone,
+                    std::atomic<quint64>* bytesTotal, QString* err)
+{
     if (!isZip(zipPath)) {
         if (err) *err = "Not a .zip file or file missing.";
         return false;
@@ -90,24 +391,189 @@ bool extractZipToDirectory(const QString& zipPath, const QString& destDir, QStri
         }
     }
 
-    // Use PowerShell Expand-Archive -Force to extract safely.
-    const QString script =
-        "$ErrorActionPreference='Stop';"
-        "Expand-Archive -LiteralPath '" + psEscape(zipPath) + "' "
-        " -DestinationPath '" + psEscape(destDir) + "' -Force;";
+    ZipArchive archive;
+    if (!archive.open(zipPath, err)) {
+        return false;
+    }
+
+    // Create the directory tree up front so workers only write files
+    const QVector<CentralEntry>& entries = archive.entries();
+    QVector<int> fileIndices;
+    QStringList targets;
+    targets.reserve(entries.size());
+    QSet<QString> directories;
+    quint64 total = 0;
+
+    for (int i = 0; i < entries.size(); ++i) {
+        const CentralEntry& entry = entries.at(i);
+        const QString relative = safeRelativePath(entry.name);
+        if (relative.isEmpty()) {
+            targets.append(QString());
+            if (!entry.isDir) {
+                if (err) *err = QString("Refusing unsafe entry path: %1").arg(entry.name);
+                return false;
+            }
+            continue;
+        }
 
-    QProcess p;
-    p.start("powershell.exe", {"-NoProfile", "-ExecutionPolicy", "Bypass", "-Command", script});
-    if (!p.waitForFinished(5 * 60 * 1000)) { // up to 5 minutes for large archives
-        if (err) *err = "PowerShell timed out while extracting ZIP.";
+        const QString target = d.filePath(relative);
+        targets.append(target);
+
+        const QString dir = entry.isDir ? target : QFileInfo(target).path();
+        if (!directories.contains(dir)) {
+            if (!QDir().mkpath(dir)) {
+                if (err) *err = QString("Could not create directory: %1").arg(dir);
+                return false;
+            }
+            directories.insert(dir);
+        }
+
+        if (!entry.isDir) {
+            fileIndices.append(i);
+            total += entry.uncompressedSize;
+        }
+    }
+
+    if (bytesTotal) {
+        bytesTotal->store(total);
+    }
+
+    std::atomic<bool> failed { false };
+    QMutex errorMutex;
+    QString firstError;
+
+    QtConcurrent::blockingMap(fileIndices, [&](int index) {
+        if (failed.load() || (cancelled && cancelled->load())) {
+            return;
+        }
+        QString entryError;
+        if (!archive.extractEntry(entries.at(index), targets.at(index), cancelled, bytesDone, &entryError)) {
+            QMutexLocker locker(&errorMutex);
+            if (!failed.exchange(true)) {
+                firstError = entryError;
+            }
+        }
+    });
+
+    if (cancelled && cancelled->load()) {
+        if (err) *err = "Extraction cancelled.";
         return false;
     }
+    if (failed.load()) {
+        if (err) *err = firstError;
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+bool isZip(const QString& filePath) {
+    QFileInfo fi(filePath);
+    return fi.exists() && fi.isFile() && fi.suffix().compare("zip", Qt::CaseInsensitive) == 0;
+}
+
+QVector<ZipEntry> listZipEntries(const QString& zipPath, QString* err) {
+    QVector<ZipEntry> entries;
 
-    const QByteArray outErr = p.readAllStandardError();
-    if (p.exitStatus() != QProcess::NormalExit || p.exitCode() != 0) {
-        if (err) *err = QString("PowerShell extraction failed: %1").arg(QString::fromUtf8(outErr));
+    if (!isZip(zipPath)) {
+        if (err) *err = "Not a .zip file or file missing.";
+        return entries;
+    }
+
+    ZipArchive archive;
+    if (!archive.open(zipPath, err)) {
+        return entries;
+    }
+
+    entries.reserve(archive.entries().size());
+    for (const CentralEntry& central : archive.entries()) {
+        ZipEntry e;
+        e.pathInArchive = central.name;
+        e.isDir = central.isDir;
+        e.size = central.isDir ? 0 : central.uncompressedSize;
+        entries.push_back(e);
+    }
+
+    return entries;
+}
+
+bool readZipEntry(const QString& zipPath, const QString& entryName,
+                  const std::function<bool(const char*, size_t)>& sink, QString* err) {
+    ZipArchive archive;
+    if (!archive.open(zipPath, err)) {
+        return false;
+    }
+
+    for (const CentralEntry& central : archive.entries()) {
+        if (central.isDir || central.name.compare(entryName, Qt::CaseInsensitive) != 0) {
+            continue;
+        }
+        return archive.readEntry(central, [&sink](const unsigned char* data, size_t size) {
+            return sink(reinterpret_cast<const char*>(data), size);
+        }, err);
+    }
+
+    if (err) *err = QString("Entry not found in archive: %1").arg(entryName);
+    return false;
+}
+
+bool extractZipToDirectory(const QString& zipPath, const QString& destDir, QString* err) {
+    return extractArchive(zipPath, destDir, nullptr, nullptr, nullptr, err);
+}
+
+ZipExtractor::ZipExtractor(QObject* parent)
+    : QObject(parent)
+{
+    m_progressTimer.setInterval(100);
+    connect(&m_progressTimer, &QTimer::timeout, this, &ZipExtractor::reportProgress);
+
+    connect(&m_watcher, &QFutureWatcher<bool>::finished, this, [this]() {
+        m_progressTimer.stop();
+        reportProgress();
+        const bool ok = m_watcher.result();
+        emit finished(ok, ok ? QString() : m_state->error);
+    });
+}
+
+ZipExtractor::~ZipExtractor()
+{
+    cancel();
+    m_watcher.waitForFinished();
+}
+
+bool ZipExtractor::start(const QString& zipPath, const QString& destDir)
+{
+    if (isRunning()) {
         return false;
     }
 
+    m_state = std::make_shared<State>();
+    std::shared_ptr<State> state = m_state;
+
+    m_watcher.setFuture(QtConcurrent::run([state, zipPath, destDir]() {
+        return extractArchive(zipPath, destDir, &state->cancelled, &state->bytesDone,
+                              &state->bytesTotal, &state->error);
+    }));
+    m_progressTimer.start();
     return true;
 }
+
+void ZipExtractor::cancel()
+{
+    if (m_state) {
+        m_state->cancelled = true;
+    }
+}
+
+bool ZipExtractor::isRunning() const
+{
+    return m_watcher.isRunning();
+}
+
+void ZipExtractor::reportProgress()
+{
+    if (m_state) {
+        emit progress(m_state->bytesDone.load(), m_state->bytesTotal.load());
+    }
+}
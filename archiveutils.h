@@ -1,9 +1,16 @@
 #ifndef ARCHIVEUTILS_H
 #define ARCHIVEUTILS_H
 
+#include <QFutureWatcher>
+#include <QObject>
 #include <QString>
+#include <QTimer>
 #include <QVector>
 
+#include <atomic>
+#include <functional>
+#include <memory>
+
 /**
  * @brief Lightweight description of an entry inside a ZIP archive.
  */
@@ -19,15 +26,26 @@ struct ZipEntry {
 bool isZip(const QString& filePath);
 
 /**
- * @brief Enumerate entries inside a ZIP using PowerShell/.NET (no extraction).
+ * @brief Enumerate entries inside a ZIP by reading its central directory (no extraction).
  * @param zipPath Full path to the .zip file
  * @param err Optional error string (set on failure)
  * @return List of entries (empty on failure)
  *
- * Note: Requires PowerShell (present on modern Windows).
+ * Native reader: supports ZIP64 archives, memory-maps the file.
  */
 QVector<ZipEntry> listZipEntries(const QString& zipPath, QString* err = nullptr);
 
+/**
+ * @brief Stream one entry's uncompressed contents without extracting it.
+ * @param zipPath Full path to the archive (any extension, e.g. .xlsx)
+ * @param entryName Path inside the archive, matched case-insensitively
+ * @param sink Receives data in order; return false to stop reading early
+ * @param err Optional error string (set on failure)
+ * @return true if the entry was found and read (or stopped by the sink)
+ */
+bool readZipEntry(const QString& zipPath, const QString& entryName,
+                  const std::function<bool(const char*, size_t)>& sink, QString* err = nullptr);
+
 /**
  * @brief Extract a ZIP to an existing destination directory (recursively).
  * @param zipPath Full path to the .zip file
@@ -35,8 +53,56 @@ QVector<ZipEntry> listZipEntries(const QString& zipPath, QString* err = nullptr)
  * @param err Optional error string (set on failure)
  * @return true on success, false on failure
  *
- * Implementation calls PowerShell Expand-Archive -Force.
+ * Stored and deflated entries are decoded in-process and independent entries
+ * are extracted in parallel. Existing files are overwritten, CRCs are
+ * verified, and entries that would escape destDir are rejected.
  */
 bool extractZipToDirectory(const QString& zipPath, const QString& destDir, QString* err = nullptr);
 
+/**
+ * @brief Asynchronous ZIP extraction with progress and cancellation.
+ *
+ * Runs extractZipToDirectory() on the global thread pool and reports
+ * progress in uncompressed bytes on the owning thread.
+ */
+class ZipExtractor : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit ZipExtractor(QObject* parent = nullptr);
+    ~ZipExtractor();
+
+    /**
+     * @brief Start extracting; ignored if an extraction is already running
+     * @return True if the extraction was started
+     */
+    bool start(const QString& zipPath, const QString& destDir);
+
+    /**
+     * @brief Request cancellation; finished() is emitted with ok == false
+     */
+    void cancel();
+
+    bool isRunning() const;
+
+signals:
+    void progress(quint64 bytesDone, quint64 bytesTotal);
+    void finished(bool ok, const QString& error);
+
+private:
+    struct State {
+        std::atomic<bool> cancelled { false };
+        std::atomic<quint64> bytesDone { 0 };
+        std::atomic<quint64> bytesTotal { 0 };
+        QString error;
+    };
+
+    void reportProgress();
+
+    std::shared_ptr<State> m_state;
+    QFutureWatcher<bool> m_watcher;
+    QTimer m_progressTimer;
+};
+
 #endif // ARCHIVEUTILS_H
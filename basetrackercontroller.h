@@ -5,7 +5,7 @@
 #include <QString>
 #include <QStringList>
 #include <QTableView>
-#include <QSqlTableModel>
+#include <QAbstractItemModel>
 #include <QModelIndex>
 #include <QStandardPaths>
 #include <QDir>
@@ -16,10 +16,10 @@
 /**
  * @brief Base class for all tracker controllers providing shared Excel copy functionality
  *
- * This class provides the standardized copyFormattedRow() functionality that creates
- * a temporary Excel file, formats it with borders and proper cell formatting,
- * copies to clipboard, and cleans up automatically. All tracker controllers
- * inherit this identical functionality to ensure consistency across all tabs.
+ * This class provides the standardized copyFormattedRow() functionality that
+ * renders the selected row as a bordered table (HTML, RTF and TSV clipboard
+ * formats) directly from the tracker model. All tracker controllers inherit
+ * this identical functionality to ensure consistency across all tabs.
  */
 class BaseTrackerController : public QObject
 {
@@ -37,23 +37,22 @@ protected:
     explicit BaseTrackerController(QObject *parent = nullptr);
 
     /**
-     * @brief Copy selected row from tracker table with Word formatting
+     * @brief Copy selected row from tracker table with table formatting
      * @return Status message indicating success or failure
      *
-     * This method creates a temporary Word document with a formatted table,
-     * including borders, bold headers, and cell styling, copies the data to
-     * the clipboard, then automatically cleans up the temporary file.
+     * Copies the header and selected row with borders, bold shaded headers
+     * and right-aligned numeric cells, ready to paste into Word or Excel.
      */
     QString copyFormattedRow();
 
     /**
-     * @brief Create Excel file and copy formatted data to clipboard
-     * @param headers Column headers for the Excel file
+     * @brief Copy a formatted header + data row table to the clipboard
+     * @param headers Column headers
      * @param rowData Row data to be formatted and copied
      * @return True if operation succeeded, false otherwise
      *
-     * Uses PowerShell script to create Excel COM object, format cells
-     * with borders and proper data types, copy to clipboard, and cleanup.
+     * Renders HTML, RTF and TSV in-process via ExcelClipboard; no Office
+     * automation or temporary files are involved.
      */
     bool createExcelAndCopy(const QStringList& headers, const QStringList& rowData);
 
@@ -75,9 +74,9 @@ protected:
 
     /**
      * @brief Get the tracker model
-     * @return Pointer to QSqlTableModel, must be implemented by derived classes
+     * @return Pointer to the tracker's table model, must be implemented by derived classes
      */
-    virtual QSqlTableModel* getTrackerModel() const = 0;
+    virtual QAbstractItemModel* getTrackerModel() const = 0;
 
     /**
      * @brief Get column headers for the tracker table
@@ -0,0 +1,680 @@
+#include "csvcombiner.h"
+
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QRandomGenerator>
+#include <QSaveFile>
+#include <QThread>
+#include <QThreadPool>
+#include <QVector>
+#include <QtConcurrent>
+
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <mutex>
+
+namespace {
+
+const qint64 kReadBufferBytes = 1024 * 1024;
+const int kBlockTargetBytes = 1024 * 1024;
+const int kWriteBufferBytes = 4 * 1024 * 1024;
+const size_t kMaxQueuedBlocks = 4;
+const quint32 kIdSpace = 36u * 36u * 36u * 36u * 36u * 36u;
+const char kIdAlphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789";
+
+// Windows-1252 code points for bytes 0x80-0x9F; the rest match Latin-1
+const ushort kCp1252High[32] = {
+    0x20AC, 0xFFFD, 0x201A, 0x0192, 0x201E, 0x2026, 0x2020, 0x2021,
+    0x02C6, 0x2030, 0x0160, 0x2039, 0x0152, 0xFFFD, 0x017D, 0xFFFD,
+    0xFFFD, 0x2018, 0x2019, 0x201C, 0x201D, 0x2022, 0x2013, 0x2014,
+    0x02DC, 0x2122, 0x0161, 0x203A, 0x0153, 0xFFFD, 0x017E, 0x0178 };
+
+bool isValidUtf8(const unsigned char* p, int n)
+{
+    int i = 0;
+    while (i < n) {
+        const unsigned char c = p[i];
+        int extra = 0;
+        quint32 cp = 0;
+        if (c < 0x80) {
+            ++i;
+            continue;
+        } else if ((c & 0xE0) == 0xC0) {
+            extra = 1;
+            cp = c & 0x1F;
+        } else if ((c & 0xF0) == 0xE0) {
+            extra = 2;
+            cp = c & 0x0F;
+        } else if ((c & 0xF8) == 0xF0) {
+            extra = 3;
+            cp = c & 0x07;
+        } else {
+            return false;
+        }
+        if (i + extra >= n) {
+            return false;
+        }
+        for (int k = 1; k <= extra; ++k) {
+            if ((p[i + k] & 0xC0) != 0x80) {
+                return false;
+            }
+            cp = (cp << 6) | (p[i + k] & 0x3F);
+        }
+        // Reject overlong forms, surrogates and out-of-range code points
+        if ((extra == 1 && cp < 0x80) || (extra == 2 && cp < 0x800) || (extra == 3 && cp < 0x10000)
+            || (cp >= 0xD800 && cp <= 0xDFFF) || cp > 0x10FFFF) {
+            return false;
+        }
+        i += extra + 1;
+    }
+    return true;
+}
+
+// Append field text as UTF-8; bytes that are not valid UTF-8 are read as Windows-1252
+void appendText(QByteArray& out, const char* p, int n)
+{
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(p);
+    bool ascii = true;
+    for (int i = 0; i < n; ++i) {
+        if (bytes[i] & 0x80) {
+            ascii = false;
+            break;
+        }
+    }
+    if (ascii || isValidUtf8(bytes, n)) {
+        out.append(p, n);
+        return;
+    }
+
+    for (int i = 0; i < n; ++i) {
+        const unsigned char b = bytes[i];
+        if (b < 0x80) {
+            out.append(static_cast<char>(b));
+            continue;
+        }
+        const ushort cp = b < 0xA0 ? kCp1252High[b - 0x80] : b;
+        if (cp < 0x800) {
+            out.append(static_cast<char>(0xC0 | (cp >> 6)));
+            out.append(static_cast<char>(0x80 | (cp & 0x3F)));
+        } else {
+            out.append(static_cast<char>(0xE0 | (cp >> 12)));
+            out.append(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+            out.append(static_cast<char>(0x80 | (cp & 0x3F)));
+        }
+    }
+}
+
+QString decodeText(const char* p, int n)
+{
+    QByteArray utf8;
+    appendText(utf8, p, n);
+    return QString::fromUtf8(utf8);
+}
+
+// QUOTE_MINIMAL: quote only fields containing a delimiter, quote or line break
+void appendCsvField(QByteArray& out, const char* p, int n)
+{
+    bool needsQuotes = false;
+    for (int i = 0; i < n; ++i) {
+        const char c = p[i];
+        if (c == ',' || c == '"' || c == '\r' || c == '\n') {
+            needsQuotes = true;
+            break;
+        }
+    }
+    if (!needsQuotes) {
+        appendText(out, p, n);
+        return;
+    }
+
+    QByteArray text;
+    appendText(text, p, n);
+    out.append('"');
+    for (const char c : text) {
+        if (c == '"') {
+            out.append('"');
+        }
+        out.append(c);
+    }
+    out.append('"');
+}
+
+QString normalizeHeader(const QString& header)
+{
+    return header.trimmed().toLower();
+}
+
+/**
+ * Streaming CSV record parser (Excel dialect, non-strict like Python's csv
+ * module). Records are reported as one byte buffer plus field end offsets;
+ * blank lines are skipped.
+ */
+class CsvRecordParser
+{
+public:
+    template<typename Callback>
+    void feed(const char* data, qint64 size, Callback&& onRecord)
+    {
+        qint64 i = 0;
+        while (i < size) {
+            const char c = data[i];
+            switch (m_state) {
+            case State::StartField:
+                if (c == '"') {
+                    m_state = State::Quoted;
+                    ++i;
+                } else if (c == ',') {
+                    endField();
+                    ++i;
+                } else if (c == '\r' || c == '\n') {
+                    if (!m_fieldEnds.isEmpty()) {
+                        endField();
+                    }
+                    endRecord(onRecord);
+                    ++i;
+                } else {
+                    m_state = State::Unquoted;
+                }
+                break;
+
+            case State::Unquoted: {
+                qint64 run = i;
+                while (run < size && data[run] != ',' && data[run] != '\r' && data[run] != '\n') {
+                    ++run;
+                }
+                m_fields.append(data + i, static_cast<int>(run - i));
+                i = run;
+                if (i < size) {
+                    endField();
+                    m_state = State::StartField;
+                    if (data[i] != ',') {
+                        endRecord(onRecord);
+                    }
+                    ++i;
+                }
+                break;
+            }
+
+            case State::Quoted: {
+                const void* quote = std::memchr(data + i, '"', static_cast<size_t>(size - i));
+                const qint64 run = quote ? static_cast<const char*>(quote) - data : size;
+                m_fields.append(data + i, static_cast<int>(run - i));
+                i = run;
+                if (i < size) {
+                    m_state = State::QuoteInQuoted;
+                    ++i;
+                }
+                break;
+            }
+
+            case State::QuoteInQuoted:
+                if (c == '"') {
+                    m_fields.append('"');
+                    m_state = State::Quoted;
+                    ++i;
+                } else if (c == ',' || c == '\r' || c == '\n') {
+                    m_state = State::StartField;
+                } else {
+                    // Text after a closing quote is kept, as Python's csv does
+                    m_state = State::Unquoted;
+                }
+                if (m_state == State::StartField) {
+                    endField();
+                    if (c != ',') {
+                        endRecord(onRecord);
+                    }
+                    ++i;
+                }
+                break;
+            }
+        }
+    }
+
+    template<typename Callback>
+    void finish(Callback&& onRecord)
+    {
+        if (m_state != State::StartField || !m_fieldEnds.isEmpty()) {
+            endField();
+            endRecord(onRecord);
+        }
+        m_state = State::StartField;
+    }
+
+private:
+    enum class State {
+        StartField,
+        Unquoted,
+        Quoted,
+        QuoteInQuoted
+    };
+
+    void endField() { m_fieldEnds.append(m_fields.size()); }
+
+    template<typename Callback>
+    void endRecord(Callback&& onRecord)
+    {
+        if (!m_fieldEnds.isEmpty()) {
+            onRecord(m_fields.constData(), m_fieldEnds.constData(), m_fieldEnds.size());
+        }
+        m_fields.resize(0);
+        m_fieldEnds.resize(0);
+    }
+
+    State m_state = State::StartField;
+    QByteArray m_fields;
+    QVector<int> m_fieldEnds;
+};
+
+/**
+ * Unique pseudo-random 6-character IDs without remembering issued ones: a
+ * keyed Feistel permutation of the row index, cycle-walked into 36^6.
+ */
+class IdGenerator
+{
+public:
+    IdGenerator()
+    {
+        for (quint32& key : m_keys) {
+            key = QRandomGenerator::global()->generate();
+        }
+    }
+
+    void write(quint32 index, char* out) const
+    {
+        quint32 value = index;
+        do {
+            value = permute(value);
+        } while (value >= kIdSpace);
+
+        for (int i = 5; i >= 0; --i) {
+            out[i] = kIdAlphabet[value % 36];
+            value /= 36;
+        }
+    }
+
+private:
+    quint32 permute(quint32 value) const
+    {
+        quint32 left = value >> 16;
+        quint32 right = value & 0xFFFF;
+        for (const quint32 key : m_keys) {
+            const quint32 mixed = ((right * 0x9E3779B1u) ^ key) * 0x85EBCA6Bu;
+            const quint32 next = left ^ (mixed >> 16);
+            left = right;
+            right = next & 0xFFFF;
+        }
+        return (left << 16) | right;
+    }
+
+    quint32 m_keys[4];
+};
+
+struct InputFile {
+    QString path;
+    QStringList headers;
+    QVector<int> outToSource;   // per output column (ID excluded); -1 when absent
+};
+
+struct RowBlock {
+    QByteArray data;
+    QVector<int> rowEnds;
+};
+
+struct FileQueue {
+    std::deque<RowBlock> blocks;
+    bool done = false;
+    QString error;
+};
+
+struct SharedState {
+    std::mutex mutex;
+    std::condition_variable changed;
+    QVector<FileQueue> queues;
+    std::atomic<bool> abort { false };
+};
+
+bool shouldStop(const SharedState& shared, const CsvCombiner::Progress* progress)
+{
+    return shared.abort.load() || (progress && progress->cancelled.load());
+}
+
+bool readHeader(InputFile& input, QString& error)
+{
+    QFile file(input.path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        error = QString("Cannot open %1: %2").arg(QFileInfo(input.path).fileName(), file.errorString());
+        return false;
+    }
+
+    CsvRecordParser parser;
+    bool found = false;
+    auto onRecord = [&](const char* data, const int* ends, int count) {
+        if (found) {
+            return;
+        }
+        found = true;
+        int begin = 0;
+        for (int i = 0; i < count; ++i) {
+            const char* field = data + begin;
+            int length = ends[i] - begin;
+            // Drop a UTF-8 BOM from the first header
+            if (i == 0 && length >= 3 && std::memcmp(field, "\xEF\xBB\xBF", 3) == 0) {
+                field += 3;
+                length -= 3;
+            }
+            input.headers.append(decodeText(field, length));
+            begin = ends[i];
+        }
+    };
+
+    QByteArray buffer(64 * 1024, Qt::Uninitialized);
+    while (!found) {
+        const qint64 n = file.read(buffer.data(), buffer.size());
+        if (n <= 0) {
+            parser.finish(onRecord);
+            break;
+        }
+        parser.feed(buffer.constData(), n, onRecord);
+    }
+    return true;
+}
+
+void streamFile(int fileIndex, const InputFile& input, int outputColumns,
+                SharedState& shared, CsvCombiner::Progress* progress)
+{
+    FileQueue& queue = shared.queues[fileIndex];
+    QString error;
+
+    auto pushBlock = [&](RowBlock&& block) {
+        std::unique_lock<std::mutex> lock(shared.mutex);
+        shared.changed.wait(lock, [&] {
+            return queue.blocks.size() < kMaxQueuedBlocks || shouldStop(shared, progress);
+        });
+        queue.blocks.push_back(std::move(block));
+        shared.changed.notify_all();
+    };
+
+    QFile file(input.path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        error = QString("Cannot open %1: %2").arg(QFileInfo(input.path).fileName(), file.errorString());
+    } else {
+        RowBlock block;
+        block.data.reserve(kBlockTargetBytes + 64 * 1024);
+        bool headerSkipped = false;
+
+        auto onRecord = [&](const char* data, const int* ends, int count) {
+            if (!headerSkipped) {
+                headerSkipped = true;
+                return;
+            }
+            for (int column = 0; column < outputColumns; ++column) {
+                if (column > 0) {
+                    block.data.append(',');
+                }
+                const int source = input.outToSource[column];
+                if (source >= 0 && source < count) {
+                    const int begin = source == 0 ? 0 : ends[source - 1];
+                    appendCsvField(block.data, data + begin, ends[source] - begin);
+                }
+            }
+            block.data.append("\r\n", 2);
+            block.rowEnds.append(block.data.size());
+
+            if (block.data.size() >= kBlockTargetBytes) {
+                pushBlock(std::move(block));
+                block = RowBlock();
+                block.data.reserve(kBlockTargetBytes + 64 * 1024);
+            }
+        };
+
+        CsvRecordParser parser;
+        QByteArray buffer(static_cast<int>(kReadBufferBytes), Qt::Uninitialized);
+        for (;;) {
+            if (shouldStop(shared, progress)) {
+                break;
+            }
+            const qint64 n = file.read(buffer.data(), buffer.size());
+            if (n < 0) {
+                error = QString("Read failed for %1: %2").arg(QFileInfo(input.path).fileName(), file.errorString());
+                break;
+            }
+            if (n == 0) {
+                parser.finish(onRecord);
+                break;
+            }
+            parser.feed(buffer.constData(), n, onRecord);
+            if (progress) {
+                progress->bytesRead.fetch_add(static_cast<quint64>(n));
+            }
+        }
+
+        if (error.isEmpty() && !block.rowEnds.isEmpty()) {
+            pushBlock(std::move(block));
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(shared.mutex);
+    queue.done = true;
+    queue.error = error;
+    shared.changed.notify_all();
+}
+
+} // namespace
+
+CsvCombineResult CsvCombiner::combineFiles(const QStringList& inputPaths, const QString& outputPath,
+                                           Progress* progress)
+{
+    CsvCombineResult result;
+    QElapsedTimer timer;
+    timer.start();
+
+    // Pass 1: header rows only, to build the output column set
+    QVector<InputFile> inputs;
+    QStringList headers;
+    QHash<QString, int> columnByKey;
+    quint64 bytesTotal = 0;
+
+    for (const QString& path : inputPaths) {
+        InputFile input;
+        input.path = path;
+        if (!readHeader(input, result.error)) {
+            return result;
+        }
+        if (input.headers.isEmpty()) {
+            result.warnings.append(QString("'%1' has no header row; skipping.").arg(QFileInfo(path).fileName()));
+            continue;
+        }
+        for (const QString& header : input.headers) {
+            const QString key = normalizeHeader(header);
+            if (!columnByKey.contains(key)) {
+                columnByKey.insert(key, headers.size());
+                headers.append(header);
+            }
+        }
+        bytesTotal += static_cast<quint64>(QFileInfo(path).size());
+        inputs.append(input);
+    }
+
+    if (inputs.isEmpty()) {
+        result.error = "No readable input files were provided.";
+        return result;
+    }
+
+    for (InputFile& input : inputs) {
+        // A later duplicate of the same header wins, as with csv.DictReader
+        input.outToSource.fill(-1, headers.size());
+        for (int i = 0; i < input.headers.size(); ++i) {
+            input.outToSource[columnByKey.value(normalizeHeader(input.headers.at(i)))] = i;
+        }
+    }
+
+    if (progress) {
+        progress->bytesTotal.store(bytesTotal);
+    }
+    result.columnCount = headers.size() + 1;
+
+    QSaveFile output(outputPath);
+    if (!output.open(QIODevice::WriteOnly)) {
+        result.error = QString("Cannot create %1: %2").arg(outputPath, output.errorString());
+        return result;
+    }
+
+    QByteArray buffer;
+    buffer.reserve(kWriteBufferBytes + kBlockTargetBytes);
+    buffer.append("\xEF\xBB\xBF", 3);
+    buffer.append("ID");
+    for (const QString& header : headers) {
+        buffer.append(',');
+        const QByteArray utf8 = header.toUtf8();
+        appendCsvField(buffer, utf8.constData(), utf8.size());
+    }
+    buffer.append("\r\n", 2);
+
+    // Pass 2: parse inputs on a small pool, write rows in input order
+    SharedState shared;
+    shared.queues.resize(inputs.size());
+
+    QThreadPool pool;
+    pool.setMaxThreadCount(qBound(1, QThread::idealThreadCount() - 1, static_cast<int>(inputs.size())));
+    const int outputColumns = headers.size();
+    for (int i = 0; i < inputs.size(); ++i) {
+        const InputFile* input = &inputs[i];
+        SharedState* sharedPtr = &shared;
+        pool.start([i, input, outputColumns, sharedPtr, progress]() {
+            streamFile(i, *input, outputColumns, *sharedPtr, progress);
+        });
+    }
+
+    const IdGenerator ids;
+    quint32 rowIndex = 0;
+    char id[7];
+    id[6] = ',';
+
+    auto flushBuffer = [&]() {
+        if (output.write(buffer) != buffer.size()) {
+            result.error = QString("Write failed for %1: %2").arg(outputPath, output.errorString());
+            return false;
+        }
+        buffer.resize(0);
+        return true;
+    };
+
+    for (int i = 0; i < inputs.size() && result.error.isEmpty(); ++i) {
+        FileQueue& queue = shared.queues[i];
+        for (;;) {
+            RowBlock block;
+            {
+                std::unique_lock<std::mutex> lock(shared.mutex);
+                shared.changed.wait(lock, [&] {
+                    return !queue.blocks.empty() || queue.done || shouldStop(shared, progress);
+                });
+                if (shouldStop(shared, progress)) {
+                    result.error = "Combine cancelled.";
+                    break;
+                }
+                if (queue.blocks.empty()) {
+                    if (!queue.error.isEmpty()) {
+                        result.error = queue.error;
+                    }
+                    break;
+                }
+                block = std::move(queue.blocks.front());
+                queue.blocks.pop_front();
+                shared.changed.notify_all();
+            }
+
+            int begin = 0;
+            for (const int end : block.rowEnds) {
+                ids.write(rowIndex++, id);
+                buffer.append(id, 7);
+                buffer.append(block.data.constData() + begin, end - begin);
+                begin = end;
+            }
+            if (progress) {
+                progress->rowsWritten.store(static_cast<qint64>(rowIndex));
+            }
+            if (buffer.size() >= kWriteBufferBytes && !flushBuffer()) {
+                break;
+            }
+        }
+    }
+
+    if (!result.error.isEmpty()) {
+        shared.abort = true;
+        shared.changed.notify_all();
+    }
+    pool.waitForDone();
+
+    if (result.error.isEmpty() && flushBuffer()) {
+        if (!output.commit()) {
+            result.error = QString("Failed to save %1: %2").arg(outputPath, output.errorString());
+        }
+    }
+    if (!result.error.isEmpty()) {
+        output.cancelWriting();
+        return result;
+    }
+
+    result.ok = true;
+    result.rowsWritten = static_cast<qint64>(rowIndex);
+    result.bytesRead = bytesTotal;
+    result.elapsedMs = timer.elapsed();
+    return result;
+}
+
+CsvCombiner::CsvCombiner(QObject* parent)
+    : QObject(parent)
+{
+    m_progressTimer.setInterval(100);
+    connect(&m_progressTimer, &QTimer::timeout, this, &CsvCombiner::reportProgress);
+
+    connect(&m_watcher, &QFutureWatcher<CsvCombineResult>::finished, this, [this]() {
+        m_progressTimer.stop();
+        reportProgress();
+        emit finished(m_watcher.result());
+    });
+}
+
+CsvCombiner::~CsvCombiner()
+{
+    cancel();
+    m_watcher.waitForFinished();
+}
+
+bool CsvCombiner::start(const QStringList& inputPaths, const QString& outputPath)
+{
+    if (isRunning()) {
+        return false;
+    }
+
+    m_state = std::make_shared<Progress>();
+    std::shared_ptr<Progress> state = m_state;
+
+    m_watcher.setFuture(QtConcurrent::run([state, inputPaths, outputPath]() {
+        return combineFiles(inputPaths, outputPath, state.get());
+    }));
+    m_progressTimer.start();
+    return true;
+}
+
+void CsvCombiner::cancel()
+{
+    if (m_state) {
+        m_state->cancelled = true;
+    }
+}
+
+bool CsvCombiner::isRunning() const
+{
+    return m_watcher.isRunning();
+}
+
+void CsvCombiner::reportProgress()
+{
+    if (m_state) {
+        emit progress(m_state->rowsWritten.load(), m_state->bytesRead.load(), m_state->bytesTotal.load());
+    }
+}
@@ -0,0 +1,181 @@
+#include "csvscanner.h"
+
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CSVSCANNER_HAS_SSE2 1
+#include <emmintrin.h>
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace {
+
+inline unsigned lowestSetBit32(uint32_t value)
+{
+#if defined(_MSC_VER)
+    unsigned long index = 0;
+    _BitScanForward(&index, value);
+    return static_cast<unsigned>(index);
+#else
+    return static_cast<unsigned>(__builtin_ctz(value));
+#endif
+}
+
+#ifndef CSVSCANNER_HAS_SSE2
+inline unsigned lowestSetBit64(uint64_t value)
+{
+#if defined(_MSC_VER) && defined(_WIN64)
+    unsigned long index = 0;
+    _BitScanForward64(&index, value);
+    return static_cast<unsigned>(index);
+#elif defined(_MSC_VER)
+    const uint32_t low = static_cast<uint32_t>(value);
+    return low ? lowestSetBit32(low) : 32 + lowestSetBit32(static_cast<uint32_t>(value >> 32));
+#else
+    return static_cast<unsigned>(__builtin_ctzll(value));
+#endif
+}
+
+// High bit set in every byte lane of v that is zero; lanes above the first
+// zero may report false positives, so only the lowest set bit is reliable
+inline uint64_t zeroByteMask(uint64_t v)
+{
+    return (v - 0x0101010101010101ull) & ~v & 0x8080808080808080ull;
+}
+
+inline bool isLittleEndian()
+{
+    const uint16_t probe = 1;
+    unsigned char first = 0;
+    std::memcpy(&first, &probe, 1);
+    return first == 1;
+}
+#endif
+
+// pos is a '\n'; the line it ends is empty or a lone CR. data starts at a
+// line start, and a blank line holds no quote, so whichever quote state
+// makes this newline a terminator made the previous one a terminator too.
+inline bool endsBlankLine(const char* data, size_t pos)
+{
+    if (pos == 0 || data[pos - 1] == '\n') {
+        return true;
+    }
+    return data[pos - 1] == '\r' && (pos == 1 || data[pos - 2] == '\n');
+}
+
+} // namespace
+
+size_t CsvScanner::nextSpecial(const char* data, size_t size)
+{
+    size_t pos = 0;
+
+#ifdef CSVSCANNER_HAS_SSE2
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i newline = _mm_set1_epi8('\n');
+    while (pos + 16 <= size) {
+        const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos));
+        const __m128i hits = _mm_or_si128(_mm_cmpeq_epi8(block, quote), _mm_cmpeq_epi8(block, newline));
+        const uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(hits));
+        if (mask != 0) {
+            return pos + lowestSetBit32(mask);
+        }
+        pos += 16;
+    }
+#else
+    if (isLittleEndian()) {
+        const uint64_t quotes = 0x2222222222222222ull;
+        const uint64_t newlines = 0x0A0A0A0A0A0A0A0Aull;
+        while (pos + 8 <= size) {
+            uint64_t word = 0;
+            std::memcpy(&word, data + pos, 8);
+            const uint64_t mask = zeroByteMask(word ^ quotes) | zeroByteMask(word ^ newlines);
+            if (mask != 0) {
+                return pos + lowestSetBit64(mask) / 8;
+            }
+            pos += 8;
+        }
+    }
+#endif
+
+    for (; pos < size; ++pos) {
+        if (data[pos] == '"' || data[pos] == '\n') {
+            return pos;
+        }
+    }
+    return size;
+}
+
+CsvScanner::ChunkSummary CsvScanner::summarize(const char* data, size_t size)
+{
+    ChunkSummary summary;
+
+    // Track the quote state as if the chunk started outside quotes; the
+    // inside-start state is always its complement
+    bool inside = false;
+    size_t pos = 0;
+    while (pos < size) {
+        pos += nextSpecial(data + pos, size - pos);
+        if (pos >= size) {
+            break;
+        }
+        if (data[pos] == '"') {
+            inside = !inside;
+        } else if (endsBlankLine(data, pos)) {
+            // Not a row in either state
+        } else if (inside) {
+            ++summary.rowsIfInside;
+        } else {
+            ++summary.rowsIfOutside;
+        }
+        ++pos;
+    }
+
+    summary.flipsQuoteState = inside;
+    return summary;
+}
+
+size_t CsvScanner::findRowEnd(const char* data, size_t size, bool startsInside, uint64_t rows)
+{
+    bool inside = startsInside;
+    size_t pos = 0;
+    while (pos < size) {
+        pos += nextSpecial(data + pos, size - pos);
+        if (pos >= size) {
+            break;
+        }
+        if (data[pos] == '"') {
+            inside = !inside;
+        } else if (!inside && !endsBlankLine(data, pos) && --rows == 0) {
+            return pos + 1;
+        }
+        ++pos;
+    }
+    return size;
+}
+
+size_t CsvScanner::nextLineStart(const char* data, size_t size, size_t offset)
+{
+    if (offset == 0 || offset >= size || data[offset - 1] == '\n') {
+        return offset < size ? offset : size;
+    }
+    const void* newline = std::memchr(data + offset, '\n', size - offset);
+    return newline ? static_cast<size_t>(static_cast<const char*>(newline) - data) + 1 : size;
+}
+
+bool CsvScanner::hasUnterminatedRow(const char* data, size_t size, bool endsInside)
+{
+    if (endsInside) {
+        // An unclosed quote still belongs to a row with content
+        return true;
+    }
+
+    size_t tail = size;
+    while (tail > 0 && data[tail - 1] != '\n') {
+        --tail;
+    }
+    const size_t length = size - tail;
+    return length > 1 || (length == 1 && data[tail] != '\r');
+}
@@ -0,0 +1,76 @@
+#ifndef CSVSCANNER_H
+#define CSVSCANNER_H
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Quote-aware CSV row boundary scanning over raw bytes
+ *
+ * A row ends at a newline that is not inside a double-quoted field. Escaped
+ * quotes ("") toggle the quote state twice and so need no special handling.
+ * Blank lines (empty, or a lone CR) end no row, matching pandas'
+ * skip_blank_lines; chunks must therefore start at a line start, see
+ * nextLineStart().
+ * The inner loop looks for '"' and '\n' sixteen bytes at a time with SSE2
+ * (eight at a time with a portable word trick elsewhere), so long unquoted
+ * stretches are skipped without per-byte branching.
+ *
+ * summarize() records the row count for both possible starting quote states,
+ * which lets independent chunks of a file be scanned in parallel and then
+ * stitched together in order with a running quote state.
+ */
+class CsvScanner
+{
+public:
+    struct ChunkSummary {
+        uint64_t rowsIfOutside = 0;  ///< Rows ended if the chunk starts outside quotes
+        uint64_t rowsIfInside = 0;   ///< Rows ended if the chunk starts inside quotes
+        bool flipsQuoteState = false; ///< True if the chunk has an odd number of quotes
+
+        uint64_t rows(bool startsInside) const { return startsInside ? rowsIfInside : rowsIfOutside; }
+        bool endState(bool startsInside) const { return startsInside != flipsQuoteState; }
+    };
+
+    /**
+     * @brief Count rows ended in a chunk for both starting quote states
+     *
+     * The chunk must start at a line start (file start or just after '\n').
+     */
+    static ChunkSummary summarize(const char* data, size_t size);
+
+    /**
+     * @brief Find the offset just past the n-th row terminator
+     * @param data Chunk start, at a line start
+     * @param size Chunk length
+     * @param startsInside Quote state at the chunk start
+     * @param rows Number of rows to pass (>= 1); blank lines are not counted
+     * @return Offset after the n-th terminator, or size if the chunk has fewer
+     */
+    static size_t findRowEnd(const char* data, size_t size, bool startsInside, uint64_t rows);
+
+    /**
+     * @brief First line start at or after offset, or size if there is none
+     *
+     * Used to place chunk boundaries.
+     */
+    static size_t nextLineStart(const char* data, size_t size, size_t offset);
+
+    /**
+     * @brief True if the bytes after the last row terminator form a row
+     * @param data Body start, at a line start
+     * @param size Body length
+     * @param endsInside Quote state at the end of the body
+     *
+     * A file's last row need not end in a newline; a trailing blank line
+     * is not a row.
+     */
+    static bool hasUnterminatedRow(const char* data, size_t size, bool endsInside);
+
+    /**
+     * @brief Offset of the next '"' or '\n' at or after data, or size if none
+     */
+    static size_t nextSpecial(const char* data, size_t size);
+};
+
+#endif // CSVSCANNER_H
@@ -0,0 +1,290 @@
+#include "csvsplitter.h"
+#include "csvscanner.h"
+
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QtConcurrent>
+
+namespace {
+
+const quint64 kScanChunkBytes = 8ull * 1024 * 1024;
+const qint64 kWriteSliceBytes = 4 * 1024 * 1024;
+
+struct ScanChunk {
+    quint64 offset = 0;
+    quint64 size = 0;
+    CsvScanner::ChunkSummary summary;
+    bool startsInside = false;
+    quint64 rowsBefore = 0;
+};
+
+struct PartRange {
+    QString path;
+    quint64 begin = 0;
+    quint64 end = 0;
+    qint64 records = 0;
+    bool ok = false;
+    QString error;
+};
+
+bool isCancelled(const CsvSplitter::Progress* progress)
+{
+    return progress && progress->cancelled.load();
+}
+
+void addProgress(CsvSplitter::Progress* progress, quint64 bytes)
+{
+    if (progress) {
+        progress->bytesDone.fetch_add(bytes);
+    }
+}
+
+// Offset just past the given number of data-row terminators in the body
+quint64 offsetAfterRows(const char* data, const QVector<ScanChunk>& chunks, quint64 rows,
+                        quint64 bodyBegin, quint64 fileSize)
+{
+    if (rows == 0) {
+        return bodyBegin;
+    }
+    for (const ScanChunk& chunk : chunks) {
+        const quint64 chunkRows = chunk.summary.rows(chunk.startsInside);
+        if (rows <= chunk.rowsBefore + chunkRows) {
+            return chunk.offset + CsvScanner::findRowEnd(data + chunk.offset, chunk.size,
+                                                         chunk.startsInside, rows - chunk.rowsBefore);
+        }
+    }
+    return fileSize;
+}
+
+bool writePart(const uchar* data, quint64 headerSize, PartRange& part,
+               CsvSplitter::Progress* progress)
+{
+    QFile out(part.path);
+    if (!out.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        part.error = QString("Cannot create %1: %2").arg(QDir::toNativeSeparators(part.path), out.errorString());
+        return false;
+    }
+
+    if (out.write(reinterpret_cast<const char*>(data), static_cast<qint64>(headerSize))
+        != static_cast<qint64>(headerSize)) {
+        part.error = QString("Write failed for %1: %2").arg(QDir::toNativeSeparators(part.path), out.errorString());
+        return false;
+    }
+
+    quint64 pos = part.begin;
+    while (pos < part.end) {
+        if (isCancelled(progress)) {
+            part.error = "Split cancelled.";
+            return false;
+        }
+        const qint64 slice = static_cast<qint64>(qMin<quint64>(kWriteSliceBytes, part.end - pos));
+        if (out.write(reinterpret_cast<const char*>(data + pos), slice) != slice) {
+            part.error = QString("Write failed for %1: %2").arg(QDir::toNativeSeparators(part.path), out.errorString());
+            return false;
+        }
+        pos += static_cast<quint64>(slice);
+        addProgress(progress, static_cast<quint64>(slice));
+    }
+
+    out.close();
+    if (out.error() != QFileDevice::NoError) {
+        part.error = QString("Write failed for %1: %2").arg(QDir::toNativeSeparators(part.path), out.errorString());
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+CsvSplitResult CsvSplitter::splitFile(const QString& inputPath, int parts,
+                                      const QString& outputDir, const QString& baseName,
+                                      Progress* progress)
+{
+    CsvSplitResult result;
+    QElapsedTimer timer;
+    timer.start();
+
+    if (parts < 1) {
+        result.error = "Invalid number of parts.";
+        return result;
+    }
+    if (!QFileInfo(outputDir).isDir()) {
+        result.error = QString("Output directory does not exist: %1").arg(QDir::toNativeSeparators(outputDir));
+        return result;
+    }
+
+    QFile input(inputPath);
+    if (!input.open(QIODevice::ReadOnly)) {
+        result.error = QString("Cannot open %1: %2").arg(QDir::toNativeSeparators(inputPath), input.errorString());
+        return result;
+    }
+
+    const quint64 fileSize = static_cast<quint64>(input.size());
+    if (fileSize == 0) {
+        result.error = "File is empty.";
+        return result;
+    }
+
+    uchar* mapped = input.map(0, input.size());
+    if (!mapped) {
+        result.error = QString("Cannot map %1: %2").arg(QDir::toNativeSeparators(inputPath), input.errorString());
+        return result;
+    }
+    const char* data = reinterpret_cast<const char*>(mapped);
+    result.inputBytes = fileSize;
+
+    // Header row, then the data rows in independently scanned chunks
+    const quint64 headerSize = CsvScanner::findRowEnd(data, fileSize, false, 1);
+    const quint64 bodySize = fileSize - headerSize;
+
+    if (progress) {
+        // Scan plus write passes over the body
+        progress->bytesTotal.store(bodySize * 2);
+    }
+
+    // Chunks start at line starts so blank lines can be told apart per chunk
+    QVector<ScanChunk> chunks;
+    for (quint64 offset = headerSize; offset < fileSize;) {
+        const quint64 end = CsvScanner::nextLineStart(data, fileSize, qMin(offset + kScanChunkBytes, fileSize));
+        ScanChunk chunk;
+        chunk.offset = offset;
+        chunk.size = end - offset;
+        chunks.append(chunk);
+        offset = end;
+    }
+
+    QtConcurrent::blockingMap(chunks, [data, progress](ScanChunk& chunk) {
+        if (isCancelled(progress)) {
+            return;
+        }
+        chunk.summary = CsvScanner::summarize(data + chunk.offset, chunk.size);
+        addProgress(progress, chunk.size);
+    });
+    if (isCancelled(progress)) {
+        result.error = "Split cancelled.";
+        return result;
+    }
+
+    bool inside = false;
+    quint64 terminators = 0;
+    for (ScanChunk& chunk : chunks) {
+        chunk.startsInside = inside;
+        chunk.rowsBefore = terminators;
+        terminators += chunk.summary.rows(inside);
+        inside = chunk.summary.endState(inside);
+    }
+
+    // A final row without a trailing newline still counts; blank lines never do
+    const bool unterminatedLastRow =
+        bodySize > 0 && CsvScanner::hasUnterminatedRow(data + headerSize, bodySize, inside);
+    const quint64 totalRows = terminators + (unterminatedLastRow ? 1 : 0);
+    result.recordCount = static_cast<qint64>(totalRows);
+
+    // Same distribution as the Python tool: earlier parts absorb the remainder
+    QVector<PartRange> ranges(parts);
+    const quint64 baseSize = totalRows / static_cast<quint64>(parts);
+    const quint64 remainder = totalRows % static_cast<quint64>(parts);
+    quint64 rowsAssigned = 0;
+    quint64 begin = headerSize;
+    for (int i = 0; i < parts; ++i) {
+        const quint64 size = baseSize + (static_cast<quint64>(i) < remainder ? 1 : 0);
+        rowsAssigned += size;
+
+        PartRange& range = ranges[i];
+        range.path = QDir(outputDir).filePath(QString("%1 %2.csv").arg(baseName).arg(i + 1, 2, 10, QChar('0')));
+        range.begin = begin;
+        range.end = rowsAssigned >= totalRows
+                        ? fileSize
+                        : offsetAfterRows(data, chunks, rowsAssigned, headerSize, fileSize);
+        range.records = static_cast<qint64>(size);
+        begin = range.end;
+    }
+
+    const uchar* header = mapped;
+    QtConcurrent::blockingMap(ranges, [header, headerSize, progress](PartRange& range) {
+        range.ok = writePart(header, headerSize, range, progress);
+    });
+
+    for (const PartRange& range : ranges) {
+        if (!range.ok) {
+            result.error = range.error;
+            break;
+        }
+    }
+
+    if (!result.error.isEmpty()) {
+        for (const PartRange& range : ranges) {
+            QFile::remove(range.path);
+        }
+        return result;
+    }
+
+    for (const PartRange& range : ranges) {
+        CsvSplitPart part;
+        part.path = range.path;
+        part.records = range.records;
+        result.parts.append(part);
+    }
+
+    input.unmap(mapped);
+    result.ok = true;
+    result.elapsedMs = timer.elapsed();
+    return result;
+}
+
+CsvSplitter::CsvSplitter(QObject* parent)
+    : QObject(parent)
+{
+    m_progressTimer.setInterval(100);
+    connect(&m_progressTimer, &QTimer::timeout, this, &CsvSplitter::reportProgress);
+
+    connect(&m_watcher, &QFutureWatcher<CsvSplitResult>::finished, this, [this]() {
+        m_progressTimer.stop();
+        reportProgress();
+        emit finished(m_watcher.result());
+    });
+}
+
+CsvSplitter::~CsvSplitter()
+{
+    cancel();
+    m_watcher.waitForFinished();
+}
+
+bool CsvSplitter::start(const QString& inputPath, int parts,
+                        const QString& outputDir, const QString& baseName)
+{
+    if (isRunning()) {
+        return false;
+    }
+
+    m_state = std::make_shared<Progress>();
+    std::shared_ptr<Progress> state = m_state;
+
+    m_watcher.setFuture(QtConcurrent::run([state, inputPath, parts, outputDir, baseName]() {
+        return splitFile(inputPath, parts, outputDir, baseName, state.get());
+    }));
+    m_progressTimer.start();
+    return true;
+}
+
+void CsvSplitter::cancel()
+{
+    if (m_state) {
+        m_state->cancelled = true;
+    }
+}
+
+bool CsvSplitter::isRunning() const
+{
+    return m_watcher.isRunning();
+}
+
+void CsvSplitter::reportProgress()
+{
+    if (m_state) {
+        emit progress(m_state->bytesDone.load(), m_state->bytesTotal.load());
+    }
+}
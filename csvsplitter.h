@@ -0,0 +1,100 @@
+#ifndef CSVSPLITTER_H
+#define CSVSPLITTER_H
+
+#include <QFutureWatcher>
+#include <QObject>
+#include <QString>
+#include <QTimer>
+#include <QVector>
+
+#include <atomic>
+#include <memory>
+
+/**
+ * @brief One output file written by CsvSplitter
+ */
+struct CsvSplitPart {
+    QString path;
+    qint64 records = 0;
+};
+
+/**
+ * @brief Outcome of a CSV split
+ */
+struct CsvSplitResult {
+    bool ok = false;
+    QString error;
+    qint64 recordCount = 0;     // data rows, header excluded
+    quint64 inputBytes = 0;
+    qint64 elapsedMs = 0;
+    QVector<CsvSplitPart> parts;
+};
+
+/**
+ * @brief Native splitter for large CSV lists (Split Large Lists)
+ *
+ * The input is memory-mapped and scanned in parallel chunks for quote-aware
+ * row boundaries. Rows are divided the same way as the Python tool (earlier
+ * parts take the remainder), and each part is written concurrently as the
+ * original header row followed by its byte range copied verbatim, so field
+ * formatting and line endings are preserved.
+ *
+ * Output files are named "<baseName> NN.csv" in the output directory.
+ */
+class CsvSplitter : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Shared progress/cancellation state for splitFile()
+     */
+    struct Progress {
+        std::atomic<bool> cancelled { false };
+        std::atomic<quint64> bytesDone { 0 };
+        std::atomic<quint64> bytesTotal { 0 };
+    };
+
+    /**
+     * @brief Split a CSV file synchronously
+     * @param inputPath CSV file with a header row
+     * @param parts Number of output files (>= 1)
+     * @param outputDir Existing destination directory
+     * @param baseName Output file name prefix
+     * @param progress Optional progress reporting and cancellation
+     * @return Split result; on failure no partial output files are left behind
+     */
+    static CsvSplitResult splitFile(const QString& inputPath, int parts,
+                                    const QString& outputDir, const QString& baseName,
+                                    Progress* progress = nullptr);
+
+    explicit CsvSplitter(QObject* parent = nullptr);
+    ~CsvSplitter();
+
+    /**
+     * @brief Start splitting on the global thread pool; ignored if already running
+     * @return True if the split was started
+     */
+    bool start(const QString& inputPath, int parts,
+               const QString& outputDir, const QString& baseName);
+
+    /**
+     * @brief Request cancellation; finished() reports a failed result
+     */
+    void cancel();
+
+    bool isRunning() const;
+
+signals:
+    void progress(quint64 bytesDone, quint64 bytesTotal);
+    void finished(const CsvSplitResult& result);
+
+private:
+    void reportProgress();
+
+    std::shared_ptr<Progress> m_state;
+    QFutureWatcher<CsvSplitResult> m_watcher;
+    QTimer m_progressTimer;
+};
+
+#endif // CSVSPLITTER_H
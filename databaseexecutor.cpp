@@ -0,0 +1,118 @@
+#include "databaseexecutor.h"
+#include "databasemanager.h"
+
+#include <QDebug>
+#include <QSqlError>
+#include <QThread>
+
+namespace {
+
+struct WorkerConnection {
+    QString name;
+    QHash<QString, QSqlQuery*> statements;
+    QSqlDatabase db;
+};
+
+// Worker-thread connections, one per database file; closed when the thread exits
+struct WorkerConnections {
+    QHash<QString, WorkerConnection*> byPath;
+    WorkerConnection* current = nullptr;
+
+    ~WorkerConnections()
+    {
+        for (WorkerConnection* connection : std::as_const(byPath)) {
+            qDeleteAll(connection->statements);
+            const QString name = connection->name;
+            connection->db.close();
+            delete connection;
+            QSqlDatabase::removeDatabase(name);
+        }
+    }
+};
+
+WorkerConnections& workerConnections()
+{
+    thread_local WorkerConnections connections;
+    return connections;
+}
+
+WorkerConnection* workerConnection(const QString& databasePath)
+{
+    WorkerConnections& connections = workerConnections();
+    WorkerConnection* connection = connections.byPath.value(databasePath);
+    if (connection) {
+        return connection;
+    }
+
+    connection = new WorkerConnection;
+    connection->name = QString("db_executor_%1_%2")
+                           .arg(reinterpret_cast<quintptr>(QThread::currentThreadId()))
+                           .arg(connections.byPath.size());
+    connections.byPath.insert(databasePath, connection);
+
+    connection->db = QSqlDatabase::addDatabase("QSQLITE", connection->name);
+    connection->db.setDatabaseName(databasePath);
+    if (connection->db.open()) {
+        // The GUI connection already put the file in WAL mode; match its per-connection settings
+        QSqlQuery pragma(connection->db);
+        pragma.exec("PRAGMA busy_timeout=5000");
+        pragma.exec("PRAGMA synchronous=NORMAL");
+        pragma.exec("PRAGMA temp_store=MEMORY");
+    } else {
+        qWarning() << "Database executor: cannot open" << databasePath << ":"
+                   << connection->db.lastError().text();
+    }
+    return connection;
+}
+
+} // namespace
+
+DatabaseExecutor& DatabaseExecutor::instance()
+{
+    static DatabaseExecutor executor;
+    return executor;
+}
+
+DatabaseExecutor::DatabaseExecutor()
+{
+    // One thread: requests run in order and each connection stays on its thread
+    m_pool.setMaxThreadCount(1);
+    m_pool.setExpiryTimeout(-1);
+}
+
+QSqlDatabase DatabaseExecutor::connection(const QString& databasePath)
+{
+    return workerConnection(databasePath)->db;
+}
+
+QSqlDatabase* DatabaseExecutor::currentConnection()
+{
+    WorkerConnection* current = workerConnections().current;
+    return current ? &current->db : nullptr;
+}
+
+QHash<QString, QSqlQuery*>* DatabaseExecutor::currentStatementCache()
+{
+    WorkerConnection* current = workerConnections().current;
+    return current ? &current->statements : nullptr;
+}
+
+void DatabaseExecutor::shutdown()
+{
+    m_pool.waitForDone();
+}
+
+QString DatabaseExecutor::mainDatabasePath()
+{
+    return DatabaseManager::instance()->getDatabase().databaseName();
+}
+
+DatabaseExecutor::TaskScope::TaskScope(const QString& databasePath)
+{
+    workerConnections().current = databasePath.isEmpty() ? nullptr : workerConnection(databasePath);
+}
+
+DatabaseExecutor::TaskScope::~TaskScope()
+{
+    workerConnections().current = nullptr;
+}
@@ -0,0 +1,119 @@
+#ifndef DATABASEEXECUTOR_H
+#define DATABASEEXECUTOR_H
+
+#include <QFuture>
+#include <QFutureWatcher>
+#include <QHash>
+#include <QObject>
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QString>
+#include <QThreadPool>
+#include <QtConcurrent>
+
+#include "tracer.h"
+
+/**
+ * @brief Runs database work on one dedicated thread with its own SQLite connection
+ *
+ * Requests are queued and run one at a time, in submission order, so two
+ * requests never race each other and a later read always sees an earlier
+ * write made through the executor. The worker thread keeps one connection
+ * per database file (WAL, same pragmas as the GUI connection) and its own
+ * prepared-statement cache.
+ *
+ * While a task submitted with run() is executing, DatabaseManager's
+ * getDatabase(), preparedQuery() and query helpers resolve to the worker's
+ * connection instead of the GUI thread's. The existing manager methods can
+ * therefore be called unchanged inside a task; this is how the managers'
+ * *Async() variants are built. Manager state that the GUI thread also
+ * touches (job indexes, cached models) must not be modified from a task.
+ */
+class DatabaseExecutor
+{
+public:
+    static DatabaseExecutor& instance();
+
+    /**
+     * @brief Queue a task for the database thread
+     * @param name Trace span name (string literal)
+     * @param task Callable run on the worker thread; its return value is the future's result
+     * @return Future for the task's result
+     */
+    template<typename Task>
+    auto run(const char* name, Task task) -> QFuture<decltype(task())>
+    {
+        const QString databasePath = mainDatabasePath();
+        return QtConcurrent::run(&m_pool, [name, databasePath, task]() mutable {
+            TRACE_SCOPE("db", name);
+            TaskScope scope(databasePath);
+            return task();
+        });
+    }
+
+    /**
+     * @brief Deliver a future's result to context's thread (normally the GUI thread)
+     *
+     * The callback is dropped if context is destroyed first. Use for futures
+     * with a non-void result.
+     */
+    template<typename T, typename Callback>
+    static void then(QObject* context, const QFuture<T>& future, Callback callback)
+    {
+        auto* watcher = new QFutureWatcher<T>(context);
+        QObject::connect(watcher, &QFutureWatcher<T>::finished, context, [watcher, callback]() {
+            callback(watcher->result());
+            watcher->deleteLater();
+        });
+        watcher->setFuture(future);
+    }
+
+    /**
+     * @brief The worker thread's connection to a database file
+     *
+     * Only valid on the worker thread (inside a task); opened on first use.
+     */
+    static QSqlDatabase connection(const QString& databasePath);
+
+    /**
+     * @brief Connection of the task running on the calling thread, or nullptr elsewhere
+     */
+    static QSqlDatabase* currentConnection();
+
+    /**
+     * @brief Prepared-statement cache of the current task's connection, or nullptr elsewhere
+     */
+    static QHash<QString, QSqlQuery*>* currentStatementCache();
+
+    /**
+     * @brief Finish queued tasks and stop the worker thread (its connections are closed)
+     *
+     * Called on application exit; a later run() starts a new thread.
+     */
+    void shutdown();
+
+private:
+    DatabaseExecutor();
+    ~DatabaseExecutor() = default;
+
+    DatabaseExecutor(const DatabaseExecutor&) = delete;
+    DatabaseExecutor& operator=(const DatabaseExecutor&) = delete;
+
+    // Binds the thread's connection for DatabaseManager while a task runs
+    class TaskScope
+    {
+    public:
+        explicit TaskScope(const QString& databasePath);
+        ~TaskScope();
+
+    private:
+        TaskScope(const TaskScope&) = delete;
+        TaskScope& operator=(const TaskScope&) = delete;
+    };
+
+    static QString mainDatabasePath();
+
+    QThreadPool m_pool;
+};
+
+#endif // DATABASEEXECUTOR_H
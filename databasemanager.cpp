@@ -1,14 +1,29 @@
 #include "databasemanager.h"
+#include "databaseexecutor.h"
+#include "querystats.h"
+#include "terminallogqueue.h"
+#include "tracer.h"
 #include <QDebug>
 #include <QSqlError>
 #include <QSqlRecord>  // Added this include for QSqlRecord
 #include <QDir>
 #include <QFileInfo>
 #include <QDateTime>
+#include <QElapsedTimer>
+#include <algorithm>
 
 // Initialize static member
 DatabaseManager* DatabaseManager::m_instance = nullptr;
 
+namespace {
+// Negative cache_size is in KiB: 16 MB page cache
+const int kCacheSizeKiB = 16 * 1024;
+// Map up to 256 MB of the database file instead of read() calls
+const qint64 kMmapSizeBytes = 256LL * 1024 * 1024;
+// Wait for a competing writer instead of failing immediately
+const int kBusyTimeoutMs = 5000;
+}
+
 DatabaseManager* DatabaseManager::instance()
 {
     if (!m_instance) {
@@ -19,11 +34,14 @@ DatabaseManager* DatabaseManager::instance()
 
 DatabaseManager::DatabaseManager()
     : m_initialized(false)
+    , m_schemaVersionsLoaded(false)
 {
 }
 
 DatabaseManager::~DatabaseManager()
 {
+    shutdownTerminalLogQueue();
+    clearStatementCache();
     if (m_db.isOpen()) {
         m_db.close();
     }
@@ -31,6 +49,7 @@ DatabaseManager::~DatabaseManager()
 
 bool DatabaseManager::initialize(const QString& dbPath)
 {
+    TRACE_FUNCTION("db");
     // Create the database directory if it doesn't exist
     QFileInfo fileInfo(dbPath);
     QDir dir = fileInfo.dir();
@@ -45,6 +64,11 @@ bool DatabaseManager::initialize(const QString& dbPath)
     // Try to open the database
     qDebug() << "Setting up database connection to:" << dbPath;
 
+    // Cached statements, schema versions and the log writer belong to the old connection
+    shutdownTerminalLogQueue();
+    clearStatementCache();
+    m_schemaVersionsLoaded = false;
+
     // Check if the connection name already exists
     QString connectionName = "main_connection";
     if (QSqlDatabase::contains(connectionName)) {
@@ -81,14 +105,20 @@ bool DatabaseManager::initialize(const QString& dbPath)
 
     qDebug() << "Database connection opened successfully";
 
+    configureConnection();
+
     // Create core tables
-    if (!createCoreTables()) {
+    if (!applyMigrations("core", {
+            {1, "terminal_logs table", [this]() { return createCoreTables(); }},
+            {2, "slow_queries table", [this]() { return createSlowQueryTable(); }}
+        })) {
         qDebug() << "Failed to create core database tables";
         m_db.close();
         return false;
     }
 
     m_initialized = true;
+    startTerminalLogQueue();
     qDebug() << "Database initialized successfully";
     return true;
 }
@@ -110,6 +140,10 @@ bool DatabaseManager::initializeAlt(const QString& dbPath)
         qDebug() << "Created directory:" << dir.path();
     }
 
+    shutdownTerminalLogQueue();
+    clearStatementCache();
+    m_schemaVersionsLoaded = false;
+
     // Remove connection if it exists
     if (QSqlDatabase::contains("qt_sql_default_connection")) {
         QSqlDatabase::removeDatabase("qt_sql_default_connection");
@@ -128,6 +162,8 @@ bool DatabaseManager::initializeAlt(const QString& dbPath)
 
     qDebug() << "Database opened successfully";
 
+    configureConnection();
+
     // Create a simplified version of the core tables
     QSqlQuery query;
     QString createTableSQL =
@@ -165,15 +201,56 @@ bool DatabaseManager::initializeAlt(const QString& dbPath)
     }
 
     m_initialized = true;
+    startTerminalLogQueue();
     qDebug() << "Database initialized successfully using alternative approach";
     return true;
 }
 
 bool DatabaseManager::isInitialized() const
 {
+    if (const QSqlDatabase* worker = DatabaseExecutor::currentConnection()) {
+        return m_initialized && worker->isOpen();
+    }
     return m_initialized && m_db.isOpen();
 }
 
+QSqlDatabase& DatabaseManager::getDatabase()
+{
+    // Inside a DatabaseExecutor task the worker thread's own connection is used
+    if (QSqlDatabase* worker = DatabaseExecutor::currentConnection()) {
+        return *worker;
+    }
+    return m_db;
+}
+
+void DatabaseManager::configureConnection()
+{
+    QSqlQuery pragma(m_db);
+
+    // WAL lets readers proceed during writes and turns most commits into a
+    // sequential append; NORMAL sync is durable across app crashes in WAL mode
+    if (pragma.exec("PRAGMA journal_mode=WAL") && pragma.next()) {
+        qDebug() << "SQLite journal mode:" << pragma.value(0).toString();
+    } else {
+        qDebug() << "Failed to enable WAL journal mode:" << pragma.lastError().text();
+    }
+
+    const QStringList pragmas = {
+        "PRAGMA synchronous=NORMAL",
+        "PRAGMA temp_store=MEMORY",
+        QString("PRAGMA cache_size=-%1").arg(kCacheSizeKiB),
+        QString("PRAGMA mmap_size=%1").arg(kMmapSizeBytes),
+        QString("PRAGMA busy_timeout=%1").arg(kBusyTimeoutMs)
+    };
+
+    for (const QString& statement : pragmas) {
+        if (!pragma.exec(statement)) {
+            qDebug() << "Failed to apply" << statement << ":" << pragma.lastError().text();
+        }
+    }
+    pragma.finish();
+}
+
 bool DatabaseManager::createCoreTables()
 {
     QSqlQuery query(m_db);
@@ -216,6 +293,60 @@ bool DatabaseManager::createCoreTables()
     return true;
 }
 
+bool DatabaseManager::createSlowQueryTable()
+{
+    QSqlQuery query(m_db);
+    if (!query.exec("CREATE TABLE IF NOT EXISTS slow_queries ("
+                    "id INTEGER PRIMARY KEY AUTOINCREMENT, "
+                    "recorded_at TEXT NOT NULL, "
+                    "statement_template TEXT NOT NULL, "
+                    "sql TEXT NOT NULL, "
+                    "connection TEXT, "
+                    "duration_ms REAL NOT NULL, "
+                    "row_count INTEGER, "
+                    "query_plan TEXT)")) {
+        qDebug() << "Failed to create slow_queries table:" << query.lastError().text();
+        return false;
+    }
+    return true;
+}
+
+int DatabaseManager::flushSlowQueryLog()
+{
+    if (!isInitialized()) {
+        return 0;
+    }
+
+    const QVector<QueryStats::SlowQuery> entries = QueryStats::instance().takeUnsavedSlowQueries();
+    if (entries.isEmpty()) {
+        return 0;
+    }
+
+    // Plain QSqlQuery: the log's own inserts are not part of the statistics
+    QSqlQuery insert(m_db);
+    insert.prepare("INSERT INTO slow_queries "
+                   "(recorded_at, statement_template, sql, connection, duration_ms, row_count, query_plan) "
+                   "VALUES (?, ?, ?, ?, ?, ?, ?)");
+    m_db.transaction();
+    int written = 0;
+    for (const QueryStats::SlowQuery& entry : entries) {
+        insert.addBindValue(entry.recordedAt);
+        insert.addBindValue(entry.statementTemplate);
+        insert.addBindValue(entry.sql);
+        insert.addBindValue(entry.connection);
+        insert.addBindValue(entry.durationMs);
+        insert.addBindValue(entry.rows < 0 ? QVariant() : QVariant(entry.rows));
+        insert.addBindValue(entry.plan);
+        if (insert.exec()) {
+            ++written;
+        } else {
+            qDebug() << "Failed to record slow query:" << insert.lastError().text();
+        }
+    }
+    m_db.commit();
+    return written;
+}
+
 bool DatabaseManager::createTable(const QString& tableName, const QString& tableDefinition)
 {
     if (!isInitialized()) {
@@ -229,13 +360,15 @@ bool DatabaseManager::createTable(const QString& tableName, const QString& table
 
 bool DatabaseManager::executeQuery(const QString& queryStr)
 {
+    TRACE_SCOPE_DETAIL("db", "DatabaseManager::executeQuery", queryStr);
     if (!isInitialized()) {
         qDebug() << "Database not initialized";
         return false;
     }
 
-    QSqlQuery query(m_db);
-    if (!query.exec(queryStr)) {
+    QSqlDatabase& db = getDatabase();
+    QSqlQuery query(db);
+    if (!QueryStats::exec(query, queryStr, db)) {
         qDebug() << "Query failed:" << query.lastError().text();
         qDebug() << "Query was:" << queryStr;
         return false;
@@ -246,12 +379,13 @@ bool DatabaseManager::executeQuery(const QString& queryStr)
 
 bool DatabaseManager::executeQuery(QSqlQuery& query)
 {
+    TRACE_SCOPE_DETAIL("db", "DatabaseManager::executeQuery", query.lastQuery());
     if (!isInitialized()) {
         qDebug() << "Database not initialized";
         return false;
     }
 
-    if (!query.exec()) {
+    if (!QueryStats::exec(query, getDatabase())) {
         qDebug() << "Query failed:" << query.lastError().text();
         qDebug() << "Query was:" << query.lastQuery();
         return false;
@@ -260,8 +394,44 @@ bool DatabaseManager::executeQuery(QSqlQuery& query)
     return true;
 }
 
+QSqlQuery* DatabaseManager::preparedQuery(const QString& key, const QString& sql)
+{
+    if (!isInitialized()) {
+        qDebug() << "Database not initialized";
+        return nullptr;
+    }
+
+    // Statements are per connection; a DatabaseExecutor task uses the worker's cache
+    QHash<QString, QSqlQuery*>* workerCache = DatabaseExecutor::currentStatementCache();
+    QHash<QString, QSqlQuery*>& cache = workerCache ? *workerCache : m_statementCache;
+
+    auto it = cache.constFind(key);
+    if (it != cache.constEnd()) {
+        // Release any result set left over from the previous use
+        it.value()->finish();
+        return it.value();
+    }
+
+    QSqlQuery* query = new QSqlQuery(getDatabase());
+    if (!query->prepare(sql)) {
+        qDebug() << "Failed to prepare statement" << key << ":" << query->lastError().text();
+        delete query;
+        return nullptr;
+    }
+
+    cache.insert(key, query);
+    return query;
+}
+
+void DatabaseManager::clearStatementCache()
+{
+    qDeleteAll(m_statementCache);
+    m_statementCache.clear();
+}
+
 QList<QMap<QString, QVariant>> DatabaseManager::executeSelectQuery(const QString& queryStr)
 {
+    TRACE_SCOPE_DETAIL("db", "DatabaseManager::executeSelectQuery", queryStr);
     QList<QMap<QString, QVariant>> result;
 
     if (!isInitialized()) {
@@ -269,8 +439,13 @@ QList<QMap<QString, QVariant>> DatabaseManager::executeSelectQuery(const QString
         return result;
     }
 
-    QSqlQuery query(m_db);
+    // Timed through the last row so the statistics include fetching
+    QElapsedTimer timer;
+    timer.start();
+    QSqlDatabase& db = getDatabase();
+    QSqlQuery query(db);
     if (!query.exec(queryStr)) {
+        QueryStats::instance().record(query, db, timer.nsecsElapsed() / 1000, -1, false);
         qDebug() << "Select query failed:" << query.lastError().text();
         qDebug() << "Query was:" << queryStr;
         return result;
@@ -286,10 +461,128 @@ QList<QMap<QString, QVariant>> DatabaseManager::executeSelectQuery(const QString
 
         result.append(row);
     }
+    QueryStats::instance().record(query, db, timer.nsecsElapsed() / 1000, result.size(), true);
 
     return result;
 }
 
+bool DatabaseManager::loadSchemaVersions()
+{
+    if (m_schemaVersionsLoaded) {
+        return true;
+    }
+
+    m_schemaVersions.clear();
+    m_schemaMigrationMs.clear();
+
+    QSqlQuery query(m_db);
+    if (query.exec("SELECT module, version, duration_ms FROM schema_migrations")) {
+        while (query.next()) {
+            const QString module = query.value(0).toString();
+            m_schemaVersions.insert(module, query.value(1).toInt());
+            m_schemaMigrationMs.insert(module, query.value(2).toLongLong());
+        }
+        m_schemaVersionsLoaded = true;
+        return true;
+    }
+
+    // First run against this database: nothing has been recorded yet
+    if (!query.exec("CREATE TABLE IF NOT EXISTS schema_migrations ("
+                    "module TEXT PRIMARY KEY, "
+                    "version INTEGER NOT NULL, "
+                    "duration_ms INTEGER NOT NULL DEFAULT 0, "
+                    "applied_at TEXT NOT NULL)")) {
+        qDebug() << "Failed to create schema_migrations table:" << query.lastError().text();
+        return false;
+    }
+    m_schemaVersionsLoaded = true;
+    return true;
+}
+
+int DatabaseManager::schemaVersion(const QString& module)
+{
+    if (!m_db.isOpen() || !loadSchemaVersions()) {
+        return 0;
+    }
+    return m_schemaVersions.value(module, 0);
+}
+
+bool DatabaseManager::applyMigrations(const QString& module, const QVector<SchemaMigration>& migrations)
+{
+    TRACE_SCOPE_DETAIL("db", "DatabaseManager::applyMigrations", module);
+    if (!m_db.isOpen()) {
+        qDebug() << "Database not open; cannot migrate" << module;
+        return false;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    if (!loadSchemaVersions()) {
+        return false;
+    }
+
+    const int currentVersion = m_schemaVersions.value(module, 0);
+    QVector<SchemaMigration> pending;
+    for (const SchemaMigration& migration : migrations) {
+        if (migration.version > currentVersion) {
+            pending.append(migration);
+        }
+    }
+
+    if (pending.isEmpty()) {
+        ++m_migrationStats.modulesCurrent;
+        m_migrationStats.skippedMs += m_schemaMigrationMs.value(module);
+        m_migrationStats.checkMs += timer.elapsed();
+        return true;
+    }
+
+    std::sort(pending.begin(), pending.end(), [](const SchemaMigration& a, const SchemaMigration& b) {
+        return a.version < b.version;
+    });
+
+    if (!m_db.transaction()) {
+        qDebug() << "Failed to begin schema migration for" << module << ":" << m_db.lastError().text();
+        m_migrationStats.checkMs += timer.elapsed();
+        return false;
+    }
+
+    for (const SchemaMigration& migration : pending) {
+        if (!migration.apply()) {
+            m_db.rollback();
+            qDebug() << "Schema migration failed for" << module << "version" << migration.version
+                     << "(" << migration.description << "); rolled back";
+            m_migrationStats.checkMs += timer.elapsed();
+            return false;
+        }
+    }
+
+    const int newVersion = pending.constLast().version;
+    const qint64 durationMs = m_schemaMigrationMs.value(module) + timer.elapsed();
+    QSqlQuery record(m_db);
+    record.prepare("INSERT OR REPLACE INTO schema_migrations (module, version, duration_ms, applied_at) "
+                   "VALUES (?, ?, ?, ?)");
+    record.addBindValue(module);
+    record.addBindValue(newVersion);
+    record.addBindValue(durationMs);
+    record.addBindValue(QDateTime::currentDateTimeUtc().toString(Qt::ISODate));
+    if (!record.exec() || !m_db.commit()) {
+        qDebug() << "Failed to record schema version for" << module << ":" << record.lastError().text()
+                 << m_db.lastError().text();
+        m_db.rollback();
+        m_migrationStats.checkMs += timer.elapsed();
+        return false;
+    }
+
+    m_schemaVersions.insert(module, newVersion);
+    m_schemaMigrationMs.insert(module, durationMs);
+    ++m_migrationStats.modulesMigrated;
+    m_migrationStats.migrationsApplied += pending.size();
+    m_migrationStats.checkMs += timer.elapsed();
+    qDebug() << "Schema for" << module << "migrated from version" << currentVersion << "to" << newVersion
+             << "in" << timer.elapsed() << "ms";
+    return true;
+}
+
 bool DatabaseManager::saveTerminalLog(const QString& tabName, const QString& year,
                                       const QString& month, const QString& week,
                                       const QString& message)
@@ -299,17 +592,28 @@ bool DatabaseManager::saveTerminalLog(const QString& tabName, const QString& yea
         return false;
     }
 
-    QSqlQuery query(m_db);
-    query.prepare("INSERT INTO terminal_logs (tab_name, year, month, week, timestamp, message) "
-                  "VALUES (:tab_name, :year, :month, :week, :timestamp, :message)");
-    query.bindValue(":tab_name", tabName);
-    query.bindValue(":year", year);
-    query.bindValue(":month", month);
-    query.bindValue(":week", week);
-    query.bindValue(":timestamp", QDateTime::currentDateTime().toString("yyyy-MM-dd hh:mm:ss"));
-    query.bindValue(":message", message);
+    const QString timestamp = QDateTime::currentDateTime().toString("yyyy-MM-dd hh:mm:ss");
 
-    return executeQuery(query);
+    if (m_terminalLogQueue && m_terminalLogQueue->enqueue({tabName, year, month, week, timestamp, message})) {
+        return true;
+    }
+
+    // Writer not running: fall back to a direct insert on the shared connection
+    QSqlQuery* query = preparedQuery("core.saveTerminalLog",
+                                     "INSERT INTO terminal_logs (tab_name, year, month, week, timestamp, message) "
+                                     "VALUES (:tab_name, :year, :month, :week, :timestamp, :message)");
+    if (!query) {
+        return false;
+    }
+
+    query->bindValue(":tab_name", tabName);
+    query->bindValue(":year", year);
+    query->bindValue(":month", month);
+    query->bindValue(":week", week);
+    query->bindValue(":timestamp", timestamp);
+    query->bindValue(":message", message);
+
+    return executeQuery(*query);
 }
 
 QStringList DatabaseManager::getTerminalLogs(const QString& tabName, const QString& year,
@@ -322,7 +626,10 @@ QStringList DatabaseManager::getTerminalLogs(const QString& tabName, const QStri
         return logs;
     }
 
-    QSqlQuery query(m_db);
+    // Make queued rows visible to this read
+    flushTerminalLogs();
+
+    QSqlQuery query(getDatabase());
     query.prepare("SELECT timestamp, message FROM terminal_logs "
                   "WHERE tab_name = :tab_name AND year = :year AND month = :month AND week = :week "
                   "ORDER BY timestamp");
@@ -344,6 +651,42 @@ QStringList DatabaseManager::getTerminalLogs(const QString& tabName, const QStri
     return logs;
 }
 
+void DatabaseManager::startTerminalLogQueue()
+{
+    m_terminalLogQueue.reset(new TerminalLogQueue(m_db.databaseName()));
+    if (!m_terminalLogQueue->start()) {
+        qDebug() << "Terminal log writer unavailable, terminal logs will be written directly";
+        m_terminalLogQueue.reset();
+    }
+}
+
+bool DatabaseManager::flushTerminalLogs()
+{
+    return m_terminalLogQueue ? m_terminalLogQueue->flush() : true;
+}
+
+void DatabaseManager::shutdownTerminalLogQueue()
+{
+    if (!m_terminalLogQueue) {
+        return;
+    }
+
+    m_terminalLogQueue->stop();
+    qDebug() << "Terminal log writer stopped:" << m_terminalLogQueue->committedRowCount() << "rows committed,"
+             << m_terminalLogQueue->failedRowCount() << "failed";
+    m_terminalLogQueue.reset();
+}
+
+int DatabaseManager::terminalLogQueueDepth() const
+{
+    return m_terminalLogQueue ? m_terminalLogQueue->queueDepth() : 0;
+}
+
+qint64 DatabaseManager::lastTerminalLogCommitMs() const
+{
+    return m_terminalLogQueue ? m_terminalLogQueue->lastCommitLatencyMs() : 0;
+}
+
 bool DatabaseManager::validateInput(const QString& value, bool allowEmpty)
 {
     if (value.isEmpty()) {
@@ -7,6 +7,32 @@
 #include <QMap>
 #include <QVariant>
 #include <QSqlQuery>
+#include <QHash>
+#include <QVector>
+#include <functional>
+#include <memory>
+
+class TerminalLogQueue;
+
+/**
+ * @brief One schema change of a module, applied once and recorded in schema_migrations
+ */
+struct SchemaMigration {
+    int version;                    // 1, 2, ... per module
+    QString description;
+    std::function<bool()> apply;    // runs inside the module's migration transaction
+};
+
+/**
+ * @brief Schema checks made by applyMigrations() during this run
+ */
+struct SchemaMigrationStats {
+    int modulesCurrent = 0;         // already at their latest version; no DDL was run
+    int modulesMigrated = 0;
+    int migrationsApplied = 0;
+    qint64 checkMs = 0;             // total time spent in applyMigrations()
+    qint64 skippedMs = 0;           // what the current modules' migrations took when they were applied
+};
 
 class DatabaseManager
 {
@@ -18,25 +44,84 @@ public:
     bool initialize(const QString& dbPath);
     bool initializeAlt(const QString& dbPath);  // Add this line here
     bool isInitialized() const;
-    QSqlDatabase& getDatabase() { return m_db; }
+
+    /**
+     * @brief Connection for the calling code: the shared GUI-thread connection,
+     * or the worker's own connection inside a DatabaseExecutor task
+     */
+    QSqlDatabase& getDatabase();
 
     // Create tables for new modules
     bool createTable(const QString& tableName, const QString& tableDefinition);
 
-    // Generic query execution
+    // Generic query execution, timed into QueryStats
     bool executeQuery(const QString& queryStr);
     bool executeQuery(QSqlQuery& query);
 
+    /**
+     * @brief Get a cached prepared statement for the shared connection
+     * @param key Stable identifier for the statement (e.g. "tmweeklypc.saveJobState")
+     * @param sql SQL text; only parsed the first time the key is seen
+     * @return The prepared query, or nullptr if preparation failed
+     *
+     * The returned query is owned by the cache and stays valid until the
+     * connection is re-initialized. Bind new values and exec() it; call
+     * finish() once a SELECT result has been read so the statement does not
+     * keep a read snapshot open.
+     */
+    QSqlQuery* preparedQuery(const QString& key, const QString& sql);
+    void clearStatementCache();
+
     // Generic data retrieval
     QList<QMap<QString, QVariant>> executeSelectQuery(const QString& queryStr);
 
-    // Terminal logs (shared functionality)
+    /**
+     * @brief Write slow queries captured by QueryStats since the last flush to slow_queries
+     * @return Number of rows written
+     *
+     * Called on exit and when query statistics are exported; slow queries are
+     * held in memory until then so logging never adds writes to a caller's
+     * transaction.
+     */
+    int flushSlowQueryLog();
+
+    /**
+     * @brief Apply a module's pending schema migrations in one transaction
+     * @param module Stable module key (e.g. "tm_healthy")
+     * @param migrations All of the module's migrations; those above its recorded version are run in order
+     * @return False if a migration failed; nothing is applied or recorded then
+     *
+     * Versions live in the schema_migrations table, read once per connection.
+     * A module that is already current runs no SQL at all.
+     */
+    bool applyMigrations(const QString& module, const QVector<SchemaMigration>& migrations);
+    int schemaVersion(const QString& module);
+    SchemaMigrationStats schemaMigrationStats() const { return m_migrationStats; }
+
+    // Terminal logs (shared functionality). Rows are queued and group-committed
+    // by a background writer; getTerminalLogs() flushes the queue first.
     bool saveTerminalLog(const QString& tabName, const QString& year,
                          const QString& month, const QString& week,
                          const QString& message);
     QStringList getTerminalLogs(const QString& tabName, const QString& year,
                                 const QString& month, const QString& week);
 
+    /**
+     * @brief Block until every queued terminal log row is committed
+     * @return False if a pending batch failed to write
+     */
+    bool flushTerminalLogs();
+
+    /**
+     * @brief Commit pending terminal log rows and stop the background writer
+     *
+     * Called on application exit; later saveTerminalLog() calls insert directly.
+     */
+    void shutdownTerminalLogQueue();
+
+    int terminalLogQueueDepth() const;
+    qint64 lastTerminalLogCommitMs() const;
+
     // Validation helper
     bool validateInput(const QString& value, bool allowEmpty = false);
 
@@ -52,8 +137,28 @@ private:
     // Singleton instance
     static DatabaseManager* m_instance;
 
+    // Background group-commit writer for terminal_logs
+    std::unique_ptr<TerminalLogQueue> m_terminalLogQueue;
+
+    // Prepared statements keyed by caller-supplied name
+    QHash<QString, QSqlQuery*> m_statementCache;
+
+    // Recorded schema versions and the time each module's migrations took
+    QHash<QString, int> m_schemaVersions;
+    QHash<QString, qint64> m_schemaMigrationMs;
+    bool m_schemaVersionsLoaded;
+    SchemaMigrationStats m_migrationStats;
+
+    bool loadSchemaVersions();
+
     // Core table creation
     bool createCoreTables();
+    bool createSlowQueryTable();
+
+    void startTerminalLogQueue();
+
+    // Connection tuning (WAL, synchronous, cache and mmap sizes)
+    void configureConnection();
 };
 
 #endif // DATABASEMANAGER_H
@@ -5,6 +5,8 @@
 #include <QMimeData>
 #include <QTableWidget>
 #include <QApplication>
+#include <QSet>
+#include <QVector>
 
 class ExcelClipboard
 {
@@ -39,7 +41,169 @@ public:
         clipboard->setMimeData(mimeData);
     }
 
+    /**
+     * @brief Copy a header row plus data rows as HTML, RTF and TSV in one step
+     * @param headers Column headers (bold, gray shading)
+     * @param rows Data rows
+     * @param emphasizeLastRow Render the last data row like the header (e.g. totals)
+     * @return True if the clipboard was populated
+     *
+     * Produces the same grid borders, header shading and right-aligned
+     * POSTAGE/COUNT/AVG RATE cells that the Word "Table Grid" copy used,
+     * without starting Word or writing any temporary file.
+     */
+    static bool copyFormattedRows(const QStringList& headers,
+                                  const QVector<QStringList>& rows,
+                                  bool emphasizeLastRow = false)
+    {
+        if (headers.isEmpty())
+            return false;
+
+        QClipboard* clipboard = QApplication::clipboard();
+        if (!clipboard)
+            return false;
+
+        const QByteArray rtf = createRowsRtf(headers, rows, emphasizeLastRow);
+
+        QMimeData* mimeData = new QMimeData();
+        mimeData->setHtml(createRowsHtml(headers, rows, emphasizeLastRow));
+        mimeData->setText(createRowsPlainText(headers, rows));
+        mimeData->setData("text/rtf", rtf);
+        mimeData->setData("application/x-qt-windows-mime;value=\"Rich Text Format\"", rtf);
+
+        clipboard->setMimeData(mimeData);
+        return true;
+    }
+
 private:
+    // Word table column indices that are right-aligned (POSTAGE, COUNT, AVG RATE)
+    static bool isRightAlignedColumn(int col)
+    {
+        return col == 2 || col == 3 || col == 4;
+    }
+
+    static QString createRowsHtml(const QStringList& headers,
+                                  const QVector<QStringList>& rows,
+                                  bool emphasizeLastRow)
+    {
+        const QString border = "border:1.0pt solid windowtext;";
+        const QString shaded = "background-color:#e0e0e0; font-weight:bold;";
+
+        QString html;
+        html.reserve(1024 + 128 * headers.size() * (rows.size() + 1));
+        html += "<html xmlns:o=\"urn:schemas-microsoft-com:office:office\" "
+                "xmlns:x=\"urn:schemas-microsoft-com:office:excel\" "
+                "xmlns=\"http://www.w3.org/TR/REC-html40\">\n";
+        html += "<head>\n<meta http-equiv=\"Content-Type\" content=\"text/html; charset=utf-8\">\n</head>\n<body>\n";
+        html += "<table border=1 cellspacing=0 cellpadding=0 style=\"border-collapse:collapse; " + border + "\">\n";
+
+        auto appendRow = [&](const QStringList& cells, bool emphasized, bool alignNumbers) {
+            html += "<tr>\n";
+            for (int col = 0; col < headers.size(); ++col) {
+                const QString text = col < cells.size() ? cells.at(col).toHtmlEscaped() : QString();
+                QString style = border + " padding:0pt 5.4pt;";
+                if (emphasized)
+                    style += " " + shaded;
+                if (alignNumbers && isRightAlignedColumn(col))
+                    style += " text-align:right;";
+                html += QString("<td style=\"%1\">%2</td>\n").arg(style, text);
+            }
+            html += "</tr>\n";
+        };
+
+        appendRow(headers, true, false);
+        for (int row = 0; row < rows.size(); ++row) {
+            appendRow(rows.at(row), emphasizeLastRow && row == rows.size() - 1, true);
+        }
+
+        html += "</table>\n</body>\n</html>";
+        return html;
+    }
+
+    static QByteArray rtfEscape(const QString& text)
+    {
+        QByteArray out;
+        out.reserve(text.size() + 8);
+        for (const QChar ch : text) {
+            const ushort code = ch.unicode();
+            if (code == '\\' || code == '{' || code == '}') {
+                out += '\\';
+                out += static_cast<char>(code);
+            } else if (code == '\n' || code == '\r') {
+                out += "\\line ";
+            } else if (code < 0x80) {
+                out += static_cast<char>(code);
+            } else {
+                // RTF \u takes a signed 16-bit value followed by a fallback character
+                out += "\\u" + QByteArray::number(static_cast<short>(code)) + "?";
+            }
+        }
+        return out;
+    }
+
+    static QByteArray createRowsRtf(const QStringList& headers,
+                                    const QVector<QStringList>& rows,
+                                    bool emphasizeLastRow)
+    {
+        // Size columns from their longest value (roughly 120 twips per character)
+        QVector<int> cellRight(headers.size());
+        int right = 0;
+        for (int col = 0; col < headers.size(); ++col) {
+            int chars = headers.at(col).size();
+            for (const QStringList& cells : rows) {
+                if (col < cells.size())
+                    chars = qMax(chars, static_cast<int>(cells.at(col).size()));
+            }
+            right += qBound(720, chars * 120 + 216, 4320);
+            cellRight[col] = right;
+        }
+
+        QByteArray rtf;
+        rtf.reserve(512 + 256 * headers.size() * (rows.size() + 1));
+        rtf += "{\\rtf1\\ansi\\ansicpg1252\\deff0"
+               "{\\fonttbl{\\f0\\fswiss Calibri;}}"
+               "{\\colortbl;\\red0\\green0\\blue0;\\red224\\green224\\blue224;}\n";
+
+        auto appendRow = [&](const QStringList& cells, bool emphasized, bool alignNumbers) {
+            rtf += "\\trowd\\trgaph108\\trleft0\n";
+            for (int col = 0; col < headers.size(); ++col) {
+                rtf += "\\clbrdrt\\brdrs\\brdrw10\\clbrdrl\\brdrs\\brdrw10"
+                       "\\clbrdrb\\brdrs\\brdrw10\\clbrdrr\\brdrs\\brdrw10";
+                if (emphasized)
+                    rtf += "\\clcbpat2";
+                rtf += "\\cellx" + QByteArray::number(cellRight.at(col)) + "\n";
+            }
+            for (int col = 0; col < headers.size(); ++col) {
+                rtf += "\\pard\\intbl\\f0\\fs22";
+                rtf += (alignNumbers && isRightAlignedColumn(col)) ? "\\qr" : "\\ql";
+                rtf += emphasized ? "\\b " : "\\b0 ";
+                if (col < cells.size())
+                    rtf += rtfEscape(cells.at(col));
+                rtf += "\\cell\n";
+            }
+            rtf += "\\row\n";
+        };
+
+        appendRow(headers, true, false);
+        for (int row = 0; row < rows.size(); ++row) {
+            appendRow(rows.at(row), emphasizeLastRow && row == rows.size() - 1, true);
+        }
+
+        rtf += "\\pard\\par}";
+        return rtf;
+    }
+
+    static QString createRowsPlainText(const QStringList& headers, const QVector<QStringList>& rows)
+    {
+        QString text = headers.join('\t');
+        text += '\n';
+        for (const QStringList& cells : rows) {
+            text += cells.join('\t');
+            text += '\n';
+        }
+        return text;
+    }
+
     static QString createExcelHtml(QTableWidget* table)
     {
         // Create Excel-specific HTML with Office namespaces for best compatibility
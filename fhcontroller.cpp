@@ -7,6 +7,7 @@
 #include "monthcomboboxhelper.h"
 #include "yearcomboboxhelper.h"
 #include "terminaloutputhelper.h"
+#include "excelclipboard.h"
 #include <QDesktopServices>
 #include <QUrl>
 #include <QDateTime>
@@ -2034,111 +2035,13 @@ bool FHController::createExcelAndCopyMultiRow(
     const QStringList& row2,
     const QStringList& totals
 ) {
-#ifdef Q_OS_WIN
-    QString tempDir = QStandardPaths::writableLocation(QStandardPaths::TempLocation);
-    QString tempFileName = QDir(tempDir).filePath("goji_temp_copy_multi.docx");
-    QString scriptPath = QDir(tempDir).filePath("goji_word_multi_script.ps1");
-
-    QFile::remove(tempFileName);
-    QFile::remove(scriptPath);
-
-    auto psEscape = [](QString s) {
-        s.replace(QString("'"), QString("''"));
-        s.replace(QString("\r"), QString(" "));
-        s.replace(QString("\n"), QString(" "));
-        s.replace(QChar(0x2028), QChar(' '));
-        s.replace(QChar(0x2029), QChar(' '));
-        return s;
-    };
-
-    QString script;
-    script += "try {\n";
-    script += "  $word = New-Object -ComObject Word.Application\n";
-    script += "  $word.Visible = $false\n";
-    script += "  $doc = $word.Documents.Add()\n";
-    script += "  $range = $doc.Range()\n";
-    script += QString("  $table = $doc.Tables.Add($range, 4, %1)\n").arg(headers.size());
-    script += "  $table.Style = 'Table Grid'\n";
-    script += "  $table.Borders.Enable = $true\n";
-
-    auto addRow = [&](int wordRow, const QStringList& values, bool bold, bool shade) {
-        const int count = qMin(headers.size(), values.size());
-        for (int i = 0; i < count; ++i) {
-            const QString value = psEscape(values[i]);
-            script += QString("  $table.Cell(%1,%2).Range.Text = '%3'\n").arg(wordRow).arg(i + 1).arg(value);
-            if (bold) {
-                script += QString("  $table.Cell(%1,%2).Range.Bold = $true\n").arg(wordRow).arg(i + 1);
-            }
-            if (shade) {
-                script += QString("  $table.Cell(%1,%2).Range.Shading.BackgroundPatternColor = 14737632\n").arg(wordRow).arg(i + 1);
-            }
-            if (i == 2 || i == 3 || i == 4) {
-                script += QString("  $table.Cell(%1,%2).Range.ParagraphFormat.Alignment = 2\n").arg(wordRow).arg(i + 1);
-            }
-        }
-    };
-
-    addRow(1, headers, true, true);
-    addRow(2, row1, false, false);
-    addRow(3, row2, false, false);
-    addRow(4, totals, true, true);
-
-    QString escapedPath = tempFileName;
-    escapedPath.replace(QString("/"), QString("\\"));
-    escapedPath = psEscape(escapedPath);
-    script += QString("  $doc.SaveAs('%1')\n").arg(escapedPath);
-    script += "  $table.Range.Select()\n";
-    script += "  $word.Selection.Copy()\n";
-    script += "  Start-Sleep -Seconds 2\n";
-    script += "  $doc.Close($false)\n";
-    script += "  $word.Quit()\n";
-    script += "  [System.Runtime.Interopservices.Marshal]::ReleaseComObject($table) | Out-Null\n";
-    script += "  [System.Runtime.Interopservices.Marshal]::ReleaseComObject($range) | Out-Null\n";
-    script += "  [System.Runtime.Interopservices.Marshal]::ReleaseComObject($doc) | Out-Null\n";
-    script += "  [System.Runtime.Interopservices.Marshal]::ReleaseComObject($word) | Out-Null\n";
-    script += "  [System.GC]::Collect()\n";
-    script += "  [System.GC]::WaitForPendingFinalizers()\n";
-    script += "  Write-Output 'SUCCESS'\n";
-    script += "} catch {\n";
-    script += "  Write-Output \"ERROR: $_\"\n";
-    script += "}\n";
-
-    QFile scriptFile(scriptPath);
-    if (!scriptFile.open(QIODevice::WriteOnly | QIODevice::Text)) {
-        outputToTerminal("Failed to create PowerShell script file", Error);
-        return false;
-    }
-
-    QTextStream out(&scriptFile);
-    out << script;
-    scriptFile.close();
-
-    QProcess process;
-    QStringList arguments;
-    arguments << "-ExecutionPolicy" << "Bypass" << "-NoProfile" << "-File" << scriptPath;
-    process.start("powershell.exe", arguments);
-    process.waitForFinished(20000);
-
-    const QString output = process.readAllStandardOutput();
-    const QString errorOutput = process.readAllStandardError();
-
-    QFile::remove(scriptPath);
-    QFile::remove(tempFileName);
-
-    const bool success = output.contains("SUCCESS") && process.exitCode() == 0;
+    // Totals row is rendered bold and shaded like the header
+    const bool success = ExcelClipboard::copyFormattedRows(
+        headers, QVector<QStringList>{ row1, row2, totals }, /*emphasizeLastRow=*/true);
     if (!success) {
-        const QString detail = errorOutput.isEmpty() ? output : errorOutput;
-        outputToTerminal(QString("Word multi-row copy failed: %1").arg(detail), Error);
+        outputToTerminal("Clipboard is not available", Error);
     }
     return success;
-#else
-    Q_UNUSED(headers)
-    Q_UNUSED(row1)
-    Q_UNUSED(row2)
-    Q_UNUSED(totals)
-    outputToTerminal("Word copy functionality only available on Windows", Warning);
-    return false;
-#endif
 }
 
 bool FHController::validateJobNumber(const QString& jobNumber) const {
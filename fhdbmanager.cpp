@@ -1,5 +1,6 @@
 #include "fhdbmanager.h"
 #include "logger.h"
+#include "tracer.h"
 #include <QSqlQuery>
 #include <QSqlError>
 #include <QSqlRecord>
@@ -67,13 +68,19 @@ FHDBManager* FHDBManager::instance()
 
 bool FHDBManager::initializeTables()
 {
+    TRACE_FUNCTION("db");
     if (!m_dbManager || !m_dbManager->isInitialized()) {
         Logger::instance().error("Database manager not initialized for FOUR HANDS");
         return false;
     }
 
-    bool success = createTables();
+    bool success = m_dbManager->applyMigrations("fh", {
+        {1, "Job and log tables, job key UNIQUE(job_number, drop_number, year, month, version)", [this]() { return createTables(); }}
+    });
     if (success) {
+        // Anything loaded before the database was ready is stale
+        m_jobIndex.invalidate();
+
         // Create tracker model
         m_trackerModel = new QSqlTableModel(this, m_dbManager->getDatabase());
         m_trackerModel->setTable("fh_log");
@@ -173,11 +180,17 @@ bool FHDBManager::createTables()
     if (!hasVersionColumn || !hasDesiredUnique) {
         Logger::instance().info("Migrating fh_jobs to UNIQUE(job_number, drop_number, year, month, version)");
         QSqlDatabase db = m_dbManager->getDatabase();
-        if (!db.transaction()) {
-            Logger::instance().error("Failed to start transaction for fh_jobs migration");
+        // Savepoint rather than a transaction: this runs inside the schema migration transaction
+        QSqlQuery mq(db);
+        if (!mq.exec("SAVEPOINT fh_jobs_rebuild")) {
+            Logger::instance().error("Failed to start savepoint for fh_jobs migration: " + mq.lastError().text());
             return false;
         }
-        QSqlQuery mq(db);
+        auto rollbackRebuild = [&db]() {
+            QSqlQuery rq(db);
+            rq.exec("ROLLBACK TO fh_jobs_rebuild");
+            rq.exec("RELEASE fh_jobs_rebuild");
+        };
         const char* createNew =
             "CREATE TABLE fh_jobs_new ("
             "id INTEGER PRIMARY KEY AUTOINCREMENT, "
@@ -197,7 +210,7 @@ bool FHDBManager::createTables()
             "UNIQUE(job_number, drop_number, year, month, version))";
         if (!mq.exec(createNew)) {
             Logger::instance().error("Migration: failed to create fh_jobs_new: " + mq.lastError().text());
-            db.rollback();
+            rollbackRebuild();
             return false;
         }
         const QString versionExpr = hasVersionColumn
@@ -213,22 +226,22 @@ bool FHDBManager::createTables()
             "last_executed_script,%1 AS version,created_at,updated_at FROM fh_jobs";
         if (!mq.exec(QString(copySql).arg(versionExpr))) {
             Logger::instance().error("Migration: copy failed: " + mq.lastError().text());
-            db.rollback();
+            rollbackRebuild();
             return false;
         }
         if (!mq.exec("DROP TABLE fh_jobs")) {
             Logger::instance().error("Migration: drop failed: " + mq.lastError().text());
-            db.rollback();
+            rollbackRebuild();
             return false;
         }
         if (!mq.exec("ALTER TABLE fh_jobs_new RENAME TO fh_jobs")) {
             Logger::instance().error("Migration: rename failed: " + mq.lastError().text());
-            db.rollback();
+            rollbackRebuild();
             return false;
         }
-        if (!db.commit()) {
-            Logger::instance().error("Migration: commit failed");
-            db.rollback();
+        if (!mq.exec("RELEASE fh_jobs_rebuild")) {
+            Logger::instance().error("Migration: release failed: " + mq.lastError().text());
+            rollbackRebuild();
             return false;
         }
         Logger::instance().info("fh_jobs migration completed successfully");
@@ -323,6 +336,8 @@ bool FHDBManager::saveJob(const QString& jobNumber, const QString& dropNumber, c
 
     Logger::instance().info(QString("FOUR HANDS job saved: %1 drop %2 version %3 for %4/%5")
                                 .arg(normalizedJobNumber, normalizedDropNumber, normalizedVersion, year, month));
+    m_jobIndex.upsert({{"job_number", normalizedJobNumber}, {"year", year}, {"month", month},
+                       {"drop_number", normalizedDropNumber}, {"version", normalizedVersion}});
     return true;
 }
 
@@ -390,6 +405,7 @@ bool FHDBManager::deleteJob(int year, int month)
     bool success = m_dbManager->executeQuery(query);
     if (success) {
         Logger::instance().info(QString("FOUR HANDS job deleted for %1/%2").arg(QString::number(year), QString("%1").arg(month, 2, 10, QChar('0'))));
+        m_jobIndex.remove({{"year", QString::number(year)}, {"month", QString::number(month)}});
     } else {
         Logger::instance().error(QString("Failed to delete FOUR HANDS job for %1/%2").arg(QString::number(year), QString("%1").arg(month, 2, 10, QChar('0'))));
     }
@@ -509,64 +525,82 @@ bool FHDBManager::addLogEntry(const QString& jobNumber, const QString& descripti
     // DESCRIPTION uniquely identifies the "job instance" (e.g., "FOUR HANDS D2").
     // When a job is edited and re-locked, we must UPDATE the existing entry instead of inserting a new row.
     // Therefore we match existing rows by (job_number, description) and update the most recent one.
-    QSqlQuery query(m_dbManager->getDatabase());
+    QSqlQuery* lookup = m_dbManager->preparedQuery("fh.findLogEntry",
+                                                   "SELECT id FROM fh_log "
+                                                   "WHERE job_number = :job_number AND description = :description "
+                                                   "ORDER BY id DESC LIMIT 1");
+    if (!lookup) {
+        Logger::instance().error("Failed to prepare FOUR HANDS log lookup");
+        return false;
+    }
 
-    query.prepare("SELECT id FROM fh_log "
-                  "WHERE job_number = :job_number AND description = :description "
-                  "ORDER BY id DESC LIMIT 1");
-    query.bindValue(":job_number", jobNumber);
-    query.bindValue(":description", description);
+    lookup->bindValue(":job_number", jobNumber);
+    lookup->bindValue(":description", description);
 
-    if (!query.exec()) {
-        Logger::instance().error("Failed to check existing FOUR HANDS log entry: " + query.lastError().text());
+    if (!m_dbManager->executeQuery(*lookup)) {
+        Logger::instance().error("Failed to check existing FOUR HANDS log entry: " + lookup->lastError().text());
         return false;
     }
 
+    const bool exists = lookup->next();
+    const int id = exists ? lookup->value(0).toInt() : -1;
+    lookup->finish();
+
     bool success = false;
-    if (query.next()) {
-        int id = query.value(0).toInt();
-        query.prepare("UPDATE fh_log SET "
-                      "description = :description, postage = :postage, "
-                      "count = :count, per_piece = :per_piece, class = :class, "
-                      "shape = :shape, permit = :permit, date = :date "
-                      "WHERE id = :id");
-
-        query.bindValue(":id", id);
-        query.bindValue(":description", description);
-        query.bindValue(":postage", postage);
-        query.bindValue(":count", count);
-        query.bindValue(":per_piece", perPiece);
-        query.bindValue(":class", mailClass);
-        query.bindValue(":shape", shape);
-        query.bindValue(":permit", permit);
-        query.bindValue(":date", date);
-
-        success = query.exec();
+    QSqlQuery* query = nullptr;
+    if (exists) {
+        query = m_dbManager->preparedQuery("fh.updateLogEntry",
+                                           "UPDATE fh_log SET "
+                                           "description = :description, postage = :postage, "
+                                           "count = :count, per_piece = :per_piece, class = :class, "
+                                           "shape = :shape, permit = :permit, date = :date "
+                                           "WHERE id = :id");
+        if (!query) {
+            Logger::instance().error(QString("Failed to prepare FOUR HANDS log update: Job %1").arg(jobNumber));
+            return false;
+        }
+
+        query->bindValue(":id", id);
+        query->bindValue(":description", description);
+        query->bindValue(":postage", postage);
+        query->bindValue(":count", count);
+        query->bindValue(":per_piece", perPiece);
+        query->bindValue(":class", mailClass);
+        query->bindValue(":shape", shape);
+        query->bindValue(":permit", permit);
+        query->bindValue(":date", date);
+
+        success = m_dbManager->executeQuery(*query);
         if (!success) {
-            Logger::instance().error(QString("Failed to update FOUR HANDS log entry: Job %1 - %2").arg(jobNumber, query.lastError().text()));
+            Logger::instance().error(QString("Failed to update FOUR HANDS log entry: Job %1 - %2").arg(jobNumber, query->lastError().text()));
         }
 
         return success;
     }
 
     // No entry exists, insert new one
-    query.prepare("INSERT INTO fh_log "
-                  "(job_number, description, postage, count, per_piece, class, shape, permit, date) "
-                  "VALUES (:job_number, :description, :postage, :count, :per_piece, :class, :shape, :permit, :date)");
-
-    query.bindValue(":job_number", jobNumber);
-    query.bindValue(":description", description);
-    query.bindValue(":postage", postage);
-    query.bindValue(":count", count);
-    query.bindValue(":per_piece", perPiece);
-    query.bindValue(":class", mailClass);
-    query.bindValue(":shape", shape);
-    query.bindValue(":permit", permit);
-    query.bindValue(":date", date);
-
-    success = query.exec();
+    query = m_dbManager->preparedQuery("fh.insertLogEntry",
+                                       "INSERT INTO fh_log "
+                                       "(job_number, description, postage, count, per_piece, class, shape, permit, date) "
+                                       "VALUES (:job_number, :description, :postage, :count, :per_piece, :class, :shape, :permit, :date)");
+    if (!query) {
+        Logger::instance().error(QString("Failed to prepare FOUR HANDS log insert: Job %1").arg(jobNumber));
+        return false;
+    }
+
+    query->bindValue(":job_number", jobNumber);
+    query->bindValue(":description", description);
+    query->bindValue(":postage", postage);
+    query->bindValue(":count", count);
+    query->bindValue(":per_piece", perPiece);
+    query->bindValue(":class", mailClass);
+    query->bindValue(":shape", shape);
+    query->bindValue(":permit", permit);
+    query->bindValue(":date", date);
+
+    success = m_dbManager->executeQuery(*query);
     if (!success) {
-        Logger::instance().error(QString("Failed to insert FOUR HANDS log entry: Job %1 - %2").arg(jobNumber, query.lastError().text()));
+        Logger::instance().error(QString("Failed to insert FOUR HANDS log entry: Job %1 - %2").arg(jobNumber, query->lastError().text()));
         return false;
     }
 
@@ -731,68 +765,78 @@ bool FHDBManager::saveJobState(const QString& jobNumber, const QString& dropNumb
     }
 
     // Canonicalize legacy rows (lowercase/spaced/R/H) so UPSERT identity stays consistent.
-    QSqlQuery normalizeQuery(m_dbManager->getDatabase());
-    normalizeQuery.prepare(QStringLiteral(
-                               "UPDATE fh_jobs SET version = :version "
-                               "WHERE job_number = :job_number AND drop_number = :drop_number "
-                               "AND year = :year AND month = :month "
-                               "AND %1 = :version "
-                               "AND COALESCE(version,'') != :version")
-                               .arg(fhVersionSqlExpr()));
-    normalizeQuery.bindValue(":version", normalizedVersion);
-    normalizeQuery.bindValue(":job_number", normalizedJobNumber);
-    normalizeQuery.bindValue(":drop_number", normalizedDropNumber);
-    normalizeQuery.bindValue(":year", year);
-    normalizeQuery.bindValue(":month", month);
-    if (!m_dbManager->executeQuery(normalizeQuery)) {
+    QSqlQuery* normalizeQuery = m_dbManager->preparedQuery("fh.normalizeJobVersion",
+                                                           QStringLiteral(
+                                                               "UPDATE fh_jobs SET version = :version "
+                                                               "WHERE job_number = :job_number AND drop_number = :drop_number "
+                                                               "AND year = :year AND month = :month "
+                                                               "AND %1 = :version "
+                                                               "AND COALESCE(version,'') != :version")
+                                                               .arg(fhVersionSqlExpr()));
+    if (!normalizeQuery) {
+        Logger::instance().error("Failed to prepare FOUR HANDS version normalization");
+        return false;
+    }
+    normalizeQuery->bindValue(":version", normalizedVersion);
+    normalizeQuery->bindValue(":job_number", normalizedJobNumber);
+    normalizeQuery->bindValue(":drop_number", normalizedDropNumber);
+    normalizeQuery->bindValue(":year", year);
+    normalizeQuery->bindValue(":month", month);
+    if (!m_dbManager->executeQuery(*normalizeQuery)) {
         Logger::instance().error(QString("Failed to normalize legacy FOUR HANDS version before state save: %1")
-                                     .arg(normalizeQuery.lastError().text()));
+                                     .arg(normalizeQuery->lastError().text()));
         return false;
     }
 
     const QString currentTime = QDateTime::currentDateTime().toString("yyyy-MM-dd hh:mm:ss");
 
-    QSqlQuery query(m_dbManager->getDatabase());
-    query.prepare("INSERT INTO fh_jobs ("
-                  "job_number, drop_number, year, month, "
-                  "html_display_state, job_data_locked, postage_data_locked, "
-                  "postage, count, last_executed_script, version, created_at, updated_at"
-                  ") VALUES ("
-                  ":job_number, :drop_number, :year, :month, "
-                  ":html_display_state, :job_data_locked, :postage_data_locked, "
-                  ":postage, :count, :last_executed_script, :version, :created_at, :updated_at"
-                  ") "
-                  "ON CONFLICT(job_number, drop_number, year, month, version) DO UPDATE SET "
-                  "html_display_state = excluded.html_display_state, "
-                  "job_data_locked = excluded.job_data_locked, "
-                  "postage_data_locked = excluded.postage_data_locked, "
-                  "postage = excluded.postage, "
-                  "count = excluded.count, "
-                  "last_executed_script = excluded.last_executed_script, "
-                  "updated_at = excluded.updated_at");
-
-    query.bindValue(":job_number", normalizedJobNumber);
-    query.bindValue(":drop_number", normalizedDropNumber);
-    query.bindValue(":year", year);
-    query.bindValue(":month", month);
-    query.bindValue(":html_display_state", htmlDisplayState);
-    query.bindValue(":job_data_locked", jobDataLocked ? 1 : 0);
-    query.bindValue(":postage_data_locked", postageDataLocked ? 1 : 0);
-    query.bindValue(":postage", postage);
-    query.bindValue(":count", count);
-    query.bindValue(":last_executed_script", lastExecutedScript);
-    query.bindValue(":version", normalizedVersion);
-    query.bindValue(":created_at", currentTime);
-    query.bindValue(":updated_at", currentTime);
-
-    if (!m_dbManager->executeQuery(query)) {
+    QSqlQuery* query = m_dbManager->preparedQuery("fh.saveJobState",
+                                                  "INSERT INTO fh_jobs ("
+                                                  "job_number, drop_number, year, month, "
+                                                  "html_display_state, job_data_locked, postage_data_locked, "
+                                                  "postage, count, last_executed_script, version, created_at, updated_at"
+                                                  ") VALUES ("
+                                                  ":job_number, :drop_number, :year, :month, "
+                                                  ":html_display_state, :job_data_locked, :postage_data_locked, "
+                                                  ":postage, :count, :last_executed_script, :version, :created_at, :updated_at"
+                                                  ") "
+                                                  "ON CONFLICT(job_number, drop_number, year, month, version) DO UPDATE SET "
+                                                  "html_display_state = excluded.html_display_state, "
+                                                  "job_data_locked = excluded.job_data_locked, "
+                                                  "postage_data_locked = excluded.postage_data_locked, "
+                                                  "postage = excluded.postage, "
+                                                  "count = excluded.count, "
+                                                  "last_executed_script = excluded.last_executed_script, "
+                                                  "updated_at = excluded.updated_at");
+    if (!query) {
+        Logger::instance().error("Failed to prepare FOUR HANDS job state UPSERT");
+        return false;
+    }
+
+    query->bindValue(":job_number", normalizedJobNumber);
+    query->bindValue(":drop_number", normalizedDropNumber);
+    query->bindValue(":year", year);
+    query->bindValue(":month", month);
+    query->bindValue(":html_display_state", htmlDisplayState);
+    query->bindValue(":job_data_locked", jobDataLocked ? 1 : 0);
+    query->bindValue(":postage_data_locked", postageDataLocked ? 1 : 0);
+    query->bindValue(":postage", postage);
+    query->bindValue(":count", count);
+    query->bindValue(":last_executed_script", lastExecutedScript);
+    query->bindValue(":version", normalizedVersion);
+    query->bindValue(":created_at", currentTime);
+    query->bindValue(":updated_at", currentTime);
+
+    if (!m_dbManager->executeQuery(*query)) {
         Logger::instance().error(QString("Failed to UPSERT FOUR HANDS job state for %1 drop %2 version %3 %4/%5: %6")
-                                     .arg(normalizedJobNumber, normalizedDropNumber, normalizedVersion, year, month, query.lastError().text()));
+                                     .arg(normalizedJobNumber, normalizedDropNumber, normalizedVersion, year, month, query->lastError().text()));
         return false;
     }
 
     Logger::instance().info(QString("FOUR HANDS job state saved for %1 drop %2 version %3 %4/%5: postage=%6, count=%7, locked=%8")
                                 .arg(normalizedJobNumber, normalizedDropNumber, normalizedVersion, year, month, postage, count, postageDataLocked ? "true" : "false"));
+    m_jobIndex.upsert({{"job_number", normalizedJobNumber}, {"year", year}, {"month", month},
+                       {"drop_number", normalizedDropNumber}, {"version", normalizedVersion}});
     return true;
 }
 
@@ -821,29 +865,34 @@ bool FHDBManager::loadJobState(const QString& jobNumber, const QString& dropNumb
         return false;
     }
 
-    QSqlQuery query(m_dbManager->getDatabase());
-    query.prepare(QStringLiteral(
-                      "SELECT html_display_state, job_data_locked, postage_data_locked, "
-                      "postage, count, last_executed_script, version "
-                      "FROM fh_jobs "
-                      "WHERE job_number = :job_number AND drop_number = :drop_number "
-                      "AND year = :year AND month = :month "
-                      "AND %1 = :version "
-                      "LIMIT 1")
-                      .arg(fhVersionSqlExpr()));
-    query.bindValue(":job_number", normalizedJobNumber);
-    query.bindValue(":drop_number", normalizedDropNumber);
-    query.bindValue(":year", year);
-    query.bindValue(":month", month);
-    query.bindValue(":version", normalizedVersion);
+    QSqlQuery* query = m_dbManager->preparedQuery("fh.loadJobState",
+                                                  QStringLiteral(
+                                                      "SELECT html_display_state, job_data_locked, postage_data_locked, "
+                                                      "postage, count, last_executed_script, version "
+                                                      "FROM fh_jobs "
+                                                      "WHERE job_number = :job_number AND drop_number = :drop_number "
+                                                      "AND year = :year AND month = :month "
+                                                      "AND %1 = :version "
+                                                      "LIMIT 1")
+                                                      .arg(fhVersionSqlExpr()));
+    if (!query) {
+        Logger::instance().error("Failed to prepare FOUR HANDS loadJobState query");
+        return false;
+    }
+    query->bindValue(":job_number", normalizedJobNumber);
+    query->bindValue(":drop_number", normalizedDropNumber);
+    query->bindValue(":year", year);
+    query->bindValue(":month", month);
+    query->bindValue(":version", normalizedVersion);
 
-    if (!m_dbManager->executeQuery(query)) {
+    if (!m_dbManager->executeQuery(*query)) {
         Logger::instance().error(QString("Failed to execute FOUR HANDS loadJobState query for %1 drop %2 version %3 %4/%5: %6")
-                                     .arg(normalizedJobNumber, normalizedDropNumber, normalizedVersion, year, month, query.lastError().text()));
+                                     .arg(normalizedJobNumber, normalizedDropNumber, normalizedVersion, year, month, query->lastError().text()));
         return false;
     }
 
-    if (!query.next()) {
+    if (!query->next()) {
+        query->finish();
         htmlDisplayState = 0;
         jobDataLocked = false;
         postageDataLocked = false;
@@ -856,13 +905,14 @@ bool FHDBManager::loadJobState(const QString& jobNumber, const QString& dropNumb
         return false;
     }
 
-    htmlDisplayState = query.value("html_display_state").toInt();
-    jobDataLocked = query.value("job_data_locked").toInt() == 1;
-    postageDataLocked = query.value("postage_data_locked").toInt() == 1;
-    postage = query.value("postage").toString();
-    count = query.value("count").toString();
-    lastExecutedScript = query.value("last_executed_script").toString();
-    versionOut = normalizeFhVersion(query.value("version").toString());
+    htmlDisplayState = query->value("html_display_state").toInt();
+    jobDataLocked = query->value("job_data_locked").toInt() == 1;
+    postageDataLocked = query->value("postage_data_locked").toInt() == 1;
+    postage = query->value("postage").toString();
+    count = query->value("count").toString();
+    lastExecutedScript = query->value("last_executed_script").toString();
+    versionOut = normalizeFhVersion(query->value("version").toString());
+    query->finish();
 
     Logger::instance().info(QString("FOUR HANDS job state loaded for %1 drop %2 version %3 %4/%5: postage=%6, count=%7, locked=%8")
                                 .arg(normalizedJobNumber, normalizedDropNumber, normalizedVersion, year, month, postage, count, postageDataLocked ? "true" : "false"));
@@ -5,6 +5,8 @@
 #include <QSqlTableModel>
 #include <QObject>
 
+#include "jobindex.h"
+
 /**
 * @brief Database manager for FOUR HANDS tab operations
 *
@@ -65,6 +67,7 @@ public:
      * @return List of job data maps containing job_number, drop_number, year, month, version
      */
     QList<QMap<QString, QString>> getAllJobs();
+    JobIndex& jobIndex() { return m_jobIndex; }   // cached getAllJobs() for the Open Job menu
 
     /**
     * @brief Job state operations (for UI state persistence)
@@ -177,6 +180,8 @@ private:
     * @return True if tables created successfully
     */
     bool createTables();
+
+    JobIndex m_jobIndex { {"year", "month", "drop_number", "job_number", "version"}, [this]() { return getAllJobs(); } };
 };
 
 #endif // FHDBMANAGER_H
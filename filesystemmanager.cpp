@@ -1,5 +1,6 @@
 #include "filesystemmanager.h"
 #include "errorhandling.h"
+#include "filetransfer.h"
 #include "logger.h"
 #include <QDir>
 #include <QFileInfo>
@@ -8,6 +9,8 @@
 #include <QUrl>
 #include <QThread>
 
+#include <memory>
+
 FileSystemManager::FileSystemManager(QSettings* settings)
     : settings(settings)
 {
@@ -79,111 +82,73 @@ bool FileSystemManager::createJobFolders(const QString& /* year */, const QStrin
     return true;
 }
 
-bool FileSystemManager::copyFilesFromHomeToWorking(const QString& month, const QString& week)
+void FileSystemManager::copyFilesFromHomeToWorking(const QString& month, const QString& week, QObject* context,
+                                                   std::function<void(bool ok)> onFinished)
 {
     QString basePath = getBasePath();
     QStringList jobTypes = {"CBC", "EXC", "INACTIVE", "NCWO", "PREPIF"};
     QString homeFolder = month + "." + week;
 
-    for (const QString& jobType : jobTypes) {
-        QString homeDir = basePath + "/" + jobType + "/" + homeFolder;
-        QString workingDir = basePath + "/" + jobType + "/JOB";
-
-        for (const QString& subDir : QStringList{"INPUT", "OUTPUT", "PRINT", "PROOF"}) {
-            QDir homeSubDir(homeDir + "/" + subDir);
-            QString workingSubDirPath = workingDir + "/" + subDir;
-            try {
-                QDir workingSubDir(workingSubDirPath);
-                if (!workingSubDir.exists() && !workingSubDir.mkpath(".")) {
-                    THROW_FILE_ERROR("Failed to create working directory", workingSubDirPath);
-                }
-            } catch (const FileOperationException& e) {
-                Logger::instance().error(QString("Failed to create working directory: %1 - %2").arg(e.message(), e.path()));
-                return false;
+    // One plan for every job type so the copy succeeds or fails as a whole
+    FileTransferQueue::instance()->enqueue("Copying files to working folders",
+        [basePath, jobTypes, homeFolder]() {
+            FileTransferPlan plan;
+            plan.mode = FileTransferPlan::Mode::Copy;
+            for (const QString& jobType : jobTypes) {
+                QString homeDir = basePath + "/" + jobType + "/" + homeFolder;
+                QString workingDir = basePath + "/" + jobType + "/JOB";
+                plan.addFolders(homeDir, workingDir, {"INPUT", "OUTPUT", "PRINT", "PROOF"});
             }
-
-            if (homeSubDir.exists()) {
-                const QStringList& files = homeSubDir.entryList(QDir::Files);
-                for (const QString& file : files) {
-                    QString src = homeSubDir.filePath(file);
-                    QString dest = workingSubDirPath + "/" + file;
-                    try {
-                        if (QFile::exists(dest)) {
-                            if (!QFile::remove(dest)) {
-                                THROW_FILE_ERROR("Failed to remove existing file at destination", dest);
-                            }
-                        }
-                        if (!QFile::copy(src, dest)) {
-                            THROW_FILE_ERROR("Failed to copy file", src);
-                        }
-                    } catch (const FileOperationException& e) {
-                        Logger::instance().error(QString("Failed to copy file from %1 to %2: %3").arg(src, dest, e.message()));
-                        return false;
-                    }
-                }
+            return plan;
+        },
+        context, [homeFolder, onFinished](const FileTransferResult& result) {
+            if (!result.ok) {
+                Logger::instance().error("Failed to copy files to working folders: " + result.summary("Copied"));
+            } else {
+                Logger::instance().info(result.summary("Copied") + " from " + homeFolder + " to working folders");
             }
-        }
-    }
-
-    return true;
+            if (onFinished) {
+                onFinished(result.ok);
+            }
+        });
 }
 
-bool FileSystemManager::moveFilesToHomeFolders(const QString& month, const QString& week)
+void FileSystemManager::moveFilesToHomeFolders(const QString& month, const QString& week, QObject* context,
+                                               std::function<void(bool ok)> onFinished)
 {
     QString basePath = getBasePath();
     QStringList jobTypes = {"CBC", "EXC", "INACTIVE", "NCWO", "PREPIF"};
     QString homeFolder = month + "." + week;
     completedCopies.clear(); // Clear tracked operations
 
-    for (const QString& jobType : jobTypes) {
-        QString homeDir = basePath + "/" + jobType + "/" + homeFolder;
-        QString workingDir = basePath + "/" + jobType + "/JOB";
-
-        for (const QString& subDir : QStringList{"INPUT", "OUTPUT", "PRINT", "PROOF"}) {
-            QDir workingSubDir(workingDir + "/" + subDir);
-            QString homeSubDirPath = homeDir + "/" + subDir;
-            try {
-                QDir homeSubDir(homeSubDirPath);
-                if (!homeSubDir.exists() && !homeSubDir.mkpath(".")) {
-                    THROW_FILE_ERROR("Failed to create home subdirectory", homeSubDirPath);
-                }
-            } catch (const FileOperationException& e) {
-                Logger::instance().error(QString("Failed to create home subdirectory: %1 - %2").arg(e.message(), e.path()));
-                return false;
+    // The plan is built when the transfer starts; keep its items for the tracking below
+    auto items = std::make_shared<QVector<FileTransferItem>>();
+    FileTransferQueue::instance()->enqueue("Moving files to home folders",
+        [basePath, jobTypes, homeFolder, items]() {
+            FileTransferPlan plan;
+            plan.mode = FileTransferPlan::Mode::Move;
+            for (const QString& jobType : jobTypes) {
+                QString homeDir = basePath + "/" + jobType + "/" + homeFolder;
+                QString workingDir = basePath + "/" + jobType + "/JOB";
+                plan.addFolders(workingDir, homeDir, {"INPUT", "OUTPUT", "PRINT", "PROOF"});
             }
-
-            if (workingSubDir.exists()) {
-                const QStringList& files = workingSubDir.entryList(QDir::Files);
-                for (const QString& file : files) {
-                    QString srcPath = workingSubDir.filePath(file);
-                    QString destPath = homeSubDirPath + "/" + file;
-                    try {
-                        if (QFile::exists(destPath)) {
-                            if (!QFile::remove(destPath)) {
-                                THROW_FILE_ERROR("Failed to remove existing file at destination", destPath);
-                            }
-                        }
-                        if (!QFile::rename(srcPath, destPath)) {
-                            // If rename fails, try copy+delete
-                            if (!QFile::copy(srcPath, destPath)) {
-                                THROW_FILE_ERROR("Failed to copy file during move operation", srcPath);
-                            }
-                            if (!QFile::remove(srcPath)) {
-                                THROW_FILE_ERROR("Failed to remove source file after copy", srcPath);
-                            }
-                        }
-                        // Track the operation
-                        completedCopies.append(qMakePair(srcPath, destPath));
-                    } catch (const FileOperationException& e) {
-                        Logger::instance().error(QString("Failed to move file from %1 to %2: %3").arg(srcPath, destPath, e.message()));
-                        return false;
-                    }
+            *items = plan.items;
+            return plan;
+        },
+        context, [this, homeFolder, items, onFinished](const FileTransferResult& result) {
+            if (!result.ok) {
+                Logger::instance().error("Failed to move files to home folders: " + result.summary("Moved"));
+            } else {
+                // Track the operations
+                for (const FileTransferItem& item : *items) {
+                    completedCopies.append(qMakePair(item.source, item.destination));
                 }
+                Logger::instance().info(result.summary("Moved") + " to " + homeFolder + " home folders");
             }
-        }
-    }
-
-    return true;
+            if (onFinished) {
+                onFinished(result.ok);
+            }
+        });
 }
 
 bool FileSystemManager::checkProofFiles(const QString& jobType, QStringList& missingFiles)
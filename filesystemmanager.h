@@ -9,6 +9,8 @@
 #include <QPair>
 #include <QString>
 
+#include <functional>
+
 class FileSystemManager
 {
 public:
@@ -17,8 +19,11 @@ public:
 
     // Job folder operations
     bool createJobFolders(const QString& year, const QString& month, const QString& week);
-    bool copyFilesFromHomeToWorking(const QString& month, const QString& week);
-    bool moveFilesToHomeFolders(const QString& month, const QString& week);
+    // Both run on FileTransferQueue; onFinished is called on the GUI thread (dropped if context is destroyed)
+    void copyFilesFromHomeToWorking(const QString& month, const QString& week, QObject* context,
+                                    std::function<void(bool ok)> onFinished);
+    void moveFilesToHomeFolders(const QString& month, const QString& week, QObject* context,
+                                std::function<void(bool ok)> onFinished);
 
     // File checking
     bool checkProofFiles(const QString& jobType, QStringList& missingFiles);
@@ -0,0 +1,503 @@
+#include "filetransfer.h"
+#include "tracer.h"
+
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QStorageInfo>
+#include <QThreadPool>
+#include <QtConcurrent>
+
+#include <atomic>
+
+namespace {
+
+const qint64 kStreamBufferBytes = 4 * 1024 * 1024;
+const int kMaxCopyThreads = 4;          // network shares gain little beyond this
+const QString kStagedSuffix = QStringLiteral(".gojipart");
+const QString kSetAsideSuffix = QStringLiteral(".gojiold");
+
+QString formatBytes(qint64 bytes)
+{
+    if (bytes >= 1024LL * 1024 * 1024) {
+        return QString("%1 GB").arg(bytes / (1024.0 * 1024 * 1024), 0, 'f', 2);
+    }
+    if (bytes >= 1024LL * 1024) {
+        return QString("%1 MB").arg(bytes / (1024.0 * 1024), 0, 'f', 1);
+    }
+    return QString("%1 KB").arg((bytes + 1023) / 1024);
+}
+
+bool sameVolume(const QString& sourceFile, const QString& destinationDir, QHash<QString, bool>& cache)
+{
+    const QString sourceDir = QFileInfo(sourceFile).absolutePath();
+    const QString key = sourceDir + QLatin1Char('\n') + destinationDir;
+    const auto it = cache.constFind(key);
+    if (it != cache.constEnd()) {
+        return it.value();
+    }
+
+    const QStorageInfo from(sourceDir);
+    const QStorageInfo to(destinationDir);
+    const bool same = from.isValid() && to.isValid() && from.rootPath() == to.rootPath()
+                      && from.device() == to.device();
+    cache.insert(key, same);
+    return same;
+}
+
+// Fallback when the OS copy routine is unavailable (or refused the file)
+bool streamCopy(const QString& source, const QString& destination,
+                FileTransfer::Progress* progress, QString& error)
+{
+    QFile in(source);
+    if (!in.open(QIODevice::ReadOnly)) {
+        error = QString("Cannot read %1: %2").arg(source, in.errorString());
+        return false;
+    }
+    QFile out(destination);
+    if (!out.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        error = QString("Cannot write %1: %2").arg(destination, out.errorString());
+        return false;
+    }
+
+    QByteArray buffer;
+    buffer.resize(static_cast<int>(kStreamBufferBytes));
+    while (true) {
+        if (progress && progress->cancelled.load()) {
+            error = QStringLiteral("Cancelled");
+            return false;
+        }
+        const qint64 read = in.read(buffer.data(), kStreamBufferBytes);
+        if (read < 0) {
+            error = QString("Cannot read %1: %2").arg(source, in.errorString());
+            return false;
+        }
+        if (read == 0) {
+            break;
+        }
+        if (out.write(buffer.constData(), read) != read) {
+            error = QString("Cannot write %1: %2").arg(destination, out.errorString());
+            return false;
+        }
+        if (progress) {
+            progress->bytesDone += read;
+        }
+    }
+
+    out.setFileTime(in.fileTime(QFileDevice::FileModificationTime), QFileDevice::FileModificationTime);
+    return true;
+}
+
+bool stageCopy(const FileTransferItem& item, const QString& staged,
+               FileTransfer::Progress* progress, QString& error)
+{
+    QFile::remove(staged);
+
+    // QFile::copy uses the platform copy routine (CopyFile / file cloning), which
+    // avoids a user-space round trip and allows server-side copies on shares
+    if (QFile::copy(item.source, staged)) {
+        if (progress) {
+            progress->bytesDone += item.size;
+        }
+        return true;
+    }
+    QFile::remove(staged);
+
+    if (!streamCopy(item.source, staged, progress, error)) {
+        QFile::remove(staged);
+        return false;
+    }
+    return true;
+}
+
+struct CommitStep {
+    int item = 0;
+    bool renamedSource = false;
+    QString setAside;
+};
+
+void rollBack(const QVector<FileTransferItem>& items, const QVector<CommitStep>& journal, QStringList& warnings)
+{
+    for (int i = journal.size() - 1; i >= 0; --i) {
+        const CommitStep& step = journal.at(i);
+        const FileTransferItem& item = items.at(step.item);
+
+        const bool undone = step.renamedSource ? QFile::rename(item.destination, item.source)
+                                               : QFile::remove(item.destination);
+        if (!undone) {
+            warnings.append(QString("Could not undo %1").arg(item.destination));
+            continue;
+        }
+        if (!step.setAside.isEmpty() && !QFile::rename(step.setAside, item.destination)) {
+            warnings.append(QString("Could not restore %1 (kept as %2)").arg(item.destination, step.setAside));
+        }
+    }
+}
+
+} // namespace
+
+void FileTransferPlan::addFolder(const QString& sourceDir, const QString& destinationDir)
+{
+    if (!directories.contains(destinationDir)) {
+        directories.append(destinationDir);
+    }
+
+    QDir dir(sourceDir);
+    if (!dir.exists()) {
+        return;
+    }
+
+    const QFileInfoList files = dir.entryInfoList(QDir::Files, QDir::Name);
+    for (const QFileInfo& file : files) {
+        // Leftovers of an interrupted transfer are never part of a job
+        if (file.fileName().endsWith(kStagedSuffix) || file.fileName().endsWith(kSetAsideSuffix)) {
+            continue;
+        }
+        FileTransferItem item;
+        item.source = file.absoluteFilePath();
+        item.destination = destinationDir + QLatin1Char('/') + file.fileName();
+        item.size = file.size();
+        totalBytes += item.size;
+        items.append(item);
+    }
+}
+
+void FileTransferPlan::addFolders(const QString& sourceRoot, const QString& destinationRoot,
+                                  const QStringList& subDirs)
+{
+    for (const QString& subDir : subDirs) {
+        addFolder(sourceRoot + QLatin1Char('/') + subDir, destinationRoot + QLatin1Char('/') + subDir);
+    }
+}
+
+QString FileTransferResult::summary(const QString& verb) const
+{
+    if (cancelled) {
+        return QStringLiteral("File transfer cancelled; no files were changed");
+    }
+    if (!ok) {
+        return QString("File transfer failed: %1%2")
+            .arg(error, rolledBack ? QStringLiteral(" (all changes were rolled back)") : QString());
+    }
+
+    QString line = QString("%1 %2 file(s), %3, in %4 s")
+                       .arg(verb)
+                       .arg(filesTransferred)
+                       .arg(formatBytes(bytesTransferred))
+                       .arg(elapsedMs / 1000.0, 0, 'f', 1);
+    if (!warnings.isEmpty()) {
+        line += QString(" (%1 warning(s): %2)").arg(warnings.size()).arg(warnings.first());
+    }
+    return line;
+}
+
+FileTransferResult FileTransfer::execute(const FileTransferPlan& plan, Progress* progress)
+{
+    TRACE_SCOPE_DETAIL("io", "FileTransfer::execute",
+                       QString("%1 files, %2 bytes").arg(plan.items.size()).arg(plan.totalBytes));
+
+    FileTransferResult result;
+    QElapsedTimer timer;
+    timer.start();
+
+    if (progress) {
+        progress->bytesTotal = plan.totalBytes;
+        progress->filesTotal = plan.items.size();
+    }
+
+    for (const QString& dir : plan.directories) {
+        if (!QDir().mkpath(dir)) {
+            result.error = QString("Cannot create folder %1").arg(dir);
+            return result;
+        }
+    }
+
+    // Decide per file: a same-volume move is one rename, everything else is staged
+    const bool moving = plan.mode == FileTransferPlan::Mode::Move;
+    QVector<QString> staged(plan.items.size());
+    QVector<int> toStage;
+    QHash<QString, bool> volumeCache;
+    for (int i = 0; i < plan.items.size(); ++i) {
+        const FileTransferItem& item = plan.items.at(i);
+        const QString destinationDir = QFileInfo(item.destination).absolutePath();
+        if (!moving || !sameVolume(item.source, destinationDir, volumeCache)) {
+            staged[i] = item.destination + kStagedSuffix;
+            toStage.append(i);
+        }
+    }
+
+    // Phase 1: stage copies in parallel
+    if (!toStage.isEmpty()) {
+        std::atomic<int> next { 0 };
+        std::atomic<bool> failed { false };
+        QMutex errorMutex;
+        QString firstError;
+
+        QThreadPool pool;
+        pool.setMaxThreadCount(qMin(kMaxCopyThreads, toStage.size()));
+        for (int t = 0; t < pool.maxThreadCount(); ++t) {
+            pool.start([&]() {
+                while (!failed.load() && !(progress && progress->cancelled.load())) {
+                    const int n = next.fetch_add(1);
+                    if (n >= toStage.size()) {
+                        return;
+                    }
+                    const int index = toStage.at(n);
+                    QString error;
+                    if (!stageCopy(plan.items.at(index), staged.at(index), progress, error)) {
+                        QMutexLocker locker(&errorMutex);
+                        if (!failed.exchange(true)) {
+                            firstError = error;
+                        }
+                        return;
+                    }
+                    if (progress && !moving) {
+                        ++progress->filesDone;
+                    }
+                }
+            });
+        }
+        pool.waitForDone();
+
+        const bool cancelled = progress && progress->cancelled.load();
+        if (failed.load() || cancelled) {
+            for (int index : toStage) {
+                QFile::remove(staged.at(index));
+            }
+            result.cancelled = cancelled;
+            result.error = cancelled ? QStringLiteral("Cancelled") : firstError;
+            result.elapsedMs = timer.elapsed();
+            return result;
+        }
+    }
+
+    // Phase 2: swap every destination in; any failure undoes the lot
+    QVector<CommitStep> journal;
+    journal.reserve(plan.items.size());
+    for (int i = 0; i < plan.items.size(); ++i) {
+        // Cancelling mid-commit undoes the renames done so far
+        if (progress && progress->cancelled.load()) {
+            result.cancelled = true;
+            result.error = QStringLiteral("Cancelled");
+            break;
+        }
+
+        const FileTransferItem& item = plan.items.at(i);
+        CommitStep step;
+        step.item = i;
+        step.renamedSource = staged.at(i).isEmpty();
+
+        if (QFile::exists(item.destination)) {
+            step.setAside = item.destination + kSetAsideSuffix;
+            QFile::remove(step.setAside);
+            if (!QFile::rename(item.destination, step.setAside)) {
+                result.error = QString("Cannot replace %1 (is it open in another program?)").arg(item.destination);
+                break;
+            }
+        }
+
+        const QString from = step.renamedSource ? item.source : staged.at(i);
+        if (!QFile::rename(from, item.destination)) {
+            if (!step.setAside.isEmpty()) {
+                QFile::rename(step.setAside, item.destination);
+            }
+            result.error = QString("Cannot move %1 to %2").arg(from, item.destination);
+            break;
+        }
+        journal.append(step);
+    }
+
+    if (!result.error.isEmpty()) {
+        rollBack(plan.items, journal, result.warnings);
+        for (int index : toStage) {
+            QFile::remove(staged.at(index));
+        }
+        result.rolledBack = true;
+        result.elapsedMs = timer.elapsed();
+        return result;
+    }
+
+    // Phase 3: drop (or keep) replaced files and the sources of cross-volume moves
+    for (const CommitStep& step : journal) {
+        const FileTransferItem& item = plan.items.at(step.item);
+        if (!step.setAside.isEmpty()) {
+            if (plan.backupPathFor) {
+                const QString backup = plan.backupPathFor(item.destination);
+                QFile::remove(backup);
+                if (!QFile::rename(step.setAside, backup)) {
+                    result.warnings.append(QString("Could not keep backup %1").arg(backup));
+                }
+            } else if (!QFile::remove(step.setAside)) {
+                result.warnings.append(QString("Could not delete %1").arg(step.setAside));
+            }
+        }
+        if (moving && !step.renamedSource && !QFile::remove(item.source)) {
+            result.warnings.append(QString("Copied but could not delete source %1").arg(item.source));
+        }
+        if (progress && moving) {
+            ++progress->filesDone;
+            if (step.renamedSource) {
+                progress->bytesDone += item.size;
+            }
+        }
+    }
+
+    result.ok = true;
+    result.filesTransferred = plan.items.size();
+    result.bytesTransferred = plan.totalBytes;
+    result.elapsedMs = timer.elapsed();
+    return result;
+}
+
+FileTransfer::FileTransfer(QObject* parent)
+    : QObject(parent)
+{
+    m_progressTimer.setInterval(100);
+    connect(&m_progressTimer, &QTimer::timeout, this, &FileTransfer::reportProgress);
+
+    connect(&m_watcher, &QFutureWatcher<FileTransferResult>::finished, this, [this]() {
+        m_progressTimer.stop();
+        reportProgress();
+        emit finished(m_watcher.result());
+    });
+}
+
+FileTransfer::~FileTransfer()
+{
+    cancel();
+    m_watcher.waitForFinished();
+}
+
+bool FileTransfer::start(const FileTransferPlan& plan)
+{
+    if (isRunning()) {
+        return false;
+    }
+
+    m_state = std::make_shared<Progress>();
+    std::shared_ptr<Progress> state = m_state;
+
+    m_watcher.setFuture(QtConcurrent::run([state, plan]() {
+        return execute(plan, state.get());
+    }));
+    m_progressTimer.start();
+    return true;
+}
+
+void FileTransfer::cancel()
+{
+    if (m_state) {
+        m_state->cancelled = true;
+    }
+}
+
+bool FileTransfer::isRunning() const
+{
+    return m_watcher.isRunning();
+}
+
+void FileTransfer::reportProgress()
+{
+    if (m_state) {
+        emit progress(m_state->bytesDone.load(), m_state->bytesTotal.load(),
+                      m_state->filesDone.load(), m_state->filesTotal.load());
+    }
+}
+
+FileTransferQueue* FileTransferQueue::m_instance = nullptr;
+
+FileTransferQueue* FileTransferQueue::instance()
+{
+    if (!m_instance) {
+        m_instance = new FileTransferQueue();
+    }
+    return m_instance;
+}
+
+FileTransferQueue::FileTransferQueue()
+{
+    connect(&m_transfer, &FileTransfer::progress, this, &FileTransferQueue::progress);
+    connect(&m_transfer, &FileTransfer::finished, this, &FileTransferQueue::onTransferFinished);
+}
+
+void FileTransferQueue::enqueue(const QString& description, PlanBuilder buildPlan, QObject* context,
+                                Callback onFinished)
+{
+    Request request;
+    request.description = description;
+    request.buildPlan = std::move(buildPlan);
+    request.context = context;
+    request.hasContext = context != nullptr;
+    request.onFinished = std::move(onFinished);
+
+    const bool wasBusy = isBusy();
+    m_pending.enqueue(request);
+    if (!wasBusy) {
+        emit busyChanged(true);
+    }
+    if (!m_running) {
+        startNext();
+    }
+}
+
+void FileTransferQueue::cancelAll()
+{
+    const QQueue<Request> dropped = m_pending;
+    m_pending.clear();
+    m_transfer.cancel();
+
+    FileTransferResult cancelled;
+    cancelled.cancelled = true;
+    cancelled.error = QStringLiteral("Cancelled");
+    for (const Request& request : dropped) {
+        deliver(request, cancelled);
+    }
+
+    if (!isBusy()) {
+        emit busyChanged(false);
+    }
+}
+
+void FileTransferQueue::startNext()
+{
+    if (m_pending.isEmpty()) {
+        return;
+    }
+
+    m_current = m_pending.dequeue();
+    m_running = true;
+    const FileTransferPlan plan = m_current.buildPlan ? m_current.buildPlan() : FileTransferPlan();
+    emit transferStarted(m_current.description);
+    m_transfer.start(plan);
+}
+
+void FileTransferQueue::onTransferFinished(const FileTransferResult& result)
+{
+    const Request finished = m_current;
+    m_current = Request();
+    m_running = false;
+
+    deliver(finished, result);
+
+    // The callback may already have queued (and started) the next transfer
+    if (m_running) {
+        return;
+    }
+    if (!m_pending.isEmpty()) {
+        startNext();
+    } else {
+        emit busyChanged(false);
+    }
+}
+
+void FileTransferQueue::deliver(const Request& request, const FileTransferResult& result)
+{
+    if (!request.onFinished || (request.hasContext && !request.context)) {
+        return;
+    }
+    request.onFinished(result);
+}
@@ -0,0 +1,221 @@
+#ifndef FILETRANSFER_H
+#define FILETRANSFER_H
+
+#include <QFutureWatcher>
+#include <QObject>
+#include <QPointer>
+#include <QQueue>
+#include <QString>
+#include <QStringList>
+#include <QTimer>
+#include <QVector>
+
+#include <atomic>
+#include <functional>
+#include <memory>
+
+/**
+ * @brief One file in a transfer plan
+ */
+struct FileTransferItem {
+    QString source;
+    QString destination;
+    qint64 size = 0;
+};
+
+/**
+ * @brief Everything a transfer will do, built before any file is touched
+ */
+struct FileTransferPlan {
+    enum class Mode {
+        Copy,
+        Move
+    };
+
+    Mode mode = Mode::Copy;
+    QVector<FileTransferItem> items;
+    QStringList directories;        // created before the first file is staged
+    qint64 totalBytes = 0;
+
+    /**
+     * @brief Where to keep a destination file that gets replaced
+     *
+     * Empty (the default) deletes replaced files once the transfer has
+     * committed; otherwise the function returns a backup path for each one.
+     */
+    std::function<QString(const QString& destination)> backupPathFor;
+
+    /**
+     * @brief Add the top-level files of sourceDir, to land in destinationDir
+     *
+     * A missing source directory adds nothing; destinationDir is created
+     * either way.
+     */
+    void addFolder(const QString& sourceDir, const QString& destinationDir);
+
+    /**
+     * @brief Add the same sub-folders under two roots (e.g. JOB and HOME)
+     */
+    void addFolders(const QString& sourceRoot, const QString& destinationRoot, const QStringList& subDirs);
+
+    bool isEmpty() const { return items.isEmpty(); }
+};
+
+/**
+ * @brief Outcome of a file transfer
+ */
+struct FileTransferResult {
+    bool ok = false;
+    bool cancelled = false;
+    bool rolledBack = false;        // a failure undid every completed step
+    QString error;
+    QStringList warnings;           // e.g. a moved file whose source could not be deleted
+    int filesTransferred = 0;
+    qint64 bytesTransferred = 0;
+    qint64 elapsedMs = 0;
+
+    /**
+     * @brief One terminal line describing the transfer
+     * @param verb "Moved", "Copied", ...
+     */
+    QString summary(const QString& verb) const;
+};
+
+/**
+ * @brief Shared engine for moving/copying job folders (JOB <-> HOME/ARCHIVE)
+ *
+ * A transfer runs in three phases:
+ *  1. Stage: every file that cannot simply be renamed (copies, and moves
+ *     across volumes) is copied in parallel next to its destination as
+ *     "<name>.gojipart", using the OS copy routine and falling back to
+ *     streaming with a large buffer. Nothing visible has changed yet, so a
+ *     failure or cancellation just deletes the staged files.
+ *  2. Commit: each destination is swapped in with renames on the target
+ *     volume (an existing file is set aside first). If any rename fails, or
+ *     the transfer is cancelled, every committed file is put back and the
+ *     set-aside files restored.
+ *  3. Clean up: set-aside files are deleted (or kept as backups) and the
+ *     sources of cross-volume moves are removed.
+ *
+ * Same-volume moves skip staging and are a single rename each.
+ */
+class FileTransfer : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Shared progress/cancellation state for execute()
+     */
+    struct Progress {
+        std::atomic<bool> cancelled { false };
+        std::atomic<qint64> bytesDone { 0 };
+        std::atomic<qint64> bytesTotal { 0 };
+        std::atomic<int> filesDone { 0 };
+        std::atomic<int> filesTotal { 0 };
+    };
+
+    /**
+     * @brief Run a plan synchronously on the calling thread plus a worker pool
+     * @param plan Transfer plan
+     * @param progress Optional progress reporting and cancellation (honoured until the clean-up phase)
+     *
+     * Blocks for the whole transfer; GUI code uses start() or FileTransferQueue.
+     */
+    static FileTransferResult execute(const FileTransferPlan& plan, Progress* progress = nullptr);
+
+    explicit FileTransfer(QObject* parent = nullptr);
+    ~FileTransfer();
+
+    /**
+     * @brief Start a transfer on the global thread pool; ignored if already running
+     * @return True if the transfer was started
+     */
+    bool start(const FileTransferPlan& plan);
+
+    /**
+     * @brief Request cancellation; finished() reports a cancelled, rolled-back result
+     */
+    void cancel();
+
+    bool isRunning() const;
+
+signals:
+    void progress(qint64 bytesDone, qint64 bytesTotal, int filesDone, int filesTotal);
+    void finished(const FileTransferResult& result);
+
+private:
+    void reportProgress();
+
+    std::shared_ptr<Progress> m_state;
+    QFutureWatcher<FileTransferResult> m_watcher;
+    QTimer m_progressTimer;
+};
+
+/**
+ * @brief Application-wide queue that runs job folder transfers one at a time
+ *
+ * Closing one job and opening the next both touch the JOB folders, so
+ * transfers run strictly in request order. Each plan is built only when its
+ * turn comes, so it sees the files an earlier transfer left behind. While
+ * the queue is busy MainWindow disables the tabs and shows progress with a
+ * cancel button; callers continue from their completion callback.
+ */
+class FileTransferQueue : public QObject
+{
+    Q_OBJECT
+
+public:
+    using PlanBuilder = std::function<FileTransferPlan()>;
+    using Callback = std::function<void(const FileTransferResult& result)>;
+
+    /**
+     * @brief Get the singleton instance
+     */
+    static FileTransferQueue* instance();
+
+    /**
+     * @brief Queue a transfer
+     * @param description Shown next to the progress bar ("Moving files to HOME", ...)
+     * @param buildPlan Called on the GUI thread just before the transfer starts
+     * @param context Callback is dropped if this object is destroyed first (may be null)
+     * @param onFinished Called on the GUI thread with the outcome
+     */
+    void enqueue(const QString& description, PlanBuilder buildPlan, QObject* context, Callback onFinished);
+
+    /**
+     * @brief Cancel the running transfer (it is rolled back) and every queued one
+     */
+    void cancelAll();
+
+    bool isBusy() const { return m_running || !m_pending.isEmpty(); }
+
+signals:
+    void busyChanged(bool busy);
+    void transferStarted(const QString& description);
+    void progress(qint64 bytesDone, qint64 bytesTotal, int filesDone, int filesTotal);
+
+private:
+    struct Request {
+        QString description;
+        PlanBuilder buildPlan;
+        QPointer<QObject> context;
+        bool hasContext = false;
+        Callback onFinished;
+    };
+
+    FileTransferQueue();
+
+    void startNext();
+    void onTransferFinished(const FileTransferResult& result);
+    static void deliver(const Request& request, const FileTransferResult& result);
+
+    static FileTransferQueue* m_instance;
+
+    FileTransfer m_transfer;
+    QQueue<Request> m_pending;
+    Request m_current;
+    bool m_running = false;
+};
+
+#endif // FILETRANSFER_H
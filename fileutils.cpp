@@ -1,6 +1,8 @@
 #include "fileutils.h"
 #include "errorhandling.h"
 #include "logger.h"
+#include "hashservice.h"
+#include "tracer.h"
 #include <QTemporaryFile>
 #include <QCryptographicHash>
 #include <QMimeDatabase>
@@ -11,10 +13,82 @@
 #include <QMutex>
 #include <QSet>
 #include <QSettings>
+#include <QVector>
+#include <QDirIterator>
+#include <QRegularExpression>
+#include <QThreadPool>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
 
 namespace FileUtils {
-// Static mutex for thread-safe file operations
-Q_GLOBAL_STATIC(QMutex, fileOperationMutex)
+
+namespace {
+
+// Operations that mutate a path take the lock stripe of that path, so
+// unrelated files never wait on each other. Read-only work (hashing, MIME
+// sniffing, directory listing) and operations the filesystem already makes
+// atomic (mkpath, exclusive create, remove) take no lock at all.
+const int kLockStripeCount = 64;
+
+struct LockStripes {
+    QMutex mutexes[kLockStripeCount];
+};
+Q_GLOBAL_STATIC(LockStripes, lockStripes)
+
+int lockStripeFor(const QString& path)
+{
+    QString key = QDir::cleanPath(QFileInfo(path).absoluteFilePath());
+#ifdef Q_OS_WIN
+    key = key.toLower(); // NTFS paths are case-insensitive
+#endif
+    return static_cast<int>(qHash(key) % kLockStripeCount);
+}
+
+/**
+ * @brief Holds the lock stripes of one or more paths for the current scope
+ *
+ * Stripes are always taken in ascending order, so two lockers over
+ * overlapping path sets cannot deadlock.
+ */
+class PathLocker
+{
+public:
+    explicit PathLocker(const QStringList& paths)
+    {
+        for (const QString& path : paths) {
+            if (!path.isEmpty()) {
+                m_stripes.append(lockStripeFor(path));
+            }
+        }
+        std::sort(m_stripes.begin(), m_stripes.end());
+        m_stripes.erase(std::unique(m_stripes.begin(), m_stripes.end()), m_stripes.end());
+        for (int stripe : std::as_const(m_stripes)) {
+            lockStripes()->mutexes[stripe].lock();
+        }
+    }
+
+    ~PathLocker()
+    {
+        for (int i = m_stripes.size() - 1; i >= 0; --i) {
+            lockStripes()->mutexes[m_stripes.at(i)].unlock();
+        }
+    }
+
+private:
+    Q_DISABLE_COPY(PathLocker)
+    QVector<int> m_stripes;
+};
+
+// The *Locked helpers expect the caller to hold the stripes of every path involved
+
+void createBackupLocked(const QString& filePath, const QString& backupDir);
+void removeFileLocked(const QString& filePath, bool createBackupFirst);
+void copyFileLocked(const QString& sourcePath, const QString& destPath, bool overwrite);
+
+} // namespace
 
 FileResult validateFileOperation(const QString& operation, const QString& sourcePath, const QString& destPath) {
     // Validate source path
@@ -58,8 +132,13 @@ FileResult validateFileOperation(const QString& operation, const QString& source
 }
 
 void createBackup(const QString& filePath, const QString& backupDir) {
-    QMutexLocker locker(fileOperationMutex()); // Lock for thread safety
+    PathLocker locker({ filePath });
+    createBackupLocked(filePath, backupDir);
+}
+
+namespace {
 
+void createBackupLocked(const QString& filePath, const QString& backupDir) {
     QFileInfo fileInfo(filePath);
 
     if (!fileInfo.exists() || !fileInfo.isReadable()) {
@@ -95,9 +174,7 @@ void createBackup(const QString& filePath, const QString& backupDir) {
     LOG_INFO(QString("Created backup: %1").arg(backupFile));
 }
 
-void safeRemoveFile(const QString& filePath, bool createBackupFirst) {
-    QMutexLocker locker(fileOperationMutex()); // Lock for thread safety
-
+void removeFileLocked(const QString& filePath, bool createBackupFirst) {
     QFileInfo fileInfo(filePath);
 
     if (!fileInfo.exists()) {
@@ -116,7 +193,7 @@ void safeRemoveFile(const QString& filePath, bool createBackupFirst) {
     // Create backup if requested
     if (createBackupFirst) {
         try {
-            createBackup(filePath);
+            createBackupLocked(filePath, QString());
         } catch (const FileOperationException& e) {
             LOG_WARNING(QString("Failed to create backup before removal: %1").arg(filePath));
             // Continue anyway - backup is optional
@@ -130,9 +207,7 @@ void safeRemoveFile(const QString& filePath, bool createBackupFirst) {
     }
 }
 
-void safeCopyFile(const QString& sourcePath, const QString& destPath, bool overwrite) {
-    QMutexLocker locker(fileOperationMutex()); // Lock for thread safety
-
+void copyFileLocked(const QString& sourcePath, const QString& destPath, bool overwrite) {
     // Validate operation
     FileResult validation = validateFileOperation("copy", sourcePath, destPath);
     if (!validation) {
@@ -145,7 +220,7 @@ void safeCopyFile(const QString& sourcePath, const QString& destPath, bool overw
         if (!overwrite) {
             THROW_FILE_ERROR("Destination file exists and overwrite is disabled: " + destPath, destPath);
         }
-        safeRemoveFile(destPath);
+        removeFileLocked(destPath, false);
     }
 
     // Perform the copy
@@ -160,7 +235,7 @@ void safeCopyFile(const QString& sourcePath, const QString& destPath, bool overw
     if (newDestInfo.size() != sourceInfo.size()) {
         // Size mismatch - remove corrupted file
         try {
-            safeRemoveFile(destPath);
+            removeFileLocked(destPath, false);
         } catch (const FileOperationException& e) {
             LOG_WARNING(QString("Failed to clean up corrupted destination file: %1").arg(destPath));
         }
@@ -168,8 +243,20 @@ void safeCopyFile(const QString& sourcePath, const QString& destPath, bool overw
     }
 }
 
+} // namespace
+
+void safeRemoveFile(const QString& filePath, bool createBackupFirst) {
+    PathLocker locker({ filePath });
+    removeFileLocked(filePath, createBackupFirst);
+}
+
+void safeCopyFile(const QString& sourcePath, const QString& destPath, bool overwrite) {
+    PathLocker locker({ sourcePath, destPath });
+    copyFileLocked(sourcePath, destPath, overwrite);
+}
+
 void safeMoveFile(const QString& sourcePath, const QString& destPath, bool overwrite) {
-    QMutexLocker locker(fileOperationMutex()); // Lock for thread safety
+    PathLocker locker({ sourcePath, destPath });
 
     // Validate operation
     FileResult validation = validateFileOperation("move", sourcePath, destPath);
@@ -183,7 +270,7 @@ void safeMoveFile(const QString& sourcePath, const QString& destPath, bool overw
         if (!overwrite) {
             THROW_FILE_ERROR("Destination file exists and overwrite is disabled: " + destPath, destPath);
         }
-        safeRemoveFile(destPath);
+        removeFileLocked(destPath, false);
     }
 
     // Try to use rename (fast move) first
@@ -194,13 +281,12 @@ void safeMoveFile(const QString& sourcePath, const QString& destPath, bool overw
 
     // If rename fails, try copy+delete
     LOG_INFO(QString("Direct rename failed, falling back to copy+delete for %1").arg(sourcePath));
-    safeCopyFile(sourcePath, destPath, true);
-    safeRemoveFile(sourcePath);
+    copyFileLocked(sourcePath, destPath, true);
+    removeFileLocked(sourcePath, false);
 }
 
 void ensureDirectoryExists(const QString& dirPath) {
-    QMutexLocker locker(fileOperationMutex()); // Lock for thread safety
-
+    // mkpath succeeds when the directory already exists, so concurrent callers need no lock
     QDir dir(dirPath);
     if (!dir.exists()) {
         if (!dir.mkpath(".")) {
@@ -210,7 +296,7 @@ void ensureDirectoryExists(const QString& dirPath) {
 }
 
 FileResult readTextFile(const QString& filePath, qint64 maxSize) {
-    QMutexLocker locker(fileOperationMutex()); // Lock for thread safety
+    PathLocker locker({ filePath }); // Don't read while writeTextFile is halfway through
 
     QFile file(filePath);
 
@@ -236,7 +322,7 @@ FileResult readTextFile(const QString& filePath, qint64 maxSize) {
 }
 
 void writeTextFile(const QString& filePath, const QString& content, bool append) {
-    QMutexLocker locker(fileOperationMutex()); // Lock for thread safety
+    PathLocker locker({ filePath });
 
     // Create directory if it doesn't exist
     QFileInfo fileInfo(filePath);
@@ -269,31 +355,137 @@ void writeTextFile(const QString& filePath, const QString& content, bool append)
     file.close();
 }
 
-FileResult findFiles(const QString& dirPath, const QStringList& filters, bool recursive) {
-    QDir dir(dirPath);
+bool walkDirectory(const QString& dirPath, const WalkOptions& options, const FileEntryCallback& callback) {
+    QDir root(dirPath);
+    if (!root.exists()) {
+        return false;
+    }
 
-    if (!dir.exists()) {
-        return FileResult(false, "Directory does not exist", dirPath);
+    TRACE_SCOPE_DETAIL("io", "FileUtils::walkDirectory", dirPath);
+
+    QVector<QRegularExpression> patterns;
+    for (const QString& filter : options.nameFilters) {
+        patterns.append(QRegularExpression(QRegularExpression::wildcardToRegularExpression(filter),
+                                           QRegularExpression::CaseInsensitiveOption));
     }
+    const auto matches = [&patterns](const QString& fileName) {
+        if (patterns.isEmpty()) {
+            return true;
+        }
+        for (const QRegularExpression& pattern : patterns) {
+            if (pattern.match(fileName).hasMatch()) {
+                return true;
+            }
+        }
+        return false;
+    };
 
     QDir::Filters dirFilters = QDir::Files | QDir::NoDotAndDotDot;
-    if (recursive) {
+    if (options.recursive || options.includeDirectories) {
         dirFilters |= QDir::AllDirs;
     }
 
-    QStringList fileList;
-    QFileInfoList entries = dir.entryInfoList(filters, dirFilters);
-
-    for (const auto& entry : std::as_const(entries)) {
-        if (entry.isFile()) {
-            fileList << entry.absoluteFilePath();
-        } else if (recursive && entry.isDir()) {
-            // Recursively search subdirectory
-            FileResult subResult = findFiles(entry.absoluteFilePath(), filters, true);
-            if (subResult) {
-                fileList.append(subResult.errorMessage.split('\n', Qt::SkipEmptyParts));
+    // Directories still to scan; a worker exits once none are pending and none are being scanned
+    std::mutex queueMutex;
+    std::condition_variable queueChanged;
+    QStringList pending { root.absolutePath() };
+    int scanning = 0;
+    std::atomic<bool> stopped { false };
+    std::mutex callbackMutex;
+
+    const auto worker = [&]() {
+        for (;;) {
+            QString dir;
+            {
+                std::unique_lock<std::mutex> lock(queueMutex);
+                queueChanged.wait(lock, [&] {
+                    return stopped.load() || !pending.isEmpty() || scanning == 0;
+                });
+                if (stopped.load() || pending.isEmpty()) {
+                    queueChanged.notify_all();
+                    return;
+                }
+                dir = pending.takeLast();
+                ++scanning;
+            }
+
+            QStringList subDirs;
+            QVector<FileEntry> entries;
+            QDirIterator it(dir, dirFilters);
+            while (it.hasNext()) {
+                it.next();
+                const QFileInfo info = it.fileInfo();
+                if (info.isDir()) {
+                    if (options.recursive && !info.isSymLink()) {
+                        subDirs.append(info.absoluteFilePath());
+                    }
+                    if (options.includeDirectories) {
+                        entries.append({ info.absoluteFilePath(), 0, info.lastModified(), true });
+                    }
+                } else if (matches(info.fileName())) {
+                    entries.append({ info.absoluteFilePath(), info.size(), info.lastModified(), false });
+                }
             }
+
+            {
+                std::lock_guard<std::mutex> lock(callbackMutex);
+                for (const FileEntry& entry : std::as_const(entries)) {
+                    if (stopped.load() || !callback(entry)) {
+                        stopped.store(true);
+                        break;
+                    }
+                }
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(queueMutex);
+                pending.append(subDirs);
+                --scanning;
+            }
+            queueChanged.notify_all();
         }
+    };
+
+    if (!options.recursive || options.maxThreads <= 1) {
+        worker();
+    } else {
+        QThreadPool pool;
+        pool.setMaxThreadCount(options.maxThreads);
+        for (int i = 0; i < options.maxThreads; ++i) {
+            pool.start(worker);
+        }
+        pool.waitForDone();
+    }
+    return true;
+}
+
+QVector<FileEntry> listFiles(const QString& dirPath, const QStringList& filters, bool recursive) {
+    WalkOptions options;
+    options.nameFilters = filters;
+    options.recursive = recursive;
+
+    QVector<FileEntry> files;
+    walkDirectory(dirPath, options, [&files](const FileEntry& entry) {
+        files.append(entry);
+        return true;
+    });
+
+    std::sort(files.begin(), files.end(), [](const FileEntry& a, const FileEntry& b) {
+        return a.path < b.path;
+    });
+    return files;
+}
+
+FileResult findFiles(const QString& dirPath, const QStringList& filters, bool recursive) {
+    if (!QDir(dirPath).exists()) {
+        return FileResult(false, "Directory does not exist", dirPath);
+    }
+
+    const QVector<FileEntry> files = listFiles(dirPath, filters, recursive);
+    QStringList fileList;
+    fileList.reserve(files.size());
+    for (const FileEntry& entry : files) {
+        fileList << entry.path;
     }
 
     // Return the file list in the errorMessage field
@@ -301,7 +493,8 @@ FileResult findFiles(const QString& dirPath, const QStringList& filters, bool re
 }
 
 FileResult isFileLocked(const QString& filePath) {
-    QMutexLocker locker(fileOperationMutex()); // Lock for thread safety
+    QString tempPath = filePath + ".locktest";
+    PathLocker locker({ filePath, tempPath });
 
     // Try to open the file for exclusive ReadWrite access
     QFile file(filePath);
@@ -310,13 +503,12 @@ FileResult isFileLocked(const QString& filePath) {
     }
 
     // Additional check: Try to rename the file temporarily
-    QString tempPath = filePath + ".locktest";
     QFile tempFile(tempPath);
 
     // Remove any existing temp file first
     if (tempFile.exists()) {
         try {
-            safeRemoveFile(tempPath);
+            removeFileLocked(tempPath, false);
         } catch (const FileOperationException& e) {
             file.close();
             return FileResult(false, "Failed to remove temporary lock test file: " + tempPath, tempPath);
@@ -330,7 +522,7 @@ FileResult isFileLocked(const QString& filePath) {
     // Clean up the temp file if it was created
     if (canRename) {
         try {
-            safeRemoveFile(tempPath);
+            removeFileLocked(tempPath, false);
         } catch (const FileOperationException& e) {
             return FileResult(false, "Failed to clean up temporary lock test file: " + tempPath, tempPath);
         }
@@ -341,8 +533,7 @@ FileResult isFileLocked(const QString& filePath) {
 }
 
 FileResult releaseFileLock(const QString& filePath) {
-    QMutexLocker locker(fileOperationMutex()); // Lock for thread safety
-
+    // No lock here: this waits for a second and pumps events, and isFileLocked() locks the path itself
     // This is a bit of a hack to try to close any processes that might have the file open
     LOG_INFO(QString("Attempting to release file handles for: %1").arg(filePath));
 
@@ -372,18 +563,12 @@ FileResult releaseFileLock(const QString& filePath) {
 }
 
 FileResult calculateFileHash(const QString& filePath, const QString& method) {
-    QMutexLocker locker(fileOperationMutex()); // Lock for thread safety
-
-    QFile file(filePath);
-
-    if (!file.exists()) {
+    // Read-only and potentially long (print PDFs run to gigabytes), so no lock is held;
+    // HashService reads on its own pool and skips files whose cached digest is still valid
+    if (!QFile::exists(filePath)) {
         return FileResult(false, "File does not exist", filePath);
     }
 
-    if (!file.open(QIODevice::ReadOnly)) {
-        THROW_FILE_ERROR("Failed to open file: " + file.errorString(), filePath);
-    }
-
     // Determine hash algorithm
     QCryptographicHash::Algorithm hashAlgorithm;
     if (method.toLower() == "md5") {
@@ -395,19 +580,14 @@ FileResult calculateFileHash(const QString& filePath, const QString& method) {
     } else if (method.toLower() == "sha512") {
         hashAlgorithm = QCryptographicHash::Sha512;
     } else {
-        file.close();
         return FileResult(false, "Unsupported hash algorithm", method);
     }
 
-    QCryptographicHash hash(hashAlgorithm);
-    if (hash.addData(&file)) {
-        QString hashResult = hash.result().toHex();
-        file.close();
-        return FileResult(true, hashResult);
+    const FileDigest digest = HashService::instance().hashFile(filePath, hashAlgorithm);
+    if (!digest.ok) {
+        THROW_FILE_ERROR("Failed to calculate hash: " + digest.error, filePath);
     }
-
-    file.close();
-    THROW_FILE_ERROR("Failed to calculate hash: " + filePath, filePath);
+    return FileResult(true, digest.hex);
 }
 
 QString formatFileSize(qint64 sizeInBytes) {
@@ -431,7 +611,6 @@ QString getMimeType(const QString& filePath, bool checkContent) {
     QMimeType mime;
 
     if (checkContent) {
-        QMutexLocker locker(fileOperationMutex()); // Lock for thread safety
         QFile file(filePath);
         if (file.open(QIODevice::ReadOnly)) {
             mime = db.mimeTypeForData(&file);
@@ -447,7 +626,7 @@ QString getMimeType(const QString& filePath, bool checkContent) {
 }
 
 QString createUniqueFileName(const QString& baseDir, const QString& baseName, const QString& extension) {
-    QMutexLocker locker(fileOperationMutex()); // Lock for thread safety
+    PathLocker locker({ baseDir }); // Callers picking names in the same directory take turns
 
     QDir dir(baseDir);
     if (!dir.exists()) {
@@ -475,8 +654,6 @@ QString createUniqueFileName(const QString& baseDir, const QString& baseName, co
 }
 
 void createTempFile(const QString& content, const QString& prefix, const QString& extension) {
-    QMutexLocker locker(fileOperationMutex()); // Lock for thread safety
-
     QString tempDir = QStandardPaths::writableLocation(QStandardPaths::TempLocation);
     QDir dir(tempDir);
     if (!dir.exists()) {
@@ -485,15 +662,21 @@ void createTempFile(const QString& content, const QString& prefix, const QString
         }
     }
 
-    // Create unique file name
+    // Create unique file name; NewOnly makes the create exclusive, so two
+    // threads in the same millisecond simply end up with different suffixes
     QString timestamp = QDateTime::currentDateTime().toString("yyyyMMdd_hhmmss_zzz");
-    QString fileName = prefix + "_" + timestamp + extension;
-    QString filePath = dir.filePath(fileName);
-
-    // Write content to file
-    QFile file(filePath);
-    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
-        THROW_FILE_ERROR("Failed to create temporary file: " + file.errorString(), filePath);
+    QString filePath;
+    QFile file;
+    for (int attempt = 0;; ++attempt) {
+        const QString suffix = attempt == 0 ? QString() : QString("_%1").arg(attempt);
+        filePath = dir.filePath(prefix + "_" + timestamp + suffix + extension);
+        file.setFileName(filePath);
+        if (file.open(QIODevice::WriteOnly | QIODevice::Text | QIODevice::NewOnly)) {
+            break;
+        }
+        if (!file.exists() || attempt >= 100) {
+            THROW_FILE_ERROR("Failed to create temporary file: " + file.errorString(), filePath);
+        }
     }
 
     QTextStream stream(&file);
@@ -502,8 +685,6 @@ void createTempFile(const QString& content, const QString& prefix, const QString
 }
 
 void cleanupTempFiles(const QString& tempDir, const QString& prefix, int maxAgeHours) {
-    QMutexLocker locker(fileOperationMutex()); // Lock for thread safety
-
     QString dirPath = tempDir;
     if (dirPath.isEmpty()) {
         dirPath = QStandardPaths::writableLocation(QStandardPaths::TempLocation);
@@ -524,7 +705,8 @@ void cleanupTempFiles(const QString& tempDir, const QString& prefix, int maxAgeH
         qint64 fileAge = fileInfo.lastModified().secsTo(currentTime) / 3600;
 
         if (fileAge > maxAgeHours) {
-            if (!QFile::remove(fileInfo.absoluteFilePath())) {
+            // Another cleanup may have removed it first; only a file that is still there is an error
+            if (!QFile::remove(fileInfo.absoluteFilePath()) && QFile::exists(fileInfo.absoluteFilePath())) {
                 THROW_FILE_ERROR("Failed to remove temporary file: " + fileInfo.absoluteFilePath(), fileInfo.absoluteFilePath());
             }
         }
@@ -8,6 +8,10 @@
 #include <QFileInfo>
 #include <QDateTime>
 #include <QDebug>
+#include <QVector>
+
+#include <functional>
+
 class QSettings;
 
 namespace FileUtils {
@@ -115,8 +119,64 @@ FileResult readTextFile(const QString& filePath, qint64 maxSize = 0);
  */
 void writeTextFile(const QString& filePath, const QString& content, bool append = false);
 
+/**
+ * @brief One entry produced by a directory walk
+ */
+struct FileEntry {
+    QString path;               ///< Absolute path
+    qint64 size = 0;            ///< Size in bytes (0 for directories)
+    QDateTime lastModified;
+    bool isDirectory = false;
+};
+
+/**
+ * @brief What a directory walk visits
+ */
+struct WalkOptions {
+    QStringList nameFilters;            ///< Wildcards matched against file names (case-insensitive); empty = all files
+    bool recursive = false;
+    bool includeDirectories = false;    ///< Also report directories (never filtered by nameFilters)
+    int maxThreads = 4;                 ///< Directories scanned concurrently when recursive
+};
+
+/**
+ * @brief Receives walk entries; return false to stop the walk
+ *
+ * Calls are serialized, so the callback needs no locking of its own, but
+ * they may come from worker threads and directories are not visited in
+ * any particular order.
+ */
+using FileEntryCallback = std::function<bool(const FileEntry& entry)>;
+
+/**
+ * @brief Walk a directory tree, reporting structured entries
+ *
+ * Each directory is read once with a non-recursive iterator and names are
+ * matched as they are read; recursive walks scan sibling directories on a
+ * small pool. Symbolic links to directories are not followed.
+ *
+ * @param dirPath The directory to walk
+ * @param options Filters and recursion
+ * @param callback Receives each matching entry
+ * @return False if dirPath does not exist
+ */
+bool walkDirectory(const QString& dirPath, const WalkOptions& options, const FileEntryCallback& callback);
+
+/**
+ * @brief Collect the files matching a pattern, sorted by path
+ * @param dirPath The directory to search
+ * @param filters File filters (e.g., "*.txt")
+ * @param recursive Whether to search subdirectories
+ * @return Matching files; empty if the directory does not exist
+ */
+QVector<FileEntry> listFiles(const QString& dirPath, const QStringList& filters, bool recursive = false);
+
 /**
  * @brief Get a list of files matching a pattern
+ *
+ * Kept for existing callers; new code should use listFiles() or
+ * walkDirectory(), which avoid the newline-joined string.
+ *
  * @param dirPath The directory to search
  * @param filters File filters (e.g., "*.txt")
  * @param recursive Whether to search subdirectories
@@ -0,0 +1,331 @@
+#include "hashservice.h"
+#include "tracer.h"
+
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QMutexLocker>
+#include <QSqlDatabase>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QStandardPaths>
+#include <QThread>
+#include <QVariant>
+#include <QtConcurrent>
+
+#ifdef Q_OS_WIN
+#include <windows.h>
+#else
+#include <sys/stat.h>
+#endif
+
+namespace {
+
+// Large enough that a network share streams at full rate, small enough for several workers
+const qint64 kReadChunkBytes = 8 * 1024 * 1024;
+const int kMaxHashThreads = 4;
+// In-memory digests kept in front of SQLite; least recently used are evicted past this
+const int kMaxMemoryCacheEntries = 4096;
+
+// One cache connection per pool thread; closed when the thread exits
+struct CacheConnection {
+    QString name;
+    bool attempted = false;
+    bool ready = false;
+
+    ~CacheConnection()
+    {
+        if (name.isEmpty()) {
+            return;
+        }
+        {
+            QSqlDatabase db = QSqlDatabase::database(name, false);
+            db.close();
+        }
+        QSqlDatabase::removeDatabase(name);
+    }
+};
+
+CacheConnection& cacheConnection(const QString& cachePath)
+{
+    thread_local CacheConnection connection;
+    if (connection.attempted) {
+        return connection;
+    }
+    connection.attempted = true;
+    connection.name = QString("digest_cache_%1").arg(reinterpret_cast<quintptr>(QThread::currentThreadId()));
+
+    QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", connection.name);
+    db.setDatabaseName(cachePath);
+    if (db.open()) {
+        QSqlQuery query(db);
+        query.exec("PRAGMA journal_mode=WAL");
+        query.exec("PRAGMA synchronous=NORMAL");
+        query.exec("PRAGMA busy_timeout=5000");
+        connection.ready = query.exec("CREATE TABLE IF NOT EXISTS file_digests ("
+                                      "path TEXT NOT NULL, "
+                                      "algorithm INTEGER NOT NULL, "
+                                      "size INTEGER NOT NULL, "
+                                      "mtime_ms INTEGER NOT NULL, "
+                                      "file_id INTEGER NOT NULL, "
+                                      "digest TEXT NOT NULL, "
+                                      "hashed_at INTEGER NOT NULL, "
+                                      "PRIMARY KEY (path, algorithm))");
+        if (!connection.ready) {
+            qWarning() << "Digest cache: failed to create table:" << query.lastError().text();
+        }
+    } else {
+        qWarning() << "Digest cache: failed to open" << cachePath << ":" << db.lastError().text();
+    }
+    return connection;
+}
+
+// NTFS file index or inode: changes when a file is replaced rather than rewritten in place
+quint64 fileIdentity(const QString& filePath)
+{
+#ifdef Q_OS_WIN
+    const std::wstring nativePath = QDir::toNativeSeparators(filePath).toStdWString();
+    HANDLE handle = CreateFileW(nativePath.c_str(), FILE_READ_ATTRIBUTES,
+                                FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                                nullptr, OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS, nullptr);
+    if (handle == INVALID_HANDLE_VALUE) {
+        return 0;
+    }
+    quint64 id = 0;
+    BY_HANDLE_FILE_INFORMATION info;
+    if (GetFileInformationByHandle(handle, &info)) {
+        id = (static_cast<quint64>(info.nFileIndexHigh) << 32) | info.nFileIndexLow;
+    }
+    CloseHandle(handle);
+    return id;
+#else
+    struct stat info;
+    if (::stat(QFile::encodeName(filePath).constData(), &info) != 0) {
+        return 0;
+    }
+    return static_cast<quint64>(info.st_ino);
+#endif
+}
+
+QString cacheKey(const QString& filePath)
+{
+    QString key = QDir::cleanPath(QFileInfo(filePath).absoluteFilePath());
+#ifdef Q_OS_WIN
+    key = key.toLower();
+#endif
+    return key;
+}
+
+} // namespace
+
+double HashService::Statistics::throughputMBps() const
+{
+    if (hashTimeMs <= 0) {
+        return 0.0;
+    }
+    return (bytesHashed / (1024.0 * 1024.0)) / (hashTimeMs / 1000.0);
+}
+
+HashService& HashService::instance()
+{
+    static HashService service;
+    return service;
+}
+
+HashService::HashService()
+{
+    m_pool.setMaxThreadCount(qBound(1, QThread::idealThreadCount(), kMaxHashThreads));
+    m_memoryCache.setMaxCost(kMaxMemoryCacheEntries);
+
+    const QString cacheDir = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + "/cache";
+    QDir().mkpath(cacheDir);
+    m_cachePath = cacheDir + "/file_digests.db";
+}
+
+HashService::~HashService()
+{
+    m_pool.waitForDone();
+}
+
+QFuture<FileDigest> HashService::hashFileAsync(const QString& filePath, QCryptographicHash::Algorithm algorithm,
+                                               CachePolicy policy)
+{
+    return QtConcurrent::run(&m_pool, [this, filePath, algorithm, policy]() {
+        return computeDigest(filePath, algorithm, policy);
+    });
+}
+
+QList<QFuture<FileDigest>> HashService::hashFilesAsync(const QStringList& filePaths,
+                                                       QCryptographicHash::Algorithm algorithm,
+                                                       CachePolicy policy)
+{
+    QList<QFuture<FileDigest>> futures;
+    futures.reserve(filePaths.size());
+    for (const QString& filePath : filePaths) {
+        futures.append(hashFileAsync(filePath, algorithm, policy));
+    }
+    return futures;
+}
+
+FileDigest HashService::hashFile(const QString& filePath, QCryptographicHash::Algorithm algorithm, CachePolicy policy)
+{
+    return hashFileAsync(filePath, algorithm, policy).result();
+}
+
+HashService::Statistics HashService::statistics() const
+{
+    Statistics stats;
+    stats.filesHashed = m_filesHashed.load();
+    stats.bytesHashed = m_bytesHashed.load();
+    stats.hashTimeMs = m_hashTimeMs.load();
+    stats.cacheHits = m_cacheHits.load();
+    return stats;
+}
+
+void HashService::resetStatistics()
+{
+    m_filesHashed = 0;
+    m_bytesHashed = 0;
+    m_hashTimeMs = 0;
+    m_cacheHits = 0;
+}
+
+bool HashService::lookupMemory(const QString& key, qint64 size, qint64 mtimeMs, qint64 fileId, QString& hex)
+{
+    QMutexLocker locker(&m_memoryMutex);
+    // object() also marks the entry as most recently used
+    const MemoryEntry* entry = m_memoryCache.object(key);
+    if (!entry) {
+        return false;
+    }
+    if (entry->size != size || entry->mtimeMs != mtimeMs || entry->fileId != fileId) {
+        m_memoryCache.remove(key);
+        return false;
+    }
+    hex = entry->hex;
+    return true;
+}
+
+void HashService::storeMemory(const QString& key, qint64 size, qint64 mtimeMs, qint64 fileId, const QString& hex)
+{
+    MemoryEntry* entry = new MemoryEntry;
+    entry->size = size;
+    entry->mtimeMs = mtimeMs;
+    entry->fileId = fileId;
+    entry->hex = hex;
+
+    QMutexLocker locker(&m_memoryMutex);
+    // Cost 1 per entry, so maxCost is the entry cap; the least recently used entry is evicted
+    m_memoryCache.insert(key, entry, 1);
+}
+
+FileDigest HashService::computeDigest(const QString& filePath, QCryptographicHash::Algorithm algorithm,
+                                      CachePolicy policy)
+{
+    TRACE_SCOPE_DETAIL("io", "HashService::computeDigest", filePath);
+
+    FileDigest result;
+    result.path = filePath;
+
+    const QFileInfo info(filePath);
+    if (!info.exists() || !info.isFile()) {
+        result.error = QStringLiteral("File does not exist");
+        return result;
+    }
+    result.size = info.size();
+
+    const QString key = cacheKey(filePath);
+    const qint64 mtimeMs = info.lastModified().toMSecsSinceEpoch();
+    const qint64 fileId = static_cast<qint64>(fileIdentity(filePath)); // SQLite integers are signed
+    const QString memoryKey = key + QLatin1Char('\n') + QString::number(static_cast<int>(algorithm));
+    CacheConnection& cache = cacheConnection(m_cachePath);
+
+    if (policy == CachePolicy::UseCache
+        && lookupMemory(memoryKey, result.size, mtimeMs, fileId, result.hex)) {
+        result.ok = true;
+        result.fromCache = true;
+        ++m_cacheHits;
+        return result;
+    }
+
+    if (cache.ready && policy == CachePolicy::UseCache) {
+        QSqlQuery lookup(QSqlDatabase::database(cache.name, false));
+        lookup.prepare("SELECT size, mtime_ms, file_id, digest FROM file_digests WHERE path = ? AND algorithm = ?");
+        lookup.addBindValue(key);
+        lookup.addBindValue(static_cast<int>(algorithm));
+        if (lookup.exec() && lookup.next()
+            && lookup.value(0).toLongLong() == result.size
+            && lookup.value(1).toLongLong() == mtimeMs
+            && lookup.value(2).toLongLong() == fileId) {
+            result.ok = true;
+            result.fromCache = true;
+            result.hex = lookup.value(3).toString();
+            storeMemory(memoryKey, result.size, mtimeMs, fileId, result.hex);
+            ++m_cacheHits;
+            return result;
+        }
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    // Unbuffered: each read goes straight from the OS into our chunk
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Unbuffered)) {
+        result.error = QString("Failed to open file: %1").arg(file.errorString());
+        return result;
+    }
+
+    QCryptographicHash hash(algorithm);
+    QByteArray buffer;
+    buffer.resize(static_cast<int>(qMin(kReadChunkBytes, qMax<qint64>(result.size, 1))));
+    qint64 total = 0;
+    while (true) {
+        const qint64 read = file.read(buffer.data(), buffer.size());
+        if (read < 0) {
+            result.error = QString("Failed to read file: %1").arg(file.errorString());
+            return result;
+        }
+        if (read == 0) {
+            break;
+        }
+        hash.addData(QByteArray::fromRawData(buffer.constData(), static_cast<int>(read)));
+        total += read;
+    }
+    file.close();
+
+    result.ok = true;
+    result.hex = QString::fromLatin1(hash.result().toHex());
+    result.elapsedMs = timer.elapsed();
+
+    ++m_filesHashed;
+    m_bytesHashed += total;
+    m_hashTimeMs += result.elapsedMs;
+
+    // Only cache if the file did not change while it was being read
+    const QFileInfo after(filePath);
+    const bool unchanged = after.size() == result.size && after.lastModified().toMSecsSinceEpoch() == mtimeMs;
+    if (unchanged) {
+        storeMemory(memoryKey, result.size, mtimeMs, fileId, result.hex);
+    }
+    if (cache.ready && unchanged) {
+        QSqlQuery store(QSqlDatabase::database(cache.name, false));
+        store.prepare("INSERT OR REPLACE INTO file_digests (path, algorithm, size, mtime_ms, file_id, digest, hashed_at) "
+                      "VALUES (?, ?, ?, ?, ?, ?, ?)");
+        store.addBindValue(key);
+        store.addBindValue(static_cast<int>(algorithm));
+        store.addBindValue(result.size);
+        store.addBindValue(mtimeMs);
+        store.addBindValue(fileId);
+        store.addBindValue(result.hex);
+        store.addBindValue(QDateTime::currentSecsSinceEpoch());
+        if (!store.exec()) {
+            qWarning() << "Digest cache: failed to store digest for" << filePath << ":" << store.lastError().text();
+        }
+    }
+
+    return result;
+}
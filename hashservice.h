@@ -0,0 +1,136 @@
+#ifndef HASHSERVICE_H
+#define HASHSERVICE_H
+
+#include <QCache>
+#include <QCryptographicHash>
+#include <QFuture>
+#include <QList>
+#include <QMutex>
+#include <QString>
+#include <QStringList>
+#include <QThreadPool>
+
+#include <atomic>
+
+/**
+ * @brief Digest of one file
+ */
+struct FileDigest {
+    bool ok = false;
+    bool fromCache = false;
+    QString path;
+    QString hex;                // lower-case hex digest; empty on failure
+    QString error;
+    qint64 size = 0;
+    qint64 elapsedMs = 0;       // time spent reading and hashing (0 for cache hits)
+};
+
+/**
+ * @brief Shared file hashing service with a persistent digest cache
+ *
+ * Files are hashed on a small dedicated pool with large unbuffered
+ * sequential reads, so several files hash concurrently and no caller's
+ * thread does the I/O. Results are cached in SQLite keyed by path and
+ * algorithm and validated against size, modification time and file ID
+ * (NTFS file index / inode); a file that has not changed is never read
+ * again, even across sessions.
+ *
+ * Each pool thread keeps its own cache connection, so lookups never
+ * contend on a shared connection. Recently used digests are also kept in
+ * a small in-memory LRU cache in front of SQLite, capped at a fixed number
+ * of entries so long sessions over many files do not grow without bound.
+ */
+class HashService
+{
+public:
+    enum class CachePolicy {
+        UseCache,
+        Bypass          // always read the file (e.g. verifying a download), but still store the result
+    };
+
+    /**
+     * @brief Running totals since startup (or the last resetStatistics())
+     */
+    struct Statistics {
+        qint64 filesHashed = 0;
+        qint64 bytesHashed = 0;
+        qint64 hashTimeMs = 0;          // summed per file, so concurrent hashes overlap
+        qint64 cacheHits = 0;
+
+        /**
+         * @brief Average per-file read+hash throughput in MB/s
+         */
+        double throughputMBps() const;
+    };
+
+    /**
+     * @brief Get the singleton instance
+     * @return Reference to the HashService instance
+     */
+    static HashService& instance();
+
+    /**
+     * @brief Hash a file on the service pool
+     */
+    QFuture<FileDigest> hashFileAsync(const QString& filePath,
+                                      QCryptographicHash::Algorithm algorithm = QCryptographicHash::Sha256,
+                                      CachePolicy policy = CachePolicy::UseCache);
+
+    /**
+     * @brief Hash several files concurrently
+     * @return One future per path, in the same order
+     */
+    QList<QFuture<FileDigest>> hashFilesAsync(const QStringList& filePaths,
+                                              QCryptographicHash::Algorithm algorithm = QCryptographicHash::Sha256,
+                                              CachePolicy policy = CachePolicy::UseCache);
+
+    /**
+     * @brief Hash a file and wait for the result
+     */
+    FileDigest hashFile(const QString& filePath,
+                        QCryptographicHash::Algorithm algorithm = QCryptographicHash::Sha256,
+                        CachePolicy policy = CachePolicy::UseCache);
+
+    /**
+     * @brief Location of the digest cache (created on first use)
+     */
+    QString cachePath() const { return m_cachePath; }
+
+    Statistics statistics() const;
+    void resetStatistics();
+
+private:
+    HashService();
+    ~HashService();
+
+    HashService(const HashService&) = delete;
+    HashService& operator=(const HashService&) = delete;
+
+    /**
+     * @brief Cached digest plus the file state it was computed for
+     */
+    struct MemoryEntry {
+        qint64 size = 0;
+        qint64 mtimeMs = 0;
+        qint64 fileId = 0;
+        QString hex;
+    };
+
+    FileDigest computeDigest(const QString& filePath, QCryptographicHash::Algorithm algorithm, CachePolicy policy);
+
+    bool lookupMemory(const QString& key, qint64 size, qint64 mtimeMs, qint64 fileId, QString& hex);
+    void storeMemory(const QString& key, qint64 size, qint64 mtimeMs, qint64 fileId, const QString& hex);
+
+    QThreadPool m_pool;
+    QString m_cachePath;
+
+    QMutex m_memoryMutex;
+    QCache<QString, MemoryEntry> m_memoryCache;     // LRU; guarded by m_memoryMutex
+
+    std::atomic<qint64> m_filesHashed { 0 };
+    std::atomic<qint64> m_bytesHashed { 0 };
+    std::atomic<qint64> m_hashTimeMs { 0 };
+    std::atomic<qint64> m_cacheHits { 0 };
+};
+
+#endif // HASHSERVICE_H
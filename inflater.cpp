@@ -0,0 +1,488 @@
+#include "inflater.h"
+
+#include <cstring>
+#include <vector>
+
+namespace {
+
+constexpr int kMaxBits = 15;
+constexpr int kMaxLitLenCodes = 288;
+constexpr int kMaxDistCodes = 30;
+constexpr int kFastBits = 10;
+constexpr size_t kWindowSize = 32768;
+constexpr size_t kChunkSize = 256 * 1024;
+constexpr size_t kMaxMatch = 258;
+
+const uint16_t kLengthBase[29] = {
+    3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+    35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+const uint8_t kLengthExtra[29] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+    3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+const uint16_t kDistBase[30] = {
+    1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+    257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577 };
+const uint8_t kDistExtra[30] = {
+    0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+    7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+const uint8_t kCodeLengthOrder[19] = {
+    16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };
+
+// Canonical Huffman table with a direct lookup for codes up to kFastBits long
+struct Huffman {
+    // Entry layout: symbol in the low 9 bits, code length in the next 4; 0 = miss
+    uint16_t fast[1 << kFastBits];
+    uint16_t count[kMaxBits + 1];
+    uint16_t symbol[kMaxLitLenCodes];
+
+    // Returns false for over-subscribed code sets; incomplete sets are allowed
+    bool build(const uint8_t* lengths, int n)
+    {
+        std::memset(fast, 0, sizeof(fast));
+        std::memset(count, 0, sizeof(count));
+        for (int i = 0; i < n; ++i) {
+            ++count[lengths[i]];
+        }
+        count[0] = 0;
+
+        int left = 1;
+        for (int len = 1; len <= kMaxBits; ++len) {
+            left <<= 1;
+            left -= count[len];
+            if (left < 0) {
+                return false;
+            }
+        }
+
+        uint16_t offsets[kMaxBits + 1];
+        offsets[1] = 0;
+        for (int len = 1; len < kMaxBits; ++len) {
+            offsets[len + 1] = offsets[len] + count[len];
+        }
+        for (int i = 0; i < n; ++i) {
+            if (lengths[i] != 0) {
+                symbol[offsets[lengths[i]]++] = static_cast<uint16_t>(i);
+            }
+        }
+
+        // Assign canonical codes and populate the fast table with bit-reversed codes
+        int code = 0;
+        int index = 0;
+        for (int len = 1; len <= kMaxBits; ++len) {
+            for (int k = 0; k < count[len]; ++k, ++code, ++index) {
+                if (len > kFastBits) {
+                    continue;
+                }
+                int reversed = 0;
+                for (int b = 0; b < len; ++b) {
+                    reversed |= ((code >> b) & 1) << (len - 1 - b);
+                }
+                const uint16_t entry = static_cast<uint16_t>(symbol[index] | (len << 9));
+                for (int fill = reversed; fill < (1 << kFastBits); fill += (1 << len)) {
+                    fast[fill] = entry;
+                }
+            }
+            code <<= 1;
+        }
+        return true;
+    }
+};
+
+class OutputWindow
+{
+public:
+    explicit OutputWindow(const Inflater::Sink& sink)
+        : m_buffer(kWindowSize + kChunkSize), m_sink(sink)
+    {
+    }
+
+    bool reserveMatch()
+    {
+        if (m_pos + kMaxMatch <= m_buffer.size()) {
+            return true;
+        }
+        if (!flush()) {
+            return false;
+        }
+
+        // Keep the last 32 KB as history for back-references
+        const size_t keep = m_pos < kWindowSize ? m_pos : kWindowSize;
+        std::memmove(m_buffer.data(), m_buffer.data() + m_pos - keep, keep);
+        m_pos = keep;
+        m_flushed = keep;
+        return true;
+    }
+
+    void put(unsigned char byte) { m_buffer[m_pos++] = byte; }
+
+    bool copy(size_t distance, size_t length)
+    {
+        if (distance == 0 || distance > m_pos) {
+            return false;
+        }
+        unsigned char* out = m_buffer.data() + m_pos;
+        const unsigned char* from = out - distance;
+        if (distance >= length) {
+            std::memcpy(out, from, length);
+        } else {
+            // Overlapping copy repeats the pattern byte by byte
+            for (size_t i = 0; i < length; ++i) {
+                out[i] = from[i];
+            }
+        }
+        m_pos += length;
+        return true;
+    }
+
+    bool appendStored(const unsigned char* data, size_t size)
+    {
+        while (size > 0) {
+            if (!reserveMatch()) {
+                return false;
+            }
+            const size_t room = m_buffer.size() - m_pos;
+            const size_t n = size < room ? size : room;
+            std::memcpy(m_buffer.data() + m_pos, data, n);
+            m_pos += n;
+            data += n;
+            size -= n;
+        }
+        return true;
+    }
+
+    bool flush()
+    {
+        if (m_pos > m_flushed) {
+            if (!m_sink(m_buffer.data() + m_flushed, m_pos - m_flushed)) {
+                return false;
+            }
+            m_flushed = m_pos;
+        }
+        return true;
+    }
+
+private:
+    std::vector<unsigned char> m_buffer;
+    size_t m_pos = 0;
+    size_t m_flushed = 0;
+    const Inflater::Sink& m_sink;
+};
+
+class Decoder
+{
+public:
+    Decoder(const unsigned char* input, size_t size, const Inflater::Sink& sink)
+        : m_in(input), m_size(size), m_out(sink)
+    {
+    }
+
+    Inflater::Status run()
+    {
+        bool last = false;
+        while (!last) {
+            uint32_t header = 0;
+            if (!getBits(3, header)) {
+                return Inflater::Status::Truncated;
+            }
+            last = (header & 1) != 0;
+
+            Inflater::Status status = Inflater::Status::Ok;
+            switch (header >> 1) {
+            case 0:
+                status = storedBlock();
+                break;
+            case 1:
+                status = fixedBlock();
+                break;
+            case 2:
+                status = dynamicBlock();
+                break;
+            default:
+                return Inflater::Status::DataError;
+            }
+            if (status != Inflater::Status::Ok) {
+                return status;
+            }
+        }
+        return m_out.flush() ? Inflater::Status::Ok : Inflater::Status::Aborted;
+    }
+
+private:
+    void refill()
+    {
+        while (m_bitCount <= 56 && m_pos < m_size) {
+            m_bitBuf |= static_cast<uint64_t>(m_in[m_pos++]) << m_bitCount;
+            m_bitCount += 8;
+        }
+    }
+
+    bool getBits(int n, uint32_t& value)
+    {
+        if (m_bitCount < n) {
+            refill();
+            if (m_bitCount < n) {
+                return false;
+            }
+        }
+        value = static_cast<uint32_t>(m_bitBuf & ((1ull << n) - 1));
+        m_bitBuf >>= n;
+        m_bitCount -= n;
+        return true;
+    }
+
+    // Returns the decoded symbol, -1 for an invalid code, -2 when input runs out
+    int decode(const Huffman& h)
+    {
+        if (m_bitCount < kMaxBits) {
+            refill();
+        }
+
+        const uint16_t entry = h.fast[m_bitBuf & ((1u << kFastBits) - 1)];
+        if (entry != 0) {
+            const int len = entry >> 9;
+            if (len > m_bitCount) {
+                return -2;
+            }
+            m_bitBuf >>= len;
+            m_bitCount -= len;
+            return entry & 0x1FF;
+        }
+
+        // Slow canonical walk for codes longer than the fast table
+        int code = 0;
+        int first = 0;
+        int index = 0;
+        for (int len = 1; len <= kMaxBits; ++len) {
+            if (len > m_bitCount) {
+                return -2;
+            }
+            code |= static_cast<int>((m_bitBuf >> (len - 1)) & 1);
+            const int count = h.count[len];
+            if (code - count < first) {
+                m_bitBuf >>= len;
+                m_bitCount -= len;
+                return h.symbol[index + (code - first)];
+            }
+            index += count;
+            first += count;
+            first <<= 1;
+            code <<= 1;
+        }
+        return -1;
+    }
+
+    Inflater::Status storedBlock()
+    {
+        // Discard to a byte boundary, then hand unread whole bytes back to the input
+        m_bitBuf >>= (m_bitCount & 7);
+        m_bitCount -= (m_bitCount & 7);
+        m_pos -= static_cast<size_t>(m_bitCount / 8);
+        m_bitBuf = 0;
+        m_bitCount = 0;
+
+        if (m_size - m_pos < 4) {
+            return Inflater::Status::Truncated;
+        }
+        const size_t len = m_in[m_pos] | (m_in[m_pos + 1] << 8);
+        const size_t nlen = m_in[m_pos + 2] | (m_in[m_pos + 3] << 8);
+        m_pos += 4;
+        if (len != (~nlen & 0xFFFF)) {
+            return Inflater::Status::DataError;
+        }
+        if (m_size - m_pos < len) {
+            return Inflater::Status::Truncated;
+        }
+        if (!m_out.appendStored(m_in + m_pos, len)) {
+            return Inflater::Status::Aborted;
+        }
+        m_pos += len;
+        return Inflater::Status::Ok;
+    }
+
+    Inflater::Status codes(const Huffman& litLen, const Huffman& dist)
+    {
+        for (;;) {
+            if (!m_out.reserveMatch()) {
+                return Inflater::Status::Aborted;
+            }
+
+            int symbol = decode(litLen);
+            if (symbol < 0) {
+                return symbol == -2 ? Inflater::Status::Truncated : Inflater::Status::DataError;
+            }
+            if (symbol < 256) {
+                m_out.put(static_cast<unsigned char>(symbol));
+                continue;
+            }
+            if (symbol == 256) {
+                return Inflater::Status::Ok;
+            }
+
+            symbol -= 257;
+            if (symbol >= 29) {
+                return Inflater::Status::DataError;
+            }
+            uint32_t extra = 0;
+            if (!getBits(kLengthExtra[symbol], extra)) {
+                return Inflater::Status::Truncated;
+            }
+            const size_t length = kLengthBase[symbol] + extra;
+
+            symbol = decode(dist);
+            if (symbol < 0) {
+                return symbol == -2 ? Inflater::Status::Truncated : Inflater::Status::DataError;
+            }
+            if (symbol >= kMaxDistCodes) {
+                return Inflater::Status::DataError;
+            }
+            if (!getBits(kDistExtra[symbol], extra)) {
+                return Inflater::Status::Truncated;
+            }
+            const size_t distance = kDistBase[symbol] + extra;
+
+            if (!m_out.copy(distance, length)) {
+                return Inflater::Status::DataError;
+            }
+        }
+    }
+
+    Inflater::Status fixedBlock()
+    {
+        struct FixedTables {
+            Huffman litLen;
+            Huffman dist;
+            FixedTables()
+            {
+                uint8_t lengths[kMaxLitLenCodes];
+                int i = 0;
+                for (; i < 144; ++i) lengths[i] = 8;
+                for (; i < 256; ++i) lengths[i] = 9;
+                for (; i < 280; ++i) lengths[i] = 7;
+                for (; i < kMaxLitLenCodes; ++i) lengths[i] = 8;
+                litLen.build(lengths, kMaxLitLenCodes);
+
+                for (i = 0; i < kMaxDistCodes; ++i) lengths[i] = 5;
+                dist.build(lengths, kMaxDistCodes);
+            }
+        };
+        static const FixedTables tables;
+        return codes(tables.litLen, tables.dist);
+    }
+
+    Inflater::Status dynamicBlock()
+    {
+        uint32_t hlit = 0;
+        uint32_t hdist = 0;
+        uint32_t hclen = 0;
+        if (!getBits(5, hlit) || !getBits(5, hdist) || !getBits(4, hclen)) {
+            return Inflater::Status::Truncated;
+        }
+        hlit += 257;
+        hdist += 1;
+        hclen += 4;
+        if (hlit > 286 || hdist > kMaxDistCodes) {
+            return Inflater::Status::DataError;
+        }
+
+        uint8_t lengths[kMaxLitLenCodes + kMaxDistCodes];
+        std::memset(lengths, 0, sizeof(lengths));
+        for (uint32_t i = 0; i < hclen; ++i) {
+            uint32_t len = 0;
+            if (!getBits(3, len)) {
+                return Inflater::Status::Truncated;
+            }
+            lengths[kCodeLengthOrder[i]] = static_cast<uint8_t>(len);
+        }
+
+        Huffman lenCode;
+        if (!lenCode.build(lengths, 19)) {
+            return Inflater::Status::DataError;
+        }
+
+        uint32_t index = 0;
+        while (index < hlit + hdist) {
+            int symbol = decode(lenCode);
+            if (symbol < 0) {
+                return symbol == -2 ? Inflater::Status::Truncated : Inflater::Status::DataError;
+            }
+            if (symbol < 16) {
+                lengths[index++] = static_cast<uint8_t>(symbol);
+                continue;
+            }
+
+            uint8_t repeatValue = 0;
+            uint32_t repeat = 0;
+            if (symbol == 16) {
+                if (index == 0) {
+                    return Inflater::Status::DataError;
+                }
+                repeatValue = lengths[index - 1];
+                if (!getBits(2, repeat)) return Inflater::Status::Truncated;
+                repeat += 3;
+            } else if (symbol == 17) {
+                if (!getBits(3, repeat)) return Inflater::Status::Truncated;
+                repeat += 3;
+            } else {
+                if (!getBits(7, repeat)) return Inflater::Status::Truncated;
+                repeat += 11;
+            }
+            if (index + repeat > hlit + hdist) {
+                return Inflater::Status::DataError;
+            }
+            while (repeat--) {
+                lengths[index++] = repeatValue;
+            }
+        }
+
+        if (lengths[256] == 0) {
+            return Inflater::Status::DataError;
+        }
+
+        Huffman litLen;
+        Huffman dist;
+        if (!litLen.build(lengths, static_cast<int>(hlit))
+            || !dist.build(lengths + hlit, static_cast<int>(hdist))) {
+            return Inflater::Status::DataError;
+        }
+        return codes(litLen, dist);
+    }
+
+    const unsigned char* m_in;
+    size_t m_size;
+    size_t m_pos = 0;
+    uint64_t m_bitBuf = 0;
+    int m_bitCount = 0;
+    OutputWindow m_out;
+};
+
+struct Crc32Table {
+    uint32_t entries[256];
+    Crc32Table()
+    {
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; ++k) {
+                c = (c & 1) ? (0xEDB88320u ^ (c >> 1)) : (c >> 1);
+            }
+            entries[i] = c;
+        }
+    }
+};
+
+} // namespace
+
+Inflater::Status Inflater::inflate(const unsigned char* input, size_t inputSize, const Sink& sink)
+{
+    Decoder decoder(input, inputSize, sink);
+    return decoder.run();
+}
+
+uint32_t Inflater::crc32(uint32_t crc, const unsigned char* data, size_t size)
+{
+    static const Crc32Table table;
+    crc = ~crc;
+    for (size_t i = 0; i < size; ++i) {
+        crc = table.entries[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
@@ -0,0 +1,50 @@
+#ifndef INFLATER_H
+#define INFLATER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+/**
+ * @brief Streaming decoder for raw DEFLATE (RFC 1951) data
+ *
+ * Used by archiveutils to extract ZIP entries in-process. The whole
+ * compressed input is expected in memory (typically a memory-mapped
+ * archive); decompressed output is delivered to a sink in large chunks
+ * while only a 32 KB history window plus one chunk is kept in memory.
+ */
+class Inflater
+{
+public:
+    /**
+     * @brief Receives decompressed data; return false to abort
+     */
+    using Sink = std::function<bool(const unsigned char* data, size_t size)>;
+
+    enum class Status {
+        Ok,          ///< Stream decoded completely
+        DataError,   ///< Malformed stream
+        Truncated,   ///< Input ended before the final block
+        Aborted      ///< Sink returned false
+    };
+
+    /**
+     * @brief Decode a raw DEFLATE stream
+     * @param input Compressed bytes
+     * @param inputSize Number of compressed bytes available
+     * @param sink Receives decompressed output in order
+     * @return Decode status
+     */
+    static Status inflate(const unsigned char* input, size_t inputSize, const Sink& sink);
+
+    /**
+     * @brief Update a CRC-32 (ZIP/zlib polynomial) with more data
+     * @param crc Running CRC; start with 0
+     * @param data Bytes to add
+     * @param size Number of bytes
+     * @return Updated CRC
+     */
+    static uint32_t crc32(uint32_t crc, const unsigned char* data, size_t size);
+};
+
+#endif // INFLATER_H
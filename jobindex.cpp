@@ -0,0 +1,146 @@
+#include "jobindex.h"
+
+#include <algorithm>
+#include <atomic>
+
+namespace {
+
+std::atomic<quint64> g_nextRevision { 1 };
+
+// "03" and "3" name the same month
+QString normalizedValue(const QString& value)
+{
+    bool ok = false;
+    const int number = value.trimmed().toInt(&ok);
+    return ok ? QString::number(number) : value.trimmed();
+}
+
+} // namespace
+
+JobIndex::JobIndex(const QStringList& keyFields, Loader loader)
+    : m_keyFields(keyFields)
+    , m_loader(std::move(loader))
+{
+    bumpRevision();
+}
+
+const QList<JobIndex::JobRow>& JobIndex::rows()
+{
+    if (!m_loaded) {
+        load(m_loader ? m_loader() : QList<JobRow>());
+    }
+    return m_rows;
+}
+
+void JobIndex::prime(const QList<JobRow>& rows, quint64 writeCountAtRead)
+{
+    if (m_loaded || writeCountAtRead != m_writeCount) {
+        return;
+    }
+    load(rows);
+}
+
+void JobIndex::load(QList<JobRow> rows)
+{
+    m_rows = std::move(rows);
+    std::stable_sort(m_rows.begin(), m_rows.end(), [this](const JobRow& a, const JobRow& b) {
+        return isNewer(a, b);
+    });
+    // An empty tab stays loaded; managers invalidate() when their database is (re)initialized
+    m_loaded = true;
+    bumpRevision();
+}
+
+void JobIndex::upsert(const JobRow& row)
+{
+    ++m_writeCount;
+    if (!m_loaded) {
+        return;
+    }
+
+    const QString key = keyOf(row);
+    for (int i = 0; i < m_rows.size(); ++i) {
+        if (keyOf(m_rows.at(i)) == key) {
+            if (m_rows.at(i) == row) {
+                return;
+            }
+            m_rows.removeAt(i);
+            break;
+        }
+    }
+
+    const auto position = std::upper_bound(m_rows.begin(), m_rows.end(), row,
+                                           [this](const JobRow& a, const JobRow& b) {
+                                               return isNewer(a, b);
+                                           });
+    m_rows.insert(position, row);
+    bumpRevision();
+}
+
+void JobIndex::remove(const JobRow& match)
+{
+    ++m_writeCount;
+    if (!m_loaded) {
+        return;
+    }
+
+    const auto matches = [&match](const JobRow& row) {
+        for (auto it = match.constBegin(); it != match.constEnd(); ++it) {
+            if (normalizedValue(row.value(it.key())) != normalizedValue(it.value())) {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    const auto first = std::remove_if(m_rows.begin(), m_rows.end(), matches);
+    if (first != m_rows.end()) {
+        m_rows.erase(first, m_rows.end());
+        bumpRevision();
+    }
+}
+
+void JobIndex::invalidate()
+{
+    ++m_writeCount;
+    if (m_loaded) {
+        m_loaded = false;
+        m_rows.clear();
+        bumpRevision();
+    }
+}
+
+QString JobIndex::keyOf(const JobRow& row) const
+{
+    QStringList parts;
+    parts.reserve(m_keyFields.size());
+    for (const QString& field : m_keyFields) {
+        parts.append(normalizedValue(row.value(field)));
+    }
+    return parts.join('|');
+}
+
+bool JobIndex::isNewer(const JobRow& a, const JobRow& b) const
+{
+    for (const QString& field : m_keyFields) {
+        bool aOk = false;
+        bool bOk = false;
+        const int av = a.value(field).trimmed().toInt(&aOk);
+        const int bv = b.value(field).trimmed().toInt(&bOk);
+        if (aOk && bOk) {
+            if (av != bv) {
+                return av > bv;
+            }
+        } else if (aOk != bOk) {
+            return aOk;
+        } else if (a.value(field) != b.value(field)) {
+            return a.value(field) > b.value(field);
+        }
+    }
+    return false;
+}
+
+void JobIndex::bumpRevision()
+{
+    m_revision = g_nextRevision.fetch_add(1);
+}
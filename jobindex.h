@@ -0,0 +1,89 @@
+#ifndef JOBINDEX_H
+#define JOBINDEX_H
+
+#include <QList>
+#include <QMap>
+#include <QString>
+#include <QStringList>
+#include <functional>
+
+/**
+ * @brief In-memory, sorted copy of one tab's saved jobs
+ *
+ * Backs the Open Job menu. The owning DB manager loads it once through its
+ * getAllJobs() query and then keeps it in step from its own save/delete
+ * calls, so opening the menu costs no database work. Rows are identified by
+ * the key fields given at construction and kept newest first (key fields
+ * compared numerically, in order).
+ *
+ * Every change bumps revision(), which is unique across all indexes, so a
+ * menu can tell cheaply whether it is still current.
+ */
+class JobIndex
+{
+public:
+    using JobRow = QMap<QString, QString>;
+    using Loader = std::function<QList<JobRow>()>;
+
+    JobIndex(const QStringList& keyFields, Loader loader);
+
+    /**
+     * @brief Rows in index order; loads through the loader on first use
+     */
+    const QList<JobRow>& rows();
+
+    quint64 revision() const { return m_revision; }
+    bool isLoaded() const { return m_loaded; }
+
+    /**
+     * @brief Insert a row or replace the one with the same key fields
+     *
+     * Ignored until the index has been loaded; the first load picks it up.
+     */
+    void upsert(const JobRow& row);
+
+    /**
+     * @brief Remove every row whose values match all fields in match
+     */
+    void remove(const JobRow& match);
+
+    /**
+     * @brief Drop the cached rows; the next rows() call reloads them
+     *
+     * For writes whose effect on the list is not known row by row, and when
+     * the owning manager's database is (re)initialized.
+     */
+    void invalidate();
+
+    /**
+     * @brief Number of upsert/remove/invalidate calls so far, loaded or not
+     *
+     * Taken before reading the job list off the GUI thread and handed back
+     * to prime() with the rows.
+     */
+    quint64 writeCount() const { return m_writeCount; }
+
+    /**
+     * @brief Load the index from rows read asynchronously
+     *
+     * Ignored if the index is already loaded or was written to since
+     * writeCount() was taken, as the rows may miss that write; rows() then
+     * loads through the loader as usual.
+     */
+    void prime(const QList<JobRow>& rows, quint64 writeCountAtRead);
+
+private:
+    void load(QList<JobRow> rows);
+    QString keyOf(const JobRow& row) const;
+    bool isNewer(const JobRow& a, const JobRow& b) const;
+    void bumpRevision();
+
+    QStringList m_keyFields;
+    Loader m_loader;
+    QList<JobRow> m_rows;
+    bool m_loaded = false;
+    quint64 m_revision = 0;
+    quint64 m_writeCount = 0;
+};
+
+#endif // JOBINDEX_H
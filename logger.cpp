@@ -1,8 +1,17 @@
 #include "logger.h"
 #include <QDebug>
 #include <QDir>
-#include <QTextStream>
 #include <QMutexLocker>
+#include <QFileInfo>
+#include <chrono>
+
+namespace {
+// Queue capacity must comfortably absorb a burst of script output between flushes
+constexpr size_t kLogQueueCapacity = 16384;
+constexpr int kDefaultBatchSize = 256;
+constexpr int kDefaultFlushIntervalMs = 250;
+constexpr int kMaxBatchBytes = 256 * 1024;
+}
 
 // Static instance
 Logger& Logger::instance()
@@ -14,7 +23,14 @@ Logger& Logger::instance()
 Logger::Logger()
     : QObject(nullptr),
     m_logToConsole(true),
-    m_initialized(false)
+    m_initialized(false),
+    m_queue(new MpscRingBuffer<QString>(kLogQueueCapacity)),
+    m_stopWriter(true),
+    m_batchSize(kDefaultBatchSize),
+    m_flushIntervalMs(kDefaultFlushIntervalMs),
+    m_droppedCount(0),
+    m_writtenCount(0),
+    m_activeProducers(0)
 {
     // No qDebug logging in constructor
 }
@@ -26,34 +42,45 @@ Logger::~Logger()
 
 bool Logger::initialize(const QString& logFilePath, bool logToConsole)
 {
-    QMutexLocker locker(&m_mutex);
-
-    // If already initialized, close the existing file
-    if (m_initialized && m_logFile.isOpen()) {
-        m_logFile.close();
-    }
-
-    // Set up the new log file
-    m_logFile.setFileName(logFilePath);
-    m_logToConsole = logToConsole;
+    {
+        QMutexLocker locker(&m_mutex);
+
+        // If already initialized, drain and close the existing file
+        m_initialized = false;
+        stopWriter();
+        {
+            std::lock_guard<std::mutex> drainLock(m_drainMutex);
+            if (m_logFile.isOpen()) {
+                m_logFile.close();
+            }
+
+            // Set up the new log file
+            m_logFile.setFileName(logFilePath);
+        }
+        m_logToConsole = logToConsole;
+
+        // Create the directory if it doesn't exist
+        QFileInfo fileInfo(logFilePath);
+        QDir dir = fileInfo.dir();
+        if (!dir.exists()) {
+            if (!dir.mkpath(".")) {
+                return false;
+            }
+        }
 
-    // Create the directory if it doesn't exist
-    QFileInfo fileInfo(logFilePath);
-    QDir dir = fileInfo.dir();
-    if (!dir.exists()) {
-        if (!dir.mkpath(".")) {
-            return false;
+        // Open the log file
+        {
+            std::lock_guard<std::mutex> drainLock(m_drainMutex);
+            if (!m_logFile.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text)) {
+                return false;
+            }
         }
-    }
 
-    // Open the log file
-    if (!m_logFile.open(QIODevice::WriteOnly | QIODevice::Text | QIODevice::Append)) {
-        return false;
+        startWriter();
+        m_initialized = true;
     }
 
-    m_initialized = true;
-
-    // Log initialization without using too much debugging
+    // Log initialization outside the lock; log() takes m_mutex itself
     info("Logger initialized", "Logger::initialize");
 
     return true;
@@ -86,13 +113,20 @@ void Logger::fatal(const QString& message, const QString& source)
 
 void Logger::log(LogLevel level, const QString& message, const QString& source)
 {
-    QMutexLocker locker(&m_mutex);
-
     QString formattedMessage = formatLogMessage(level, message, source);
 
-    // Write to file if initialized
-    if (m_initialized && m_logFile.isOpen()) {
-        writeToFile(formattedMessage);
+    // Hand off to the writer thread if initialized; fatal messages are flushed immediately.
+    // The producer count (seq_cst on both sides) lets stopWriter() wait for a push
+    // that already passed the check.
+    m_activeProducers.fetch_add(1);
+    if (m_initialized.load()) {
+        enqueueForWrite(formattedMessage);
+        m_activeProducers.fetch_sub(1);
+        if (level == LogLevel::Fatal) {
+            flush();
+        }
+    } else {
+        m_activeProducers.fetch_sub(1);
     }
 
     // Write to console if enabled
@@ -115,8 +149,11 @@ void Logger::log(LogLevel level, const QString& message, const QString& source)
     }
 
     // Call custom handler if set
-    if (m_customHandler) {
-        m_customHandler(level, formattedMessage);
+    {
+        QMutexLocker locker(&m_mutex);
+        if (m_customHandler) {
+            m_customHandler(level, formattedMessage);
+        }
     }
 
     // Re-enable signal emission - this was previously commented out to test for crash
@@ -133,11 +170,41 @@ void Logger::close()
 {
     QMutexLocker locker(&m_mutex);
 
-    if (m_initialized && m_logFile.isOpen()) {
+    // Stop accepting new file messages, then drain what is already queued
+    m_initialized = false;
+    stopWriter();
+
+    std::lock_guard<std::mutex> drainLock(m_drainMutex);
+    if (m_logFile.isOpen()) {
         m_logFile.close();
     }
+}
 
-    m_initialized = false;
+void Logger::flush()
+{
+    drainQueue();
+}
+
+void Logger::setFlushPolicy(int batchSize, int flushIntervalMs)
+{
+    m_batchSize = qMax(1, batchSize);
+    m_flushIntervalMs = qMax(1, flushIntervalMs);
+    m_writerWake.notify_one();
+}
+
+quint64 Logger::droppedMessageCount() const
+{
+    return m_droppedCount.load(std::memory_order_relaxed);
+}
+
+quint64 Logger::queuedMessageCount() const
+{
+    return static_cast<quint64>(m_queue->approximateSize());
+}
+
+quint64 Logger::writtenMessageCount() const
+{
+    return m_writtenCount.load(std::memory_order_relaxed);
 }
 
 bool Logger::isInitialized() const
@@ -168,11 +235,104 @@ QString Logger::formatLogMessage(LogLevel level, const QString& message, const Q
     return formattedMessage;
 }
 
-void Logger::writeToFile(const QString& message)
+void Logger::enqueueForWrite(const QString& message)
 {
-    QTextStream out(&m_logFile);
-    out << message << "\n";
-    out.flush();
+    QString line = message;
+    if (!m_queue->tryPush(std::move(line))) {
+        // Queue is full; never block the caller on disk I/O
+        m_droppedCount.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    if (m_queue->approximateSize() >= static_cast<size_t>(m_batchSize.load(std::memory_order_relaxed))) {
+        m_writerWake.notify_one();
+    }
+}
+
+void Logger::startWriter()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_writerMutex);
+        m_stopWriter = false;
+    }
+    m_writerThread = std::thread(&Logger::writerLoop, this);
+}
+
+void Logger::stopWriter()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_writerMutex);
+        m_stopWriter = true;
+    }
+    m_writerWake.notify_all();
+
+    if (m_writerThread.joinable()) {
+        m_writerThread.join();
+    }
+
+    // Callers clear m_initialized first; a log() that saw it set may still be
+    // pushing, so let it finish before the final drain or its message is lost
+    while (m_activeProducers.load() > 0) {
+        std::this_thread::yield();
+    }
+
+    // Anything enqueued after the writer's last pass
+    drainQueue();
+}
+
+void Logger::writerLoop()
+{
+    std::unique_lock<std::mutex> lock(m_writerMutex);
+    while (!m_stopWriter) {
+        const auto interval = std::chrono::milliseconds(m_flushIntervalMs.load(std::memory_order_relaxed));
+        m_writerWake.wait_for(lock, interval, [this]() {
+            return m_stopWriter
+                   || m_queue->approximateSize() >= static_cast<size_t>(m_batchSize.load(std::memory_order_relaxed));
+        });
+
+        lock.unlock();
+        drainQueue();
+        lock.lock();
+    }
+}
+
+void Logger::drainQueue()
+{
+    // The drain mutex keeps the ring buffer single-consumer across the writer
+    // thread and synchronous flush() callers
+    std::lock_guard<std::mutex> drainLock(m_drainMutex);
+
+    QByteArray batch;
+    QString line;
+    quint64 count = 0;
+
+    while (m_queue->tryPop(line)) {
+        batch.append(line.toUtf8());
+        batch.append('\n');
+        ++count;
+
+        if (batch.size() >= kMaxBatchBytes) {
+            writeToFile(batch);
+            batch.clear();
+        }
+    }
+
+    if (!batch.isEmpty()) {
+        writeToFile(batch);
+    }
+
+    m_writtenCount.fetch_add(count, std::memory_order_relaxed);
+}
+
+void Logger::writeToFile(const QByteArray& batch)
+{
+    // Caller holds m_drainMutex
+    if (!m_logFile.isOpen()) {
+        return;
+    }
+
+    m_logFile.write(batch);
+    m_logFile.flush();
 }
 
 QString Logger::levelToString(LogLevel level) const
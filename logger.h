@@ -6,7 +6,14 @@
 #include <QFile>
 #include <QDateTime>
 #include <QMutex>
+#include <atomic>
+#include <condition_variable>
 #include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "mpscringbuffer.h"
 
 /**
  * @brief Log level enumeration
@@ -27,6 +34,10 @@ enum class LogLevel {
  * - Output logs to the console and Qt Creator's Application Output window
  * - Emit signals for log messages that can be displayed in the UI
  * - Format log messages with timestamps and log levels
+ *
+ * File output is asynchronous: log() formats the line and pushes it onto a
+ * lock-free ring buffer, and a background writer thread drains it in batches
+ * (by size or interval). Fatal messages and close() flush synchronously.
  */
 class Logger : public QObject
 {
@@ -92,9 +103,38 @@ public:
 
     /**
      * @brief Close the log file
+     *
+     * Stops the writer thread after draining any queued messages.
      */
     void close();
 
+    /**
+     * @brief Synchronously write every queued message to the log file
+     */
+    void flush();
+
+    /**
+     * @brief Configure when the writer thread flushes a batch
+     * @param batchSize Queued message count that wakes the writer early
+     * @param flushIntervalMs Maximum time a message waits before being written
+     */
+    void setFlushPolicy(int batchSize, int flushIntervalMs);
+
+    /**
+     * @brief Number of messages dropped because the queue was full
+     */
+    quint64 droppedMessageCount() const;
+
+    /**
+     * @brief Number of messages waiting to be written to the log file
+     */
+    quint64 queuedMessageCount() const;
+
+    /**
+     * @brief Number of messages written to the log file since startup
+     */
+    quint64 writtenMessageCount() const;
+
     /**
      * @brief Check if the logger is initialized
      * @return True if initialized
@@ -127,7 +167,7 @@ private:
     // Log file handling
     QFile m_logFile;
     bool m_logToConsole;
-    bool m_initialized;
+    std::atomic<bool> m_initialized;
 
     // Custom log handler
     std::function<void(LogLevel, const QString&)> m_customHandler;
@@ -135,9 +175,27 @@ private:
     // Thread safety
     QMutex m_mutex;
 
+    // Asynchronous file writer
+    std::unique_ptr<MpscRingBuffer<QString>> m_queue;
+    std::thread m_writerThread;
+    std::mutex m_writerMutex;
+    std::condition_variable m_writerWake;
+    bool m_stopWriter;
+    std::mutex m_drainMutex;
+    std::atomic<int> m_batchSize;
+    std::atomic<int> m_flushIntervalMs;
+    std::atomic<quint64> m_droppedCount;
+    std::atomic<quint64> m_writtenCount;
+    std::atomic<int> m_activeProducers;     // log() calls between the initialized check and the push
+
     // Helper methods
     QString formatLogMessage(LogLevel level, const QString& message, const QString& source = QString()) const;
-    void writeToFile(const QString& message);
+    void enqueueForWrite(const QString& message);
+    void startWriter();
+    void stopWriter();
+    void writerLoop();
+    void drainQueue();
+    void writeToFile(const QByteArray& batch);
     QString levelToString(LogLevel level) const;
 };
 
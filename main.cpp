@@ -9,7 +9,10 @@
 #include <QSqlDatabase>
 
 #include "mainwindow.h"
+#include "databaseexecutor.h"
 #include "databasemanager.h"
+#include "querystats.h"
+#include "tracer.h"
 #include "qloggingcategory.h"
 
 // Global log file for application-wide logging
@@ -41,6 +44,39 @@ void setupLogFile()
     }
 }
 
+// --query-stats[=path] writes the query statistics report on exit;
+// --slow-query-ms=N sets the slow query threshold
+QString queryStatsReportPath(const QStringList& arguments, bool* requested)
+{
+    *requested = false;
+    QString path;
+    for (const QString& argument : arguments) {
+        if (argument == "--query-stats") {
+            *requested = true;
+        } else if (argument.startsWith("--query-stats=")) {
+            *requested = true;
+            path = argument.mid(QString("--query-stats=").size());
+        } else if (argument.startsWith("--slow-query-ms=")) {
+            bool ok = false;
+            const double ms = argument.mid(QString("--slow-query-ms=").size()).toDouble(&ok);
+            if (ok && ms >= 0) {
+                QueryStats::instance().setSlowThresholdMs(ms);
+            } else {
+                qWarning() << "Ignoring invalid" << argument;
+            }
+        }
+    }
+
+    if (*requested && path.isEmpty()) {
+        // Same directory as the session log
+        const QString logDir = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + "/logs";
+        QDir().mkpath(logDir);
+        path = QString("%1/goji_query_stats_%2.txt")
+                   .arg(logDir, QDateTime::currentDateTime().toString("yyyyMMdd_hhmmss"));
+    }
+    return path;
+}
+
 void messageHandler(QtMsgType type, const QMessageLogContext& /*context*/, const QString& msg)
 {
     // Format the message based on type
@@ -80,6 +116,9 @@ void messageHandler(QtMsgType type, const QMessageLogContext& /*context*/, const
 
 int main(int argc, char *argv[])
 {
+    // Start the trace clock first so the whole startup is covered
+    Tracer::instance().configureFromEnvironment();
+
     // Set up logging before anything else
     setupLogFile();
     qInstallMessageHandler(messageHandler);
@@ -92,6 +131,10 @@ int main(int argc, char *argv[])
     app.setOrganizationName("Yourorganization");
     app.setOrganizationDomain("yourdomain.com");
 
+    QueryStats::instance().configureFromEnvironment();
+    bool queryStatsRequested = false;
+    const QString queryStatsPath = queryStatsReportPath(app.arguments(), &queryStatsRequested);
+
     QFile styleFile(":/resources/styles/goji_theme.qss");
     if (styleFile.open(QIODevice::ReadOnly | QIODevice::Text)) {
         const QString styleSheet = QString::fromUtf8(styleFile.readAll());
@@ -160,9 +203,12 @@ int main(int argc, char *argv[])
 
         // Initialize database with single, reliable approach
         qDebug() << "Initializing database with standard approach";
-        if (!DatabaseManager::instance()->initialize(dbPath)) {
-            qCritical() << "Standard database initialization failed";
-            throw std::runtime_error("Failed to initialize database with standard approach");
+        {
+            TRACE_SCOPE("startup", "DatabaseManager::initialize");
+            if (!DatabaseManager::instance()->initialize(dbPath)) {
+                qCritical() << "Standard database initialization failed";
+                throw std::runtime_error("Failed to initialize database with standard approach");
+            }
         }
 
         qDebug() << "Database initialization successful";
@@ -172,12 +218,36 @@ int main(int argc, char *argv[])
         // (Click left margin next to the line below)
         // ──────────────────────────────────────────────
         MainWindow mainWindow;
-        mainWindow.show();
+        {
+            TRACE_SCOPE("startup", "MainWindow::show");
+            mainWindow.show();
+        }
 
         qDebug() << "Main window created and shown";
         qDebug() << "Entering application event loop";
 
-        return app.exec();
+        const int exitCode = app.exec();
+
+        // Finish queued database work, then commit queued terminal log rows before the process exits
+        DatabaseExecutor::instance().shutdown();
+        DatabaseManager::instance()->shutdownTerminalLogQueue();
+        DatabaseManager::instance()->flushSlowQueryLog();
+
+        if (queryStatsRequested) {
+            QString error;
+            if (QueryStats::instance().writeReport(queryStatsPath, &error)) {
+                qDebug() << "Query statistics written to:" << queryStatsPath;
+            } else {
+                qWarning() << "Failed to write query statistics:" << error;
+            }
+        }
+
+        const QString tracePath = Tracer::instance().writeExitTrace();
+        if (!tracePath.isEmpty()) {
+            qDebug() << "Trace written to:" << tracePath;
+        }
+
+        return exitCode;
     }
     catch (const std::exception& e) {
         qCritical() << "Fatal error:" << e.what();
@@ -28,9 +28,12 @@
 #include <QDesktopServices>
 #include <QDialog>
 #include <QDir>
+#include <QElapsedTimer>
+#include <QFileDialog>
 #include <QFileInfo>
 #include <QFileIconProvider>
 #include <QFontDatabase>
+#include <QHash>
 #include <QInputDialog>
 #include <QLabel>
 #include <QLineEdit>
@@ -39,13 +42,16 @@
 #include <QMainWindow>
 #include <QMap>
 #include <QMenu>
+#include <QMenuBar>
 #include <QMessageBox>
 #include <QProcess>
+#include <QProgressBar>
 #include <QPushButton>
 #include <QRegularExpression>
 #include <QSet>
 #include <QSignalBlocker>
 #include <QSqlError>
+#include <QStatusBar>
 #include <QSqlQuery>
 #include <QStandardPaths>
 #include <QTemporaryFile>
@@ -64,7 +70,10 @@
 
 // Custom includes
 #include "dropwindow.h"
+#include "filetransfer.h"
 #include "logger.h"
+#include "querystats.h"
+#include "tracer.h"
 #include "ui_GOJI.h"
 #include "updatedialog.h"
 #include "updatesettingsdialog.h"
@@ -76,6 +85,9 @@
 #include "tmtarragoncontroller.h"
 #include "tmtarragondbmanager.h"
 #include "databasemanager.h"
+#include "csvcombiner.h"
+#include "csvsplitter.h"
+#include "recordcounter.h"
 #include "tmflercontroller.h"
 #include "tmflerdbmanager.h"
 #include "tmhealthycontroller.h"
@@ -90,6 +102,7 @@
 #include "jobcontextutils.h"
 #include "meterrateservice.h"
 #include "openjobmenuhelper.h"
+#include "printmanifeststore.h"
 #include "terminaloutputhelper.h"
 #include "misccombinedatadialog.h"
 #include "miscdarkreportdialog.h"
@@ -157,6 +170,10 @@ padding: 5px;
 )";
 
 const QString kRuntimeScriptsRoot = QStringLiteral("C:/Goji/scripts");
+
+// Dynamic properties used to sync the Manage Scripts menus in place
+const char* const kScriptMenuSignatureProperty = "scriptTreeSignature";
+const char* const kScriptMenuPathProperty = "scriptTreePath";
 } // namespace
 
 MainWindow::MainWindow(QWidget* parent)
@@ -177,6 +194,9 @@ MainWindow::MainWindow(QWidget* parent)
     m_exitShortcut(nullptr),
     m_tabCycleShortcut(nullptr)
 {
+    TRACE_SCOPE("startup", "MainWindow::MainWindow");
+    m_startupTimer.start();
+
     // Inactivity timer setup (single-shot) and global event filter
     if (!m_inactivityTimer) {
         m_inactivityTimer = new QTimer(this);
@@ -189,7 +209,10 @@ MainWindow::MainWindow(QWidget* parent)
 
     try {
         // Setup UI first
-        ui->setupUi(this);
+        {
+            TRACE_SCOPE("startup", "Ui::setupUi");
+            ui->setupUi(this);
+        }
         applyTerminalWindowStyling();
         
         // Apply global ALL-CAPS font policy for QPushButton and QToolButton
@@ -345,31 +368,8 @@ MainWindow::MainWindow(QWidget* parent)
         m_updateManager = new UpdateManager(m_settings, this);
         if (!m_updateManager) throw std::runtime_error("Failed to create UpdateManager");
 
-        // Create controllers
-        try { m_fhController = new FHController(this); } catch (...) { m_fhController = nullptr; }
-        try { m_tmWeeklyPCController = new TMWeeklyPCController(this); } catch (...) { m_tmWeeklyPCController = nullptr; }
-        try { m_tmWeeklyPIDOController = new TMWeeklyPIDOController(this); } catch (...) { m_tmWeeklyPIDOController = nullptr; }
-        try { m_tmTermController = new TMTermController(this); } catch (...) { m_tmTermController = nullptr; }
-        try { m_tmTarragonController = new TMTarragonController(this); } catch (...) { m_tmTarragonController = nullptr; }
-        try { m_tmFlerController = new TMFLERController(this); } catch (...) { m_tmFlerController = nullptr; }
-        try { m_tmHealthyController = new TMHealthyController(this); } catch (...) { m_tmHealthyController = nullptr; }
-        try { m_tmBrokenController = new TMBrokenController(this); } catch (...) { m_tmBrokenController = nullptr; }
-        try { m_tmFarmController = new TMFarmController(this); } catch (...) { m_tmFarmController = nullptr; }
-        try { m_tmCAController = new TMCAController(this); } catch (...) { m_tmCAController = nullptr; }
-        try { m_ailiController = new AILIController(this, ui, this); } catch (...) { m_ailiController = nullptr; }
-
-
-
-        // Initialize database managers
-        if (!TMWeeklyPCDBManager::instance()->initialize()) throw std::runtime_error("Failed to initialize TM Weekly PC database manager");
-        if (!TMTermDBManager::instance()->initialize()) throw std::runtime_error("Failed to initialize TM Term database manager");
-        if (!TMTarragonDBManager::instance()->initialize()) throw std::runtime_error("Failed to initialize TM Tarragon database manager");
-        if (!TMFLERDBManager::instance()->initializeTables()) throw std::runtime_error("Failed to initialize TM FLER database manager");
-        if (!TMHealthyDBManager::instance()->initializeDatabase()) throw std::runtime_error("Failed to initialize TM HEALTHY database manager");
-        if (!TMBrokenDBManager::instance()->initializeDatabase()) throw std::runtime_error("Failed to initialize TM BROKEN database manager");
-        // TMFarmDBManager initializes via ensureTables() in constructor (no initializeDatabase method)
-        if (!TMFarmDBManager::instance()->isInitialized()) throw std::runtime_error("Failed to initialize TM FARM database manager");
-        if (!FHDBManager::instance()->initializeTables()) throw std::runtime_error("Failed to initialize FOUR HANDS database manager");
+        // Tab controllers and their database tables are created on first use
+        // (ensureTabActivated); the rest are warmed after the window is shown.
 
         // Connect UpdateManager signals
         connect(m_updateManager, &UpdateManager::logMessage, this, &MainWindow::logToTerminal);
@@ -446,10 +446,22 @@ MainWindow::MainWindow(QWidget* parent)
             }
         }
 
-        setupSignalSlots();
+        // Only the tab the window opens on is wired before it is shown
+        ensureTabActivated(getCurrentJobContext());
+
+        {
+            TRACE_SCOPE("startup", "setupSignalSlots");
+            setupSignalSlots();
+        }
         setupKeyboardShortcuts();
-        setupMenus();
-        initWatchersAndTimers();
+        {
+            TRACE_SCOPE("startup", "setupMenus");
+            setupMenus();
+        }
+        {
+            TRACE_SCOPE("startup", "initWatchersAndTimers");
+            initWatchersAndTimers();
+        }
 
         // Enable jobs for TRACHMAR (and others if needed)
         if (ui->customerTab && ui->customerTab->count() > 0) {
@@ -463,9 +475,23 @@ MainWindow::MainWindow(QWidget* parent)
         }
 
         // Ensure meter rates table exists
-        { MeterRateService meterRateSvc(m_dbManager); meterRateSvc.ensureMeterRatesTableExists(); }
+        {
+            TRACE_SCOPE("startup", "ensureMeterRatesTableExists");
+            MeterRateService meterRateSvc(m_dbManager);
+            meterRateSvc.ensureMeterRatesTableExists();
+        }
 
         logToTerminal(tr("Goji started: %1").arg(QDateTime::currentDateTime().toString()));
+        Logger::instance().info(QString("Startup: main window constructed in %1 ms")
+                                    .arg(m_startupTimer.elapsed()));
+        const SchemaMigrationStats schemaStats = m_dbManager->schemaMigrationStats();
+        Logger::instance().info(QString("Startup: schema %1 module(s) current, %2 migrated (%3 step(s)), "
+                                        "checked in %4 ms, skipped %5 ms of migrations")
+                                    .arg(schemaStats.modulesCurrent)
+                                    .arg(schemaStats.modulesMigrated)
+                                    .arg(schemaStats.migrationsApplied)
+                                    .arg(schemaStats.checkMs)
+                                    .arg(schemaStats.skippedMs));
 
     } catch (const std::exception& e) {
         QMessageBox::critical(this, "Startup Error",
@@ -913,17 +939,60 @@ void MainWindow::closeEvent(QCloseEvent *event)
         Logger::instance().info("No active jobs found to close on app exit");
     }
 
+    // Closing moves job files back to HOME in the background; exit once that has finished
+    if (FileTransferQueue::instance()->isBusy()) {
+        Logger::instance().info("Waiting for file transfers to finish before exit");
+        m_closeAfterTransfers = true;
+        event->ignore();
+        return;
+    }
+
+    // Persist any terminal log rows still waiting for a group commit
+    if (m_dbManager) {
+        m_dbManager->flushTerminalLogs();
+    }
+
     event->accept();
 }
 
+QProgressBar* MainWindow::scriptProgressBar()
+{
+    if (!m_scriptProgressBar) {
+        m_scriptProgressBar = new QProgressBar(this);
+        m_scriptProgressBar->setMaximumWidth(320);
+        m_scriptProgressBar->setTextVisible(true);
+        m_scriptProgressBar->hide();
+        statusBar()->addPermanentWidget(m_scriptProgressBar);
+    }
+    return m_scriptProgressBar;
+}
+
 void MainWindow::setupUi()
 {
+    TRACE_FUNCTION("startup");
     Logger::instance().info("Setting up UI elements...");
 
+    setupMiscScriptWiring();
+    setupFileTransferWiring();
+}
+
+bool MainWindow::setupTMWeeklyPCTab()
+{
+    if (!m_tmWeeklyPCController) {
+        try { m_tmWeeklyPCController = new TMWeeklyPCController(this); } catch (...) { m_tmWeeklyPCController = nullptr; }
+    }
+    if (!TMWeeklyPCDBManager::instance()->initialize()) {
+        Logger::instance().error("Failed to initialize TM Weekly PC database manager");
+        logToTerminal("Failed to initialize TM Weekly PC database manager");
+        return false;
+    }
+    TMWeeklyPCDBManager::instance()->primeJobIndexAsync(this);
+
     // Setup TM WEEKLY PC controller if available
     if (m_tmWeeklyPCController) {
         // Connect the textBrowser to the controller FIRST
         m_tmWeeklyPCController->setTextBrowser(ui->textBrowserTMWPC);
+        m_tmWeeklyPCController->setScriptProgressBar(scriptProgressBar());
 
     // THEN initialize TM WEEKLY PC controller with UI elements
     m_tmWeeklyPCController->initializeUI(
@@ -967,6 +1036,15 @@ void MainWindow::setupUi()
                 this, &MainWindow::onJobClosed);
     }
 
+    return m_tmWeeklyPCController != nullptr;
+}
+
+bool MainWindow::setupTMWeeklyPIDOTab()
+{
+    if (!m_tmWeeklyPIDOController) {
+        try { m_tmWeeklyPIDOController = new TMWeeklyPIDOController(this); } catch (...) { m_tmWeeklyPIDOController = nullptr; }
+    }
+
     // Setup TM WEEKLY PACK/IDO controller if available
     if (m_tmWeeklyPIDOController) {
         // Connect the textBrowser to the PIDO controller FIRST
@@ -1000,6 +1078,20 @@ void MainWindow::setupUi()
         Logger::instance().warning("TMWeeklyPIDOController is null, skipping UI setup");
     }
 
+    return m_tmWeeklyPIDOController != nullptr;
+}
+
+bool MainWindow::setupTMTermTab()
+{
+    if (!m_tmTermController) {
+        try { m_tmTermController = new TMTermController(this); } catch (...) { m_tmTermController = nullptr; }
+    }
+    if (!TMTermDBManager::instance()->initialize()) {
+        Logger::instance().error("Failed to initialize TM Term database manager");
+        logToTerminal("Failed to initialize TM Term database manager");
+        return false;
+    }
+
     // Setup TM TERM controller if available
     if (m_tmTermController) {
         // Connect the textBrowser to the TERM controller FIRST
@@ -1037,6 +1129,20 @@ void MainWindow::setupUi()
         Logger::instance().warning("TMTermController is null, skipping UI setup");
     }
 
+    return m_tmTermController != nullptr;
+}
+
+bool MainWindow::setupTMTarragonTab()
+{
+    if (!m_tmTarragonController) {
+        try { m_tmTarragonController = new TMTarragonController(this); } catch (...) { m_tmTarragonController = nullptr; }
+    }
+    if (!TMTarragonDBManager::instance()->initialize()) {
+        Logger::instance().error("Failed to initialize TM Tarragon database manager");
+        logToTerminal("Failed to initialize TM Tarragon database manager");
+        return false;
+    }
+
     // Setup TM TARRAGON controller if available
     if (m_tmTarragonController) {
         // Connect the textBrowser to the TARRAGON controller FIRST
@@ -1074,6 +1180,20 @@ void MainWindow::setupUi()
         Logger::instance().warning("TMTarragonController is null, skipping UI setup");
     }
 
+    return m_tmTarragonController != nullptr;
+}
+
+bool MainWindow::setupTMFLERTab()
+{
+    if (!m_tmFlerController) {
+        try { m_tmFlerController = new TMFLERController(this); } catch (...) { m_tmFlerController = nullptr; }
+    }
+    if (!TMFLERDBManager::instance()->initializeTables()) {
+        Logger::instance().error("Failed to initialize TM FLER database manager");
+        logToTerminal("Failed to initialize TM FLER database manager");
+        return false;
+    }
+
     // Set up TMFLER controller with UI widgets
     if (m_tmFlerController) {
         // Safely cast the widget to DropWindow, with null check
@@ -1101,6 +1221,7 @@ void MainWindow::setupUi()
         m_tmFlerController->setTextBrowser(ui->textBrowserTMFLER);
         m_tmFlerController->setTracker(ui->trackerTMFLER);
         m_tmFlerController->setDropWindow(dropWindowTMFLER);  // CRITICAL: Connect drop window
+        m_tmFlerController->setScriptProgressBar(scriptProgressBar());
 
         // Connect auto-save timer signals for TMFLER
         connect(m_tmFlerController, &TMFLERController::jobOpened, this, [this]() {
@@ -1117,6 +1238,15 @@ void MainWindow::setupUi()
         Logger::instance().warning("TMFLERController is null, skipping UI setup");
     }
 
+    return m_tmFlerController != nullptr;
+}
+
+bool MainWindow::setupTMCATab()
+{
+    if (!m_tmCAController) {
+        try { m_tmCAController = new TMCAController(this); } catch (...) { m_tmCAController = nullptr; }
+    }
+
     // Setup TMCA controller (peer-level, not nested under TMFLER)
     {
         DropWindow* dropWindowTMCA = nullptr;
@@ -1154,6 +1284,20 @@ void MainWindow::setupUi()
         }
     }
 
+    return m_tmCAController != nullptr;
+}
+
+bool MainWindow::setupTMHealthyTab()
+{
+    if (!m_tmHealthyController) {
+        try { m_tmHealthyController = new TMHealthyController(this); } catch (...) { m_tmHealthyController = nullptr; }
+    }
+    if (!TMHealthyDBManager::instance()->initializeDatabase()) {
+        Logger::instance().error("Failed to initialize TM HEALTHY database manager");
+        logToTerminal("Failed to initialize TM HEALTHY database manager");
+        return false;
+    }
+
     // Setup TM HEALTHY controller if available
     if (m_tmHealthyController) {
         m_tmHealthyController->setTextBrowser(ui->textBrowserTMHB);
@@ -1200,6 +1344,20 @@ void MainWindow::setupUi()
         Logger::instance().warning("TMHealthyController is null, skipping UI setup");
     }
 
+    return m_tmHealthyController != nullptr;
+}
+
+bool MainWindow::setupTMBrokenTab()
+{
+    if (!m_tmBrokenController) {
+        try { m_tmBrokenController = new TMBrokenController(this); } catch (...) { m_tmBrokenController = nullptr; }
+    }
+    if (!TMBrokenDBManager::instance()->initializeDatabase()) {
+        Logger::instance().error("Failed to initialize TM BROKEN database manager");
+        logToTerminal("Failed to initialize TM BROKEN database manager");
+        return false;
+    }
+
     // Setup TM BROKEN controller if available
     if (m_tmBrokenController) {
         m_tmBrokenController->setTextBrowser(ui->textBrowserTMBA);
@@ -1245,6 +1403,21 @@ void MainWindow::setupUi()
     } else {
         Logger::instance().warning("TMBrokenController is null, skipping UI setup");
     }
+
+    return m_tmBrokenController != nullptr;
+}
+
+bool MainWindow::setupTMFarmTab()
+{
+    if (!m_tmFarmController) {
+        try { m_tmFarmController = new TMFarmController(this); } catch (...) { m_tmFarmController = nullptr; }
+    }
+    if (!TMFarmDBManager::instance()->isInitialized()) {
+        Logger::instance().error("Failed to initialize TM FARM database manager");
+        logToTerminal("Failed to initialize TM FARM database manager");
+        return false;
+    }
+
     // Setup TM FARM WORKERS controller if available
     if (m_tmFarmController) {
         // Connect the textBrowser to the controller FIRST
@@ -1282,6 +1455,20 @@ void MainWindow::setupUi()
         Logger::instance().warning("TMFarmController is null, skipping UI setup");
     }
 
+    return m_tmFarmController != nullptr;
+}
+
+bool MainWindow::setupFHTab()
+{
+    if (!m_fhController) {
+        try { m_fhController = new FHController(this); } catch (...) { m_fhController = nullptr; }
+    }
+    if (!FHDBManager::instance()->initializeTables()) {
+        Logger::instance().error("Failed to initialize FOUR HANDS database manager");
+        logToTerminal("Failed to initialize FOUR HANDS database manager");
+        return false;
+    }
+
     // Setup FOUR HANDS controller if available
     if (m_fhController) {
         // Safely cast the widget to DropWindow, with null check
@@ -1389,6 +1576,15 @@ void MainWindow::setupUi()
         Logger::instance().warning("FHController is null, skipping UI setup");
     }
 
+    return m_fhController != nullptr;
+}
+
+bool MainWindow::setupAILITab()
+{
+    if (!m_ailiController) {
+        try { m_ailiController = new AILIController(this, ui, this); } catch (...) { m_ailiController = nullptr; }
+    }
+
     // Setup AILI controller if available
     if (m_ailiController) {
         DropWindow* dropWindowAILI = nullptr;
@@ -1414,7 +1610,89 @@ void MainWindow::setupUi()
         Logger::instance().warning("AILIController is null, skipping UI setup");
     }
 
-    setupMiscScriptWiring();
+    return m_ailiController != nullptr;
+}
+
+bool MainWindow::ensureTabActivated(const QString& tabName)
+{
+    if (tabName.isEmpty() || m_activatedTabs.contains(tabName)) {
+        return true;
+    }
+
+    TRACE_SCOPE_DETAIL("startup", "ensureTabActivated", tabName);
+    QElapsedTimer timer;
+    timer.start();
+
+    bool ok = false;
+    if (tabName == "TMWEEKLYPC") {
+        ok = setupTMWeeklyPCTab();
+    } else if (tabName == "TMWEEKLYPIDO") {
+        ok = setupTMWeeklyPIDOTab();
+    } else if (tabName == "TMTERM") {
+        ok = setupTMTermTab();
+    } else if (tabName == "TMTARRAGON") {
+        ok = setupTMTarragonTab();
+    } else if (tabName == "TMFLER") {
+        ok = setupTMFLERTab();
+    } else if (tabName == "TMCA") {
+        ok = setupTMCATab();
+    } else if (tabName == "TMHEALTHY") {
+        ok = setupTMHealthyTab();
+    } else if (tabName == "TMBROKEN") {
+        ok = setupTMBrokenTab();
+    } else if (tabName == "TMFARMWORKERS") {
+        ok = setupTMFarmTab();
+    } else if (tabName == "FOURHANDS") {
+        ok = setupFHTab();
+    } else if (tabName == "AILI") {
+        ok = setupAILITab();
+    } else {
+        // Tabs without a controller (MISC etc.) need no activation
+        return true;
+    }
+
+    // A failed activation is retried the next time the tab becomes current
+    if (ok) {
+        m_activatedTabs.insert(tabName);
+    }
+    Logger::instance().info(QString("Tab %1 %2 in %3 ms")
+                                .arg(tabName, ok ? "activated" : "failed to activate")
+                                .arg(timer.elapsed()));
+    return ok;
+}
+
+void MainWindow::warmNextTab()
+{
+    if (m_pendingWarmTabs.isEmpty()) {
+        Logger::instance().info(QString("Startup: all tabs ready in %1 ms")
+                                    .arg(m_startupTimer.elapsed()));
+        return;
+    }
+
+    // One tab per event-loop turn keeps the window responsive while warming
+    ensureTabActivated(m_pendingWarmTabs.takeFirst());
+    QTimer::singleShot(0, this, &MainWindow::warmNextTab);
+}
+
+void MainWindow::showEvent(QShowEvent* event)
+{
+    QMainWindow::showEvent(event);
+
+    if (m_tabWarmupStarted) {
+        return;
+    }
+    m_tabWarmupStarted = true;
+
+    // Runs after the pending show/paint events, i.e. once the window is on screen
+    QTimer::singleShot(0, this, [this]() {
+        Logger::instance().info(QString("Startup: window ready in %1 ms")
+                                    .arg(m_startupTimer.elapsed()));
+        m_pendingWarmTabs = {
+            "TMWEEKLYPC", "TMWEEKLYPIDO", "TMTERM", "TMTARRAGON", "TMFLER", "TMCA",
+            "TMHEALTHY", "TMBROKEN", "TMFARMWORKERS", "FOURHANDS", "AILI"
+        };
+        warmNextTab();
+    });
 }
 
 void MainWindow::applyTerminalWindowStyling()
@@ -1433,6 +1711,62 @@ void MainWindow::applyTerminalWindowStyling()
     }
 }
 
+void MainWindow::setupFileTransferWiring()
+{
+    FileTransferQueue* queue = FileTransferQueue::instance();
+
+    m_transferProgressBar = new QProgressBar(this);
+    m_transferProgressBar->setMaximumWidth(320);
+    m_transferProgressBar->setRange(0, 1000);
+    m_transferProgressBar->setTextVisible(true);
+    m_transferProgressBar->hide();
+    statusBar()->addPermanentWidget(m_transferProgressBar);
+
+    m_transferCancelButton = new QPushButton(tr("Cancel transfer"), this);
+    m_transferCancelButton->hide();
+    statusBar()->addPermanentWidget(m_transferCancelButton);
+
+    connect(m_transferCancelButton, &QPushButton::clicked, this, [this, queue]() {
+        m_transferCancelButton->setEnabled(false);
+        m_transferProgressBar->setFormat(tr("Cancelling - rolling back..."));
+        queue->cancelAll();
+    });
+    connect(queue, &FileTransferQueue::busyChanged, this, &MainWindow::onFileTransferBusyChanged);
+    connect(queue, &FileTransferQueue::transferStarted, this, [this](const QString& description) {
+        m_transferProgressBar->setValue(0);
+        m_transferProgressBar->setFormat(description + QStringLiteral(" - %p%"));
+    });
+    connect(queue, &FileTransferQueue::progress, this,
+            [this](qint64 bytesDone, qint64 bytesTotal, int filesDone, int filesTotal) {
+        int value = 0;
+        if (bytesTotal > 0) {
+            value = static_cast<int>(qMin<qint64>(1000, bytesDone * 1000 / bytesTotal));
+        } else if (filesTotal > 0) {
+            value = qMin(1000, filesDone * 1000 / filesTotal);
+        }
+        m_transferProgressBar->setValue(value);
+        m_transferProgressBar->setToolTip(tr("%1 of %2 file(s)").arg(filesDone).arg(filesTotal));
+    });
+}
+
+void MainWindow::onFileTransferBusyChanged(bool busy)
+{
+    // Job folders are half moved: nothing may open, close or run a job until the queue is idle
+    if (centralWidget()) {
+        centralWidget()->setEnabled(!busy);
+    }
+    menuBar()->setEnabled(!busy);
+
+    m_transferProgressBar->setVisible(busy);
+    m_transferCancelButton->setVisible(busy);
+    m_transferCancelButton->setEnabled(true);
+
+    if (!busy && m_closeAfterTransfers) {
+        m_closeAfterTransfers = false;
+        QTimer::singleShot(0, this, &QWidget::close);
+    }
+}
+
 void MainWindow::setupMiscScriptWiring()
 {
     if (!ui) {
@@ -1659,6 +1993,19 @@ void MainWindow::onCombineDataFilesRequested(const QStringList& selectedFiles)
                                      .arg(selectedFiles.size()),
                                  TerminalSeverity::Info);
 
+    // All-CSV selections are combined in-process; spreadsheets still go through the script
+    bool allCsv = true;
+    for (const QString& file : selectedFiles) {
+        if (QFileInfo(file).suffix().compare("csv", Qt::CaseInsensitive) != 0) {
+            allCsv = false;
+            break;
+        }
+    }
+    if (allCsv) {
+        startNativeCsvCombine(selectedFiles, outputPath);
+        return;
+    }
+
     QStringList args;
     args << "--input-files";
     args << selectedFiles;
@@ -1681,6 +2028,79 @@ void MainWindow::onCombineDataFilesRequested(const QStringList& selectedFiles)
                                               TerminalSeverity::Info);
 }
 
+bool MainWindow::startNativeCsvCombine(const QStringList& selectedFiles, const QString& outputPath)
+{
+    if (!m_csvCombiner) {
+        m_csvCombiner = new CsvCombiner(this);
+        connect(m_csvCombiner, &CsvCombiner::progress, this,
+                [this](qint64 rowsWritten, quint64 bytesRead, quint64 bytesTotal) {
+            if (m_miscCombineDataDialog && bytesTotal > 0) {
+                m_miscCombineDataDialog->setStatusMessage(
+                    QString("Combining... %1% (%2 rows)")
+                        .arg(static_cast<int>(bytesRead * 100 / bytesTotal))
+                        .arg(rowsWritten),
+                    TerminalSeverity::Info);
+            }
+        });
+        connect(m_csvCombiner, &CsvCombiner::finished, this, &MainWindow::onCsvCombineFinished);
+    }
+
+    if (!m_csvCombiner->start(selectedFiles, outputPath)) {
+        m_miscCombineDataDialog->setStatusMessage("A combine is already running.", TerminalSeverity::Warning);
+        return false;
+    }
+
+    m_activeMiscWorkflowOperation = MiscWorkflowOperation::CombineRun;
+    m_miscCombineDataDialog->setRunning(true);
+    m_miscCombineDataDialog->setStatusMessage("Combining... 0%", TerminalSeverity::Info);
+    return true;
+}
+
+void MainWindow::onCsvCombineFinished(const CsvCombineResult& result)
+{
+    if (m_activeMiscWorkflowOperation == MiscWorkflowOperation::CombineRun) {
+        m_activeMiscWorkflowOperation = MiscWorkflowOperation::None;
+    }
+
+    if (ui && ui->terminalWindowMISC) {
+        for (const QString& warning : result.warnings) {
+            TerminalOutputHelper::append(ui->terminalWindowMISC,
+                                         QString("WARNING: %1").arg(warning),
+                                         TerminalSeverity::Warning);
+        }
+        if (result.ok) {
+            const double seconds = qMax<qint64>(result.elapsedMs, 1) / 1000.0;
+            TerminalOutputHelper::append(ui->terminalWindowMISC,
+                                         QString("SUCCESS: Wrote %1 row(s) x %2 column(s) in %3 s (%4 rows/s, %5 MB/s).")
+                                             .arg(result.rowsWritten)
+                                             .arg(result.columnCount)
+                                             .arg(seconds, 0, 'f', 2)
+                                             .arg(static_cast<qint64>(result.rowsWritten / seconds))
+                                             .arg(result.bytesRead / (1024.0 * 1024.0) / seconds, 0, 'f', 1),
+                                         TerminalSeverity::Success);
+        } else {
+            TerminalOutputHelper::append(ui->terminalWindowMISC,
+                                         QString("ERROR: %1").arg(result.error),
+                                         TerminalSeverity::Error);
+        }
+    }
+
+    if (!m_miscCombineDataDialog) {
+        return;
+    }
+
+    m_miscCombineDataDialog->setRunning(false);
+    if (result.ok) {
+        m_miscCombineDataDialog->setStatusMessage(
+            "SUCCESS: COMBINED.csv created at C:\\Users\\JCox\\Downloads\\COMBINED.csv",
+            TerminalSeverity::Success);
+    } else {
+        m_miscCombineDataDialog->setStatusMessage(
+            QString("Combine failed: %1").arg(result.error),
+            TerminalSeverity::Error);
+    }
+}
+
 void MainWindow::openRenameHeadersDialog()
 {
     if (!ui || !ui->terminalWindowMISC) {
@@ -1903,6 +2323,23 @@ void MainWindow::onSplitLargeListsLoadRequested(const QString& filePath)
         return;
     }
 
+    // CSV and XLSX are counted in-process; other formats and failures fall back to the script
+    if (!m_recordCounter) {
+        m_recordCounter = new RecordCounter(this);
+        connect(m_recordCounter, &RecordCounter::finished, this, &MainWindow::onSplitRecordCountFinished);
+    }
+    if (m_recordCounter->start(trimmedPath)) {
+        m_pendingSplitInfoFilePath = trimmedPath;
+        m_miscSplitLargeListsDialog->setRunning(true);
+        m_miscSplitLargeListsDialog->setStatusMessage("Loading record count...", TerminalSeverity::Info);
+        return;
+    }
+
+    startSplitInspectScript(trimmedPath);
+}
+
+void MainWindow::startSplitInspectScript(const QString& trimmedPath)
+{
     QStringList args;
     args << "--mode" << "inspect"
          << "--file" << trimmedPath;
@@ -1917,6 +2354,9 @@ void MainWindow::onSplitLargeListsLoadRequested(const QString& filePath)
     if (!m_miscScriptCoordinator
         || !m_miscScriptCoordinator->runScript("SPLIT LARGE LISTS", runtimeScriptPath, args)) {
         m_activeMiscWorkflowOperation = MiscWorkflowOperation::None;
+        m_pendingSplitInfoFilePath.clear();
+        // The native count may have put the dialog into its running state already
+        m_miscSplitLargeListsDialog->setRunning(false);
         m_miscSplitLargeListsDialog->setStatusMessage("Failed to start file inspect.",
                                                        TerminalSeverity::Error);
         return;
@@ -1926,6 +2366,41 @@ void MainWindow::onSplitLargeListsLoadRequested(const QString& filePath)
     m_miscSplitLargeListsDialog->setStatusMessage("Loading record count...", TerminalSeverity::Info);
 }
 
+void MainWindow::onSplitRecordCountFinished(const RecordCountResult& result)
+{
+    if (!ui || !ui->terminalWindowMISC || !m_miscSplitLargeListsDialog
+        || !m_miscSplitLargeListsDialog->isVisible() || result.path != m_pendingSplitInfoFilePath) {
+        return;
+    }
+
+    if (!result.ok) {
+        if (result.supported) {
+            TerminalOutputHelper::append(ui->terminalWindowMISC,
+                                         QString("Native record count failed (%1); using inspect script.")
+                                             .arg(result.error),
+                                         TerminalSeverity::Warning);
+        }
+        startSplitInspectScript(result.path);
+        return;
+    }
+
+    m_miscSplitLargeListsDialog->setRunning(false);
+    m_miscSplitLargeListsDialog->setLoadedFileInfo(result.path,
+                                                   QFileInfo(result.path).completeBaseName(),
+                                                   result.recordCount);
+    m_miscSplitLargeListsDialog->setStatusMessage(
+        QString("Loaded %1 record(s).").arg(result.recordCount),
+        TerminalSeverity::Success);
+    TerminalOutputHelper::append(ui->terminalWindowMISC,
+                                 QString("Loaded split input file: %1 (%2 record(s), %3).")
+                                     .arg(QDir::toNativeSeparators(result.path))
+                                     .arg(result.recordCount)
+                                     .arg(result.fromCache ? QStringLiteral("cached")
+                                                           : QString("counted in %1 ms").arg(result.elapsedMs)),
+                                 TerminalSeverity::Info);
+    m_pendingSplitInfoFilePath.clear();
+}
+
 void MainWindow::onSplitLargeListsRunRequested(const QString& filePath,
                                                int parts,
                                                const QString& outputDirectory,
@@ -1955,6 +2430,12 @@ void MainWindow::onSplitLargeListsRunRequested(const QString& filePath,
         return;
     }
 
+    // CSV input is split in-process; spreadsheets still go through the script
+    if (QFileInfo(trimmedPath).suffix().compare("csv", Qt::CaseInsensitive) == 0) {
+        startNativeCsvSplit(trimmedPath, parts, trimmedOutputDirectory, trimmedBaseName);
+        return;
+    }
+
     QStringList args;
     args << "--mode" << "split"
          << "--file" << trimmedPath
@@ -1987,6 +2468,88 @@ void MainWindow::onSplitLargeListsRunRequested(const QString& filePath,
                                  TerminalSeverity::Info);
 }
 
+bool MainWindow::startNativeCsvSplit(const QString& filePath,
+                                     int parts,
+                                     const QString& outputDirectory,
+                                     const QString& baseName)
+{
+    if (!m_csvSplitter) {
+        m_csvSplitter = new CsvSplitter(this);
+        connect(m_csvSplitter, &CsvSplitter::progress, this, [this](quint64 done, quint64 total) {
+            if (m_miscSplitLargeListsDialog && total > 0) {
+                m_miscSplitLargeListsDialog->setStatusMessage(
+                    QString("Splitting... %1%").arg(static_cast<int>(done * 100 / total)),
+                    TerminalSeverity::Info);
+            }
+        });
+        connect(m_csvSplitter, &CsvSplitter::finished, this, &MainWindow::onCsvSplitFinished);
+    }
+
+    const QString resolvedBaseName = baseName.isEmpty() ? QFileInfo(filePath).completeBaseName() : baseName;
+    if (!m_csvSplitter->start(filePath, parts, outputDirectory, resolvedBaseName)) {
+        m_miscSplitLargeListsDialog->setStatusMessage("A split is already running.", TerminalSeverity::Warning);
+        return false;
+    }
+
+    m_activeMiscWorkflowOperation = MiscWorkflowOperation::SplitRun;
+    m_miscSplitLargeListsDialog->setRunning(true);
+    m_miscSplitLargeListsDialog->setStatusMessage("Splitting... 0%", TerminalSeverity::Info);
+    TerminalOutputHelper::append(ui->terminalWindowMISC,
+                                 QString("Splitting file into %1 part(s): %2")
+                                     .arg(parts)
+                                     .arg(QDir::toNativeSeparators(filePath)),
+                                 TerminalSeverity::Info);
+    TerminalOutputHelper::append(ui->terminalWindowMISC,
+                                 QString("Output directory: %1")
+                                     .arg(QDir::toNativeSeparators(outputDirectory)),
+                                 TerminalSeverity::Info);
+    return true;
+}
+
+void MainWindow::onCsvSplitFinished(const CsvSplitResult& result)
+{
+    if (m_activeMiscWorkflowOperation == MiscWorkflowOperation::SplitRun) {
+        m_activeMiscWorkflowOperation = MiscWorkflowOperation::None;
+    }
+
+    if (ui && ui->terminalWindowMISC) {
+        if (result.ok) {
+            for (const CsvSplitPart& part : result.parts) {
+                TerminalOutputHelper::append(ui->terminalWindowMISC,
+                                             QString("%1: %2 records")
+                                                 .arg(QFileInfo(part.path).fileName())
+                                                 .arg(part.records),
+                                             TerminalSeverity::Info);
+            }
+            const double seconds = qMax<qint64>(result.elapsedMs, 1) / 1000.0;
+            TerminalOutputHelper::append(ui->terminalWindowMISC,
+                                         QString("SUCCESS: Split %1 record(s) in %2 s (%3 MB/s).")
+                                             .arg(result.recordCount)
+                                             .arg(seconds, 0, 'f', 2)
+                                             .arg(result.inputBytes / (1024.0 * 1024.0) / seconds, 0, 'f', 1),
+                                         TerminalSeverity::Success);
+        } else {
+            TerminalOutputHelper::append(ui->terminalWindowMISC,
+                                         QString("ERROR: %1").arg(result.error),
+                                         TerminalSeverity::Error);
+        }
+    }
+
+    if (!m_miscSplitLargeListsDialog) {
+        return;
+    }
+
+    m_miscSplitLargeListsDialog->setRunning(false);
+    if (result.ok) {
+        m_miscSplitLargeListsDialog->setStatusMessage("Split completed.", TerminalSeverity::Success);
+        m_miscSplitLargeListsDialog->accept();
+    } else {
+        m_miscSplitLargeListsDialog->setStatusMessage(
+            QString("Split failed: %1").arg(result.error),
+            TerminalSeverity::Error);
+    }
+}
+
 void MainWindow::onMiscCoordinatorScriptOutput(const QString& output)
 {
     const QString trimmed = output.trimmed();
@@ -2291,12 +2854,6 @@ void MainWindow::setupPrintWatcher()
         return;
     }
 
-    // Clear existing paths
-    const QStringList currentPaths = m_printWatcher->directories();
-    if (!currentPaths.isEmpty()) {
-        m_printWatcher->removePaths(currentPaths);
-    }
-
     // Use the new helper to get current job context
     QString obj = getCurrentJobContext();
 
@@ -2360,10 +2917,15 @@ void MainWindow::setupPrintWatcher()
         Logger::instance().warning("Unknown tab or controller not initialized, using fallback path");
     }
 
+    // Already watching this directory (e.g. switching back and forth between tabs)
+    if (m_printWatcher->directories() == QStringList{printPath}) {
+        return;
+    }
+
     // Ensure the directory exists, then watch it
     QDir dir(printPath);
     if (dir.exists()) {
-        m_printWatcher->addPath(printPath);
+        m_printWatcher->setDirectories({printPath});
         logToTerminal(tr("Watching print directory: %1").arg(printPath));
         Logger::instance().info(QString("Print watcher set to: %1").arg(printPath));
     } else {
@@ -2372,13 +2934,15 @@ void MainWindow::setupPrintWatcher()
 
         // Try to create the directory
         if (QDir().mkpath(printPath)) {
-            m_printWatcher->addPath(printPath);
+            m_printWatcher->setDirectories({printPath});
             logToTerminal(tr("Created and now watching print directory: %1").arg(printPath));
             Logger::instance().info(QString("Created and watching print directory: %1").arg(printPath));
         } else {
+            m_printWatcher->setDirectories({});
             Logger::instance().error(QString("Failed to create print directory: %1").arg(printPath));
         }
     }
+    PrintManifestStore::instance().setLiveDirectories(m_printWatcher->directories());
 }
 
 void MainWindow::onTabChanged(int index)
@@ -2387,6 +2951,8 @@ void MainWindow::onTabChanged(int index)
     logToTerminal("Switched to tab: " + tabName);
     Logger::instance().info(QString("Tab changed to index: %1 (%2)").arg(index).arg(tabName));
 
+    ensureTabActivated(getCurrentJobContext());
+
     // Update print watcher for the new tab
     setupPrintWatcher();
 
@@ -2400,12 +2966,25 @@ void MainWindow::onCustomerTabChanged(int index)
     Logger::instance().info(QString("Customer tab changed to index: %1 (%2)")
                                 .arg(index)
                                 .arg(customerName));
+    ensureTabActivated(getCurrentJobContext());
     setupPrintWatcher();
 }
 
-void MainWindow::onPrintDirChanged(const QString &path)
+void MainWindow::onPrintDirChanged(const PrintDirDiff& diff)
 {
-    logToTerminal(tr("Print directory changed: %1").arg(path));
+    QStringList parts;
+    if (!diff.added.isEmpty()) {
+        parts << tr("%n added", nullptr, diff.added.size());
+    }
+    if (!diff.modified.isEmpty()) {
+        parts << tr("%n modified", nullptr, diff.modified.size());
+    }
+    if (!diff.removed.isEmpty()) {
+        parts << tr("%n removed", nullptr, diff.removed.size());
+    }
+    logToTerminal(tr("Print directory changed: %1 (%2)").arg(diff.directory, parts.join(", ")));
+
+    PrintManifestStore::instance().applyDiff(diff, m_printWatcher->snapshot(diff.directory));
 }
 
 void MainWindow::onInactivityTimeout()
@@ -2466,6 +3045,65 @@ void MainWindow::onActionExitTriggered()
     close();
 }
 
+void MainWindow::onExportTraceTriggered()
+{
+    Tracer& tracer = Tracer::instance();
+    if (tracer.eventCount() == 0) {
+        QMessageBox::information(this, tr("Export Performance Trace"),
+                                 tr("No trace events have been recorded. Enable Settings > Performance Tracing "
+                                    "(or start Goji with GOJI_TRACE=1) and repeat the slow operation first."));
+        return;
+    }
+
+    const QString defaultPath = QDir(QStandardPaths::writableLocation(QStandardPaths::DocumentsLocation))
+                                    .filePath(QString("goji_trace_%1.json")
+                                                  .arg(QDateTime::currentDateTime().toString("yyyyMMdd_hhmmss")));
+    const QString path = QFileDialog::getSaveFileName(this, tr("Export Performance Trace"), defaultPath,
+                                                      tr("Chrome trace (*.json)"));
+    if (path.isEmpty()) {
+        return;
+    }
+
+    QString error;
+    if (!tracer.exportChromeTrace(path, &error)) {
+        logToTerminal(tr("Failed to export trace: %1").arg(error));
+        Logger::instance().error(QString("Trace export failed: %1").arg(error));
+        return;
+    }
+
+    logToTerminal(tr("Trace exported (%1 events, %2 dropped): %3")
+                      .arg(tracer.eventCount())
+                      .arg(tracer.droppedEventCount())
+                      .arg(path));
+}
+
+void MainWindow::onExportQueryStatsTriggered()
+{
+    const int saved = m_dbManager->flushSlowQueryLog();
+
+    const QString defaultPath = QDir(QStandardPaths::writableLocation(QStandardPaths::DocumentsLocation))
+                                    .filePath(QString("goji_query_stats_%1.txt")
+                                                  .arg(QDateTime::currentDateTime().toString("yyyyMMdd_hhmmss")));
+    const QString path = QFileDialog::getSaveFileName(this, tr("Export Query Statistics"), defaultPath,
+                                                      tr("Text files (*.txt)"));
+    if (path.isEmpty()) {
+        return;
+    }
+
+    QString error;
+    if (!QueryStats::instance().writeReport(path, &error)) {
+        logToTerminal(tr("Failed to export query statistics: %1").arg(error));
+        Logger::instance().error(QString("Query statistics export failed: %1").arg(error));
+        return;
+    }
+
+    logToTerminal(tr("Query statistics exported (%1 statements, %2 slow queries, %3 newly saved to slow_queries): %4")
+                      .arg(QueryStats::instance().summaries().size())
+                      .arg(QueryStats::instance().slowQueries().size())
+                      .arg(saved)
+                      .arg(path));
+}
+
 void MainWindow::onCheckForUpdatesTriggered()
 {
     Logger::instance().info("Check for updates triggered.");
@@ -2628,16 +3266,22 @@ void MainWindow::populateTMTarragonJobMenu()
     // Get all TMTARRAGON jobs from database
     TMTarragonDBManager* dbManager = TMTarragonDBManager::instance();
     if (!dbManager) {
+        OpenJobMenuHelper::resetMenu(openJobMenu, m_openJobMenuState);
         QAction* errorAction = openJobMenu->addAction("Database not available");
         errorAction->setEnabled(false);
         logToTerminal("Open Job: TMTARRAGON Database manager not available");
         return;
     }
 
-    QList<QMap<QString, QString>> jobs = dbManager->getAllJobs();
+    JobIndex& jobIndex = dbManager->jobIndex();
+    const QList<QMap<QString, QString>>& jobs = jobIndex.rows();
+    if (OpenJobMenuHelper::isCurrent(m_openJobMenuState, "TMTARRAGON", jobIndex.revision())) {
+        return;
+    }
     logToTerminal(QString("Open Job: Found %1 TMTARRAGON jobs in database").arg(jobs.size()));
 
     if (jobs.isEmpty()) {
+        OpenJobMenuHelper::resetMenu(openJobMenu, m_openJobMenuState);
         QAction* noJobsAction = openJobMenu->addAction("No saved jobs found");
         noJobsAction->setEnabled(false);
         logToTerminal("Open Job: No TMTARRAGON jobs found in database");
@@ -2671,7 +3315,8 @@ void MainWindow::populateTMTarragonJobMenu()
         loadTMTarragonJob(row["year"], row["month"], row["drop_number"]);
     };
 
-    OpenJobMenuHelper::buildMenu(openJobMenu, this, jobs, spec);
+    OpenJobMenuHelper::syncMenu(openJobMenu, this, m_openJobMenuState, "TMTARRAGON",
+                                jobIndex.revision(), jobs, spec);
 }
 
 void MainWindow::logToTerminal(const QString& message)
@@ -2856,6 +3501,23 @@ void MainWindow::setupMenus()
     connect(updateSettingsAction, &QAction::triggered, this, &MainWindow::onUpdateSettingsTriggered);
     settingsMenu->addAction(updateSettingsAction);
 
+    // Performance tracing (also enabled from startup by GOJI_TRACE)
+    settingsMenu->addSeparator();
+    QAction* tracingAction = new QAction(tr("Performance Tracing"));
+    tracingAction->setCheckable(true);
+    tracingAction->setChecked(Tracer::isEnabled());
+    connect(tracingAction, &QAction::toggled, this, [this](bool checked) {
+        Tracer::instance().setEnabled(checked);
+        logToTerminal(checked ? tr("Performance tracing enabled") : tr("Performance tracing disabled"));
+    });
+    settingsMenu->addAction(tracingAction);
+    QAction* exportTraceAction = new QAction(tr("Export Performance Trace..."));
+    connect(exportTraceAction, &QAction::triggered, this, &MainWindow::onExportTraceTriggered);
+    settingsMenu->addAction(exportTraceAction);
+    QAction* exportQueryStatsAction = new QAction(tr("Export Query Statistics..."));
+    connect(exportQueryStatsAction, &QAction::triggered, this, &MainWindow::onExportQueryStatsTriggered);
+    settingsMenu->addAction(exportQueryStatsAction);
+
     // Setup Script Management menu with dynamic directory structure
     setupScriptsMenu();
 
@@ -2893,9 +3555,10 @@ void MainWindow::initWatchersAndTimers()
 {
     Logger::instance().info("Initializing watchers and timers...");
 
-    // Create file system watcher for print directory (but don't set it up yet)
-    m_printWatcher = new QFileSystemWatcher(this);
-    connect(m_printWatcher, &QFileSystemWatcher::directoryChanged, this, &MainWindow::onPrintDirChanged);
+    // Create the print directory watcher (but don't set it up yet); it reports
+    // settled changes only, after bursts of PDF writes have finished
+    m_printWatcher = new PrintDirWatcher(this);
+    connect(m_printWatcher, &PrintDirWatcher::directoryChanged, this, &MainWindow::onPrintDirChanged);
 
     // Set up the print watcher for the current tab
     setupPrintWatcher();
@@ -2918,16 +3581,22 @@ void MainWindow::populateTMWPCJobMenu()
     // Get all TMWPC jobs from database
     TMWeeklyPCDBManager* dbManager = TMWeeklyPCDBManager::instance();
     if (!dbManager) {
+        OpenJobMenuHelper::resetMenu(openJobMenu, m_openJobMenuState);
         QAction* errorAction = openJobMenu->addAction("Database not available");
         errorAction->setEnabled(false);
         logToTerminal("Open Job: Database manager not available");
         return;
     }
 
-    QList<QMap<QString, QString>> jobs = dbManager->getAllJobs();
+    JobIndex& jobIndex = dbManager->jobIndex();
+    const QList<QMap<QString, QString>>& jobs = jobIndex.rows();
+    if (OpenJobMenuHelper::isCurrent(m_openJobMenuState, "TMWEEKLYPC", jobIndex.revision())) {
+        return;
+    }
     logToTerminal(QString("Open Job: Found %1 TMWPC jobs in database").arg(jobs.size()));
 
     if (jobs.isEmpty()) {
+        OpenJobMenuHelper::resetMenu(openJobMenu, m_openJobMenuState);
         QAction* noJobsAction = openJobMenu->addAction("No saved jobs found");
         noJobsAction->setEnabled(false);
         logToTerminal("Open Job: No TMWPC jobs found in database");
@@ -3036,7 +3705,8 @@ void MainWindow::populateTMWPCJobMenu()
         loadTMWPCJob(row["year"], row["month"], row["week"]);
     };
 
-    OpenJobMenuHelper::buildMenu(openJobMenu, this, jobs, spec);
+    OpenJobMenuHelper::syncMenu(openJobMenu, this, m_openJobMenuState, "TMWEEKLYPC",
+                                jobIndex.revision(), jobs, spec);
 }
 
 void MainWindow::populateTMTermJobMenu()
@@ -3046,16 +3716,22 @@ void MainWindow::populateTMTermJobMenu()
     // Get all TMTERM jobs from database
     TMTermDBManager* dbManager = TMTermDBManager::instance();
     if (!dbManager) {
+        OpenJobMenuHelper::resetMenu(openJobMenu, m_openJobMenuState);
         QAction* errorAction = openJobMenu->addAction("Database not available");
         errorAction->setEnabled(false);
         logToTerminal("Open Job: TMTERM Database manager not available");
         return;
     }
 
-    QList<QMap<QString, QString>> jobs = dbManager->getAllJobs();
+    JobIndex& jobIndex = dbManager->jobIndex();
+    const QList<QMap<QString, QString>>& jobs = jobIndex.rows();
+    if (OpenJobMenuHelper::isCurrent(m_openJobMenuState, "TMTERM", jobIndex.revision())) {
+        return;
+    }
     logToTerminal(QString("Open Job: Found %1 TMTERM jobs in database").arg(jobs.size()));
 
     if (jobs.isEmpty()) {
+        OpenJobMenuHelper::resetMenu(openJobMenu, m_openJobMenuState);
         QAction* noJobsAction = openJobMenu->addAction("No saved jobs found");
         noJobsAction->setEnabled(false);
         logToTerminal("Open Job: No TMTERM jobs found in database");
@@ -3086,11 +3762,13 @@ void MainWindow::populateTMTermJobMenu()
         loadTMTermJob(row["year"], row["month"]);
     };
 
-    OpenJobMenuHelper::buildMenu(openJobMenu, this, jobs, spec);
+    OpenJobMenuHelper::syncMenu(openJobMenu, this, m_openJobMenuState, "TMTERM",
+                                jobIndex.revision(), jobs, spec);
 }
 
 void MainWindow::loadTMWPCJob(const QString& year, const QString& month, const QString& week)
 {
+    TRACE_FUNCTION("job");
     if (m_tmWeeklyPCController) {
         m_tmWeeklyPCController->loadJob(year, month, week);
     }
@@ -3098,6 +3776,7 @@ void MainWindow::loadTMWPCJob(const QString& year, const QString& month, const Q
 
 void MainWindow::loadTMTermJob(const QString& year, const QString& month)
 {
+    TRACE_FUNCTION("job");
     if (m_tmTermController) {
         m_tmTermController->loadJob(year, month);
     }
@@ -3105,6 +3784,7 @@ void MainWindow::loadTMTermJob(const QString& year, const QString& month)
 
 void MainWindow::loadTMTarragonJob(const QString& year, const QString& month, const QString& dropNumber)
 {
+    TRACE_FUNCTION("job");
     if (m_tmTarragonController) {
         m_tmTarragonController->loadJob(year, month, dropNumber);
     }
@@ -3112,13 +3792,14 @@ void MainWindow::loadTMTarragonJob(const QString& year, const QString& month, co
 
 void MainWindow::populateOpenJobMenu()
 {
+    TRACE_FUNCTION("ui");
     if (!openJobMenu) return;
-    openJobMenu->clear();
 
     // Use the new helper to get current job context
     QString obj = getCurrentJobContext();
 
     auto addNotAvailable = [&](const QString& msg){
+        OpenJobMenuHelper::resetMenu(openJobMenu, m_openJobMenuState);
         QAction* a = openJobMenu->addAction(msg);
         a->setEnabled(false);
     };
@@ -3161,6 +3842,7 @@ void MainWindow::populateOpenJobMenu()
 
 void MainWindow::onSaveJobTriggered()
 {
+    TRACE_FUNCTION("job");
     Logger::instance().info("Save job triggered.");
 
     // Use the new helper to get current job context
@@ -3364,6 +4046,7 @@ void MainWindow::onSaveJobTriggered()
 
 void MainWindow::onCloseJobTriggered()
 {
+    TRACE_FUNCTION("job");
     Logger::instance().info("Close job triggered.");
     const QString obj = getCurrentJobContext();
 
@@ -3372,6 +4055,9 @@ void MainWindow::onCloseJobTriggered()
         if (obj != "TMBA" && obj != "TMBROKEN") {
             logToTerminal("Job closed and saved successfully");
         }
+        if (m_dbManager) {
+            m_dbManager->flushTerminalLogs();
+        }
     } else {
         logToTerminal("No job is currently open to close");
         return;
@@ -3387,16 +4073,22 @@ void MainWindow::populateTMFLERJobMenu()
     // Get all TMFLER jobs from database
     TMFLERDBManager* dbManager = TMFLERDBManager::instance();
     if (!dbManager) {
+        OpenJobMenuHelper::resetMenu(openJobMenu, m_openJobMenuState);
         QAction* errorAction = openJobMenu->addAction("Database not available");
         errorAction->setEnabled(false);
         logToTerminal("Open Job: TMFLER Database manager not available");
         return;
     }
 
-    QList<QMap<QString, QString>> jobs = dbManager->getAllJobs();
+    JobIndex& jobIndex = dbManager->jobIndex();
+    const QList<QMap<QString, QString>>& jobs = jobIndex.rows();
+    if (OpenJobMenuHelper::isCurrent(m_openJobMenuState, "TMFLER", jobIndex.revision())) {
+        return;
+    }
     logToTerminal(QString("Open Job: Found %1 TMFLER jobs in database").arg(jobs.size()));
 
     if (jobs.isEmpty()) {
+        OpenJobMenuHelper::resetMenu(openJobMenu, m_openJobMenuState);
         QAction* noJobsAction = openJobMenu->addAction("No saved jobs found");
         noJobsAction->setEnabled(false);
         logToTerminal("Open Job: No TMFLER jobs found in database");
@@ -3427,7 +4119,8 @@ void MainWindow::populateTMFLERJobMenu()
         loadTMFLERJob(row["job_number"], row["year"], row["month"]);
     };
 
-    OpenJobMenuHelper::buildMenu(openJobMenu, this, jobs, spec);
+    OpenJobMenuHelper::syncMenu(openJobMenu, this, m_openJobMenuState, "TMFLER",
+                                jobIndex.revision(), jobs, spec);
 }
 
 
@@ -3437,16 +4130,22 @@ void MainWindow::populateTMCAJobMenu()
 
     TMCADBManager* dbManager = TMCADBManager::instance();
     if (!dbManager) {
+        OpenJobMenuHelper::resetMenu(openJobMenu, m_openJobMenuState);
         QAction* errorAction = openJobMenu->addAction("Database not available");
         errorAction->setEnabled(false);
         logToTerminal("Open Job: TMCA Database manager not available");
         return;
     }
 
-    QList<QMap<QString, QString>> jobs = dbManager->getAllJobs();
+    JobIndex& jobIndex = dbManager->jobIndex();
+    const QList<QMap<QString, QString>>& jobs = jobIndex.rows();
+    if (OpenJobMenuHelper::isCurrent(m_openJobMenuState, "TMCA", jobIndex.revision())) {
+        return;
+    }
     logToTerminal(QString("Open Job: Found %1 TMCA jobs in database").arg(jobs.size()));
 
     if (jobs.isEmpty()) {
+        OpenJobMenuHelper::resetMenu(openJobMenu, m_openJobMenuState);
         QAction* noJobsAction = openJobMenu->addAction("No saved jobs found");
         noJobsAction->setEnabled(false);
         logToTerminal("Open Job: No TMCA jobs found in database");
@@ -3468,11 +4167,13 @@ void MainWindow::populateTMCAJobMenu()
         loadTMCAJob(row["job_number"], row["year"], row["month"]);
     };
 
-    OpenJobMenuHelper::buildMenu(openJobMenu, this, jobs, spec);
+    OpenJobMenuHelper::syncMenu(openJobMenu, this, m_openJobMenuState, "TMCA",
+                                jobIndex.revision(), jobs, spec);
 }
 
 void MainWindow::loadTMCAJob(const QString& jobNumber, const QString& year, const QString& month)
 {
+    TRACE_FUNCTION("job");
     if (!m_tmCAController) {
         logToTerminal("Cannot load TMCA job: controller not available");
         return;
@@ -3487,6 +4188,7 @@ void MainWindow::loadTMCAJob(const QString& jobNumber, const QString& year, cons
 }
 void MainWindow::loadTMFLERJob(const QString& jobNumber, const QString& year, const QString& month)
 {
+    TRACE_FUNCTION("job");
     if (!m_tmFlerController) return;
 
     // Switch to TMFLER tab first
@@ -3503,16 +4205,22 @@ void MainWindow::populateTMHealthyJobMenu()
     // Get all TMHEALTHY jobs from database
     TMHealthyDBManager* dbManager = TMHealthyDBManager::instance();
     if (!dbManager) {
+        OpenJobMenuHelper::resetMenu(openJobMenu, m_openJobMenuState);
         QAction* errorAction = openJobMenu->addAction("Database not available");
         errorAction->setEnabled(false);
         logToTerminal("Open Job: TMHEALTHY Database manager not available");
         return;
     }
 
-    QList<QMap<QString, QString>> jobs = dbManager->getAllJobs();
+    JobIndex& jobIndex = dbManager->jobIndex();
+    const QList<QMap<QString, QString>>& jobs = jobIndex.rows();
+    if (OpenJobMenuHelper::isCurrent(m_openJobMenuState, "TMHEALTHY", jobIndex.revision())) {
+        return;
+    }
     logToTerminal(QString("Open Job: Found %1 TMHEALTHY jobs in database").arg(jobs.size()));
 
     if (jobs.isEmpty()) {
+        OpenJobMenuHelper::resetMenu(openJobMenu, m_openJobMenuState);
         QAction* noJobsAction = openJobMenu->addAction("No saved jobs found");
         noJobsAction->setEnabled(false);
         logToTerminal("Open Job: No TMHEALTHY jobs found in database");
@@ -3543,11 +4251,13 @@ void MainWindow::populateTMHealthyJobMenu()
         loadTMHealthyJob(row["job_number"], row["year"], row["month"]);
     };
 
-    OpenJobMenuHelper::buildMenu(openJobMenu, this, jobs, spec);
+    OpenJobMenuHelper::syncMenu(openJobMenu, this, m_openJobMenuState, "TMHEALTHY",
+                                jobIndex.revision(), jobs, spec);
 }
 
 void MainWindow::loadTMHealthyJob(const QString& jobNumber, const QString& year, const QString& month)
 {
+    TRACE_FUNCTION("job");
     if (m_tmHealthyController) {
         bool success = m_tmHealthyController->loadJob(jobNumber, year, month);
         if (success) {
@@ -3600,75 +4310,124 @@ void MainWindow::setupScriptsMenu()
     
     manageScriptsMenu->setStyleSheet(menuStyleSheet);
     
-    // Connect the aboutToShow signal to dynamically populate the menu
-    connect(manageScriptsMenu, &QMenu::aboutToShow, this, [this, manageScriptsMenu, menuStyleSheet]() {
-        // Clear existing items
-        manageScriptsMenu->clear();
-        
-        // Define the base scripts directory - try both paths
-        QString scriptsPath = "C:/Goji/scripts";
+    // Define the base scripts directory - try both paths
+    QString scriptsPath = "C:/Goji/scripts";
+    if (!QDir(scriptsPath).exists()) {
+        scriptsPath = QDir(QCoreApplication::applicationDirPath()).absoluteFilePath("../scripts");
         if (!QDir(scriptsPath).exists()) {
-            scriptsPath = QDir(QCoreApplication::applicationDirPath()).absoluteFilePath("../scripts");
-            if (!QDir(scriptsPath).exists()) {
-                // Final fallback to current project directory
-                scriptsPath = QDir::currentPath() + "/scripts";
-            }
+            // Final fallback to current project directory
+            scriptsPath = QDir::currentPath() + "/scripts";
+        }
+    }
+
+    // The tree is scanned in the background and kept current by a watcher,
+    // so opening the menu only touches submenus whose directories changed
+    m_scriptTreeCache = new ScriptTreeCache([this](const QString& fileName) {
+        return isScriptFile(fileName);
+    }, this);
+    m_scriptTreeCache->setRootPath(scriptsPath);
+
+    connect(manageScriptsMenu, &QMenu::aboutToShow, this, [this, manageScriptsMenu, menuStyleSheet]() {
+        syncScriptsMenu(manageScriptsMenu, menuStyleSheet);
+    });
+    connect(m_scriptTreeCache, &ScriptTreeCache::treeChanged, this, [this, manageScriptsMenu, menuStyleSheet]() {
+        if (manageScriptsMenu->isVisible()) {
+            syncScriptsMenu(manageScriptsMenu, menuStyleSheet);
         }
-        
-        // Build the menu structure recursively
-        buildScriptMenuRecursively(manageScriptsMenu, scriptsPath, menuStyleSheet);
     });
     
     Logger::instance().info("Scripts menu setup complete.");
 }
 
-void MainWindow::buildScriptMenuRecursively(QMenu* parentMenu, const QString& dirPath, const QString& styleSheet)
+void MainWindow::syncScriptsMenu(QMenu* menu, const QString& styleSheet)
 {
-    QDir dir(dirPath);
-    if (!dir.exists()) {
-        QAction* notFoundAction = new QAction(tr("Directory not found: %1").arg(dirPath), this);
-        notFoundAction->setEnabled(false);
-        parentMenu->addAction(notFoundAction);
+    TRACE_FUNCTION("ui");
+
+    const ScriptDirNodePtr root = m_scriptTreeCache->root();
+    if (root) {
+        syncScriptSubmenu(menu, root, styleSheet);
         return;
     }
-    
-    // Get all subdirectories and files
-    QFileInfoList entries = dir.entryInfoList(QDir::AllEntries | QDir::NoDotAndDotDot, QDir::DirsFirst | QDir::Name);
-    
-    // Lists to hold different types of entries
-    QList<QFileInfo> directories;
-    QList<QFileInfo> scriptFiles;
-    
-    // Separate directories and script files
-    for (const QFileInfo& entry : std::as_const(entries)) {
-        if (entry.isDir()) {
-            directories.append(entry);
-        } else if (isScriptFile(entry.fileName())) {
-            scriptFiles.append(entry);
+
+    // No tree yet (first scan still running) or no scripts directory
+    const QString text = m_scriptTreeCache->hasSnapshot()
+                             ? tr("Directory not found: %1").arg(m_scriptTreeCache->rootPath())
+                             : tr("Loading scripts...");
+    const QList<QAction*> actions = menu->actions();
+    for (QAction* action : actions) {
+        if (QMenu* submenu = action->menu()) {
+            submenu->deleteLater();
         }
     }
-    
+    menu->clear();
+    menu->setProperty(kScriptMenuSignatureProperty, QVariant());
+
+    QAction* placeholderAction = new QAction(text, menu);
+    placeholderAction->setEnabled(false);
+    menu->addAction(placeholderAction);
+}
+
+void MainWindow::syncScriptSubmenu(QMenu* menu, const ScriptDirNodePtr& node, const QString& styleSheet)
+{
+    // Same signature: this menu and everything below it are already current
+    const QVariant builtSignature = menu->property(kScriptMenuSignatureProperty);
+    if (builtSignature.isValid() && builtSignature.toULongLong() == node->signature) {
+        return;
+    }
+
+    // Detach the current items, keeping submenus and script actions for reuse
+    QHash<QString, QMenu*> oldSubmenus;
+    QHash<QString, QAction*> oldScriptActions;
+    const QList<QAction*> actions = menu->actions();
+    for (QAction* action : actions) {
+        menu->removeAction(action);
+        if (QMenu* submenu = action->menu()) {
+            oldSubmenus.insert(submenu->property(kScriptMenuPathProperty).toString(), submenu);
+        } else if (!action->data().toString().isEmpty()) {
+            oldScriptActions.insert(action->data().toString(), action);
+        } else {
+            action->deleteLater();
+        }
+    }
+
     // Add directories as submenus
-    for (const QFileInfo& dirInfo : directories) {
-        QMenu* submenu = parentMenu->addMenu(dirInfo.fileName());
-        submenu->setStyleSheet(styleSheet);
-        
-        // Recursively build the submenu
-        buildScriptMenuRecursively(submenu, dirInfo.absoluteFilePath(), styleSheet);
+    for (const ScriptDirNodePtr& child : node->children) {
+        QMenu* submenu = oldSubmenus.take(child->path);
+        if (!submenu) {
+            submenu = new QMenu(child->name, menu);
+            submenu->setStyleSheet(styleSheet);
+            submenu->setProperty(kScriptMenuPathProperty, child->path);
+        }
+        menu->addMenu(submenu);
+        syncScriptSubmenu(submenu, child, styleSheet);
     }
-    
+
     // Add script files as actions
-    for (const QFileInfo& fileInfo : scriptFiles) {
-        QAction* fileAction = createScriptFileAction(fileInfo);
-        parentMenu->addAction(fileAction);
+    for (const QString& script : node->scripts) {
+        const QString scriptPath = node->path + "/" + script;
+        QAction* fileAction = oldScriptActions.take(scriptPath);
+        if (!fileAction) {
+            fileAction = createScriptFileAction(QFileInfo(scriptPath));
+            fileAction->setParent(menu);
+        }
+        menu->addAction(fileAction);
     }
-    
+
+    for (QMenu* submenu : std::as_const(oldSubmenus)) {
+        submenu->deleteLater();
+    }
+    for (QAction* action : std::as_const(oldScriptActions)) {
+        action->deleteLater();
+    }
+
     // If the menu is empty, add a "No scripts found" action
-    if (parentMenu->actions().isEmpty()) {
-        QAction* emptyAction = new QAction(tr("No scripts found"), this);
+    if (menu->actions().isEmpty()) {
+        QAction* emptyAction = new QAction(tr("No scripts found"), menu);
         emptyAction->setEnabled(false);
-        parentMenu->addAction(emptyAction);
+        menu->addAction(emptyAction);
     }
+
+    menu->setProperty(kScriptMenuSignatureProperty, QVariant::fromValue<quint64>(node->signature));
 }
 
 QString MainWindow::convertMonthToAbbreviation(const QString& monthNumber) const
@@ -3948,16 +4707,22 @@ void MainWindow::populateTMBrokenJobMenu()
     // Get all TMBROKEN jobs from database
     TMBrokenDBManager* dbManager = TMBrokenDBManager::instance();
     if (!dbManager) {
+        OpenJobMenuHelper::resetMenu(openJobMenu, m_openJobMenuState);
         QAction* errorAction = openJobMenu->addAction("Database not available");
         errorAction->setEnabled(false);
         logToTerminal("Open Job: TMBROKEN Database manager not available");
         return;
     }
 
-    QList<QMap<QString, QString>> jobs = dbManager->getAllJobs();
+    JobIndex& jobIndex = dbManager->jobIndex();
+    const QList<QMap<QString, QString>>& jobs = jobIndex.rows();
+    if (OpenJobMenuHelper::isCurrent(m_openJobMenuState, "TMBROKEN", jobIndex.revision())) {
+        return;
+    }
     logToTerminal(QString("Open Job: Found %1 TMBROKEN jobs in database").arg(jobs.size()));
 
     if (jobs.isEmpty()) {
+        OpenJobMenuHelper::resetMenu(openJobMenu, m_openJobMenuState);
         QAction* noJobsAction = openJobMenu->addAction("No saved jobs found");
         noJobsAction->setEnabled(false);
         logToTerminal("Open Job: No TMBROKEN jobs found in database");
@@ -3988,11 +4753,13 @@ void MainWindow::populateTMBrokenJobMenu()
         loadTMBrokenJob(row["year"], row["month"]);
     };
 
-    OpenJobMenuHelper::buildMenu(openJobMenu, this, jobs, spec);
+    OpenJobMenuHelper::syncMenu(openJobMenu, this, m_openJobMenuState, "TMBROKEN",
+                                jobIndex.revision(), jobs, spec);
 }
 
 void MainWindow::loadTMBrokenJob(const QString& year, const QString& month)
 {
+    TRACE_FUNCTION("job");
     if (m_tmBrokenController) {
         bool success = m_tmBrokenController->loadJob(year, month);
         if (!success) {
@@ -4008,16 +4775,22 @@ void MainWindow::populateTMFarmJobMenu()
     // Get all TMFARM jobs from database
     TMFarmDBManager* dbManager = TMFarmDBManager::instance();
     if (!dbManager) {
+        OpenJobMenuHelper::resetMenu(openJobMenu, m_openJobMenuState);
         QAction* errorAction = openJobMenu->addAction("Database not available");
         errorAction->setEnabled(false);
         logToTerminal("Open Job: TMFARM Database manager not available");
         return;
     }
 
-    QList<QMap<QString, QString>> jobs = dbManager->getAllJobs();
+    JobIndex& jobIndex = dbManager->jobIndex();
+    const QList<QMap<QString, QString>>& jobs = jobIndex.rows();
+    if (OpenJobMenuHelper::isCurrent(m_openJobMenuState, "TMFARM", jobIndex.revision())) {
+        return;
+    }
     logToTerminal(QString("Open Job: Found %1 TMFARM jobs in database").arg(jobs.size()));
 
     if (jobs.isEmpty()) {
+        OpenJobMenuHelper::resetMenu(openJobMenu, m_openJobMenuState);
         QAction* noJobsAction = openJobMenu->addAction("No saved jobs found");
         noJobsAction->setEnabled(false);
         logToTerminal("Open Job: No TMFARM jobs found in database");
@@ -4059,11 +4832,13 @@ void MainWindow::populateTMFarmJobMenu()
         loadTMFarmJob(row["year"], row["quarter"]);
     };
 
-    OpenJobMenuHelper::buildMenu(openJobMenu, this, jobs, spec);
+    OpenJobMenuHelper::syncMenu(openJobMenu, this, m_openJobMenuState, "TMFARM",
+                                jobIndex.revision(), jobs, spec);
 }
 
 void MainWindow::loadTMFarmJob(const QString& year, const QString& quarter)
 {
+    TRACE_FUNCTION("job");
     if (m_tmFarmController) {
         m_tmFarmController->loadJob(year, quarter);
     }
@@ -4073,16 +4848,20 @@ void MainWindow::populateFHJobMenu()
 {
     if (!openJobMenu) return;
 
-    openJobMenu->clear();
     FHDBManager* dbManager = FHDBManager::instance();
     if (!dbManager) {
+        OpenJobMenuHelper::resetMenu(openJobMenu, m_openJobMenuState);
         QAction* errorAction = openJobMenu->addAction("Database not available");
         errorAction->setEnabled(false);
         logToTerminal("Open Job: FOUR HANDS database manager not available");
         return;
     }
 
-    QList<QMap<QString, QString>> jobs = dbManager->getAllJobs();
+    JobIndex& jobIndex = dbManager->jobIndex();
+    const QList<QMap<QString, QString>>& jobs = jobIndex.rows();
+    if (OpenJobMenuHelper::isCurrent(m_openJobMenuState, "FOURHANDS", jobIndex.revision())) {
+        return;
+    }
     logToTerminal(QString("Open Job: Found %1 FOUR HANDS jobs in database").arg(jobs.size()));
 
     QList<QMap<QString, QString>> validJobs;
@@ -4100,6 +4879,7 @@ void MainWindow::populateFHJobMenu()
     }
 
     if (validJobs.isEmpty()) {
+        OpenJobMenuHelper::resetMenu(openJobMenu, m_openJobMenuState);
         QAction* noJobsAction = openJobMenu->addAction("No saved jobs found");
         noJobsAction->setEnabled(false);
         return;
@@ -4144,12 +4924,14 @@ void MainWindow::populateFHJobMenu()
                   row.value("year"), row.value("month"), version);
     };
 
-    OpenJobMenuHelper::buildMenu(openJobMenu, this, validJobs, spec);
+    OpenJobMenuHelper::syncMenu(openJobMenu, this, m_openJobMenuState, "FOURHANDS",
+                                jobIndex.revision(), validJobs, spec);
 }
 
 void MainWindow::loadFHJob(const QString& jobNumber, const QString& dropNumber,
                            const QString& year, const QString& month, const QString& version)
 {
+    TRACE_FUNCTION("job");
     if (!m_fhController) {
         logToTerminal("FOUR HANDS controller not initialized.");
         return;
@@ -13,6 +13,9 @@
 #include <QCheckBox>
 #include <QPair>
 #include <QCloseEvent>
+#include <QShowEvent>
+#include <QElapsedTimer>
+#include <QSet>
 #include <QFile>
 #include <QTextStream>
 #include <QFontDatabase>
@@ -26,6 +29,7 @@
 #include <QPushButton>
 #include <QFileInfo>
 #include <QProcess>
+#include <QProgressBar>
 
 // Windows-specific includes for ShellExecute
 #ifdef Q_OS_WIN
@@ -34,6 +38,7 @@
 #endif
 
 #include "databasemanager.h"
+#include "openjobmenuhelper.h"
 #include "filesystemmanager.h"
 #include "scriptrunner.h"
 #include "updatemanager.h"
@@ -50,6 +55,8 @@
 #include "tmcacontroller.h"
 #include "terminaloutputhelper.h"
 #include "miscscriptcoordinator.h"
+#include "printdirwatcher.h"
+#include "scripttreecache.h"
 
 // Qt namespace declaration - make sure your project is properly configured for Qt
 QT_BEGIN_NAMESPACE
@@ -60,6 +67,12 @@ class MiscCombineDataDialog;
 class MiscDarkReportDialog;
 class MiscRenameHeadersDialog;
 class MiscSplitLargeListsDialog;
+class CsvCombiner;
+struct CsvCombineResult;
+class CsvSplitter;
+struct CsvSplitResult;
+class RecordCounter;
+struct RecordCountResult;
 
 // Custom dialog for choosing which program to open script files with
 class ScriptOpenDialog : public QDialog
@@ -92,11 +105,14 @@ protected:
     bool eventFilter(QObject *obj, QEvent *event) override;
     void restartInactivityTimer();
     void closeEvent(QCloseEvent *event) override;
+    void showEvent(QShowEvent *event) override;
 
 private slots:
     // Menu actions
     void onActionExitTriggered();
     void onCheckForUpdatesTriggered();
+    void onExportTraceTriggered();
+    void onExportQueryStatsTriggered();
     void onUpdateSettingsTriggered();
     void onUpdateMeteredRateTriggered();
     void onManageEditDatabaseTriggered();
@@ -109,7 +125,7 @@ private slots:
     void onCustomerTabChanged(int index);
 
     // File system and timer slots
-    void onPrintDirChanged(const QString &path);
+    void onPrintDirChanged(const PrintDirDiff& diff);
     void onInactivityTimeout();
 
     // Keyboard shortcut handler
@@ -131,30 +147,45 @@ private:
     UpdateManager* m_updateManager;
     MiscScriptCoordinator* m_miscScriptCoordinator;
 
-    // Tab controllers
-    AILIController* m_ailiController;
-    FHController* m_fhController;
-    TMWeeklyPCController* m_tmWeeklyPCController;
-    TMWeeklyPIDOController* m_tmWeeklyPIDOController;
-    TMTermController* m_tmTermController;
-    TMTarragonController* m_tmTarragonController;
-    TMFLERController* m_tmFlerController;
-    TMHealthyController* m_tmHealthyController;
-    TMBrokenController* m_tmBrokenController;
-
-    TMFarmController* m_tmFarmController;
-    TMCAController* m_tmCAController;
+    // Tab controllers (created on first activation of their tab)
+    AILIController* m_ailiController = nullptr;
+    FHController* m_fhController = nullptr;
+    TMWeeklyPCController* m_tmWeeklyPCController = nullptr;
+    TMWeeklyPIDOController* m_tmWeeklyPIDOController = nullptr;
+    TMTermController* m_tmTermController = nullptr;
+    TMTarragonController* m_tmTarragonController = nullptr;
+    TMFLERController* m_tmFlerController = nullptr;
+    TMHealthyController* m_tmHealthyController = nullptr;
+    TMBrokenController* m_tmBrokenController = nullptr;
+
+    TMFarmController* m_tmFarmController = nullptr;
+    TMCAController* m_tmCAController = nullptr;
+
+    // Lazy tab activation
+    QElapsedTimer m_startupTimer;
+    QSet<QString> m_activatedTabs;
+    QStringList m_pendingWarmTabs;
+    bool m_tabWarmupStarted = false;
 
     // UI components
     QMenu* openJobMenu;
-    QFileSystemWatcher* m_printWatcher;
+    OpenJobMenuHelper::MenuState m_openJobMenuState;
+    PrintDirWatcher* m_printWatcher;
+    ScriptTreeCache* m_scriptTreeCache = nullptr;
     QTimer* m_inactivityTimer;
     QList<QPushButton*> m_miscScriptButtons;
+    QProgressBar* m_scriptProgressBar = nullptr;
+    QProgressBar* m_transferProgressBar = nullptr;
+    QPushButton* m_transferCancelButton = nullptr;
+    bool m_closeAfterTransfers = false;     // exit once queued file transfers have finished
     bool m_miscScriptRunning = false;
     MiscCombineDataDialog* m_miscCombineDataDialog;
     MiscDarkReportDialog* m_miscDarkReportDialog;
     MiscRenameHeadersDialog* m_miscRenameHeadersDialog;
     MiscSplitLargeListsDialog* m_miscSplitLargeListsDialog;
+    CsvCombiner* m_csvCombiner = nullptr;
+    CsvSplitter* m_csvSplitter = nullptr;
+    RecordCounter* m_recordCounter = nullptr;
     enum class MiscWorkflowOperation {
         None,
         CombineRun,
@@ -214,6 +245,33 @@ private:
 
     // Private methods
     void setupUi();
+
+    /**
+     * @brief Create and wire the controller behind a job tab on first use
+     *
+     * Constructs the controller, makes sure its database tables exist and
+     * connects it to its widgets. Does nothing for tabs already activated or
+     * without a controller. A failure is logged and retried next time.
+     * @param tabName Tab objectName as returned by getCurrentJobContext()
+     * @return False if the tab's controller could not be set up
+     */
+    bool ensureTabActivated(const QString& tabName);
+    void warmNextTab();
+    /**
+     * @brief Status bar progress bar shared by controllers whose scripts report progress events
+     */
+    QProgressBar* scriptProgressBar();
+    bool setupTMWeeklyPCTab();
+    bool setupTMWeeklyPIDOTab();
+    bool setupTMTermTab();
+    bool setupTMTarragonTab();
+    bool setupTMFLERTab();
+    bool setupTMCATab();
+    bool setupTMHealthyTab();
+    bool setupTMBrokenTab();
+    bool setupTMFarmTab();
+    bool setupFHTab();
+    bool setupAILITab();
     void setupMenus();
     void setupSignalSlots();
     void setupKeyboardShortcuts();
@@ -221,6 +279,8 @@ private:
     void setupPrintWatcher();
     void applyTerminalWindowStyling();
     void setupMiscScriptWiring();
+    void setupFileTransferWiring();
+    void onFileTransferBusyChanged(bool busy);
     void setMiscButtonsEnabled(bool enabled);
     void runMiscScript(const QString& scriptLabel, const QString& runtimeScriptPath);
     void onMiscScriptOutput(const QString& output);
@@ -228,15 +288,24 @@ private:
     void openCombineDataFilesDialog();
     void openDarkReportDialog();
     void onCombineDataFilesRequested(const QStringList& selectedFiles);
+    bool startNativeCsvCombine(const QStringList& selectedFiles, const QString& outputPath);
+    void onCsvCombineFinished(const CsvCombineResult& result);
     void openRenameHeadersDialog();
     void onRenameHeadersLoadRequested(const QString& filePath);
     void onRenameHeadersSaveRequested();
     void openSplitLargeListsDialog();
     void onSplitLargeListsLoadRequested(const QString& filePath);
+    void startSplitInspectScript(const QString& trimmedPath);
+    void onSplitRecordCountFinished(const RecordCountResult& result);
     void onSplitLargeListsRunRequested(const QString& filePath,
                                        int parts,
                                        const QString& outputDirectory,
                                        const QString& baseName);
+    bool startNativeCsvSplit(const QString& filePath,
+                             int parts,
+                             const QString& outputDirectory,
+                             const QString& baseName);
+    void onCsvSplitFinished(const CsvSplitResult& result);
     void openMiscNotYetImplementedDialog();
     void onMiscCoordinatorScriptOutput(const QString& output);
     void onMiscCoordinatorScriptFinished(int exitCode, QProcess::ExitStatus exitStatus);
@@ -250,7 +319,8 @@ private:
     
     // Dynamic script menu methods
     void setupScriptsMenu();
-    void buildScriptMenuRecursively(QMenu* parentMenu, const QString& dirPath, const QString& styleSheet);
+    void syncScriptsMenu(QMenu* menu, const QString& styleSheet);
+    void syncScriptSubmenu(QMenu* menu, const ScriptDirNodePtr& node, const QString& styleSheet);
     bool isScriptFile(const QString& fileName);
     QAction* createScriptFileAction(const QFileInfo& fileInfo);
     void openScriptFileWithDialog(const QString& filePath);
@@ -1,5 +1,8 @@
 #include "miscdarkreportdialog.h"
 
+#include "scriptrunner.h"
+#include "scriptrunnerbindinghelper.h"
+
 #include <QApplication>
 #include <QByteArray>
 #include <QClipboard>
@@ -15,7 +18,7 @@
 #include <QLineEdit>
 #include <QMap>
 #include <QMimeData>
-#include <QProcess>
+#include <QProgressBar>
 #include <QPushButton>
 #include <QRegularExpression>
 #include <QRegularExpressionValidator>
@@ -25,6 +28,7 @@
 #include <QVBoxLayout>
 #include <QHBoxLayout>
 #include <QStringList>
+#include <QTimer>
 #include <QVector>
 
 namespace {
@@ -33,6 +37,7 @@ const QString kRuntimeDarkReportScriptPath =
 constexpr double kDomesticRate = 1.310;
 constexpr double kDefaultInternationalRate = 5.740;
 constexpr int kResultsRowHeight = 34;
+constexpr int kProcessorTimeoutMs = 120000;
 const QMap<QString, double> kInternationalRateOverrides = {
     {QStringLiteral("CANADA"), 3.440},
 };
@@ -137,6 +142,11 @@ MiscDarkReportDialog::MiscDarkReportDialog(QWidget* parent)
     , m_copyButton(nullptr)
     , m_closeButton(nullptr)
     , m_statusLabel(nullptr)
+    , m_progressBar(nullptr)
+    , m_scriptRunner(new ScriptRunner(this))
+    , m_timeoutTimer(new QTimer(this))
+    , m_resultEventSeen(false)
+    , m_timedOut(false)
     , m_running(false)
     , m_hasResults(false)
 {
@@ -146,6 +156,25 @@ MiscDarkReportDialog::MiscDarkReportDialog(QWidget* parent)
     setWindowFlags(Qt::Dialog | Qt::WindowTitleHint | Qt::CustomizeWindowHint);
 
     setupUi();
+
+    // The processor never prompts, so it runs without the input wrapper
+    m_scriptRunner->setInputWrapperEnabled(false);
+    // The --json payload is UTF-8, and only stdout may carry it
+    m_scriptRunner->setUtf8OutputEnabled(true);
+    ScriptRunnerBindingHelper::setupBaselineBindings(
+        m_scriptRunner,
+        this,
+        [](const QString&) {},
+        [this](int exitCode, QProcess::ExitStatus exitStatus) { onProcessorFinished(exitCode, exitStatus); },
+        [this](const QString& errorOutput) { m_stderrLines.append(errorOutput); });
+    connect(m_scriptRunner, &ScriptRunner::scriptStandardOutput, this,
+            [this](const QStringList& lines) { m_stdoutLines.append(lines); });
+    connect(m_scriptRunner, &ScriptRunner::scriptResult, this, &MiscDarkReportDialog::onProcessorResult);
+    ScriptRunnerBindingHelper::bindProgressBar(m_scriptRunner, m_progressBar);
+
+    m_timeoutTimer->setSingleShot(true);
+    connect(m_timeoutTimer, &QTimer::timeout, this, &MiscDarkReportDialog::onProcessorTimeout);
+
     resetTable();
     updateControlStates();
     setStatusMessage("Choose a file, enter a 5-digit job number, then click PROCESS.",
@@ -222,49 +251,9 @@ void MiscDarkReportDialog::onProcessClicked()
     setStatusMessage("Processing file...", TerminalSeverity::Info);
 
     QString errorMessage;
-    QString outputFilePath;
-    int domesticCount = 0;
-    int internationalCount = 0;
-    int totalCount = 0;
-    QMap<QString, int> internationalCountryCounts;
-
-    const bool ok = runProcessorScript(m_selectedFilePath,
-                                       jobNumber,
-                                       &errorMessage,
-                                       &domesticCount,
-                                       &internationalCount,
-                                       &totalCount,
-                                       &internationalCountryCounts,
-                                       &outputFilePath);
-
-    m_running = false;
-    if (!ok) {
-        m_hasResults = false;
-        resetTable();
-        setStatusMessage(errorMessage, TerminalSeverity::Error);
-        emit terminalMessageRequested(QString("THE DARK REPORT: %1").arg(errorMessage),
-                                      TerminalSeverity::Error);
-        updateControlStates();
-        return;
-    }
-
-    if (totalCount != (domesticCount + internationalCount)) {
-        totalCount = domesticCount + internationalCount;
+    if (!startProcessorScript(m_selectedFilePath, jobNumber, &errorMessage)) {
+        finishProcessing(false, errorMessage, QJsonObject());
     }
-
-    populateResultsTable(jobNumber,
-                         domesticCount,
-                         internationalCount,
-                         internationalCountryCounts);
-    m_hasResults = true;
-    updateControlStates();
-    setStatusMessage(
-        QString("PROCESS COMPLETE. Output saved: %1")
-            .arg(QFileInfo(outputFilePath).fileName()),
-        TerminalSeverity::Success);
-    emit terminalMessageRequested(
-        QString("THE DARK REPORT: processed successfully (%1 total pieces).").arg(totalCount),
-        TerminalSeverity::Success);
 }
 
 void MiscDarkReportDialog::onCopyClicked()
@@ -301,6 +290,14 @@ void MiscDarkReportDialog::onCloseClicked()
     }
 }
 
+void MiscDarkReportDialog::reject()
+{
+    // Escape must not close the dialog under a running processor
+    if (!m_running) {
+        QDialog::reject();
+    }
+}
+
 void MiscDarkReportDialog::setupUi()
 {
     QVBoxLayout* mainLayout = new QVBoxLayout(this);
@@ -420,6 +417,12 @@ void MiscDarkReportDialog::setupUi()
     copyLayout->addStretch();
     mainLayout->addLayout(copyLayout);
 
+    m_progressBar = new QProgressBar(this);
+    m_progressBar->setTextVisible(true);
+    m_progressBar->setFont(QFont("Blender Pro", 10));
+    m_progressBar->hide();
+    mainLayout->addWidget(m_progressBar);
+
     m_statusLabel = new QLabel(this);
     m_statusLabel->setWordWrap(true);
     m_statusLabel->setAlignment(Qt::AlignLeft | Qt::AlignVCenter);
@@ -582,34 +585,10 @@ void MiscDarkReportDialog::populateResultsTable(const QString& jobNumber,
                                    + 8);
 }
 
-bool MiscDarkReportDialog::runProcessorScript(const QString& filePath,
-                                              const QString& jobNumber,
-                                              QString* errorMessage,
-                                              int* domesticCount,
-                                              int* internationalCount,
-                                              int* totalCount,
-                                              QMap<QString, int>* internationalCountryCounts,
-                                              QString* outputFilePath)
+bool MiscDarkReportDialog::startProcessorScript(const QString& filePath,
+                                                const QString& jobNumber,
+                                                QString* errorMessage)
 {
-    if (errorMessage) {
-        errorMessage->clear();
-    }
-    if (domesticCount) {
-        *domesticCount = 0;
-    }
-    if (internationalCount) {
-        *internationalCount = 0;
-    }
-    if (totalCount) {
-        *totalCount = 0;
-    }
-    if (internationalCountryCounts) {
-        internationalCountryCounts->clear();
-    }
-    if (outputFilePath) {
-        outputFilePath->clear();
-    }
-
     const QFileInfo scriptInfo(kRuntimeDarkReportScriptPath);
     if (!scriptInfo.exists()) {
         if (errorMessage) {
@@ -619,39 +598,87 @@ bool MiscDarkReportDialog::runProcessorScript(const QString& filePath,
         return false;
     }
 
-    QProcess process;
-    process.setProcessChannelMode(QProcess::SeparateChannels);
+    m_runJobNumber = jobNumber;
+    m_stdoutLines.clear();
+    m_stderrLines.clear();
+    m_resultPayload = QJsonObject();
+    m_resultEventSeen = false;
+    m_timedOut = false;
+
     QStringList arguments;
-    arguments << kRuntimeDarkReportScriptPath
-              << "--input-file" << filePath
+    arguments << "--input-file" << filePath
               << "--job-number" << jobNumber
               << "--json";
 
-    process.start("python", arguments, QIODevice::ReadOnly);
-    if (!process.waitForStarted(5000)) {
+    if (!m_scriptRunner->runScript(kRuntimeDarkReportScriptPath, arguments)) {
         if (errorMessage) {
             *errorMessage = "Failed to start Python process.";
         }
         return false;
     }
 
-    if (!process.waitForFinished(120000)) {
-        process.kill();
-        process.waitForFinished(2000);
-        if (errorMessage) {
-            *errorMessage = "Processing timed out.";
-        }
-        return false;
+    m_timeoutTimer->start(kProcessorTimeoutMs);
+    return true;
+}
+
+void MiscDarkReportDialog::onProcessorResult(const QJsonObject& result)
+{
+    m_resultPayload = result;
+    m_resultEventSeen = true;
+}
+
+void MiscDarkReportDialog::onProcessorTimeout()
+{
+    if (!m_running || !m_scriptRunner->isRunning()) {
+        return;
     }
 
-    const QString stdoutText = QString::fromUtf8(process.readAllStandardOutput()).trimmed();
-    const QString stderrText = QString::fromUtf8(process.readAllStandardError()).trimmed();
+    m_timedOut = true;
+    m_scriptRunner->terminate();
+}
+
+void MiscDarkReportDialog::onProcessorFinished(int exitCode, QProcess::ExitStatus exitStatus)
+{
+    Q_UNUSED(exitCode);
+    m_timeoutTimer->stop();
+
+    if (m_timedOut) {
+        finishProcessing(false, "Processing timed out.", QJsonObject());
+        return;
+    }
 
     QJsonObject payload;
-    bool parsed = false;
-    const QStringList lines = stdoutText.split('\n', Qt::SkipEmptyParts);
-    for (int i = lines.size() - 1; i >= 0; --i) {
-        const QString candidate = lines.at(i).trimmed();
+    QString errorMessage;
+    if (!readProcessorPayload(&payload, &errorMessage)) {
+        if (exitStatus == QProcess::CrashExit && errorMessage.isEmpty()) {
+            errorMessage = "Processing failed. The script crashed.";
+        }
+        finishProcessing(false, errorMessage, QJsonObject());
+        return;
+    }
+
+    if (!payload.value("ok").toBool(false)) {
+        QString error = payload.value("error").toString().trimmed();
+        if (error.isEmpty()) {
+            error = payload.value("detail").toString().trimmed();
+        }
+        finishProcessing(false, error.isEmpty() ? "Processing failed." : error, QJsonObject());
+        return;
+    }
+
+    finishProcessing(true, QString(), payload);
+}
+
+bool MiscDarkReportDialog::readProcessorPayload(QJsonObject* payload, QString* errorMessage) const
+{
+    if (m_resultEventSeen) {
+        *payload = m_resultPayload;
+        return true;
+    }
+
+    // Without the event channel the --json line on stdout still carries the result
+    for (int i = m_stdoutLines.size() - 1; i >= 0; --i) {
+        const QString candidate = m_stdoutLines.at(i).trimmed();
         if (!candidate.startsWith('{') || !candidate.endsWith('}')) {
             continue;
         }
@@ -659,54 +686,63 @@ bool MiscDarkReportDialog::runProcessorScript(const QString& filePath,
         QJsonParseError parseError;
         const QJsonDocument document = QJsonDocument::fromJson(candidate.toUtf8(), &parseError);
         if (parseError.error == QJsonParseError::NoError && document.isObject()) {
-            payload = document.object();
-            parsed = true;
-            break;
+            *payload = document.object();
+            return true;
         }
     }
 
-    if (!parsed) {
-        if (errorMessage) {
-            *errorMessage = stdoutText.isEmpty()
-                ? QString("Processing failed. %1").arg(stderrText.isEmpty() ? "No output returned." : stderrText)
-                : QString("Processing returned invalid output: %1").arg(stdoutText);
-        }
-        return false;
-    }
+    const QString stdoutText = m_stdoutLines.join('\n').trimmed();
+    const QString stderrText = m_stderrLines.join('\n').trimmed();
+    *errorMessage = stdoutText.isEmpty()
+        ? QString("Processing failed. %1").arg(stderrText.isEmpty() ? "No output returned." : stderrText)
+        : QString("Processing returned invalid output: %1").arg(stdoutText);
+    return false;
+}
 
-    if (!payload.value("ok").toBool(false)) {
-        if (errorMessage) {
-            const QString error = payload.value("error").toString().trimmed();
-            *errorMessage = error.isEmpty() ? "Processing failed." : error;
-        }
-        return false;
+void MiscDarkReportDialog::finishProcessing(bool ok, const QString& errorMessage, const QJsonObject& payload)
+{
+    m_running = false;
+    if (!ok) {
+        m_hasResults = false;
+        resetTable();
+        setStatusMessage(errorMessage, TerminalSeverity::Error);
+        emit terminalMessageRequested(QString("THE DARK REPORT: %1").arg(errorMessage),
+                                      TerminalSeverity::Error);
+        updateControlStates();
+        return;
     }
 
-    if (domesticCount) {
-        *domesticCount = payload.value("domestic_count").toInt(0);
-    }
-    if (internationalCount) {
-        *internationalCount = payload.value("international_count").toInt(0);
-    }
-    if (totalCount) {
-        *totalCount = payload.value("total_count").toInt(0);
+    const int domesticCount = payload.value("domestic_count").toInt(0);
+    const int internationalCount = payload.value("international_count").toInt(0);
+    int totalCount = payload.value("total_count").toInt(0);
+    if (totalCount != (domesticCount + internationalCount)) {
+        totalCount = domesticCount + internationalCount;
     }
-    if (internationalCountryCounts) {
-        const QJsonObject countryCounts =
-            payload.value("international_country_counts").toObject();
-        for (auto it = countryCounts.constBegin(); it != countryCounts.constEnd(); ++it) {
-            const QString country = it.key().trimmed().toUpper();
-            const int count = it.value().toInt(0);
-            if (!country.isEmpty() && count > 0) {
-                internationalCountryCounts->insert(country, count);
-            }
+
+    QMap<QString, int> internationalCountryCounts;
+    const QJsonObject countryCounts = payload.value("international_country_counts").toObject();
+    for (auto it = countryCounts.constBegin(); it != countryCounts.constEnd(); ++it) {
+        const QString country = it.key().trimmed().toUpper();
+        const int count = it.value().toInt(0);
+        if (!country.isEmpty() && count > 0) {
+            internationalCountryCounts.insert(country, count);
         }
     }
-    if (outputFilePath) {
-        *outputFilePath = payload.value("output_file").toString().trimmed();
-    }
+    const QString outputFilePath = payload.value("output_file").toString().trimmed();
 
-    return true;
+    populateResultsTable(m_runJobNumber,
+                         domesticCount,
+                         internationalCount,
+                         internationalCountryCounts);
+    m_hasResults = true;
+    updateControlStates();
+    setStatusMessage(
+        QString("PROCESS COMPLETE. Output saved: %1")
+            .arg(QFileInfo(outputFilePath).fileName()),
+        TerminalSeverity::Success);
+    emit terminalMessageRequested(
+        QString("THE DARK REPORT: processed successfully (%1 total pieces).").arg(totalCount),
+        TerminalSeverity::Success);
 }
 
 QString MiscDarkReportDialog::statusColorForSeverity(TerminalSeverity severity)
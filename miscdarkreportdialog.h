@@ -2,15 +2,21 @@
 #define MISCDARKREPORTDIALOG_H
 
 #include <QDialog>
+#include <QJsonObject>
 #include <QMap>
+#include <QProcess>
+#include <QStringList>
 
 #include "terminaloutputhelper.h"
 
 class QLabel;
 class QLineEdit;
+class QProgressBar;
 class QPushButton;
 class QTableWidget;
 class QTableWidgetItem;
+class QTimer;
+class ScriptRunner;
 
 class MiscDarkReportDialog : public QDialog
 {
@@ -25,11 +31,17 @@ public:
 signals:
     void terminalMessageRequested(const QString& message, TerminalSeverity severity);
 
+public slots:
+    void reject() override;
+
 private slots:
     void onChooseFileClicked();
     void onProcessClicked();
     void onCopyClicked();
     void onCloseClicked();
+    void onProcessorResult(const QJsonObject& result);
+    void onProcessorFinished(int exitCode, QProcess::ExitStatus exitStatus);
+    void onProcessorTimeout();
 
 private:
     void setupUi();
@@ -39,14 +51,11 @@ private:
                               int domesticCount,
                               int internationalCount,
                               const QMap<QString, int>& internationalCountryCounts);
-    bool runProcessorScript(const QString& filePath,
-                            const QString& jobNumber,
-                            QString* errorMessage,
-                            int* domesticCount,
-                            int* internationalCount,
-                            int* totalCount,
-                            QMap<QString, int>* internationalCountryCounts,
-                            QString* outputFilePath);
+    bool startProcessorScript(const QString& filePath,
+                              const QString& jobNumber,
+                              QString* errorMessage);
+    bool readProcessorPayload(QJsonObject* payload, QString* errorMessage) const;
+    void finishProcessing(bool ok, const QString& errorMessage, const QJsonObject& payload);
     static QString statusColorForSeverity(TerminalSeverity severity);
     static QString formatCurrency(double value);
     void setCell(int row,
@@ -65,8 +74,18 @@ private:
     QPushButton* m_copyButton;
     QPushButton* m_closeButton;
     QLabel* m_statusLabel;
+    QProgressBar* m_progressBar;
+
+    ScriptRunner* m_scriptRunner;
+    QTimer* m_timeoutTimer;
 
     QString m_selectedFilePath;
+    QString m_runJobNumber;
+    QStringList m_stdoutLines;          // fallback source when no result event arrives
+    QStringList m_stderrLines;
+    QJsonObject m_resultPayload;
+    bool m_resultEventSeen;
+    bool m_timedOut;
     bool m_running;
     bool m_hasResults;
 };
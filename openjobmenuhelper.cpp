@@ -3,6 +3,7 @@
 #include <QAction>
 #include <QHash>
 #include <QObject>
+#include <QSet>
 #include <algorithm>
 #include <limits>
 
@@ -15,12 +16,10 @@ int toIntOr(const QString& value, int fallback)
     return ok ? parsed : fallback;
 }
 
-void buildMenu(QMenu* rootMenu, QObject* receiver, const QList<JobRow>& jobs, const BuildSpec& spec)
-{
-    if (!rootMenu) {
-        return;
-    }
+namespace {
 
+QList<JobRow> sortJobs(const QList<JobRow>& jobs, const BuildSpec& spec)
+{
     QList<JobRow> sortedJobs = jobs;
 
     const auto yearValue = [&](const JobRow& row) {
@@ -56,6 +55,50 @@ void buildMenu(QMenu* rootMenu, QObject* receiver, const QList<JobRow>& jobs, co
         return a.value("job_number") > b.value("job_number");
     });
 
+    return sortedJobs;
+}
+
+// Identity of a row for menu diffing: every field and value
+QString rowSignature(const JobRow& row)
+{
+    QString signature;
+    for (auto it = row.constBegin(); it != row.constEnd(); ++it) {
+        signature += it.key() + QChar('=') + it.value() + QChar(0x1F);
+    }
+    return signature;
+}
+
+void connectTrigger(QAction* action, QObject* receiver, const BuildSpec& spec, const JobRow& row)
+{
+    if (spec.onTriggered) {
+        QObject::connect(action, &QAction::triggered, receiver, [handler = spec.onTriggered, row]() {
+            handler(row);
+        });
+    }
+}
+
+void arrangeActions(QMenu* menu, const QList<QAction*>& desired)
+{
+    if (menu->actions() == desired) {
+        return;
+    }
+    const QList<QAction*> current = menu->actions();
+    for (QAction* action : current) {
+        menu->removeAction(action);
+    }
+    menu->addActions(desired);
+}
+
+} // namespace
+
+void buildMenu(QMenu* rootMenu, QObject* receiver, const QList<JobRow>& jobs, const BuildSpec& spec)
+{
+    if (!rootMenu) {
+        return;
+    }
+
+    const QList<JobRow> sortedJobs = sortJobs(jobs, spec);
+
     QHash<QString, QMenu*> yearMenus;
     QHash<QString, QMenu*> monthMenus;
 
@@ -90,11 +133,127 @@ void buildMenu(QMenu* rootMenu, QObject* receiver, const QList<JobRow>& jobs, co
             spec.configureAction(action, row);
         }
 
-        if (spec.onTriggered) {
-            QObject::connect(action, &QAction::triggered, receiver, [handler = spec.onTriggered, row]() {
-                handler(row);
-            });
+        connectTrigger(action, receiver, spec, row);
+    }
+}
+
+void resetMenu(QMenu* rootMenu, MenuState& state)
+{
+    qDeleteAll(state.yearMenus);
+    state.yearMenus.clear();
+    state.monthMenus.clear();
+    state.actions.clear();
+    state.context.clear();
+    state.revision = 0;
+    if (rootMenu) {
+        rootMenu->clear();
+    }
+}
+
+bool isCurrent(const MenuState& state, const QString& context, quint64 revision)
+{
+    return !state.context.isEmpty() && state.context == context && state.revision == revision;
+}
+
+void syncMenu(QMenu* rootMenu, QObject* receiver, MenuState& state, const QString& context,
+              quint64 revision, const QList<JobRow>& jobs, const BuildSpec& spec)
+{
+    if (!rootMenu) {
+        return;
+    }
+    if (state.context != context) {
+        resetMenu(rootMenu, state);
+        state.context = context;
+    } else if (state.revision == revision) {
+        return;
+    }
+    state.revision = revision;
+
+    const QList<JobRow> sortedJobs = sortJobs(jobs, spec);
+
+    QSet<QString> wanted;
+    for (const JobRow& row : sortedJobs) {
+        wanted.insert(rowSignature(row));
+    }
+    for (auto it = state.actions.begin(); it != state.actions.end();) {
+        if (!wanted.contains(it.key())) {
+            delete it.value();
+            it = state.actions.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    // Walk the rows in menu order, reusing existing actions and submenus
+    QList<QAction*> rootOrder;
+    QHash<QMenu*, QList<QAction*>> childOrder;
+    QSet<QMenu*> usedMenus;
+
+    for (const JobRow& row : sortedJobs) {
+        const QString yearText = spec.yearMenuText ? spec.yearMenuText(row) : row.value("year");
+        QMenu* yearMenu = state.yearMenus.value(yearText, nullptr);
+        if (!yearMenu) {
+            yearMenu = new QMenu(yearText, rootMenu);
+            state.yearMenus.insert(yearText, yearMenu);
+        }
+        if (!usedMenus.contains(yearMenu)) {
+            usedMenus.insert(yearMenu);
+            rootOrder.append(yearMenu->menuAction());
+        }
+
+        QMenu* targetMenu = yearMenu;
+        if (spec.groupByMonth) {
+            const QString monthText = spec.monthMenuText ? spec.monthMenuText(row) : row.value("month");
+            const QString monthKey = yearText + "|" + monthText;
+            QMenu* monthMenu = state.monthMenus.value(monthKey, nullptr);
+            if (!monthMenu) {
+                monthMenu = new QMenu(monthText, yearMenu);
+                state.monthMenus.insert(monthKey, monthMenu);
+            }
+            if (!usedMenus.contains(monthMenu)) {
+                usedMenus.insert(monthMenu);
+                childOrder[yearMenu].append(monthMenu->menuAction());
+            }
+            targetMenu = monthMenu;
         }
+
+        const QString signature = rowSignature(row);
+        QAction* action = state.actions.value(signature, nullptr);
+        if (!action) {
+            if (spec.beforeAddAction) {
+                spec.beforeAddAction(row);
+            }
+            action = new QAction(spec.actionText ? spec.actionText(row) : row.value("job_number"), targetMenu);
+            if (spec.configureAction) {
+                spec.configureAction(action, row);
+            }
+            connectTrigger(action, receiver, spec, row);
+            state.actions.insert(signature, action);
+        }
+        childOrder[targetMenu].append(action);
+    }
+
+    // Submenus left without jobs; month menus first since year menus own them
+    for (auto it = state.monthMenus.begin(); it != state.monthMenus.end();) {
+        if (!usedMenus.contains(it.value())) {
+            delete it.value();
+            it = state.monthMenus.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    for (auto it = state.yearMenus.begin(); it != state.yearMenus.end();) {
+        if (!usedMenus.contains(it.value())) {
+            delete it.value();
+            it = state.yearMenus.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    arrangeActions(rootMenu, rootOrder);
+    for (auto it = childOrder.constBegin(); it != childOrder.constEnd(); ++it) {
+        arrangeActions(it.key(), it.value());
     }
 }
 
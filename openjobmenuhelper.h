@@ -1,6 +1,7 @@
 #ifndef OPENJOBMENUHELPER_H
 #define OPENJOBMENUHELPER_H
 
+#include <QHash>
 #include <QList>
 #include <QMap>
 #include <QMenu>
@@ -32,6 +33,38 @@ struct BuildSpec {
 
 void buildMenu(QMenu* rootMenu, QObject* receiver, const QList<JobRow>& jobs, const BuildSpec& spec);
 
+/**
+ * @brief What syncMenu() last put into a menu, so later calls can diff
+ */
+struct MenuState {
+    QString context;                        // tab the menu was built for
+    quint64 revision = 0;                   // JobIndex revision it reflects
+    QHash<QString, QAction*> actions;       // by row signature
+    QHash<QString, QMenu*> yearMenus;
+    QHash<QString, QMenu*> monthMenus;      // by "year|month" text
+};
+
+/**
+ * @brief Clear the menu (including placeholders) and forget its state
+ */
+void resetMenu(QMenu* rootMenu, MenuState& state);
+
+/**
+ * @brief True if the menu already shows this context at this revision
+ */
+bool isCurrent(const MenuState& state, const QString& context, quint64 revision);
+
+/**
+ * @brief Bring the menu in line with jobs, touching only what changed
+ *
+ * Returns immediately when context and revision match the last call.
+ * Otherwise actions for removed rows are deleted, new rows get actions
+ * (beforeAddAction/configureAction run for those only), empty submenus are
+ * dropped and menus whose order changed are re-laid out.
+ */
+void syncMenu(QMenu* rootMenu, QObject* receiver, MenuState& state, const QString& context,
+              quint64 revision, const QList<JobRow>& jobs, const BuildSpec& spec);
+
 } // namespace OpenJobMenuHelper
 
 #endif // OPENJOBMENUHELPER_H
@@ -0,0 +1,356 @@
+#include "printdirwatcher.h"
+#include "tracer.h"
+
+#include <QDateTime>
+#include <QDir>
+#include <QDirIterator>
+#include <QFileInfo>
+#include <QtConcurrent>
+
+namespace {
+
+const int kDefaultDebounceMs = 300;
+
+// Closest directory at or above path that exists; empty if none does
+QString nearestExistingDir(const QString& path)
+{
+    QString current = QDir::cleanPath(QFileInfo(path).absoluteFilePath());
+    while (!current.isEmpty()) {
+        if (QFileInfo(current).isDir()) {
+            return current;
+        }
+        const QString parent = QFileInfo(current).absolutePath();
+        if (parent == current) {
+            break;
+        }
+        current = parent;
+    }
+    return QString();
+}
+
+} // namespace
+
+PrintDirWatcher::PrintDirWatcher(QObject* parent)
+    : QObject(parent)
+{
+    m_clock.start();
+
+    m_debounceTimer.setSingleShot(true);
+    m_debounceTimer.setInterval(kDefaultDebounceMs);
+    connect(&m_debounceTimer, &QTimer::timeout, this, &PrintDirWatcher::startCycle);
+
+    m_settleTimer.setSingleShot(true);
+    m_settleTimer.setInterval(m_settleMs);
+    connect(&m_settleTimer, &QTimer::timeout, this, &PrintDirWatcher::startCycle);
+
+    connect(&m_fsWatcher, &QFileSystemWatcher::directoryChanged, this, &PrintDirWatcher::onWatcherDirectoryChanged);
+    connect(&m_cycleWatcher, &QFutureWatcher<CycleResult>::finished, this, &PrintDirWatcher::onCycleFinished);
+}
+
+PrintDirWatcher::~PrintDirWatcher()
+{
+    m_cycleWatcher.waitForFinished();
+}
+
+void PrintDirWatcher::setDirectories(const QStringList& directories)
+{
+    ++m_generation;     // results of a cycle already running are dropped
+
+    const QStringList watched = m_fsWatcher.directories();
+    if (!watched.isEmpty()) {
+        m_fsWatcher.removePaths(watched);
+    }
+    m_debounceTimer.stop();
+    m_settleTimer.stop();
+    m_snapshots.clear();
+    m_pending.clear();
+    m_dirty.clear();
+    m_baselinePending.clear();
+    m_missing.clear();
+
+    m_directories = directories;
+    for (const QString& directory : directories) {
+        watchDirectory(directory);
+        m_dirty.insert(directory);
+        m_baselinePending.insert(directory);
+    }
+    startCycle();
+}
+
+void PrintDirWatcher::setTimings(int debounceMs, int settleMs)
+{
+    m_debounceTimer.setInterval(qMax(0, debounceMs));
+    m_settleMs = qMax(0, settleMs);
+    m_settleTimer.setInterval(m_settleMs);
+}
+
+PrintDirWatcher::Snapshot PrintDirWatcher::scanDirectory(const QString& directory)
+{
+    TRACE_SCOPE_DETAIL("io", "PrintDirWatcher::scanDirectory", directory);
+
+    Snapshot snapshot;
+    QDirIterator it(directory, QDir::Files | QDir::NoDotAndDotDot);
+    while (it.hasNext()) {
+        it.next();
+        const QFileInfo info = it.fileInfo();
+        Entry entry;
+        entry.size = info.size();
+        entry.modifiedMs = info.lastModified().toMSecsSinceEpoch();
+        snapshot.insert(info.fileName(), entry);
+    }
+    return snapshot;
+}
+
+void PrintDirWatcher::onWatcherDirectoryChanged(const QString& path)
+{
+    if (m_missing.contains(path)) {
+        rewatchMissing(path);
+    }
+    if (m_directories.contains(path)) {
+        if (!QFileInfo(path).isDir()) {
+            // Deleted: the watcher dropped it, so wait for it on an ancestor
+            watchDirectory(path);
+        }
+        m_dirty.insert(path);
+    }
+    m_debounceTimer.start();
+}
+
+void PrintDirWatcher::watchDirectory(const QString& directory)
+{
+    const QStringList watched = m_fsWatcher.directories();
+    if (QFileInfo(directory).isDir()) {
+        if (!watched.contains(directory)) {
+            m_fsWatcher.addPath(directory);
+        }
+        return;
+    }
+
+    if (watched.contains(directory)) {
+        m_fsWatcher.removePath(directory);
+    }
+    const QString ancestor = nearestExistingDir(directory);
+    if (ancestor.isEmpty()) {
+        return;
+    }
+    m_missing[ancestor].insert(directory);
+    if (!watched.contains(ancestor)) {
+        m_fsWatcher.addPath(ancestor);
+    }
+}
+
+void PrintDirWatcher::rewatchMissing(const QString& ancestor)
+{
+    const QSet<QString> missing = m_missing.take(ancestor);
+    if (!m_directories.contains(ancestor)) {
+        m_fsWatcher.removePath(ancestor);
+    }
+
+    // Re-added either on the directory itself or on a closer ancestor that now exists
+    for (const QString& directory : missing) {
+        watchDirectory(directory);
+        if (QFileInfo(directory).isDir()) {
+            m_dirty.insert(directory);
+        }
+    }
+}
+
+void PrintDirWatcher::startCycle()
+{
+    if (m_cycleWatcher.isRunning()) {
+        m_cycleRequested = true;
+        return;
+    }
+    m_cycleRequested = false;
+
+    // Dirty directories are listed in full; elsewhere only the files still settling are checked
+    const QSet<QString> dirty = m_dirty;
+    m_dirty.clear();
+    QHash<QString, QStringList> statted;
+    for (auto it = m_pending.cbegin(); it != m_pending.cend(); ++it) {
+        if (!dirty.contains(it.key()) && !it.value().isEmpty()) {
+            statted.insert(it.key(), it.value().keys());
+        }
+    }
+    if (dirty.isEmpty() && statted.isEmpty()) {
+        return;
+    }
+
+    const quint64 generation = m_generation;
+    m_cycleWatcher.setFuture(QtConcurrent::run([generation, dirty, statted]() {
+        CycleResult result;
+        result.generation = generation;
+        for (const QString& directory : dirty) {
+            result.scans.insert(directory, scanDirectory(directory));
+        }
+        for (auto it = statted.cbegin(); it != statted.cend(); ++it) {
+            Snapshot found;
+            for (const QString& name : it.value()) {
+                const QFileInfo info(it.key() + "/" + name);
+                if (info.exists()) {
+                    Entry entry;
+                    entry.size = info.size();
+                    entry.modifiedMs = info.lastModified().toMSecsSinceEpoch();
+                    found.insert(name, entry);
+                }
+            }
+            result.stats.insert(it.key(), found);
+        }
+        result.statted = statted;
+        return result;
+    }));
+}
+
+void PrintDirWatcher::onCycleFinished()
+{
+    const CycleResult result = m_cycleWatcher.result();
+    if (result.generation != m_generation) {
+        startCycle();
+        return;
+    }
+
+    const qint64 now = m_clock.elapsed();
+    QList<PrintDirDiff> diffs;
+
+    for (auto it = result.scans.cbegin(); it != result.scans.cend(); ++it) {
+        const QString& directory = it.key();
+        if (!m_directories.contains(directory)) {
+            continue;
+        }
+        if (m_baselinePending.remove(directory)) {
+            m_snapshots.insert(directory, it.value());
+            m_pending.remove(directory);
+            continue;
+        }
+
+        PrintDirDiff diff;
+        diff.directory = directory;
+        applyScan(directory, it.value(), now, diff);
+        settle(directory, now, diff);
+        diffs.append(diff);
+    }
+
+    for (auto it = result.statted.cbegin(); it != result.statted.cend(); ++it) {
+        const QString& directory = it.key();
+        if (!m_pending.contains(directory)) {
+            continue;
+        }
+
+        PrintDirDiff diff;
+        diff.directory = directory;
+        applyStats(directory, it.value(), result.stats.value(directory), now, diff);
+        settle(directory, now, diff);
+        diffs.append(diff);
+    }
+
+    if (!m_pending.isEmpty()) {
+        m_settleTimer.start();
+    }
+    if (m_cycleRequested) {
+        startCycle();
+    }
+
+    for (PrintDirDiff& diff : diffs) {
+        if (diff.isEmpty()) {
+            continue;
+        }
+        diff.added.sort(Qt::CaseInsensitive);
+        diff.modified.sort(Qt::CaseInsensitive);
+        diff.removed.sort(Qt::CaseInsensitive);
+        emit directoryChanged(diff);
+    }
+}
+
+void PrintDirWatcher::applyScan(const QString& directory, const Snapshot& scan, qint64 now, PrintDirDiff& diff)
+{
+    Snapshot& committed = m_snapshots[directory];
+    QHash<QString, PendingFile>& pending = m_pending[directory];
+
+    for (auto it = committed.begin(); it != committed.end();) {
+        if (!scan.contains(it.key())) {
+            diff.removed.append(it.key());
+            it = committed.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    for (auto it = pending.begin(); it != pending.end();) {
+        if (!scan.contains(it.key())) {
+            it = pending.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    for (auto it = scan.cbegin(); it != scan.cend(); ++it) {
+        auto pendingIt = pending.find(it.key());
+        if (pendingIt != pending.end()) {
+            if (pendingIt->entry != it.value()) {
+                pendingIt->entry = it.value();
+                pendingIt->changedAtMs = now;
+            }
+        } else {
+            auto committedIt = committed.constFind(it.key());
+            if (committedIt == committed.constEnd() || committedIt.value() != it.value()) {
+                PendingFile file;
+                file.entry = it.value();
+                file.changedAtMs = now;
+                pending.insert(it.key(), file);
+            }
+        }
+    }
+}
+
+void PrintDirWatcher::applyStats(const QString& directory, const QStringList& names, const Snapshot& stats,
+                                 qint64 now, PrintDirDiff& diff)
+{
+    Snapshot& committed = m_snapshots[directory];
+    QHash<QString, PendingFile>& pending = m_pending[directory];
+
+    for (const QString& name : names) {
+        auto pendingIt = pending.find(name);
+        if (pendingIt == pending.end()) {
+            continue;
+        }
+
+        auto statIt = stats.constFind(name);
+        if (statIt == stats.constEnd()) {
+            // Gone before it settled
+            pending.erase(pendingIt);
+            if (committed.remove(name) > 0) {
+                diff.removed.append(name);
+            }
+        } else if (pendingIt->entry != statIt.value()) {
+            pendingIt->entry = statIt.value();
+            pendingIt->changedAtMs = now;
+        }
+    }
+}
+
+void PrintDirWatcher::settle(const QString& directory, qint64 now, PrintDirDiff& diff)
+{
+    auto pendingDir = m_pending.find(directory);
+    if (pendingDir == m_pending.end()) {
+        return;
+    }
+
+    Snapshot& committed = m_snapshots[directory];
+    QHash<QString, PendingFile>& pending = pendingDir.value();
+    for (auto it = pending.begin(); it != pending.end();) {
+        if (now - it->changedAtMs < m_settleMs) {
+            ++it;
+            continue;
+        }
+        if (committed.contains(it.key())) {
+            diff.modified.append(it.key());
+        } else {
+            diff.added.append(it.key());
+        }
+        committed.insert(it.key(), it->entry);
+        it = pending.erase(it);
+    }
+
+    if (pending.isEmpty()) {
+        m_pending.erase(pendingDir);
+    }
+}
@@ -0,0 +1,128 @@
+#ifndef PRINTDIRWATCHER_H
+#define PRINTDIRWATCHER_H
+
+#include <QElapsedTimer>
+#include <QFileSystemWatcher>
+#include <QFutureWatcher>
+#include <QHash>
+#include <QObject>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <QTimer>
+
+/**
+ * @brief Files that changed in one watched directory (names only, sorted)
+ */
+struct PrintDirDiff {
+    QString directory;
+    QStringList added;
+    QStringList modified;
+    QStringList removed;
+
+    bool isEmpty() const { return added.isEmpty() && modified.isEmpty() && removed.isEmpty(); }
+};
+
+/**
+ * @brief Debounced, diffing watcher for the PRINT/ARCHIVE output directories
+ *
+ * Keeps a (name, size, mtime) snapshot per watched directory. Change
+ * notifications are coalesced for a short debounce interval before the
+ * dirty directories are listed on a worker thread. New or modified files are
+ * only reported once they are stable, i.e. their size and modification time
+ * have not changed for the settle interval; until then only those files are
+ * re-stat'ed, never the whole directory. Removals are reported straight away.
+ *
+ * A directory that does not exist yet (or is deleted) cannot be watched
+ * itself; its nearest existing ancestor is watched instead, and the
+ * directory is watched and listed again as soon as it appears.
+ */
+class PrintDirWatcher : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Entry {
+        qint64 size = -1;
+        qint64 modifiedMs = 0;
+
+        bool operator==(const Entry& other) const { return size == other.size && modifiedMs == other.modifiedMs; }
+        bool operator!=(const Entry& other) const { return !(*this == other); }
+    };
+
+    using Snapshot = QHash<QString, Entry>;     // keyed by file name
+
+    explicit PrintDirWatcher(QObject* parent = nullptr);
+    ~PrintDirWatcher();
+
+    /**
+     * @brief Replace the watched directories
+     *
+     * Each directory's current contents become its baseline; nothing is
+     * reported for files that were already there.
+     */
+    void setDirectories(const QStringList& directories);
+    QStringList directories() const { return m_directories; }
+
+    /**
+     * @brief Set the burst debounce and the stability interval (milliseconds)
+     */
+    void setTimings(int debounceMs, int settleMs);
+
+    /**
+     * @brief Stable files of a watched directory as last reported
+     */
+    Snapshot snapshot(const QString& directory) const { return m_snapshots.value(directory); }
+
+    /**
+     * @brief List a directory's files synchronously
+     */
+    static Snapshot scanDirectory(const QString& directory);
+
+signals:
+    /**
+     * @brief Emitted once per settled batch of changes in a directory
+     */
+    void directoryChanged(const PrintDirDiff& diff);
+
+private:
+    struct PendingFile {
+        Entry entry;
+        qint64 changedAtMs = 0;
+    };
+
+    struct CycleResult {
+        quint64 generation = 0;
+        QHash<QString, Snapshot> scans;         // full listings of dirty directories
+        QHash<QString, QStringList> statted;    // pending files re-checked in other directories
+        QHash<QString, Snapshot> stats;         // ... and what was found (missing files are absent)
+    };
+
+    void onWatcherDirectoryChanged(const QString& path);
+    void watchDirectory(const QString& directory);
+    void rewatchMissing(const QString& ancestor);
+    void startCycle();
+    void onCycleFinished();
+    void applyScan(const QString& directory, const Snapshot& scan, qint64 now, PrintDirDiff& diff);
+    void applyStats(const QString& directory, const QStringList& names, const Snapshot& stats, qint64 now,
+                    PrintDirDiff& diff);
+    void settle(const QString& directory, qint64 now, PrintDirDiff& diff);
+
+    QFileSystemWatcher m_fsWatcher;
+    QStringList m_directories;
+    QHash<QString, Snapshot> m_snapshots;
+    QHash<QString, QHash<QString, PendingFile>> m_pending;
+    QSet<QString> m_dirty;
+    QSet<QString> m_baselinePending;            // first listing is taken as-is, without a diff
+    QHash<QString, QSet<QString>> m_missing;    // watched ancestor -> missing directories below it
+
+    QTimer m_debounceTimer;
+    QTimer m_settleTimer;
+    int m_settleMs = 1500;
+    QElapsedTimer m_clock;
+    quint64 m_generation = 0;
+    bool m_cycleRequested = false;
+    QFutureWatcher<CycleResult> m_cycleWatcher;
+};
+
+#endif // PRINTDIRWATCHER_H
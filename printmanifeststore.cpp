@@ -0,0 +1,327 @@
+#include "printmanifeststore.h"
+#include "tracer.h"
+
+#include <QDebug>
+#include <QDir>
+#include <QFileInfo>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QStandardPaths>
+#include <QVariant>
+
+namespace {
+
+const char* const kConnectionName = "print_manifest";
+const qint64 kSessionRetentionMs = 30LL * 24 * 60 * 60 * 1000;
+
+} // namespace
+
+PrintManifestStore& PrintManifestStore::instance()
+{
+    static PrintManifestStore store;
+    return store;
+}
+
+PrintManifestStore::PrintManifestStore()
+{
+    const QString cacheDir = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + "/cache";
+    QDir().mkpath(cacheDir);
+    m_databasePath = cacheDir + "/print_manifest.db";
+}
+
+PrintManifestStore::~PrintManifestStore()
+{
+    if (m_db.isValid()) {
+        m_db.close();
+        m_db = QSqlDatabase();
+        QSqlDatabase::removeDatabase(kConnectionName);
+    }
+}
+
+bool PrintManifestStore::open(QString* error)
+{
+    if (m_db.isOpen()) {
+        return true;
+    }
+    if (m_openAttempted) {
+        if (error) {
+            *error = QStringLiteral("Print manifest database is unavailable");
+        }
+        return false;
+    }
+    m_openAttempted = true;
+
+    m_db = QSqlDatabase::addDatabase("QSQLITE", kConnectionName);
+    m_db.setDatabaseName(m_databasePath);
+    if (!m_db.open()) {
+        if (error) {
+            *error = QString("Cannot open print manifest %1: %2").arg(m_databasePath, m_db.lastError().text());
+        }
+        qWarning() << "Print manifest: failed to open" << m_databasePath << ":" << m_db.lastError().text();
+        return false;
+    }
+
+    // WAL lets the post-print scripts read while the app records watcher diffs
+    QSqlQuery query(m_db);
+    query.exec("PRAGMA journal_mode=WAL");
+    query.exec("PRAGMA synchronous=NORMAL");
+    query.exec("PRAGMA busy_timeout=5000");
+
+    const QStringList schema = {
+        "CREATE TABLE IF NOT EXISTS print_manifest ("
+        "directory TEXT NOT NULL, "
+        "name TEXT NOT NULL, "
+        "size INTEGER NOT NULL, "
+        "mtime_utc_ms INTEGER NOT NULL, "
+        "updated_seq INTEGER NOT NULL, "
+        "PRIMARY KEY (directory, name))",
+        "CREATE INDEX IF NOT EXISTS idx_print_manifest_seq ON print_manifest (directory, updated_seq)",
+        "CREATE TABLE IF NOT EXISTS print_manifest_dirs ("
+        "directory TEXT PRIMARY KEY, "
+        "seq INTEGER NOT NULL)",
+        "CREATE TABLE IF NOT EXISTS print_sessions ("
+        "id INTEGER PRIMARY KEY AUTOINCREMENT, "
+        "directory TEXT NOT NULL, "
+        "started_utc_ms INTEGER NOT NULL, "
+        "baseline_seq INTEGER NOT NULL)"
+    };
+    for (const QString& statement : schema) {
+        if (!query.exec(statement)) {
+            if (error) {
+                *error = QString("Cannot create print manifest schema: %1").arg(query.lastError().text());
+            }
+            qWarning() << "Print manifest: schema error:" << query.lastError().text();
+            m_db.close();
+            return false;
+        }
+    }
+    return true;
+}
+
+QString PrintManifestStore::directoryKey(const QString& directory)
+{
+    QString key = QDir::cleanPath(QFileInfo(directory).absoluteFilePath());
+#ifdef Q_OS_WIN
+    key = key.toLower();
+#endif
+    return key;
+}
+
+qint64 PrintManifestStore::nextSequence(const QString& key)
+{
+    QSqlQuery query(m_db);
+    query.prepare("INSERT INTO print_manifest_dirs (directory, seq) VALUES (?, 1) "
+                  "ON CONFLICT(directory) DO UPDATE SET seq = seq + 1");
+    query.addBindValue(key);
+    if (!query.exec()) {
+        return -1;
+    }
+    query.prepare("SELECT seq FROM print_manifest_dirs WHERE directory = ?");
+    query.addBindValue(key);
+    if (!query.exec() || !query.next()) {
+        return -1;
+    }
+    return query.value(0).toLongLong();
+}
+
+void PrintManifestStore::setLiveDirectories(const QStringList& directories)
+{
+    QSet<QString> live;
+    for (const QString& directory : directories) {
+        live.insert(directoryKey(directory));
+    }
+    // A directory that stops being watched must be reconciled again before its next use
+    m_trackedDirectories.intersect(live);
+    m_liveDirectories = live;
+}
+
+bool PrintManifestStore::applyDiff(const PrintDirDiff& diff, const PrintDirWatcher::Snapshot& snapshot)
+{
+    const QString key = directoryKey(diff.directory);
+    if (diff.isEmpty() || !m_trackedDirectories.contains(key)) {
+        return true;    // reconciled from a listing when it is next needed
+    }
+    if (!open(nullptr)) {
+        return false;
+    }
+
+    TRACE_SCOPE_DETAIL("db", "PrintManifestStore::applyDiff", diff.directory);
+
+    m_db.transaction();
+    const qint64 seq = nextSequence(key);
+    bool ok = seq > 0;
+
+    QSqlQuery upsert(m_db);
+    // Unchanged rows keep their sequence number, so a watcher diff that
+    // arrives after a listing already recorded it does not re-stamp the file
+    upsert.prepare("INSERT INTO print_manifest (directory, name, size, mtime_utc_ms, updated_seq) "
+                   "VALUES (?, ?, ?, ?, ?) "
+                   "ON CONFLICT(directory, name) DO UPDATE SET "
+                   "size = excluded.size, mtime_utc_ms = excluded.mtime_utc_ms, updated_seq = excluded.updated_seq "
+                   "WHERE size <> excluded.size OR mtime_utc_ms <> excluded.mtime_utc_ms");
+    const QStringList changed = diff.added + diff.modified;
+    for (const QString& name : changed) {
+        if (!ok) {
+            break;
+        }
+        const PrintDirWatcher::Entry entry = snapshot.value(name);
+        if (entry.size < 0) {
+            continue;
+        }
+        upsert.addBindValue(key);
+        upsert.addBindValue(name);
+        upsert.addBindValue(entry.size);
+        upsert.addBindValue(entry.modifiedMs);
+        upsert.addBindValue(seq);
+        ok = upsert.exec();
+    }
+
+    QSqlQuery remove(m_db);
+    remove.prepare("DELETE FROM print_manifest WHERE directory = ? AND name = ?");
+    for (const QString& name : diff.removed) {
+        if (!ok) {
+            break;
+        }
+        remove.addBindValue(key);
+        remove.addBindValue(name);
+        ok = remove.exec();
+    }
+
+    if (!ok || !m_db.commit()) {
+        m_db.rollback();
+        // The manifest may have missed this change; list the directory before it is used again
+        m_trackedDirectories.remove(key);
+        qWarning() << "Print manifest: failed to record changes for" << diff.directory;
+        return false;
+    }
+    return true;
+}
+
+bool PrintManifestStore::syncDirectory(const QString& directory, QString* error)
+{
+    if (!open(error)) {
+        return false;
+    }
+    if (!QDir(directory).exists()) {
+        if (error) {
+            *error = QString("Directory does not exist: %1").arg(directory);
+        }
+        return false;
+    }
+
+    TRACE_SCOPE_DETAIL("db", "PrintManifestStore::syncDirectory", directory);
+
+    const QString key = directoryKey(directory);
+    const PrintDirWatcher::Snapshot listing = PrintDirWatcher::scanDirectory(directory);
+
+    PrintDirWatcher::Snapshot recorded;
+    QSqlQuery select(m_db);
+    select.prepare("SELECT name, size, mtime_utc_ms FROM print_manifest WHERE directory = ?");
+    select.addBindValue(key);
+    if (select.exec()) {
+        while (select.next()) {
+            PrintDirWatcher::Entry entry;
+            entry.size = select.value(1).toLongLong();
+            entry.modifiedMs = select.value(2).toLongLong();
+            recorded.insert(select.value(0).toString(), entry);
+        }
+    }
+
+    PrintDirDiff diff;
+    diff.directory = directory;
+    for (auto it = listing.cbegin(); it != listing.cend(); ++it) {
+        auto recordedIt = recorded.constFind(it.key());
+        if (recordedIt == recorded.constEnd()) {
+            diff.added.append(it.key());
+        } else if (recordedIt.value() != it.value()) {
+            diff.modified.append(it.key());
+        }
+    }
+    for (auto it = recorded.cbegin(); it != recorded.cend(); ++it) {
+        if (!listing.contains(it.key())) {
+            diff.removed.append(it.key());
+        }
+    }
+
+    // applyDiff() only records directories it is tracking
+    m_trackedDirectories.insert(key);
+    const bool ok = applyDiff(diff, listing);
+    if (!m_liveDirectories.contains(key)) {
+        m_trackedDirectories.remove(key);
+    }
+    if (!ok && error) {
+        *error = QString("Failed to update print manifest for %1").arg(directory);
+    }
+    return ok;
+}
+
+qint64 PrintManifestStore::beginSession(const QString& directory, qint64 startedUtcMs, QString* error)
+{
+    if (!syncDirectory(directory, error)) {
+        return 0;
+    }
+
+    const QString key = directoryKey(directory);
+    qint64 baselineSeq = 0;
+    QSqlQuery query(m_db);
+    query.prepare("SELECT seq FROM print_manifest_dirs WHERE directory = ?");
+    query.addBindValue(key);
+    if (query.exec() && query.next()) {
+        baselineSeq = query.value(0).toLongLong();
+    }
+
+    query.prepare("DELETE FROM print_sessions WHERE started_utc_ms < ?");
+    query.addBindValue(startedUtcMs - kSessionRetentionMs);
+    query.exec();
+
+    query.prepare("INSERT INTO print_sessions (directory, started_utc_ms, baseline_seq) VALUES (?, ?, ?)");
+    query.addBindValue(key);
+    query.addBindValue(startedUtcMs);
+    query.addBindValue(baselineSeq);
+    if (!query.exec()) {
+        if (error) {
+            *error = QString("Failed to record print session: %1").arg(query.lastError().text());
+        }
+        return 0;
+    }
+    return query.lastInsertId().toLongLong();
+}
+
+QVector<PrintManifestStore::Entry> PrintManifestStore::changesSince(qint64 sessionId)
+{
+    QVector<Entry> changes;
+    if (!open(nullptr)) {
+        return changes;
+    }
+
+    QSqlQuery query(m_db);
+    query.prepare("SELECT m.name, m.size, m.mtime_utc_ms FROM print_sessions s "
+                  "JOIN print_manifest m ON m.directory = s.directory AND m.updated_seq > s.baseline_seq "
+                  "WHERE s.id = ? ORDER BY m.name");
+    query.addBindValue(sessionId);
+    if (query.exec()) {
+        while (query.next()) {
+            Entry entry;
+            entry.name = query.value(0).toString();
+            entry.size = query.value(1).toLongLong();
+            entry.mtimeUtcMs = query.value(2).toLongLong();
+            changes.append(entry);
+        }
+    }
+    return changes;
+}
+
+int PrintManifestStore::pdfCount(const QString& directory)
+{
+    if (!open(nullptr)) {
+        return 0;
+    }
+
+    QSqlQuery query(m_db);
+    query.prepare("SELECT COUNT(*) FROM print_manifest WHERE directory = ? AND lower(name) LIKE '%.pdf'");
+    query.addBindValue(directoryKey(directory));
+    if (query.exec() && query.next()) {
+        return query.value(0).toInt();
+    }
+    return 0;
+}
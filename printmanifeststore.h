@@ -0,0 +1,96 @@
+#ifndef PRINTMANIFESTSTORE_H
+#define PRINTMANIFESTSTORE_H
+
+#include "printdirwatcher.h"
+
+#include <QSet>
+#include <QSqlDatabase>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+/**
+ * @brief Persistent (name, size, mtime) manifest of the print output directories
+ *
+ * Replaces the per-run JSON baselines. Each directory has a change sequence
+ * number; every recorded change stamps the affected rows with a new value.
+ * A print session stores the sequence number at its start, so "what changed
+ * since the session began" is an indexed query over the changed rows only.
+ *
+ * While MainWindow's PrintDirWatcher is watching a directory the manifest
+ * is kept current from its diffs. Those diffs lag by the watcher's debounce
+ * and settle window and miss a file overwritten in place, so a session start
+ * and a post-print query always list the directory with syncDirectory()
+ * first. The database lives in the app data cache directory and is opened
+ * read-only by the post-print scripts.
+ */
+class PrintManifestStore
+{
+public:
+    struct Entry {
+        QString name;
+        qint64 size = 0;
+        qint64 mtimeUtcMs = 0;
+    };
+
+    /**
+     * @brief Get the singleton instance
+     * @return Reference to the PrintManifestStore instance
+     */
+    static PrintManifestStore& instance();
+
+    QString databasePath() const { return m_databasePath; }
+
+    /**
+     * @brief Directories the print watcher currently keeps current
+     */
+    void setLiveDirectories(const QStringList& directories);
+
+    /**
+     * @brief Record a settled watcher diff
+     * @param snapshot The watcher's snapshot of the directory (sizes/mtimes of added and modified files)
+     */
+    bool applyDiff(const PrintDirDiff& diff, const PrintDirWatcher::Snapshot& snapshot);
+
+    /**
+     * @brief List a directory and reconcile the manifest with it
+     *
+     * Rows whose size and mtime are unchanged keep their sequence number.
+     */
+    bool syncDirectory(const QString& directory, QString* error = nullptr);
+
+    /**
+     * @brief Start a print session: record the directory's current state as its baseline
+     * @return Session id, or 0 on failure
+     */
+    qint64 beginSession(const QString& directory, qint64 startedUtcMs, QString* error = nullptr);
+
+    /**
+     * @brief Files added or modified since a session began
+     */
+    QVector<Entry> changesSince(qint64 sessionId);
+
+    /**
+     * @brief Number of PDFs currently recorded for a directory
+     */
+    int pdfCount(const QString& directory);
+
+private:
+    PrintManifestStore();
+    ~PrintManifestStore();
+
+    PrintManifestStore(const PrintManifestStore&) = delete;
+    PrintManifestStore& operator=(const PrintManifestStore&) = delete;
+
+    bool open(QString* error);
+    static QString directoryKey(const QString& directory);
+    qint64 nextSequence(const QString& key);
+
+    QString m_databasePath;
+    QSqlDatabase m_db;
+    bool m_openAttempted = false;
+    QSet<QString> m_liveDirectories;
+    QSet<QString> m_trackedDirectories;     // live and reconciled since they became live
+};
+
+#endif // PRINTMANIFESTSTORE_H
@@ -0,0 +1,345 @@
+#include "querystats.h"
+
+#include <QDateTime>
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QRegularExpression>
+#include <QSaveFile>
+#include <QSqlError>
+#include <QStringList>
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+const double kFirstBucketUs = 10.0;
+const double kBucketGrowth = 1.25;          // ~12% worst-case error on a percentile
+const double kDefaultSlowThresholdMs = 50.0;
+const int kMaxSlowQueries = 200;
+const int kMaxTemplateCacheEntries = 2000;
+
+double bucketUpperUs(int bucket)
+{
+    return kFirstBucketUs * std::pow(kBucketGrowth, bucket);
+}
+
+} // namespace
+
+QueryStats& QueryStats::instance()
+{
+    static QueryStats stats;
+    return stats;
+}
+
+QueryStats::QueryStats()
+    : m_slowThresholdUs(static_cast<qint64>(kDefaultSlowThresholdMs * 1000))
+{
+}
+
+bool QueryStats::exec(QSqlQuery& query, const QSqlDatabase& db)
+{
+    QElapsedTimer timer;
+    timer.start();
+    const bool ok = query.exec();
+    const qint64 elapsedUs = timer.nsecsElapsed() / 1000;
+    const qint64 rows = ok && !query.isSelect() ? query.numRowsAffected() : -1;
+    instance().record(query, db, elapsedUs, rows, ok);
+    return ok;
+}
+
+bool QueryStats::exec(QSqlQuery& query, const QString& sql, const QSqlDatabase& db)
+{
+    QElapsedTimer timer;
+    timer.start();
+    const bool ok = query.exec(sql);
+    const qint64 elapsedUs = timer.nsecsElapsed() / 1000;
+    const qint64 rows = ok && !query.isSelect() ? query.numRowsAffected() : -1;
+    instance().record(query, db, elapsedUs, rows, ok);
+    return ok;
+}
+
+void QueryStats::record(const QSqlQuery& query, const QSqlDatabase& db, qint64 elapsedUs, qint64 rows, bool ok)
+{
+    const QString sql = query.lastQuery();
+    if (sql.isEmpty()) {
+        return;
+    }
+
+    QString statement;
+    bool slow = false;
+    bool needPlan = false;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        statement = templateFor(sql);
+        Histogram& histogram = m_histograms[statement];
+        ++histogram.count;
+        if (!ok) {
+            ++histogram.errors;
+        }
+        if (rows > 0) {
+            histogram.rows += rows;
+        }
+        histogram.totalUs += elapsedUs;
+        histogram.maxUs = qMax(histogram.maxUs, elapsedUs);
+        ++histogram.buckets[bucketFor(elapsedUs)];
+
+        slow = ok && elapsedUs >= m_slowThresholdUs;
+        needPlan = slow && !m_plans.contains(statement);
+    }
+
+    if (!slow) {
+        return;
+    }
+
+    // The plan is taken outside the lock: it runs SQL on the caller's connection
+    QString plan;
+    if (needPlan) {
+        plan = capturePlan(query, db);
+    }
+
+    SlowQuery entry;
+    entry.recordedAt = QDateTime::currentDateTimeUtc().toString(Qt::ISODateWithMs);
+    entry.statementTemplate = statement;
+    entry.sql = sql;
+    entry.connection = db.connectionName();
+    entry.durationMs = elapsedUs / 1000.0;
+    entry.rows = rows;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (needPlan) {
+        m_plans.insert(statement, plan);
+    }
+    entry.plan = m_plans.value(statement);
+    m_slowQueries.append(entry);
+    m_unsavedSlowQueries = qMin(m_unsavedSlowQueries + 1, kMaxSlowQueries);
+    if (m_slowQueries.size() > kMaxSlowQueries) {
+        m_slowQueries.remove(0, m_slowQueries.size() - kMaxSlowQueries);
+    }
+    qWarning().noquote() << QString("Slow query (%1 ms): %2").arg(entry.durationMs, 0, 'f', 1).arg(statement);
+}
+
+QString QueryStats::capturePlan(const QSqlQuery& query, const QSqlDatabase& db)
+{
+    if (!db.isValid() || !db.isOpen()) {
+        return QString();
+    }
+
+    QSqlQuery explain(db);
+    if (!explain.prepare("EXPLAIN QUERY PLAN " + query.lastQuery())) {
+        return QString("(no plan: %1)").arg(explain.lastError().text());
+    }
+    // Same values as the slow execution, so the plan matches what actually ran
+    const int boundCount = static_cast<int>(query.boundValues().size());
+    for (int i = 0; i < boundCount; ++i) {
+        explain.addBindValue(query.boundValue(i));
+    }
+    if (!explain.exec()) {
+        return QString("(no plan: %1)").arg(explain.lastError().text());
+    }
+
+    QStringList lines;
+    while (explain.next()) {
+        // Columns: id, parent, notused, detail
+        lines.append(explain.value(3).toString());
+    }
+    explain.finish();
+    return lines.join('\n');
+}
+
+double QueryStats::slowThresholdMs() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_slowThresholdUs / 1000.0;
+}
+
+void QueryStats::setSlowThresholdMs(double ms)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_slowThresholdUs = static_cast<qint64>(qMax(0.0, ms) * 1000);
+}
+
+void QueryStats::configureFromEnvironment()
+{
+    const QString value = qEnvironmentVariable("GOJI_SLOW_QUERY_MS").trimmed();
+    if (value.isEmpty()) {
+        return;
+    }
+
+    bool ok = false;
+    const double ms = value.toDouble(&ok);
+    if (ok && ms >= 0) {
+        setSlowThresholdMs(ms);
+    } else {
+        qWarning() << "Ignoring invalid GOJI_SLOW_QUERY_MS:" << value;
+    }
+}
+
+QVector<QueryStats::TemplateSummary> QueryStats::summaries() const
+{
+    QVector<TemplateSummary> result;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    result.reserve(m_histograms.size());
+    for (auto it = m_histograms.constBegin(); it != m_histograms.constEnd(); ++it) {
+        const Histogram& histogram = it.value();
+        TemplateSummary summary;
+        summary.statementTemplate = it.key();
+        summary.count = histogram.count;
+        summary.errors = histogram.errors;
+        summary.rows = histogram.rows;
+        summary.totalMs = histogram.totalUs / 1000.0;
+        summary.maxMs = histogram.maxUs / 1000.0;
+        summary.p50Ms = percentileMs(histogram, 0.50);
+        summary.p95Ms = percentileMs(histogram, 0.95);
+        summary.p99Ms = percentileMs(histogram, 0.99);
+        result.append(summary);
+    }
+
+    std::sort(result.begin(), result.end(), [](const TemplateSummary& a, const TemplateSummary& b) {
+        return a.totalMs > b.totalMs;
+    });
+    return result;
+}
+
+QVector<QueryStats::SlowQuery> QueryStats::slowQueries() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_slowQueries;
+}
+
+QVector<QueryStats::SlowQuery> QueryStats::takeUnsavedSlowQueries()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const int count = qMin(m_unsavedSlowQueries, static_cast<int>(m_slowQueries.size()));
+    m_unsavedSlowQueries = 0;
+    return m_slowQueries.mid(m_slowQueries.size() - count);
+}
+
+QString QueryStats::report() const
+{
+    const QVector<TemplateSummary> templates = summaries();
+    const QVector<SlowQuery> slow = slowQueries();
+
+    QString out;
+    out += QString("GOJI query statistics, %1\n")
+               .arg(QDateTime::currentDateTime().toString("yyyy-MM-dd hh:mm:ss"));
+    out += QString("Slow query threshold: %1 ms\n\n").arg(slowThresholdMs());
+
+    out += QString("%1 %2 %3 %4 %5 %6 %7 %8  %9\n")
+               .arg("count", 8).arg("errors", 6).arg("total ms", 10).arg("p50", 8)
+               .arg("p95", 8).arg("p99", 8).arg("max", 8).arg("rows", 9).arg("statement");
+    for (const TemplateSummary& summary : templates) {
+        out += QString("%1 %2 %3 %4 %5 %6 %7 %8  %9\n")
+                   .arg(summary.count, 8)
+                   .arg(summary.errors, 6)
+                   .arg(summary.totalMs, 10, 'f', 1)
+                   .arg(summary.p50Ms, 8, 'f', 2)
+                   .arg(summary.p95Ms, 8, 'f', 2)
+                   .arg(summary.p99Ms, 8, 'f', 2)
+                   .arg(summary.maxMs, 8, 'f', 2)
+                   .arg(summary.rows, 9)
+                   .arg(summary.statementTemplate);
+    }
+
+    out += QString("\nSlow queries this session: %1\n").arg(slow.size());
+    for (const SlowQuery& entry : slow) {
+        out += QString("\n[%1] %2 ms on %3, rows %4\n  %5\n")
+                   .arg(entry.recordedAt)
+                   .arg(entry.durationMs, 0, 'f', 1)
+                   .arg(entry.connection.isEmpty() ? QString("(default)") : entry.connection)
+                   .arg(entry.rows < 0 ? QString("n/a") : QString::number(entry.rows))
+                   .arg(entry.sql.simplified());
+        const QStringList planLines = entry.plan.split('\n', Qt::SkipEmptyParts);
+        for (const QString& line : planLines) {
+            out += QString("    plan: %1\n").arg(line);
+        }
+    }
+    return out;
+}
+
+bool QueryStats::writeReport(const QString& filePath, QString* error) const
+{
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        if (error) {
+            *error = QString("Cannot open %1: %2").arg(filePath, file.errorString());
+        }
+        return false;
+    }
+    file.write(report().toUtf8());
+    if (!file.commit()) {
+        if (error) {
+            *error = QString("Cannot write %1: %2").arg(filePath, file.errorString());
+        }
+        return false;
+    }
+    return true;
+}
+
+void QueryStats::reset()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_histograms.clear();
+    m_slowQueries.clear();
+    m_unsavedSlowQueries = 0;
+    // A reset starts a fresh capture; stale plans would otherwise suppress new EXPLAINs
+    m_plans.clear();
+    m_templateCache.clear();
+}
+
+QString QueryStats::statementTemplate(const QString& sql)
+{
+    static const QRegularExpression stringLiteral("'(?:[^']|'')*'");
+    static const QRegularExpression numberLiteral("(?<![\\w.:$@])\\d+(?:\\.\\d+)?\\b");
+    static const QRegularExpression placeholderList("\\(\\s*\\?(?:\\s*,\\s*\\?)+\\s*\\)");
+    static const QRegularExpression namedPlaceholder(":\\w+");
+
+    QString result = sql;
+    result.replace(stringLiteral, "?");
+    result.replace(numberLiteral, "?");
+    result.replace(namedPlaceholder, "?");
+    result = result.simplified();
+    result.replace(placeholderList, "(?, ...)");
+    return result;
+}
+
+int QueryStats::bucketFor(qint64 elapsedUs)
+{
+    if (elapsedUs <= kFirstBucketUs) {
+        return 0;
+    }
+    const int bucket = static_cast<int>(std::ceil(std::log(elapsedUs / kFirstBucketUs) / std::log(kBucketGrowth)));
+    return qBound(0, bucket, kBucketCount - 1);
+}
+
+double QueryStats::percentileMs(const Histogram& histogram, double fraction)
+{
+    if (histogram.count == 0) {
+        return 0;
+    }
+
+    const qint64 rank = qMax<qint64>(1, static_cast<qint64>(std::ceil(fraction * histogram.count)));
+    qint64 seen = 0;
+    for (int i = 0; i < kBucketCount; ++i) {
+        seen += histogram.buckets[i];
+        if (seen >= rank) {
+            // Upper edge of the bucket, but never above the slowest observation
+            return qMin(bucketUpperUs(i), static_cast<double>(histogram.maxUs)) / 1000.0;
+        }
+    }
+    return histogram.maxUs / 1000.0;
+}
+
+QString QueryStats::templateFor(const QString& sql)
+{
+    auto it = m_templateCache.constFind(sql);
+    if (it != m_templateCache.constEnd()) {
+        return it.value();
+    }
+    if (m_templateCache.size() >= kMaxTemplateCacheEntries) {
+        m_templateCache.clear();
+    }
+    const QString result = statementTemplate(sql);
+    m_templateCache.insert(sql, result);
+    return result;
+}
@@ -0,0 +1,155 @@
+#ifndef QUERYSTATS_H
+#define QUERYSTATS_H
+
+#include <QHash>
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QString>
+#include <QVector>
+
+#include <array>
+#include <mutex>
+
+/**
+ * @brief Process-wide SQL latency histograms and slow-query capture
+ *
+ * Every statement run through exec() (or reported with record()) is grouped
+ * by its template: the SQL text with literals replaced by '?' and whitespace
+ * collapsed, so a prepared statement and the same query built with different
+ * values land in one entry. Each template keeps a count, an error count,
+ * rows returned and a log-scaled latency histogram for p50/p95/p99.
+ *
+ * A statement slower than the threshold is kept as a slow query together
+ * with its EXPLAIN QUERY PLAN, taken on the connection that ran it (once per
+ * template). DatabaseManager::flushSlowQueryLog() writes the kept entries to
+ * the slow_queries table.
+ *
+ * The threshold defaults to 50 ms; GOJI_SLOW_QUERY_MS or --slow-query-ms
+ * changes it. Recording is always on: it costs one timer read and a short
+ * locked hash update per statement. Safe to use from any thread.
+ */
+class QueryStats
+{
+public:
+    struct SlowQuery {
+        QString recordedAt;         // UTC, ISO 8601
+        QString statementTemplate;
+        QString sql;
+        QString connection;
+        double durationMs = 0;
+        qint64 rows = -1;
+        QString plan;
+    };
+
+    struct TemplateSummary {
+        QString statementTemplate;
+        qint64 count = 0;
+        qint64 errors = 0;
+        qint64 rows = 0;            // rows returned (SELECT) or affected (DML) where known
+        double totalMs = 0;
+        double maxMs = 0;
+        double p50Ms = 0;
+        double p95Ms = 0;
+        double p99Ms = 0;
+    };
+
+    /**
+     * @brief Get the singleton instance
+     * @return Reference to the QueryStats instance
+     */
+    static QueryStats& instance();
+
+    /**
+     * @brief Execute an already prepared (or prepared-and-bound) query and record it
+     * @param db Connection the query belongs to; used for EXPLAIN QUERY PLAN when slow
+     * @return Result of query.exec()
+     *
+     * Rows are counted for statements that change data; a SELECT is recorded
+     * without a row count because its rows have not been fetched yet.
+     */
+    static bool exec(QSqlQuery& query, const QSqlDatabase& db);
+
+    /**
+     * @brief Execute a SQL string on a query and record it
+     */
+    static bool exec(QSqlQuery& query, const QString& sql, const QSqlDatabase& db);
+
+    /**
+     * @brief Record a statement timed by the caller (e.g. exec plus fetching all rows)
+     * @param query The executed query; its text and bound values are used for the plan
+     * @param rows Rows returned or affected, or -1 if not known
+     */
+    void record(const QSqlQuery& query, const QSqlDatabase& db, qint64 elapsedUs, qint64 rows, bool ok);
+
+    double slowThresholdMs() const;
+    void setSlowThresholdMs(double ms);
+
+    /**
+     * @brief Apply GOJI_SLOW_QUERY_MS, if set
+     */
+    void configureFromEnvironment();
+
+    QVector<TemplateSummary> summaries() const;
+
+    /**
+     * @brief Slow queries recorded this session (most recent last, bounded)
+     */
+    QVector<SlowQuery> slowQueries() const;
+
+    /**
+     * @brief Remove and return slow queries not yet written to the slow_queries table
+     */
+    QVector<SlowQuery> takeUnsavedSlowQueries();
+
+    /**
+     * @brief Plain-text report: per-template table sorted by total time, then slow queries
+     */
+    QString report() const;
+
+    /**
+     * @brief Write report() to a file (replaced atomically)
+     * @param error Receives a description on failure
+     */
+    bool writeReport(const QString& filePath, QString* error = nullptr) const;
+
+    /**
+     * @brief Drop all statistics, captured plans and cached statement templates
+     */
+    void reset();
+
+    static QString statementTemplate(const QString& sql);
+
+private:
+    QueryStats();
+    ~QueryStats() = default;
+
+    QueryStats(const QueryStats&) = delete;
+    QueryStats& operator=(const QueryStats&) = delete;
+
+    // Bucket i holds latencies up to kFirstBucketUs * kBucketGrowth^i; the last bucket is open-ended
+    static constexpr int kBucketCount = 64;
+
+    struct Histogram {
+        qint64 count = 0;
+        qint64 errors = 0;
+        qint64 rows = 0;
+        qint64 totalUs = 0;
+        qint64 maxUs = 0;
+        std::array<qint64, kBucketCount> buckets {};
+    };
+
+    static int bucketFor(qint64 elapsedUs);
+    static double percentileMs(const Histogram& histogram, double fraction);
+    QString templateFor(const QString& sql);
+    QString capturePlan(const QSqlQuery& query, const QSqlDatabase& db);
+
+    mutable std::mutex m_mutex;
+    QHash<QString, Histogram> m_histograms;
+    QHash<QString, QString> m_templateCache;    // raw SQL -> template
+    QHash<QString, QString> m_plans;            // template -> captured plan
+    QVector<SlowQuery> m_slowQueries;
+    int m_unsavedSlowQueries = 0;
+    qint64 m_slowThresholdUs;
+};
+
+#endif // QUERYSTATS_H
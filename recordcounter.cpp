@@ -0,0 +1,367 @@
+#include "recordcounter.h"
+#include "archiveutils.h"
+#include "csvscanner.h"
+
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QVector>
+#include <QXmlStreamReader>
+#include <QtConcurrent>
+
+#include <cstring>
+
+namespace {
+
+const quint64 kScanChunkBytes = 8ull * 1024 * 1024;
+const QString kRelationshipsNamespace =
+    QStringLiteral("http://schemas.openxmlformats.org/officeDocument/2006/relationships");
+
+struct CacheEntry {
+    qint64 size = 0;
+    qint64 modifiedMs = 0;
+    qint64 recordCount = 0;
+};
+
+QMutex& cacheMutex()
+{
+    static QMutex mutex;
+    return mutex;
+}
+
+QHash<QString, CacheEntry>& cache()
+{
+    static QHash<QString, CacheEntry> entries;
+    return entries;
+}
+
+struct ScanChunk {
+    quint64 offset = 0;
+    quint64 size = 0;
+    CsvScanner::ChunkSummary summary;
+};
+
+bool countCsv(const QString& path, qint64& records, QString& error)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        error = QString("Cannot open file: %1").arg(file.errorString());
+        return false;
+    }
+
+    const quint64 size = static_cast<quint64>(file.size());
+    if (size == 0) {
+        records = 0;
+        return true;
+    }
+
+    const uchar* mapped = file.map(0, file.size());
+    if (!mapped) {
+        error = QString("Cannot map file: %1").arg(file.errorString());
+        return false;
+    }
+    const char* data = reinterpret_cast<const char*>(mapped);
+
+    // Chunks start at line starts so blank lines can be told apart per chunk
+    QVector<ScanChunk> chunks;
+    for (quint64 offset = 0; offset < size;) {
+        const quint64 end = CsvScanner::nextLineStart(data, size, qMin(offset + kScanChunkBytes, size));
+        ScanChunk chunk;
+        chunk.offset = offset;
+        chunk.size = end - offset;
+        chunks.append(chunk);
+        offset = end;
+    }
+    QtConcurrent::blockingMap(chunks, [data](ScanChunk& chunk) {
+        chunk.summary = CsvScanner::summarize(data + chunk.offset, chunk.size);
+    });
+
+    bool inside = false;
+    quint64 rows = 0;
+    for (const ScanChunk& chunk : chunks) {
+        rows += chunk.summary.rows(inside);
+        inside = chunk.summary.endState(inside);
+    }
+
+    // A final row without a trailing newline still counts; the header does not
+    if (CsvScanner::hasUnterminatedRow(data, size, inside)) {
+        ++rows;
+    }
+    records = rows > 0 ? static_cast<qint64>(rows - 1) : 0;
+    return true;
+}
+
+bool readSmallEntry(const QString& path, const QString& entryName, QByteArray& out, QString& error)
+{
+    out.clear();
+    return readZipEntry(path, entryName, [&out](const char* data, size_t size) {
+        out.append(data, static_cast<int>(size));
+        return true;
+    }, &error);
+}
+
+// Archive path of the first worksheet (the one pandas reads by default)
+QString firstWorksheetEntry(const QString& path)
+{
+    const QString fallback = QStringLiteral("xl/worksheets/sheet1.xml");
+
+    QByteArray workbook;
+    QString error;
+    if (!readSmallEntry(path, "xl/workbook.xml", workbook, error)) {
+        return fallback;
+    }
+
+    QString relationshipId;
+    QXmlStreamReader workbookXml(workbook);
+    while (!workbookXml.atEnd() && relationshipId.isEmpty()) {
+        if (workbookXml.readNext() == QXmlStreamReader::StartElement && workbookXml.name() == QLatin1String("sheet")) {
+            relationshipId = workbookXml.attributes().value(kRelationshipsNamespace, "id").toString();
+        }
+    }
+
+    QByteArray rels;
+    if (relationshipId.isEmpty() || !readSmallEntry(path, "xl/_rels/workbook.xml.rels", rels, error)) {
+        return fallback;
+    }
+
+    QXmlStreamReader relsXml(rels);
+    while (!relsXml.atEnd()) {
+        if (relsXml.readNext() != QXmlStreamReader::StartElement
+            || relsXml.name() != QLatin1String("Relationship")
+            || relsXml.attributes().value("Id") != relationshipId) {
+            continue;
+        }
+        const QString target = relsXml.attributes().value("Target").toString();
+        if (target.isEmpty()) {
+            break;
+        }
+        return target.startsWith('/') ? target.mid(1) : QStringLiteral("xl/") + target;
+    }
+    return fallback;
+}
+
+/**
+ * Tag-level scanner over worksheet XML. Only the <row>, <v> and <is> start
+ * tags are inspected; cell text is skipped with memchr. A row counts once it
+ * holds a cell with a value, so blank and formatting-only rows (which the
+ * <dimension> range includes) are not reported as records.
+ */
+class SheetRowScanner
+{
+public:
+    // Every row has to be seen, so reading never stops early
+    bool feed(const char* data, size_t size)
+    {
+        size_t pos = 0;
+        while (pos < size) {
+            if (!m_inTag) {
+                const void* open = std::memchr(data + pos, '<', size - pos);
+                if (!open) {
+                    return true;
+                }
+                pos = static_cast<size_t>(static_cast<const char*>(open) - data) + 1;
+                m_inTag = true;
+                m_tag.resize(0);
+                continue;
+            }
+
+            const void* close = std::memchr(data + pos, '>', size - pos);
+            const size_t end = close ? static_cast<size_t>(static_cast<const char*>(close) - data) : size;
+            m_tag.append(data + pos, static_cast<int>(end - pos));
+            pos = end;
+            if (close) {
+                m_inTag = false;
+                ++pos;
+                handleTag(m_tag.constData(), m_tag.size());
+            }
+        }
+        return true;
+    }
+
+    // Valued rows minus the header row
+    qint64 recordCount() const
+    {
+        return m_valuedRows > 0 ? m_valuedRows - 1 : 0;
+    }
+
+private:
+    static qint64 rowOfReference(const char* ref, int length)
+    {
+        qint64 row = 0;
+        for (int i = 0; i < length; ++i) {
+            if (ref[i] >= '0' && ref[i] <= '9') {
+                row = row * 10 + (ref[i] - '0');
+            }
+        }
+        return row;
+    }
+
+    static bool attribute(const char* tag, int length, const char* name, const char** value, int* valueLength)
+    {
+        const int nameLength = static_cast<int>(std::strlen(name));
+        for (int i = 1; i + nameLength + 1 < length; ++i) {
+            if ((tag[i - 1] == ' ' || tag[i - 1] == '\t' || tag[i - 1] == '\r' || tag[i - 1] == '\n')
+                && std::memcmp(tag + i, name, nameLength) == 0 && tag[i + nameLength] == '=') {
+                const char quote = tag[i + nameLength + 1];
+                const int begin = i + nameLength + 2;
+                int end = begin;
+                while (end < length && tag[end] != quote) {
+                    ++end;
+                }
+                *value = tag + begin;
+                *valueLength = end - begin;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void handleTag(const char* tag, int length)
+    {
+        if (length == 0 || tag[0] == '/' || tag[0] == '?' || tag[0] == '!') {
+            return;
+        }
+
+        int nameEnd = 0;
+        while (nameEnd < length && tag[nameEnd] != ' ' && tag[nameEnd] != '/' && tag[nameEnd] != '\t'
+               && tag[nameEnd] != '\r' && tag[nameEnd] != '\n') {
+            ++nameEnd;
+        }
+        int nameBegin = nameEnd;
+        while (nameBegin > 0 && tag[nameBegin - 1] != ':') {
+            --nameBegin;
+        }
+        const char* name = tag + nameBegin;
+        const int nameLength = nameEnd - nameBegin;
+
+        const char* value = nullptr;
+        int valueLength = 0;
+
+        if ((nameLength == 1 && name[0] == 'v') || (nameLength == 2 && std::memcmp(name, "is", 2) == 0)) {
+            // <v/> and <is/> carry no value; formatting-only cells have neither child
+            if (tag[length - 1] != '/' && m_currentRow > 0 && m_currentRow != m_lastValuedRow) {
+                m_lastValuedRow = m_currentRow;
+                ++m_valuedRows;
+            }
+        } else if (nameLength == 3 && std::memcmp(name, "row", 3) == 0) {
+            m_currentRow = attribute(tag, length, "r", &value, &valueLength)
+                               ? rowOfReference(value, valueLength)
+                               : m_currentRow + 1;
+        }
+    }
+
+    QByteArray m_tag;
+    bool m_inTag = false;
+    qint64 m_currentRow = 0;
+    qint64 m_lastValuedRow = 0;
+    qint64 m_valuedRows = 0;
+};
+
+bool countXlsx(const QString& path, qint64& records, QString& error)
+{
+    SheetRowScanner scanner;
+    if (!readZipEntry(path, firstWorksheetEntry(path), [&scanner](const char* data, size_t size) {
+            return scanner.feed(data, size);
+        }, &error)) {
+        return false;
+    }
+    records = scanner.recordCount();
+    return true;
+}
+
+} // namespace
+
+RecordCountResult RecordCounter::countRecords(const QString& path)
+{
+    RecordCountResult result;
+    result.path = path;
+
+    QElapsedTimer timer;
+    timer.start();
+
+    const QFileInfo info(path);
+    if (!info.exists() || !info.isFile()) {
+        result.error = "File does not exist.";
+        return result;
+    }
+
+    const QString suffix = info.suffix().toLower();
+    if (suffix != "csv" && suffix != "xlsx") {
+        result.supported = false;
+        result.error = QString("Native record count is not available for .%1 files.").arg(suffix);
+        return result;
+    }
+
+    const QString key = info.absoluteFilePath();
+    const qint64 size = info.size();
+    const qint64 modifiedMs = info.lastModified().toMSecsSinceEpoch();
+    {
+        QMutexLocker locker(&cacheMutex());
+        const auto it = cache().constFind(key);
+        if (it != cache().constEnd() && it->size == size && it->modifiedMs == modifiedMs) {
+            result.ok = true;
+            result.fromCache = true;
+            result.recordCount = it->recordCount;
+            return result;
+        }
+    }
+
+    qint64 records = 0;
+    const bool ok = suffix == "csv" ? countCsv(path, records, result.error)
+                                    : countXlsx(path, records, result.error);
+    result.elapsedMs = timer.elapsed();
+    if (!ok) {
+        return result;
+    }
+
+    result.ok = true;
+    result.recordCount = records;
+
+    CacheEntry entry;
+    entry.size = size;
+    entry.modifiedMs = modifiedMs;
+    entry.recordCount = records;
+    QMutexLocker locker(&cacheMutex());
+    cache().insert(key, entry);
+    return result;
+}
+
+void RecordCounter::clearCache()
+{
+    QMutexLocker locker(&cacheMutex());
+    cache().clear();
+}
+
+RecordCounter::RecordCounter(QObject* parent)
+    : QObject(parent)
+{
+    connect(&m_watcher, &QFutureWatcher<RecordCountResult>::finished, this, [this]() {
+        emit finished(m_watcher.result());
+    });
+}
+
+RecordCounter::~RecordCounter()
+{
+    m_watcher.waitForFinished();
+}
+
+bool RecordCounter::start(const QString& path)
+{
+    if (isRunning()) {
+        return false;
+    }
+
+    m_watcher.setFuture(QtConcurrent::run([path]() {
+        return countRecords(path);
+    }));
+    return true;
+}
+
+bool RecordCounter::isRunning() const
+{
+    return m_watcher.isRunning();
+}
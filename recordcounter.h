@@ -0,0 +1,63 @@
+#ifndef RECORDCOUNTER_H
+#define RECORDCOUNTER_H
+
+#include <QFutureWatcher>
+#include <QObject>
+#include <QString>
+
+/**
+ * @brief Outcome of a record count
+ */
+struct RecordCountResult {
+    bool ok = false;
+    bool supported = true;      // false for formats that still need the Python inspect
+    QString path;
+    QString error;
+    qint64 recordCount = 0;     // data rows, header excluded
+    bool fromCache = false;
+    qint64 elapsedMs = 0;
+};
+
+/**
+ * @brief Native record counter for Split Large Lists inspection
+ *
+ * CSV files are memory-mapped and scanned in parallel chunks with the same
+ * quote-aware row scanner CsvSplitter uses, so the count matches what a
+ * split produces. XLSX files stream the first worksheet's XML and count the
+ * rows holding at least one valued cell, so blank and formatting-only rows
+ * inside the sheet's <dimension> range are not counted; nothing is extracted
+ * to disk. Legacy XLS is reported as unsupported.
+ *
+ * Results are cached per (path, size, modification time).
+ */
+class RecordCounter : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Count data rows synchronously (thread-safe, cached)
+     */
+    static RecordCountResult countRecords(const QString& path);
+
+    static void clearCache();
+
+    explicit RecordCounter(QObject* parent = nullptr);
+    ~RecordCounter();
+
+    /**
+     * @brief Count on the global thread pool; ignored if already running
+     * @return True if the count was started
+     */
+    bool start(const QString& path);
+
+    bool isRunning() const;
+
+signals:
+    void finished(const RecordCountResult& result);
+
+private:
+    QFutureWatcher<RecordCountResult> m_watcher;
+};
+
+#endif // RECORDCOUNTER_H
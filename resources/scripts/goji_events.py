@@ -0,0 +1,88 @@
+"""
+GOJI script event channel.
+
+ScriptRunner listens on a local socket (a named pipe on Windows) for each
+script it runs and passes its address in GOJI_EVENT_PIPE. Events written
+here travel on that side channel as newline-delimited JSON, separate from
+the human-readable stdout that goes to the terminal:
+
+    {"event": "progress", "percent": 40.0, "message": "Copying files"}
+    {"event": "file", "path": "C:/...", "kind": "postprint"}
+    {"event": "count", "name": "records", "value": 1234}
+    {"event": "result", "ok": false, "reason": "CODE", "detail": "..."}
+
+Every function is a no-op when the script is not run by GOJI, so scripts can
+call them unconditionally. ScriptRunner puts this module on PYTHONPATH.
+"""
+
+import json
+import os
+import sys
+
+PIPE_ENV = "GOJI_EVENT_PIPE"
+
+_channel = None
+_disabled = False
+
+
+def _open_channel():
+    global _channel, _disabled
+    if _channel is not None or _disabled:
+        return _channel
+
+    address = os.environ.get(PIPE_ENV, "").strip()
+    if not address:
+        _disabled = True
+        return None
+
+    try:
+        if sys.platform == "win32":
+            # QLocalServer's full server name is the \\.\pipe\ path
+            _channel = open(address, "wb", buffering=0)
+        else:
+            import socket
+            sock = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+            sock.connect(address)
+            _channel = sock.makefile("wb", buffering=0)
+    except OSError as exc:
+        print(f"WARNING: GOJI event channel unavailable: {exc}", file=sys.stderr)
+        _disabled = True
+        _channel = None
+    return _channel
+
+
+def emit(event, **fields):
+    """Send one event; fields must be JSON-serialisable."""
+    global _channel, _disabled
+    channel = _open_channel()
+    if channel is None:
+        return
+
+    fields["event"] = event
+    line = json.dumps(fields, ensure_ascii=False, default=str) + "\n"
+    try:
+        channel.write(line.encode("utf-8"))
+    except OSError:
+        # GOJI went away; keep running the script without events
+        _disabled = True
+        _channel = None
+
+
+def progress(percent, message=""):
+    """Report overall progress, 0-100."""
+    emit("progress", percent=max(0.0, min(100.0, float(percent))), message=str(message))
+
+
+def file_produced(path, kind=""):
+    """Report a file the script created; kind lets the controller tell outputs apart."""
+    emit("file", path=os.path.abspath(str(path)), kind=str(kind))
+
+
+def count(name, value):
+    """Report a named count (records processed, pages, ...)."""
+    emit("count", name=str(name), value=int(value))
+
+
+def result(ok, reason="", detail="", **fields):
+    """Report the run's outcome; extra fields are passed through to the controller."""
+    emit("result", ok=bool(ok), reason=str(reason), detail=str(detail), **fields)
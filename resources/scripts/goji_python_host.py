@@ -0,0 +1,212 @@
+"""
+GOJI warm Python host.
+
+Started by ScriptRunner when warm mode is enabled. Each job is read from
+stdin as one JSON line ({"script": path, "args": [...]}) and run as __main__
+in a worker process that was spawned, with the heavy modules imported, while
+the host sat idle. A job therefore skips interpreter and import startup but
+still gets a fresh interpreter: module state, os._exit() and crashes stay in
+the worker. The next worker is spawned as soon as a job finishes.
+
+The host announces a random token with its ready marker and repeats it in
+every done marker. Workers never see the token, so a job that prints a
+marker-looking line cannot end its own run early.
+
+While a job runs, lines arriving on the host's stdin are forwarded to the
+worker so ScriptRunner::writeToScript() still reaches input() calls.
+"""
+
+import json
+import os
+import queue
+import runpy
+import secrets
+import subprocess
+import sys
+import threading
+import time
+import traceback
+
+READY_MARKER = "@@GOJI_HOST_READY@@"
+DONE_MARKER = "@@GOJI_HOST_DONE@@"
+WORKER_FLAG = "--worker"
+
+PRELOAD_MODULES = ("numpy", "pandas", "openpyxl")
+
+
+def preload():
+    for name in PRELOAD_MODULES:
+        try:
+            __import__(name)
+        except Exception:
+            # A missing optional module only means that job pays its own import
+            pass
+
+
+def exit_code_from(exc):
+    code = exc.code
+    if code is None:
+        return 0
+    if isinstance(code, int):
+        return code
+    print(code, file=sys.stderr)
+    return 1
+
+
+# ---------------------------------------------------------------------------
+# Worker side
+# ---------------------------------------------------------------------------
+
+def watch_host(host_pid):
+    """End the worker when the host goes away (ScriptRunner::terminate kills the host)."""
+    if sys.platform == "win32":
+        import ctypes
+        SYNCHRONIZE = 0x00100000
+        INFINITE = 0xFFFFFFFF
+        kernel32 = ctypes.windll.kernel32
+        handle = kernel32.OpenProcess(SYNCHRONIZE, False, host_pid)
+        if not handle:
+            os._exit(1)
+        kernel32.WaitForSingleObject(handle, INFINITE)
+        os._exit(1)
+
+    while os.getppid() == host_pid:
+        time.sleep(0.5)
+    os._exit(1)
+
+
+def run_job(job):
+    script = job["script"]
+    sys.argv = [script] + [str(arg) for arg in job.get("args", [])]
+    sys.path.insert(0, os.path.dirname(os.path.abspath(script)))
+
+    try:
+        runpy.run_path(script, run_name="__main__")
+        return 0
+    except SystemExit as exc:
+        return exit_code_from(exc)
+    except BaseException:
+        traceback.print_exc()
+        return 1
+    finally:
+        sys.stdout.flush()
+        sys.stderr.flush()
+
+
+def worker_main(host_pid):
+    threading.Thread(target=watch_host, args=(host_pid,), daemon=True).start()
+    preload()
+
+    # The first stdin line is the job; the rest of stdin belongs to the job
+    line = sys.stdin.buffer.readline()
+    if not line.strip():
+        return 0
+    return run_job(json.loads(line.decode("utf-8")))
+
+
+# ---------------------------------------------------------------------------
+# Host side
+# ---------------------------------------------------------------------------
+
+def spawn_worker():
+    # stdout and stderr are inherited, so job output goes straight to ScriptRunner
+    return subprocess.Popen(
+        [sys.executable, "-u", os.path.abspath(__file__), WORKER_FLAG, str(os.getpid())],
+        stdin=subprocess.PIPE,
+        creationflags=getattr(subprocess, "CREATE_NO_WINDOW", 0),
+    )
+
+
+class StdinRouter:
+    """Reads the host's stdin; a job line starts the idle worker, later lines go to that worker."""
+
+    def __init__(self, worker):
+        self.started = queue.Queue()
+        self._lock = threading.Lock()
+        self._idle = worker
+        self._active = None
+
+    def job_finished(self, next_worker):
+        with self._lock:
+            self._active = None
+            self._idle = next_worker
+
+    def run(self):
+        for line in sys.stdin.buffer:
+            with self._lock:
+                if self._active is not None:
+                    write_to(self._active, line)
+                    continue
+
+                stripped = line.strip()
+                # Blank lines are keep-alive newlines from ScriptRunner's input wrapper
+                if not stripped.startswith(b"{"):
+                    continue
+                try:
+                    json.loads(stripped.decode("utf-8"))
+                except ValueError:
+                    continue
+
+                worker = self._idle if self._idle is not None else spawn_worker()
+                self._idle = None
+                self._active = worker
+                write_to(worker, stripped + b"\n")
+            self.started.put(worker)
+
+        # EOF on stdin ends the command loop
+        self.started.put(None)
+
+    def close_idle(self):
+        with self._lock:
+            worker, self._idle = self._idle, None
+        if worker is None:
+            return
+        try:
+            worker.stdin.close()
+            worker.wait(timeout=2)
+        except (OSError, subprocess.TimeoutExpired):
+            worker.kill()
+
+
+def write_to(worker, data):
+    try:
+        worker.stdin.write(data)
+        worker.stdin.flush()
+    except OSError:
+        # The job already exited or closed its stdin
+        pass
+
+
+def host_main():
+    token = secrets.token_hex(16)
+    router = StdinRouter(spawn_worker())
+    threading.Thread(target=router.run, daemon=True).start()
+
+    print("%s %s" % (READY_MARKER, token), flush=True)
+
+    while True:
+        worker = router.started.get()
+        if worker is None:
+            break
+
+        code = worker.wait()
+        try:
+            worker.stdin.close()
+        except OSError:
+            pass
+        router.job_finished(spawn_worker())
+
+        # A negative code means the worker was killed by a signal
+        code = code & 0xFF if code >= 0 else 1
+        sys.stdout.flush()
+        sys.stderr.flush()
+        # Leading newline terminates any partial line the job left behind
+        print("\n%s %s %d" % (DONE_MARKER, token, code), flush=True)
+
+    router.close_idle()
+
+
+if __name__ == "__main__":
+    if len(sys.argv) == 3 and sys.argv[1] == WORKER_FLAG:
+        sys.exit(worker_main(int(sys.argv[2])))
+    host_main()
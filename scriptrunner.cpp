@@ -1,7 +1,183 @@
 #include "scriptrunner.h"
+#include "logger.h"
+#include "tracer.h"
 #include <QCoreApplication>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonParseError>
+#include <QLocalServer>
+#include <QLocalSocket>
 #include <QTextStream>
 
+namespace {
+// Buffers larger than this are released after a run instead of being kept for reuse
+constexpr int kMaxRetainedFramerBytes = 1024 * 1024;
+
+// Control lines printed by resources/scripts/goji_python_host.py
+const QLatin1String kHostReadyMarker("@@GOJI_HOST_READY@@");
+const QLatin1String kHostDoneMarker("@@GOJI_HOST_DONE@@");
+
+// Environment variable read by resources/scripts/goji_events.py
+const char kEventPipeVariable[] = "GOJI_EVENT_PIPE";
+
+// Upper bound on waiting for a finished script's last events
+constexpr int kEventDrainTimeoutMs = 250;
+
+// Copy a bundled script to the temp directory, rewriting it only when it changed
+QString extractResourceScript(const QString &resourcePath, const QString &fileName)
+{
+    QFile resource(resourcePath);
+    if (!resource.open(QIODevice::ReadOnly))
+        return QString();
+    const QByteArray contents = resource.readAll();
+
+    const QString path = QDir::temp().filePath(fileName);
+
+    QFile existing(path);
+    if (existing.open(QIODevice::ReadOnly) && existing.readAll() == contents)
+        return path;
+    existing.close();
+
+    QFile out(path);
+    if (!out.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        return QString();
+    out.write(contents);
+    return path;
+}
+}
+
+void ScriptLineFramer::feed(const QByteArray &data, QStringList &lines)
+{
+    if (data.isEmpty())
+        return;
+
+    const int scanFrom = m_buffer.size();
+    m_buffer.append(data);
+
+    const char *bytes = m_buffer.constData();
+    const int size = m_buffer.size();
+
+    for (int i = scanFrom; i < size; ++i) {
+        const char c = bytes[i];
+        if (c == '\n') {
+            if (m_lastWasCR && i == m_readPos) {
+                // Second half of a CRLF pair; the line was already emitted at the CR
+                m_readPos = i + 1;
+            } else {
+                appendLine(i, lines);
+                m_readPos = i + 1;
+            }
+            m_lastWasCR = false;
+        } else if (c == '\r') {
+            appendLine(i, lines);
+            m_readPos = i + 1;
+            m_lastWasCR = true;
+        } else {
+            m_lastWasCR = false;
+        }
+    }
+
+    compact();
+}
+
+void ScriptLineFramer::finish(QStringList &lines)
+{
+    appendLine(m_buffer.size(), lines);
+    clear();
+}
+
+void ScriptLineFramer::clear()
+{
+    if (m_buffer.capacity() > kMaxRetainedFramerBytes)
+        m_buffer.clear();
+    else
+        m_buffer.resize(0);
+
+    m_readPos = 0;
+    m_lastWasCR = false;
+}
+
+void ScriptLineFramer::appendLine(int end, QStringList &lines) const
+{
+    const int length = end - m_readPos;
+    if (length <= 0)
+        return;
+
+    const QString line = (m_utf8 ? QString::fromUtf8(m_buffer.constData() + m_readPos, length)
+                                 : QString::fromLocal8Bit(m_buffer.constData() + m_readPos, length)).trimmed();
+    if (!line.isEmpty())
+        lines.append(line);
+}
+
+void ScriptLineFramer::compact()
+{
+    if (m_readPos == 0)
+        return;
+
+    if (m_readPos >= m_buffer.size()) {
+        m_buffer.resize(0);
+        m_readPos = 0;
+    } else if (m_readPos >= m_buffer.size() / 2) {
+        // Only move the unconsumed tail once most of the buffer is spent
+        m_buffer.remove(0, m_readPos);
+        m_readPos = 0;
+    }
+}
+
+void ScriptEventParser::feed(const QByteArray &data, QVector<QJsonObject> &events)
+{
+    if (data.isEmpty())
+        return;
+
+    int scanFrom = m_buffer.size();
+    m_buffer.append(data);
+
+    int lineStart = 0;
+    int newline;
+    while ((newline = static_cast<int>(m_buffer.indexOf('\n', scanFrom))) >= 0) {
+        appendEvent(lineStart, newline, events);
+        lineStart = newline + 1;
+        scanFrom = lineStart;
+    }
+
+    if (lineStart > 0)
+        m_buffer.remove(0, lineStart);
+}
+
+void ScriptEventParser::finish(QVector<QJsonObject> &events)
+{
+    appendEvent(0, m_buffer.size(), events);
+    m_buffer.clear();
+}
+
+void ScriptEventParser::clear()
+{
+    m_buffer.clear();
+    m_malformedLines = 0;
+}
+
+void ScriptEventParser::appendEvent(int begin, int end, QVector<QJsonObject> &events)
+{
+    const QByteArray line = m_buffer.mid(begin, end - begin).trimmed();
+    if (line.isEmpty())
+        return;
+
+    QJsonParseError error;
+    const QJsonDocument document = QJsonDocument::fromJson(line, &error);
+    if (error.error != QJsonParseError::NoError || !document.isObject()) {
+        ++m_malformedLines;
+        Logger::instance().warning(QString("Dropped malformed script event: %1")
+                                       .arg(QString::fromUtf8(line.left(200))),
+                                   "ScriptEventParser");
+        return;
+    }
+    events.append(document.object());
+}
+
 ScriptRunner::ScriptRunner(QObject *parent)
     : QObject(parent),
     m_process(new QProcess(this))
@@ -24,9 +200,10 @@ ScriptRunner::ScriptRunner(QObject *parent)
         if (!inputWrapperEnabled)
             return;
 
-        if (m_process && m_process->state() == QProcess::Running) {
-            m_process->write("\n");
-            m_process->waitForBytesWritten(50);
+        QProcess *process = activeProcess();
+        if (process && process->state() == QProcess::Running) {
+            process->write("\n");
+            process->waitForBytesWritten(50);
         }
     });
 }
@@ -34,6 +211,8 @@ ScriptRunner::ScriptRunner(QObject *parent)
 ScriptRunner::~ScriptRunner()
 {
     stopInputWrapper();
+    closeEventSockets();
+    stopHost();
     if (m_process) {
         if (m_process->state() == QProcess::Running) {
             m_process->terminate();
@@ -46,12 +225,30 @@ bool ScriptRunner::runScript(const QString &scriptPath, const QStringList &argum
 {
     if (!m_process) return false;
 
-    if (m_process->state() != QProcess::NotRunning) {
+    if (m_process->state() != QProcess::NotRunning || m_hostJobActive) {
         return false;
     }
 
+    TRACE_SCOPE_DETAIL("script", "ScriptRunner::runScript", scriptPath);
+    m_traceStartUs = Tracer::isEnabled() ? Tracer::instance().nowUs() : -1;
+
     resetBuffers();
+    closeEventSockets();
     m_lastScriptPath = scriptPath;
+    m_runTimer.start();
+    m_awaitingFirstOutput = true;
+    m_lastTimeToFirstOutputMs = -1;
+
+    if (m_warmPythonEnabled && scriptPath.endsWith(".py", Qt::CaseInsensitive)) {
+        if (dispatchToHost(scriptPath, arguments)) {
+            m_lastRunWarm = true;
+            startInputWrapper();
+            return true;
+        }
+        Logger::instance().warning("Warm Python host unavailable, falling back to cold start",
+                                   "ScriptRunner::runScript");
+    }
+    m_lastRunWarm = false;
 
     QString program;
     QStringList procArgs;
@@ -70,6 +267,7 @@ bool ScriptRunner::runScript(const QString &scriptPath, const QStringList &argum
     }
 
     m_process->setProcessChannelMode(QProcess::SeparateChannels);
+    m_process->setProcessEnvironment(scriptEnvironment());
     m_process->start(program, procArgs, QIODevice::ReadWrite | QIODevice::Unbuffered);
 
     const bool started = m_process->waitForStarted(5000);
@@ -81,11 +279,17 @@ bool ScriptRunner::runScript(const QString &scriptPath, const QStringList &argum
 
 bool ScriptRunner::isRunning() const
 {
-    return m_process && m_process->state() == QProcess::Running;
+    return m_hostJobActive || (m_process && m_process->state() == QProcess::Running);
 }
 
 void ScriptRunner::terminate()
 {
+    if (m_hostJobActive && m_hostProcess) {
+        // The job's worker watches the host and exits with it; the host is restarted on the next warm run
+        m_hostProcess->kill();
+        return;
+    }
+
     if (!m_process) return;
 
     if (m_process->state() == QProcess::Running) {
@@ -95,15 +299,16 @@ void ScriptRunner::terminate()
 
 void ScriptRunner::writeToScript(const QString &text)
 {
-    if (!m_process || m_process->state() != QProcess::Running) {
+    QProcess *process = activeProcess();
+    if (!process || process->state() != QProcess::Running) {
         return;
     }
 
     QByteArray payload = text.toUtf8();
-    m_process->write(payload);
-    m_process->waitForBytesWritten(50);
+    process->write(payload);
+    process->waitForBytesWritten(50);
 
-    emit scriptOutput(QStringLiteral("[stdin] %1").arg(text));
+    emitLines(QStringList{ QStringLiteral("[stdin] %1").arg(text) }, /*isStdErr=*/false);
 }
 
 QString ScriptRunner::getLastActualScript() const
@@ -115,7 +320,7 @@ void ScriptRunner::handleReadyReadStandardOutput()
 {
     if (!m_process) return;
     QByteArray data = m_process->readAllStandardOutput();
-    processNewData(m_stdoutBuf, data, /*isStdErr=*/false);
+    processNewData(m_stdoutFramer, data, /*isStdErr=*/false);
 }
 
 void ScriptRunner::handleReadyReadStandardError()
@@ -124,53 +329,36 @@ void ScriptRunner::handleReadyReadStandardError()
         return;
 
     QByteArray data = m_process->readAllStandardError();
-    const QList<QByteArray> lines = data.split('\n');
-
-    // Use an iterator to avoid potential QList detachment warnings
-    for (auto it = lines.cbegin(); it != lines.cend(); ++it) {
-        const QByteArray &line = *it;
-        QString qline = QString::fromLocal8Bit(line).trimmed();
-        if (!qline.isEmpty()) {
-            emit scriptError(qline);
-            emit scriptOutput(qline);  // Forward stderr to terminal
-        }
-    }
+    processNewData(m_stderrFramer, data, /*isStdErr=*/true);
 }
 
 void ScriptRunner::handleFinished(int exitCode, QProcess::ExitStatus exitStatus)
 {
     stopInputWrapper();
+    m_awaitingFirstOutput = false;
 
-    if (!m_stdoutBuf.isEmpty()) {
-        QList<QByteArray> lines = m_stdoutBuf.split('\n');
-        for (int i = 0; i < lines.size(); ++i) {
-            QString line = QString::fromLocal8Bit(lines.at(i)).trimmed();
-            if (!line.isEmpty())
-                emit scriptOutput(line);
-        }
-        m_stdoutBuf.clear();
-    }
-    if (!m_stderrBuf.isEmpty()) {
-        QList<QByteArray> lines = m_stderrBuf.split('\n');
-        for (int i = 0; i < lines.size(); ++i) {
-            QString line = QString::fromLocal8Bit(lines.at(i)).trimmed();
-            if (!line.isEmpty())
-                emit scriptError(line);
-        }
-        m_stderrBuf.clear();
-    }
+    // Deliver any unterminated trailing line from either channel
+    QStringList remaining;
+    m_stdoutFramer.finish(remaining);
+    emitLines(remaining, /*isStdErr=*/false);
+
+    remaining.clear();
+    m_stderrFramer.finish(remaining);
+    emitLines(remaining, /*isStdErr=*/true);
 
     if (m_process && m_process->isWritable()) {
         m_process->closeWriteChannel();
     }
 
+    drainEvents();
+    recordRunTrace();
     emit scriptFinished(exitCode, exitStatus);
 }
 
 void ScriptRunner::resetBuffers()
 {
-    m_stdoutBuf.clear();
-    m_stderrBuf.clear();
+    m_stdoutFramer.clear();
+    m_stderrFramer.clear();
 }
 
 void ScriptRunner::startInputWrapper()
@@ -185,21 +373,37 @@ void ScriptRunner::stopInputWrapper()
         m_inputWrapperTimer.stop();
 }
 
-void ScriptRunner::processNewData(QByteArray &accumulator, const QByteArray &newData, bool isStdErr)
+void ScriptRunner::processNewData(ScriptLineFramer &framer, const QByteArray &newData, bool isStdErr)
 {
-    accumulator.append(newData);
-    accumulator.replace("\r\n", "\n");
-    accumulator.replace('\r', '\n');
+    QStringList lines;
+    framer.feed(newData, lines);
+    emitLines(lines, isStdErr);
+}
 
-    int idx;
-    while ((idx = accumulator.indexOf('\n')) != -1) {
-        QByteArray line = accumulator.left(idx);
-        accumulator.remove(0, idx + 1);
-        QString qline = QString::fromLocal8Bit(line).trimmed();
-        if (qline.isEmpty())
-            continue;
-        if (isStdErr) emit scriptError(qline);
-        else emit scriptOutput(qline);
+void ScriptRunner::emitLines(const QStringList &lines, bool isStdErr)
+{
+    if (lines.isEmpty())
+        return;
+
+    if (m_awaitingFirstOutput) {
+        m_awaitingFirstOutput = false;
+        m_lastTimeToFirstOutputMs = m_runTimer.elapsed();
+        Logger::instance().info(QString("Time to first output: %1 ms (%2 start) for %3")
+                                    .arg(m_lastTimeToFirstOutputMs)
+                                    .arg(m_lastRunWarm ? "warm" : "cold")
+                                    .arg(QFileInfo(m_lastScriptPath).fileName()),
+                                "ScriptRunner");
+    }
+
+    // stderr is forwarded to the terminal alongside stdout
+    emit scriptOutputBatch(lines);
+    if (!isStdErr)
+        emit scriptStandardOutput(lines);
+
+    for (const QString &line : lines) {
+        if (isStdErr)
+            emit scriptError(line);
+        emit scriptOutput(line);
     }
 }
 
@@ -212,3 +416,370 @@ void ScriptRunner::setInputWrapperEnabled(bool enabled)
         startInputWrapper();
     }
 }
+
+void ScriptRunner::setUtf8OutputEnabled(bool enabled)
+{
+    m_stdoutFramer.setUtf8(enabled);
+    m_stderrFramer.setUtf8(enabled);
+    m_hostStdoutFramer.setUtf8(enabled);
+    m_hostStderrFramer.setUtf8(enabled);
+}
+
+void ScriptRunner::setWarmPythonEnabled(bool enabled)
+{
+    if (m_warmPythonEnabled == enabled)
+        return;
+
+    m_warmPythonEnabled = enabled;
+    if (enabled) {
+        // Pre-warm so the first run already skips interpreter and import startup;
+        // the first dispatch waits for the start if it has not completed by then
+        ensureHostStarted(/*waitUntilStarted=*/false);
+    } else if (!m_hostJobActive) {
+        stopHost();
+    }
+}
+
+QProcess *ScriptRunner::activeProcess() const
+{
+    return (m_hostJobActive && m_hostProcess) ? m_hostProcess : m_process;
+}
+
+bool ScriptRunner::ensureHostStarted(bool waitUntilStarted)
+{
+    if (m_hostProcess && m_hostProcess->state() != QProcess::NotRunning)
+        return true;
+
+    const QString hostScript = hostScriptPath();
+    if (hostScript.isEmpty()) {
+        Logger::instance().warning("Could not extract warm Python host script", "ScriptRunner::ensureHostStarted");
+        return false;
+    }
+
+    if (!m_hostProcess) {
+        m_hostProcess = new QProcess(this);
+        m_hostProcess->setProcessChannelMode(QProcess::SeparateChannels);
+        connect(m_hostProcess, &QProcess::readyReadStandardOutput,
+                this, &ScriptRunner::handleHostReadyReadStandardOutput);
+        connect(m_hostProcess, &QProcess::readyReadStandardError,
+                this, &ScriptRunner::handleHostReadyReadStandardError);
+        connect(m_hostProcess, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished),
+                this, &ScriptRunner::handleHostFinished);
+        connect(m_hostProcess, &QProcess::errorOccurred, this, [this](QProcess::ProcessError error) {
+            if (error == QProcess::FailedToStart) {
+                Logger::instance().warning(QString("Failed to start warm Python host: %1").arg(m_hostProcess->errorString()),
+                                           "ScriptRunner::ensureHostStarted");
+            }
+        });
+    }
+
+    m_hostStdoutFramer.clear();
+    m_hostStderrFramer.clear();
+    m_hostToken.clear();
+
+    // Jobs inherit the host's environment, event channel included
+    m_hostProcess->setProcessEnvironment(scriptEnvironment());
+    m_hostProcess->start("python", QStringList() << "-u" << hostScript,
+                         QIODevice::ReadWrite | QIODevice::Unbuffered);
+    if (!waitUntilStarted)
+        return true;
+
+    if (!m_hostProcess->waitForStarted(5000))
+        return false;
+
+    Logger::instance().info("Warm Python host started", "ScriptRunner::ensureHostStarted");
+    return true;
+}
+
+void ScriptRunner::stopHost()
+{
+    if (!m_hostProcess || m_hostProcess->state() == QProcess::NotRunning)
+        return;
+
+    m_hostJobActive = false;
+
+    // EOF on stdin ends the host's command loop
+    m_hostProcess->closeWriteChannel();
+    if (!m_hostProcess->waitForFinished(1000)) {
+        m_hostProcess->kill();
+        m_hostProcess->waitForFinished(1000);
+    }
+}
+
+bool ScriptRunner::dispatchToHost(const QString &scriptPath, const QStringList &arguments)
+{
+    if (!ensureHostStarted(/*waitUntilStarted=*/false))
+        return false;
+    if (m_hostProcess->state() == QProcess::Starting && !m_hostProcess->waitForStarted(5000))
+        return false;
+
+    QJsonObject job;
+    job["script"] = scriptPath;
+    job["args"] = QJsonArray::fromStringList(arguments);
+
+    QByteArray command = QJsonDocument(job).toJson(QJsonDocument::Compact);
+    command.append('\n');
+
+    if (m_hostProcess->write(command) != command.size())
+        return false;
+    m_hostProcess->waitForBytesWritten(50);
+
+    m_hostJobActive = true;
+    return true;
+}
+
+void ScriptRunner::handleHostReadyReadStandardOutput()
+{
+    if (!m_hostProcess)
+        return;
+
+    QStringList lines;
+    m_hostStdoutFramer.feed(m_hostProcess->readAllStandardOutput(), lines);
+
+    QStringList jobLines;
+    for (const QString &line : lines) {
+        // The host prints its token once, before any job can run
+        if (m_hostToken.isEmpty() && line.startsWith(kHostReadyMarker)) {
+            m_hostToken = line.mid(kHostReadyMarker.size()).trimmed();
+            continue;
+        }
+
+        // Jobs run in worker processes that never see the token, so a job
+        // echoing the marker text is passed through as ordinary output
+        if (m_hostJobActive && line.startsWith(kHostDoneMarker)) {
+            const QStringList parts = line.mid(kHostDoneMarker.size()).split(' ', Qt::SkipEmptyParts);
+            if (parts.size() == 2 && !m_hostToken.isEmpty() && parts.at(0) == m_hostToken) {
+                emitLines(jobLines, /*isStdErr=*/false);
+                jobLines.clear();
+
+                finishHostJob(parts.at(1).toInt(), QProcess::NormalExit);
+                continue;
+            }
+        }
+
+        if (m_hostJobActive)
+            jobLines.append(line);
+        else
+            Logger::instance().debug(line, "PythonHost");
+    }
+
+    emitLines(jobLines, /*isStdErr=*/false);
+}
+
+void ScriptRunner::handleHostReadyReadStandardError()
+{
+    if (!m_hostProcess)
+        return;
+
+    QStringList lines;
+    m_hostStderrFramer.feed(m_hostProcess->readAllStandardError(), lines);
+
+    if (m_hostJobActive) {
+        emitLines(lines, /*isStdErr=*/true);
+    } else {
+        // Preload warnings between jobs
+        for (const QString &line : lines)
+            Logger::instance().debug(line, "PythonHost");
+    }
+}
+
+void ScriptRunner::handleHostFinished(int exitCode, QProcess::ExitStatus exitStatus)
+{
+    Logger::instance().info(QString("Warm Python host exited with code %1").arg(exitCode),
+                            "ScriptRunner::handleHostFinished");
+
+    if (!m_hostJobActive)
+        return;
+
+    // The host died mid-job (crash or terminate()); a job's own os._exit
+    // only ends its worker and is reported through the done marker
+    QStringList remaining;
+    m_hostStdoutFramer.finish(remaining);
+    emitLines(remaining, /*isStdErr=*/false);
+
+    finishHostJob(exitCode, exitStatus);
+}
+
+void ScriptRunner::finishHostJob(int exitCode, QProcess::ExitStatus exitStatus)
+{
+    if (!m_hostJobActive)
+        return;
+
+    // stderr travels on its own pipe and may trail the done marker
+    if (m_hostProcess) {
+        QStringList lines;
+        m_hostStderrFramer.feed(m_hostProcess->readAllStandardError(), lines);
+        m_hostStderrFramer.finish(lines);
+        emitLines(lines, /*isStdErr=*/true);
+    }
+
+    m_hostJobActive = false;
+    m_awaitingFirstOutput = false;
+    stopInputWrapper();
+
+    drainEvents();
+    recordRunTrace();
+    emit scriptFinished(exitCode, exitStatus);
+}
+
+void ScriptRunner::recordRunTrace()
+{
+    if (m_traceStartUs < 0)
+        return;
+
+    // The whole run, launch to exit, as one span next to the launch span
+    Tracer& tracer = Tracer::instance();
+    tracer.addComplete("script", m_lastRunWarm ? "script run (warm)" : "script run",
+                       m_traceStartUs, tracer.nowUs() - m_traceStartUs, m_lastScriptPath);
+    m_traceStartUs = -1;
+}
+
+QString ScriptRunner::hostScriptPath()
+{
+    return extractResourceScript(":/resources/scripts/goji_python_host.py", "goji_python_host.py");
+}
+
+QString ScriptRunner::eventsModuleDir()
+{
+    const QString path = extractResourceScript(":/resources/scripts/goji_events.py", "goji_events.py");
+    return path.isEmpty() ? QString() : QFileInfo(path).absolutePath();
+}
+
+QString ScriptRunner::eventChannelName() const
+{
+    return (m_eventServer && m_eventServer->isListening()) ? m_eventServer->fullServerName() : QString();
+}
+
+bool ScriptRunner::ensureEventServer()
+{
+    if (m_eventServer && m_eventServer->isListening())
+        return true;
+
+    if (!m_eventServer) {
+        m_eventServer = new QLocalServer(this);
+        m_eventServer->setSocketOptions(QLocalServer::UserAccessOption);
+        connect(m_eventServer, &QLocalServer::newConnection,
+                this, &ScriptRunner::handleEventConnection);
+    }
+
+    const QString name = QString("goji-events-%1-%2")
+                             .arg(QCoreApplication::applicationPid())
+                             .arg(reinterpret_cast<quintptr>(this), 0, 16);
+    // A crashed earlier process can leave a stale socket file behind
+    QLocalServer::removeServer(name);
+    if (!m_eventServer->listen(name)) {
+        Logger::instance().warning(QString("Script event channel unavailable: %1").arg(m_eventServer->errorString()),
+                                   "ScriptRunner::ensureEventServer");
+        return false;
+    }
+    return true;
+}
+
+QProcessEnvironment ScriptRunner::scriptEnvironment()
+{
+    QProcessEnvironment environment = QProcessEnvironment::systemEnvironment();
+
+    if (ensureEventServer())
+        environment.insert(kEventPipeVariable, m_eventServer->fullServerName());
+
+    // Make goji_events importable from any script
+    const QString modulesDir = QDir::toNativeSeparators(eventsModuleDir());
+    if (!modulesDir.isEmpty()) {
+        const QString pythonPath = environment.value("PYTHONPATH");
+        environment.insert("PYTHONPATH", pythonPath.isEmpty()
+                                             ? modulesDir
+                                             : modulesDir + QDir::listSeparator() + pythonPath);
+    }
+    return environment;
+}
+
+void ScriptRunner::handleEventConnection()
+{
+    while (m_eventServer && m_eventServer->hasPendingConnections()) {
+        QLocalSocket *socket = m_eventServer->nextPendingConnection();
+        m_eventSockets.insert(socket, ScriptEventParser());
+
+        connect(socket, &QLocalSocket::readyRead, this, &ScriptRunner::handleEventReadyRead);
+        connect(socket, &QLocalSocket::disconnected, this, [this, socket]() {
+            readEvents(socket, /*atEnd=*/true);
+            m_eventSockets.remove(socket);
+            socket->deleteLater();
+        });
+    }
+}
+
+void ScriptRunner::handleEventReadyRead()
+{
+    readEvents(qobject_cast<QLocalSocket *>(sender()), /*atEnd=*/false);
+}
+
+void ScriptRunner::readEvents(QLocalSocket *socket, bool atEnd)
+{
+    auto it = m_eventSockets.find(socket);
+    if (it == m_eventSockets.end())
+        return;
+
+    QVector<QJsonObject> events;
+    it->feed(socket->readAll(), events);
+    if (atEnd)
+        it->finish(events);
+
+    // Slots may start another run, which closes the sockets; the events are already copied out
+    for (const QJsonObject &event : std::as_const(events))
+        dispatchEvent(event);
+}
+
+void ScriptRunner::dispatchEvent(const QJsonObject &event)
+{
+    emit scriptEvent(event);
+
+    const QString type = event.value("event").toString();
+    if (type == QLatin1String("progress")) {
+        emit scriptProgress(event.value("percent").toDouble(), event.value("message").toString());
+    } else if (type == QLatin1String("file")) {
+        emit scriptFileProduced(event.value("path").toString(), event.value("kind").toString());
+    } else if (type == QLatin1String("count")) {
+        emit scriptCount(event.value("name").toString(), static_cast<qint64>(event.value("value").toDouble()));
+    } else if (type == QLatin1String("result")) {
+        emit scriptResult(event);
+    }
+}
+
+void ScriptRunner::drainEvents()
+{
+    if (!m_eventServer)
+        return;
+
+    // The script has exited but its last events may not have been read yet;
+    // deliver them so they always precede scriptFinished
+    QElapsedTimer elapsed;
+    elapsed.start();
+    if (m_eventServer->hasPendingConnections() || m_eventServer->waitForNewConnection(0))
+        handleEventConnection();
+
+    const QList<QLocalSocket *> sockets = m_eventSockets.keys();
+    for (QLocalSocket *socket : sockets) {
+        while (m_eventSockets.contains(socket)
+               && socket->state() == QLocalSocket::ConnectedState
+               && !elapsed.hasExpired(kEventDrainTimeoutMs)) {
+            readEvents(socket, /*atEnd=*/false);
+            if (!socket->waitForReadyRead(20))
+                break;
+        }
+        readEvents(socket, /*atEnd=*/true);
+    }
+
+    // Anything a leftover child writes after this belongs to no run
+    closeEventSockets();
+}
+
+void ScriptRunner::closeEventSockets()
+{
+    const QList<QLocalSocket *> sockets = m_eventSockets.keys();
+    m_eventSockets.clear();
+    for (QLocalSocket *socket : sockets) {
+        disconnect(socket, nullptr, this, nullptr);
+        socket->abort();
+        socket->deleteLater();
+    }
+}
@@ -5,6 +5,85 @@
 #include <QProcess>
 #include <QTimer>
 #include <QStringList>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QJsonObject>
+#include <QVector>
+
+class QLocalServer;
+class QLocalSocket;
+
+/**
+ * @brief Incremental line framer for process output
+ *
+ * Appends incoming bytes to a reusable buffer and scans each new byte once,
+ * treating CR, LF and CRLF as line terminators. Consumed bytes are only
+ * compacted away once they make up most of the buffer, so a large chunk
+ * containing many lines is split in linear time.
+ */
+class ScriptLineFramer
+{
+public:
+    /**
+     * @brief Append data and collect every complete, non-empty line
+     * @param data Newly read bytes
+     * @param lines Receives decoded, trimmed lines in order
+     */
+    void feed(const QByteArray &data, QStringList &lines);
+
+    /**
+     * @brief Emit any trailing partial line and reset the framer
+     * @param lines Receives the decoded, trimmed remainder if non-empty
+     */
+    void finish(QStringList &lines);
+
+    void clear();
+    bool isEmpty() const { return m_readPos >= m_buffer.size(); }
+
+    // Decode lines as UTF-8 instead of the local 8-bit encoding
+    void setUtf8(bool utf8) { m_utf8 = utf8; }
+
+private:
+    void appendLine(int end, QStringList &lines) const;
+    void compact();
+
+    QByteArray m_buffer;
+    int m_readPos { 0 };
+    bool m_lastWasCR { false };
+    bool m_utf8 { false };
+};
+
+/**
+ * @brief Incremental parser for the NDJSON script event stream
+ *
+ * Splits the side-channel bytes on LF and decodes each complete line as a
+ * UTF-8 JSON object. Lines that are not objects are counted and dropped so a
+ * malformed event cannot stall the ones behind it.
+ */
+class ScriptEventParser
+{
+public:
+    /**
+     * @brief Append data and collect every complete event
+     * @param data Newly read bytes
+     * @param events Receives decoded events in order
+     */
+    void feed(const QByteArray &data, QVector<QJsonObject> &events);
+
+    /**
+     * @brief Decode any trailing unterminated line and reset the parser
+     */
+    void finish(QVector<QJsonObject> &events);
+
+    void clear();
+    int malformedLines() const { return m_malformedLines; }
+
+private:
+    void appendEvent(int begin, int end, QVector<QJsonObject> &events);
+
+    QByteArray m_buffer;
+    int m_malformedLines { 0 };
+};
 
 class ScriptRunner : public QObject
 {
@@ -24,28 +103,105 @@ public:
     bool inputWrapperEnabled { true };
     void setInputWrapperEnabled(bool enabled);
 
+    // Decode script output as UTF-8 rather than the local 8-bit encoding,
+    // for callers that parse what the script prints
+    void setUtf8OutputEnabled(bool enabled);
+
+    // Warm mode: .py scripts run in a worker the long-lived Python host spawned
+    // ahead of time with pandas/openpyxl pre-imported. Enabling starts the host
+    // without waiting for it; a run falls back to a cold spawn if the host
+    // cannot be started.
+    void setWarmPythonEnabled(bool enabled);
+    bool isWarmPythonEnabled() const { return m_warmPythonEnabled; }
+
+    // Milliseconds from runScript() to the first output line of the last
+    // run, or -1 if it produced none; logged together with warm/cold mode
+    qint64 lastTimeToFirstOutputMs() const { return m_lastTimeToFirstOutputMs; }
+
+    // Address of the event side channel passed to scripts in GOJI_EVENT_PIPE,
+    // or empty if the channel could not be opened
+    QString eventChannelName() const;
+
 signals:
     void scriptOutput(const QString &line);
     void scriptError(const QString &line);
+
+    // Emitted once per read with every line that scriptOutput is about to
+    // deliver, so consumers can append many lines per event-loop turn
+    void scriptOutputBatch(const QStringList &lines);
+
+    // The stdout lines of each batch on their own, without stderr
+    void scriptStandardOutput(const QStringList &lines);
     void scriptFinished(int exitCode, QProcess::ExitStatus exitStatus);
 
+    // Structured events written by the script through goji_events.py. Every
+    // event is delivered before scriptFinished for the same run; scriptEvent
+    // carries each one raw, followed by the typed signal for known kinds.
+    void scriptEvent(const QJsonObject &event);
+    void scriptProgress(double percent, const QString &message);
+    void scriptFileProduced(const QString &path, const QString &kind);
+    void scriptCount(const QString &name, qint64 value);
+    void scriptResult(const QJsonObject &result);
+
 public slots:
     void handleReadyReadStandardOutput();
     void handleReadyReadStandardError();
     void handleFinished(int exitCode, QProcess::ExitStatus exitStatus);
 
+private slots:
+    void handleHostReadyReadStandardOutput();
+    void handleHostReadyReadStandardError();
+    void handleHostFinished(int exitCode, QProcess::ExitStatus exitStatus);
+    void handleEventConnection();
+    void handleEventReadyRead();
+
 private:
     void resetBuffers();
     void startInputWrapper();
     void stopInputWrapper();
-    void processNewData(QByteArray &accumulator, const QByteArray &newData, bool isStdErr);
+    void processNewData(ScriptLineFramer &framer, const QByteArray &newData, bool isStdErr);
+    void emitLines(const QStringList &lines, bool isStdErr);
+    QProcess *activeProcess() const;
+    bool ensureHostStarted(bool waitUntilStarted);
+    void stopHost();
+    bool dispatchToHost(const QString &scriptPath, const QStringList &arguments);
+    void finishHostJob(int exitCode, QProcess::ExitStatus exitStatus);
+    static QString hostScriptPath();
+    void recordRunTrace();
+    bool ensureEventServer();
+    QProcessEnvironment scriptEnvironment();
+    void closeEventSockets();
+    void drainEvents();
+    void readEvents(QLocalSocket *socket, bool atEnd);
+    void dispatchEvent(const QJsonObject &event);
+    static QString eventsModuleDir();
 
 private:
     QProcess *m_process { nullptr };
     QString   m_lastScriptPath;
-    QByteArray m_stdoutBuf;
-    QByteArray m_stderrBuf;
+    ScriptLineFramer m_stdoutFramer;
+    ScriptLineFramer m_stderrFramer;
     QTimer    m_inputWrapperTimer;
+
+    // Warm Python host
+    QProcess *m_hostProcess { nullptr };
+    ScriptLineFramer m_hostStdoutFramer;
+    ScriptLineFramer m_hostStderrFramer;
+    bool m_warmPythonEnabled { false };
+    bool m_hostJobActive { false };
+    QString m_hostToken;    // from the ready marker; done markers must repeat it
+
+    // Event side channel; one parser per connection since a script may
+    // start helpers that report on their own connection
+    QLocalServer *m_eventServer { nullptr };
+    QHash<QLocalSocket *, ScriptEventParser> m_eventSockets;
+
+    // Time-to-first-output measurement
+    QElapsedTimer m_runTimer;
+    bool m_awaitingFirstOutput { false };
+    bool m_lastRunWarm { false };
+    qint64 m_lastTimeToFirstOutputMs { -1 };
+    qint64 m_traceStartUs { -1 };
 };
 
 #endif // SCRIPTRUNNER_H
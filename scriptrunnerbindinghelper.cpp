@@ -1,8 +1,16 @@
 #include "scriptrunnerbindinghelper.h"
 
 #include "scriptrunner.h"
+#include "terminaloutputhelper.h"
 
 #include <QObject>
+#include <QProgressBar>
+#include <QStringList>
+#include <QVariant>
+
+namespace {
+const char* const kProgressOwnerProperty = "gojiScriptRunner";
+}
 
 bool ScriptRunnerBindingHelper::setupBaselineBindings(
     ScriptRunner* scriptRunner,
@@ -15,9 +23,14 @@ bool ScriptRunnerBindingHelper::setupBaselineBindings(
         return false;
     }
 
-    QObject::connect(scriptRunner, &ScriptRunner::scriptOutput, context,
-                     [scriptOutputHandler](const QString& output) {
-                         scriptOutputHandler(output);
+    // Lines arrive in one batch per read; the terminal appends made by the
+    // handler for the whole batch are written to the document once
+    QObject::connect(scriptRunner, &ScriptRunner::scriptOutputBatch, context,
+                     [scriptOutputHandler](const QStringList& lines) {
+                         TerminalOutputHelper::BatchScope batch;
+                         for (const QString& output : lines) {
+                             scriptOutputHandler(output);
+                         }
                      });
 
     QObject::connect(scriptRunner, &ScriptRunner::scriptFinished, context,
@@ -34,3 +47,32 @@ bool ScriptRunnerBindingHelper::setupBaselineBindings(
 
     return true;
 }
+
+bool ScriptRunnerBindingHelper::bindProgressBar(ScriptRunner* scriptRunner, QProgressBar* progressBar)
+{
+    if (!scriptRunner || !progressBar) {
+        return false;
+    }
+
+    QObject::connect(scriptRunner, &ScriptRunner::scriptProgress, progressBar,
+                     [scriptRunner, progressBar](double percent, const QString& message) {
+                         progressBar->setProperty(kProgressOwnerProperty, QVariant::fromValue<QObject*>(scriptRunner));
+                         progressBar->setRange(0, 100);
+                         progressBar->setValue(qBound(0, qRound(percent), 100));
+                         progressBar->setFormat(message.isEmpty() ? QStringLiteral("%p%")
+                                                                  : message + QStringLiteral(" - %p%"));
+                         progressBar->show();
+                     });
+
+    QObject::connect(scriptRunner, &ScriptRunner::scriptFinished, progressBar,
+                     [scriptRunner, progressBar]() {
+                         if (progressBar->property(kProgressOwnerProperty).value<QObject*>() != scriptRunner) {
+                             return;
+                         }
+                         progressBar->setProperty(kProgressOwnerProperty, QVariant());
+                         progressBar->reset();
+                         progressBar->hide();
+                     });
+
+    return true;
+}
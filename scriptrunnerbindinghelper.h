@@ -7,6 +7,7 @@
 #include <functional>
 
 class QObject;
+class QProgressBar;
 class ScriptRunner;
 
 class ScriptRunnerBindingHelper
@@ -22,6 +23,10 @@ public:
         const ScriptOutputHandler& scriptOutputHandler,
         const ScriptFinishedHandler& scriptFinishedHandler,
         const ScriptErrorHandler& scriptErrorHandler = ScriptErrorHandler());
+
+    // Show a runner's progress events on a bar that is hidden between runs.
+    // One bar may serve several runners; the runner that reported last owns it.
+    static bool bindProgressBar(ScriptRunner* scriptRunner, QProgressBar* progressBar);
 };
 
 #endif // SCRIPTRUNNERBINDINGHELPER_H
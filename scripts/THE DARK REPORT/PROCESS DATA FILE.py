@@ -7,11 +7,21 @@ import sys
 import pandas as pd
 from iso3166 import countries
 
+try:
+    import goji_events
+except ImportError:
+    goji_events = None
+
 COPY_INSTRUCTION_COPY_RE = re.compile(r"\bcop(?:y|ies)\b", re.IGNORECASE)
 COPY_INSTRUCTION_QUANTITY_RE = re.compile(r"\b(?:two|2)\b", re.IGNORECASE)
 UNNAMED_COLUMN_RE = re.compile(r"^Unnamed:\s*\d+$", re.IGNORECASE)
 
 
+def emit_event(name, *args, **kwargs):
+    if goji_events is not None:
+        getattr(goji_events, name)(*args, **kwargs)
+
+
 def normalize_source_col(value: str) -> str:
     if value is None:
         return ""
@@ -201,8 +211,11 @@ def process_dark_report(input_file: str, job_number: str):
     if not re.fullmatch(r"\d{5}", job_number):
         raise ProcessingError("Job number must be exactly five digits.")
 
+    emit_event("progress", 10, "Reading input file")
     df = read_input_file(input_file)
+    emit_event("progress", 35, "Duplicating copy-instruction rows")
     df = duplicate_rows_for_copy_instructions(df)
+    emit_event("progress", 55, "Normalizing countries")
     transform_country_values(df)
     rename_columns(df)
     df = drop_empty_unnamed_columns(df)
@@ -211,11 +224,14 @@ def process_dark_report(input_file: str, job_number: str):
     output_name = f"{job_number} THE DARK REPORT.csv"
     output_path = os.path.join(output_dir, output_name)
 
+    emit_event("progress", 75, "Saving CSV")
     try:
         df.to_csv(output_path, index=False, encoding="utf-8-sig")
     except Exception as exc:
         raise ProcessingError(f"Could not save CSV: {exc}") from exc
+    emit_event("file_produced", output_path, "output")
 
+    emit_event("progress", 90, "Counting pieces")
     domestic_count, international_count, total_count, international_country_counts = calculate_counts(df)
 
     return {
@@ -245,6 +261,8 @@ def main(argv=None):
     try:
         args = parse_args(argv)
         result = process_dark_report(args.input_file, args.job_number)
+        emit_event("progress", 100, "Complete")
+        emit_event("result", True, **{k: v for k, v in result.items() if k != "ok"})
         if args.json:
             print(json.dumps(result))
         else:
@@ -255,10 +273,12 @@ def main(argv=None):
         return 0
     except ProcessingError as exc:
         payload = {"ok": False, "error": str(exc)}
+        emit_event("result", False, reason="PROCESSING_ERROR", detail=str(exc), error=str(exc))
         print(json.dumps(payload))
         return 1
     except Exception as exc:
         payload = {"ok": False, "error": f"Unexpected error: {exc}"}
+        emit_event("result", False, reason="UNEXPECTED_ERROR", detail=str(exc), error=payload["error"])
         print(json.dumps(payload))
         return 1
 
@@ -12,6 +12,15 @@ import time
 from datetime import datetime
 import argparse
 
+try:
+    import goji_events
+except ImportError:
+    goji_events = None
+
+def emit_event(name, *args, **kwargs):
+    if goji_events is not None:
+        getattr(goji_events, name)(*args, **kwargs)
+
 CANONICAL_TM_ROOT = r"C:\Goji\AUTOMATION\TRACHMAR"
 
 def resolve_tm_root():
@@ -319,19 +328,26 @@ class CSVMergerProcessor:
             print(f"INFO: Job={job_number}, Year={year}, Month={month}")
 
             print("Creating backups...")
+            emit_event("progress", 10, "Creating backups")
             self.backup_directory_contents()
 
             print("\nFinding original CSV files...")
+            emit_event("progress", 30, "Finding original files")
             original_files = self.find_original_files()
             print(f"[OK] Found {len(original_files)} original file(s):")
             for file_path in original_files:
                 print(f"  - {os.path.basename(file_path)}")
 
             print("\nCreating MERGED files...")
+            emit_event("progress", 50, "Creating MERGED files")
             merged_files = self.create_merged_files(original_files)
 
             print("\n" + "="*50)
             print(f"[OK] {len(merged_files)} MERGED file(s) created and validated")
+            emit_event("count", "merged_files", len(merged_files))
+            emit_event("file_produced", self.data_dir, "output_dir")
+            emit_event("emit", "pause_for_email", path=self.data_dir)
+            emit_event("progress", 100, "Waiting for email")
             print("=== NAS_FOLDER_PATH ===")
             print(self.data_dir)
             print("=== END_NAS_FOLDER_PATH ===")
@@ -340,6 +356,7 @@ class CSVMergerProcessor:
 
         except Exception as e:
             print(f"\nFATAL ERROR: {str(e)}")
+            emit_event("result", False, reason="PREARCHIVE_FAILED", detail=str(e))
             self.rollback()
             sys.exit(1)
 
@@ -356,16 +373,21 @@ class CSVMergerProcessor:
                     merged_files.append(os.path.join(self.data_dir, file_name))
 
             print("\nRenaming TRACHMAR FL ER.csv...")
+            emit_event("progress", 10, "Renaming TRACHMAR file")
             renamed_file = self.rename_trachmar_file(job_number)
 
             print("\nCopying to destination...")
+            emit_event("progress", 30, "Copying to destination")
             self.copy_to_destination(renamed_file)
 
             print("\nCreating archive...")
+            emit_event("progress", 55, "Creating archive")
             self.create_archive(job_number, merged_files)
 
             print("\nDeleting files from DATA directory...")
+            emit_event("progress", 80, "Cleaning DATA directory")
             self.delete_data_files()
+            emit_event("progress", 100, "Archive complete")
 
             print("\n" + "="*50)
             print("SUCCESS! All operations completed successfully")
@@ -380,6 +402,7 @@ class CSVMergerProcessor:
 
         except Exception as e:
             print(f"\nFATAL ERROR: {str(e)}")
+            emit_event("result", False, reason="ARCHIVE_FAILED", detail=str(e))
             self.rollback()
             print("\nScript terminated due to error.")
             print("TERMINATING...")
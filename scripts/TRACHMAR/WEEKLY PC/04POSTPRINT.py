@@ -5,10 +5,18 @@ import sys
 import traceback
 import re
 import json
+import sqlite3
 import time
+from urllib.request import pathname2url
 import tkinter as tk
 from tkinter import messagebox
 
+try:
+    import goji_events
+except ImportError:
+    # Run outside GOJI: events have no listener
+    goji_events = None
+
 def print_status(message):
     """Print status message to stdout and flush"""
     print(message)
@@ -24,7 +32,13 @@ def print_warning(message):
     print(f"WARNING: {message}", file=sys.stderr)
     sys.stderr.flush()
 
+def emit_event(name, *args, **kwargs):
+    """Send a structured event to GOJI (no-op when not run by GOJI)"""
+    if goji_events is not None:
+        getattr(goji_events, name)(*args, **kwargs)
+
 CANONICAL_TM_WEEKLY_BASE = r"C:\Goji\AUTOMATION\TRACHMAR\WEEKLY PC"
+# Stdout markers GOJI falls back to when the event channel is unavailable
 POSTPRINT_MARKER_FILES_START = "=== POSTPRINT_FILES ==="
 POSTPRINT_MARKER_FILES_END = "=== END_POSTPRINT_FILES ==="
 POSTPRINT_FAIL_REASON_PREFIX = "POSTPRINT_FAIL_REASON="
@@ -63,6 +77,7 @@ def emit_failure_reason(reason_code, detail):
         print_status(f"{POSTPRINT_FAIL_REASON_PREFIX}{reason_code}|{detail_text}")
     else:
         print_status(f"{POSTPRINT_FAIL_REASON_PREFIX}{reason_code}")
+    emit_event("result", False, reason=reason_code, detail=detail_text)
 
 def parse_session_start_utc_ms(raw_value):
     if raw_value is None:
@@ -76,6 +91,9 @@ def parse_session_start_utc_ms(raw_value):
         return None
     return parsed if parsed > 0 else None
 
+def parse_session_id(raw_value):
+    return parse_session_start_utc_ms(raw_value)
+
 def load_baseline_manifest(baseline_manifest_path):
     path = str(baseline_manifest_path).strip()
     if not path:
@@ -140,9 +158,61 @@ def list_print_pdf_files(print_dir):
     current_files.sort(key=lambda entry: entry["path"].lower())
     return current_files
 
+def load_session_changes(manifest_db_path, session_id, print_dir):
+    """
+    Reads the files GOJI recorded as added/modified since the print session began
+    from its print manifest database, and stats only those files.
+    """
+    path = str(manifest_db_path).strip()
+    if not path:
+        return None, "Print manifest path not provided"
+    if not os.path.isfile(path):
+        return None, f"Print manifest not found: {path}"
+
+    try:
+        uri = "file:" + pathname2url(os.path.abspath(path)) + "?mode=ro"
+        connection = sqlite3.connect(uri, uri=True, timeout=5)
+        try:
+            session_row = connection.execute(
+                "SELECT id FROM print_sessions WHERE id = ?", (session_id,)
+            ).fetchone()
+            if session_row is None:
+                return None, f"Print session {session_id} not found in manifest"
+            names = [row[0] for row in connection.execute(
+                "SELECT m.name FROM print_sessions s "
+                "JOIN print_manifest m ON m.directory = s.directory AND m.updated_seq > s.baseline_seq "
+                "WHERE s.id = ?",
+                (session_id,)
+            )]
+        finally:
+            connection.close()
+    except sqlite3.Error as exc:
+        return None, f"Unable to read print manifest: {exc}"
+
+    changed_files = []
+    for name in names:
+        if not name.lower().endswith(".pdf"):
+            continue
+
+        absolute_path = os.path.abspath(os.path.join(print_dir, name))
+        if not os.path.isfile(absolute_path):
+            continue
+
+        stat_result = os.stat(absolute_path)
+        changed_files.append({
+            "path": absolute_path,
+            "key": os.path.normcase(absolute_path),
+            "name": os.path.basename(absolute_path),
+            "size": int(stat_result.st_size),
+            "mtime_utc_ms": int(stat_result.st_mtime * 1000)
+        })
+
+    changed_files.sort(key=lambda entry: entry["path"].lower())
+    return changed_files, None
+
 def detect_current_run_print_files(print_dir, session_start_utc_ms, baseline_by_path):
     current_files = list_print_pdf_files(print_dir)
-    changed_candidates = []
+    changed_files = []
 
     for entry in current_files:
         baseline_entry = baseline_by_path.get(entry["key"])
@@ -151,13 +221,16 @@ def detect_current_run_print_files(print_dir, session_start_utc_ms, baseline_by_
             or baseline_entry["size"] != entry["size"]
             or baseline_entry["mtime_utc_ms"] != entry["mtime_utc_ms"]
         )
-        if not is_new_or_changed:
-            continue
+        if is_new_or_changed:
+            changed_files.append(entry)
 
-        if entry["mtime_utc_ms"] < session_start_utc_ms:
-            continue
+    return select_current_run_print_files(changed_files, session_start_utc_ms)
 
-        changed_candidates.append(entry)
+def select_current_run_print_files(changed_files, session_start_utc_ms):
+    changed_candidates = [
+        entry for entry in changed_files
+        if entry["mtime_utc_ms"] >= session_start_utc_ms
+    ]
 
     if not changed_candidates:
         return None, "STALE_PROTECTION_EMPTY_RESULT", "No new/changed PRINT PDFs passed session boundary checks"
@@ -299,7 +372,7 @@ def copy_files_with_verification_and_rename(
                     source_files.append(source_file)
 
         files_found = len(source_files)
-        for source_file in source_files:
+        for index, source_file in enumerate(source_files):
             file = os.path.basename(source_file)
             renamed_file = generate_renamed_filename(file, job_number, month, week)
             dest_file = os.path.join(dest_dir, renamed_file)
@@ -313,6 +386,8 @@ def copy_files_with_verification_and_rename(
                 if source_size == dest_size:
                     copied_files.append(dest_file)
                     print_status(f"  - Copied and renamed: {file} -> {renamed_file} ({source_size} bytes)")
+                    # Copying spans 30-90% of the post-print run
+                    emit_event("progress", 30 + 60 * (index + 1) / files_found, f"Copied {renamed_file}")
                 else:
                     print_error(f"Size mismatch for {file}: source={source_size}, dest={dest_size}")
                     return None
@@ -417,7 +492,8 @@ def show_network_unavailable_popup():
         print_status("*** PRINT FILE SAVED TO DESKTOP FOLDER ***")
         print_warning(f"Could not show popup dialog: {str(e)}")
 
-def post_print_process(job_number, month, week, year, session_start_raw, baseline_manifest_path):
+def post_print_process(job_number, month, week, year, session_start_raw, baseline_manifest_path,
+                       session_id_raw=None):
     """
     Handles post-print processing tasks
     
@@ -426,11 +502,14 @@ def post_print_process(job_number, month, week, year, session_start_raw, baselin
         month: Month number from monthDDboxTMWPC (2-digit format)
         week: Week number from weekDDboxTMWPC (day of month)
         year: Year value from yearDDboxTMWPC (4-digit format)
+        baseline_manifest_path: GOJI print manifest database, or a legacy JSON baseline
+        session_id_raw: Print session id in the manifest database
     """
     operations_completed = []
 
     try:
         print_status("=== POST PRINT PROCESS ===")
+        emit_event("progress", 0, "Validating parameters")
         
         validation_errors = validate_parameters(job_number, month, week, year)
         if validation_errors:
@@ -455,11 +534,24 @@ def post_print_process(job_number, month, week, year, session_start_raw, baselin
             print_error("Missing or invalid print session boundary signal")
             return False
 
-        baseline_by_path, baseline_error = load_baseline_manifest(baseline_manifest_path)
-        if baseline_error is not None:
-            emit_failure_reason("STALE_PROTECTION_BASELINE_UNREADABLE", baseline_error)
-            print_error(baseline_error)
-            return False
+        uses_json_baseline = str(baseline_manifest_path).strip().lower().endswith(".json")
+        baseline_by_path = None
+        session_id = None
+        if uses_json_baseline:
+            baseline_by_path, baseline_error = load_baseline_manifest(baseline_manifest_path)
+            if baseline_error is not None:
+                emit_failure_reason("STALE_PROTECTION_BASELINE_UNREADABLE", baseline_error)
+                print_error(baseline_error)
+                return False
+        else:
+            session_id = parse_session_id(session_id_raw)
+            if session_id is None:
+                emit_failure_reason(
+                    "STALE_PROTECTION_MISSING_SESSION_SIGNAL",
+                    "Missing or invalid print session id"
+                )
+                print_error("Missing or invalid print session id")
+                return False
 
         # Define paths
         weekly_base_path = resolve_tm_weekly_base_path()
@@ -469,8 +561,12 @@ def post_print_process(job_number, month, week, year, session_start_raw, baselin
         week_folder_path = os.path.join(job_folder_path, week_number)
         fallback_path = os.path.join(r"C:\Users\JCox\Desktop\MOVE TO NETWORK DRIVE", job_number, week_number)
         print_status(f"Source PRINT path: {source_print_path}")
+        emit_event("progress", 10, "Finding current-run PRINT files")
         print_status(f"Session boundary (UTC ms): {session_start_utc_ms}")
-        print_status(f"Baseline entries: {len(baseline_by_path)}")
+        if uses_json_baseline:
+            print_status(f"Baseline entries: {len(baseline_by_path)}")
+        else:
+            print_status(f"Print session: {session_id}")
         
         if not os.path.exists(source_print_path):
             print_error(f"Print source path does not exist: {source_print_path}")
@@ -481,11 +577,27 @@ def post_print_process(job_number, month, week, year, session_start_raw, baselin
             return False
         
         try:
-            postprint_files, fail_code, fail_detail = detect_current_run_print_files(
-                source_print_path,
-                session_start_utc_ms,
-                baseline_by_path
-            )
+            if uses_json_baseline:
+                postprint_files, fail_code, fail_detail = detect_current_run_print_files(
+                    source_print_path,
+                    session_start_utc_ms,
+                    baseline_by_path
+                )
+            else:
+                changed_files, changes_error = load_session_changes(
+                    baseline_manifest_path,
+                    session_id,
+                    source_print_path
+                )
+                if changes_error is not None:
+                    emit_failure_reason("STALE_PROTECTION_BASELINE_UNREADABLE", changes_error)
+                    print_error(changes_error)
+                    return False
+                print_status(f"Changed files since session start: {len(changed_files)}")
+                postprint_files, fail_code, fail_detail = select_current_run_print_files(
+                    changed_files,
+                    session_start_utc_ms
+                )
         except Exception as e:
             emit_failure_reason("STALE_PROTECTION_BASELINE_UNREADABLE", f"Failed during PDF detection: {e}")
             print_error(f"Failed during current-run PDF detection: {e}")
@@ -505,6 +617,7 @@ def post_print_process(job_number, month, week, year, session_start_raw, baselin
             destination_path = week_folder_path
 
         print_status(f"Destination: {destination_path}")
+        emit_event("progress", 30, "Copying PRINT files")
 
         try:
             print_status("Creating destination directory structure...")
@@ -530,11 +643,16 @@ def post_print_process(job_number, month, week, year, session_start_raw, baselin
             return False
         operations_completed.append(("copy_pdf", copied_postprint_files))
 
+        # Exact destination paths for the GOJI drag-and-drop popup
+        emit_event("file_produced", destination_path, "output_dir")
+        for file_path in copied_postprint_files:
+            emit_event("file_produced", file_path, "postprint")
+        emit_event("count", "postprint_files", len(copied_postprint_files))
+
         print_status("=== OUTPUT_PATH ===")
         print_status(destination_path)
         print_status("=== END_OUTPUT_PATH ===")
 
-        # Emit exact destination file paths for GOJI popup population.
         print_status(POSTPRINT_MARKER_FILES_START)
         for file_path in copied_postprint_files:
             print_status(os.path.abspath(file_path))
@@ -544,6 +662,8 @@ def post_print_process(job_number, month, week, year, session_start_raw, baselin
         print_status(f"Job: {job_number} ({week_number}/{year})")
         print_status(f"Current-run PRINT PDFs copied: {len(copied_postprint_files)}")
         print_status("POST PRINT PROCESS COMPLETED SUCCESSFULLY!")
+        emit_event("progress", 100, "Post print complete")
+        emit_event("result", True)
         
         return True
         
@@ -600,11 +720,13 @@ if __name__ == "__main__":
             year = sys.argv[4]
             session_start_utc_ms = sys.argv[5]
             baseline_manifest_path = sys.argv[6]
+            session_id = sys.argv[7] if len(sys.argv) >= 8 else None
             
             print_status(
                 "Parameters: "
                 f"Job={job_number}, Month={month}, Week={week}, Year={year}, "
-                f"SessionUTCms={session_start_utc_ms}, BaselineManifest={baseline_manifest_path}"
+                f"SessionUTCms={session_start_utc_ms}, BaselineManifest={baseline_manifest_path}, "
+                f"Session={session_id}"
             )
             
             success = post_print_process(
@@ -613,7 +735,8 @@ if __name__ == "__main__":
                 week,
                 year,
                 session_start_utc_ms,
-                baseline_manifest_path
+                baseline_manifest_path,
+                session_id
             )
             
             if success:
@@ -630,7 +753,7 @@ if __name__ == "__main__":
             print_error("Missing required parameters")
             print_status(
                 "Usage: python 04POSTPRINT.py "
-                "<job_number> <month> <week> <year> <print_session_start_utc_ms> <baseline_manifest_path>"
+                "<job_number> <month> <week> <year> <print_session_start_utc_ms> <print_manifest_db> <print_session_id>"
             )
             print_status("This script should normally be called from the GOJI application")
             sys.exit(1)
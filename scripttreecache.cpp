@@ -0,0 +1,282 @@
+#include "scripttreecache.h"
+#include "tracer.h"
+
+#include <QDir>
+#include <QFileInfo>
+#include <QHash>
+#include <QtConcurrent>
+
+namespace {
+
+// Editors and sync tools touch a directory several times per save
+const int kDebounceMs = 500;
+
+quint64 mixSignature(quint64 hash, quint64 value)
+{
+    return (hash ^ value) * 1099511628211ULL;
+}
+
+quint64 signatureOf(const ScriptDirNode& node)
+{
+    quint64 hash = 14695981039346656037ULL;
+    hash = mixSignature(hash, qHash(node.name));
+    for (const QString& script : node.scripts) {
+        hash = mixSignature(hash, qHash(script));
+    }
+    hash = mixSignature(hash, node.scripts.size());
+    for (const ScriptDirNodePtr& child : node.children) {
+        hash = mixSignature(hash, child->signature);
+    }
+    return hash;
+}
+
+// Closest directory at or above path that exists; empty if none does
+QString nearestExistingDir(const QString& path)
+{
+    QString current = QDir::cleanPath(path);
+    while (!current.isEmpty()) {
+        if (QFileInfo(current).isDir()) {
+            return current;
+        }
+        const QString parent = QFileInfo(current).absolutePath();
+        if (parent == current) {
+            break;
+        }
+        current = parent;
+    }
+    return QString();
+}
+
+bool containsPathUnder(const QSet<QString>& paths, const QString& dirPath)
+{
+    const QString prefix = dirPath + QLatin1Char('/');
+    for (const QString& path : paths) {
+        if (path.startsWith(prefix)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Read one directory; subdirectories found in previous are reused unless they are dirty
+ScriptDirNodePtr buildNode(const QString& dirPath, const ScriptTreeCache::ScriptFilter& isScript,
+                           const ScriptDirNode* previous, const QSet<QString>& dirtyPaths)
+{
+    QDir dir(dirPath);
+    if (!dir.exists()) {
+        return ScriptDirNodePtr();
+    }
+
+    QHash<QString, ScriptDirNodePtr> previousChildren;
+    if (previous) {
+        for (const ScriptDirNodePtr& child : previous->children) {
+            previousChildren.insert(child->path, child);
+        }
+    }
+
+    QSharedPointer<ScriptDirNode> node = QSharedPointer<ScriptDirNode>::create();
+    node->path = dir.absolutePath();
+    node->name = dir.dirName();
+
+    const QFileInfoList entries = dir.entryInfoList(QDir::AllEntries | QDir::NoDotAndDotDot, QDir::DirsFirst | QDir::Name);
+    for (const QFileInfo& entry : entries) {
+        if (entry.isDir()) {
+            const QString childPath = entry.absoluteFilePath();
+            const ScriptDirNodePtr old = previousChildren.value(childPath);
+            const ScriptDirNodePtr child = old ? ScriptTreeCache::rescan(old, dirtyPaths, isScript)
+                                               : buildNode(childPath, isScript, nullptr, dirtyPaths);
+            if (child) {
+                node->children.append(child);
+            }
+        } else if (isScript(entry.fileName())) {
+            node->scripts.append(entry.fileName());
+        }
+    }
+
+    node->signature = signatureOf(*node);
+    return node;
+}
+
+} // namespace
+
+ScriptTreeCache::ScriptTreeCache(ScriptFilter isScript, QObject* parent)
+    : QObject(parent)
+    , m_isScript(std::move(isScript))
+{
+    m_debounceTimer.setSingleShot(true);
+    m_debounceTimer.setInterval(kDebounceMs);
+    connect(&m_debounceTimer, &QTimer::timeout, this, &ScriptTreeCache::startScan);
+    connect(&m_fsWatcher, &QFileSystemWatcher::directoryChanged, this, &ScriptTreeCache::onDirectoryChanged);
+    connect(&m_scanWatcher, &QFutureWatcher<ScriptDirNodePtr>::finished, this, &ScriptTreeCache::onScanFinished);
+}
+
+ScriptTreeCache::~ScriptTreeCache()
+{
+    m_scanWatcher.waitForFinished();
+}
+
+void ScriptTreeCache::setRootPath(const QString& rootPath)
+{
+    const QString absolutePath = QDir(rootPath).absolutePath();
+    if (absolutePath == m_rootPath && (m_hasSnapshot || isScanning())) {
+        return;
+    }
+
+    m_rootPath = absolutePath;
+    m_root.reset();
+    m_hasSnapshot = false;
+    m_dirtyPaths.clear();
+    m_watchedAncestor.clear();
+    m_fullScanPending = true;
+    const QStringList watched = m_fsWatcher.directories();
+    if (!watched.isEmpty()) {
+        m_fsWatcher.removePaths(watched);
+    }
+    startScan();
+}
+
+ScriptDirNodePtr ScriptTreeCache::scanTree(const QString& dirPath, const ScriptFilter& isScript)
+{
+    TRACE_SCOPE_DETAIL("io", "ScriptTreeCache::scanTree", dirPath);
+    return buildNode(dirPath, isScript, nullptr, QSet<QString>());
+}
+
+ScriptDirNodePtr ScriptTreeCache::rescan(const ScriptDirNodePtr& node, const QSet<QString>& dirtyPaths,
+                                         const ScriptFilter& isScript)
+{
+    if (!node) {
+        return node;
+    }
+    if (dirtyPaths.contains(node->path)) {
+        return buildNode(node->path, isScript, node.data(), dirtyPaths);
+    }
+    if (!containsPathUnder(dirtyPaths, node->path)) {
+        return node;
+    }
+
+    // Something below changed: copy this level and rebuild the affected children
+    QSharedPointer<ScriptDirNode> copy = QSharedPointer<ScriptDirNode>::create(*node);
+    copy->children.clear();
+    for (const ScriptDirNodePtr& child : node->children) {
+        const ScriptDirNodePtr rebuilt = rescan(child, dirtyPaths, isScript);
+        if (rebuilt) {
+            copy->children.append(rebuilt);
+        }
+    }
+    copy->signature = signatureOf(*copy);
+    return copy;
+}
+
+void ScriptTreeCache::onDirectoryChanged(const QString& path)
+{
+    if (!m_watchedAncestor.isEmpty() && path == m_watchedAncestor) {
+        // Something appeared (or vanished) above a missing root; look for the root again
+        m_fullScanPending = true;
+        m_debounceTimer.start();
+        return;
+    }
+    m_dirtyPaths.insert(path);
+    m_debounceTimer.start();
+}
+
+void ScriptTreeCache::startScan()
+{
+    // onScanFinished() comes back here if more work arrived meanwhile
+    if (isScanning() || m_rootPath.isEmpty()) {
+        return;
+    }
+
+    const ScriptFilter isScript = m_isScript;
+    m_scanRootPath = m_rootPath;
+
+    if (m_fullScanPending || !m_root) {
+        m_fullScanPending = false;
+        m_dirtyPaths.clear();
+        const QString rootPath = m_rootPath;
+        m_scanWatcher.setFuture(QtConcurrent::run([rootPath, isScript]() {
+            return scanTree(rootPath, isScript);
+        }));
+        return;
+    }
+
+    if (m_dirtyPaths.isEmpty()) {
+        return;
+    }
+    const QSet<QString> dirtyPaths = m_dirtyPaths;
+    m_dirtyPaths.clear();
+    const ScriptDirNodePtr base = m_root;
+    m_scanWatcher.setFuture(QtConcurrent::run([base, dirtyPaths, isScript]() {
+        TRACE_SCOPE("io", "ScriptTreeCache::rescan");
+        return rescan(base, dirtyPaths, isScript);
+    }));
+}
+
+void ScriptTreeCache::onScanFinished()
+{
+    if (m_scanRootPath != m_rootPath) {
+        // The root changed while scanning; setRootPath() already asked for a full scan
+        startScan();
+        return;
+    }
+
+    const ScriptDirNodePtr result = m_scanWatcher.result();
+    const bool changed = !m_hasSnapshot || result != m_root;
+    m_root = result;
+    m_hasSnapshot = true;
+    updateWatchedDirectories();
+    if (changed) {
+        emit treeChanged();
+    }
+
+    if (m_fullScanPending || !m_dirtyPaths.isEmpty()) {
+        m_debounceTimer.start();
+    }
+}
+
+void ScriptTreeCache::updateWatchedDirectories()
+{
+    QSet<QString> wanted;
+    QVector<ScriptDirNodePtr> stack;
+    if (m_root) {
+        stack.append(m_root);
+    }
+    while (!stack.isEmpty()) {
+        const ScriptDirNodePtr node = stack.takeLast();
+        wanted.insert(node->path);
+        for (const ScriptDirNodePtr& child : node->children) {
+            stack.append(child);
+        }
+    }
+
+    // A missing root cannot be watched; watch the closest ancestor until it appears
+    m_watchedAncestor.clear();
+    if (!m_root && !m_rootPath.isEmpty()) {
+        m_watchedAncestor = nearestExistingDir(m_rootPath);
+        if (!m_watchedAncestor.isEmpty()) {
+            wanted.insert(m_watchedAncestor);
+        }
+    }
+
+    const QStringList watchedList = m_fsWatcher.directories();
+    const QSet<QString> watched(watchedList.cbegin(), watchedList.cend());
+
+    QStringList toRemove;
+    for (const QString& path : watched) {
+        if (!wanted.contains(path)) {
+            toRemove.append(path);
+        }
+    }
+    QStringList toAdd;
+    for (const QString& path : std::as_const(wanted)) {
+        if (!watched.contains(path)) {
+            toAdd.append(path);
+        }
+    }
+
+    if (!toRemove.isEmpty()) {
+        m_fsWatcher.removePaths(toRemove);
+    }
+    if (!toAdd.isEmpty()) {
+        m_fsWatcher.addPaths(toAdd);
+    }
+}
@@ -0,0 +1,104 @@
+#ifndef SCRIPTTREECACHE_H
+#define SCRIPTTREECACHE_H
+
+#include <QFileSystemWatcher>
+#include <QFutureWatcher>
+#include <QObject>
+#include <QSet>
+#include <QSharedPointer>
+#include <QString>
+#include <QStringList>
+#include <QTimer>
+#include <QVector>
+
+#include <functional>
+
+/**
+ * @brief One directory of the scripts tree (immutable once built)
+ *
+ * signature covers this directory's script names and every descendant, so
+ * two nodes with the same signature produce identical menus.
+ */
+struct ScriptDirNode {
+    QString path;
+    QString name;
+    QStringList scripts;                                    // file names, sorted
+    QVector<QSharedPointer<const ScriptDirNode>> children;  // sorted by name
+    quint64 signature = 0;
+};
+
+using ScriptDirNodePtr = QSharedPointer<const ScriptDirNode>;
+
+/**
+ * @brief Background-scanned, watch-invalidated snapshot of the scripts tree
+ *
+ * The tree is scanned once on a worker thread. Every directory in it is
+ * then watched; changes are collected for a short debounce interval and
+ * only the directories that changed are rescanned, again off the GUI thread.
+ * Unchanged subtrees are shared between snapshots, so consumers can skip
+ * them by comparing signatures. While the root does not exist, its nearest
+ * existing ancestor is watched instead and the root is scanned again when
+ * that ancestor changes, so a root created later is still picked up.
+ */
+class ScriptTreeCache : public QObject
+{
+    Q_OBJECT
+
+public:
+    using ScriptFilter = std::function<bool(const QString& fileName)>;
+
+    ScriptTreeCache(ScriptFilter isScript, QObject* parent = nullptr);
+    ~ScriptTreeCache();
+
+    /**
+     * @brief Scan (or rescan) a new root; ignored if it is already the root
+     */
+    void setRootPath(const QString& rootPath);
+    QString rootPath() const { return m_rootPath; }
+
+    /**
+     * @brief Current snapshot; null until the first scan has finished or if the root is missing
+     */
+    ScriptDirNodePtr root() const { return m_root; }
+
+    bool isScanning() const { return m_scanWatcher.isRunning(); }
+    bool hasSnapshot() const { return m_hasSnapshot; }
+
+    /**
+     * @brief Scan a directory tree synchronously
+     */
+    static ScriptDirNodePtr scanTree(const QString& dirPath, const ScriptFilter& isScript);
+
+    /**
+     * @brief Rebuild only the dirty directories of a snapshot, sharing everything else
+     */
+    static ScriptDirNodePtr rescan(const ScriptDirNodePtr& node, const QSet<QString>& dirtyPaths,
+                                   const ScriptFilter& isScript);
+
+signals:
+    /**
+     * @brief A new snapshot is available
+     */
+    void treeChanged();
+
+private:
+    void onDirectoryChanged(const QString& path);
+    void startScan();
+    void onScanFinished();
+    void updateWatchedDirectories();
+
+    ScriptFilter m_isScript;
+    QString m_rootPath;
+    ScriptDirNodePtr m_root;
+    bool m_hasSnapshot = false;
+
+    QFileSystemWatcher m_fsWatcher;
+    QTimer m_debounceTimer;
+    QSet<QString> m_dirtyPaths;
+    QString m_watchedAncestor;      // watched in place of a missing root
+    bool m_fullScanPending = false;
+    QFutureWatcher<ScriptDirNodePtr> m_scanWatcher;
+    QString m_scanRootPath;
+};
+
+#endif // SCRIPTTREECACHE_H
@@ -0,0 +1,252 @@
+#include "terminallogqueue.h"
+
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QSqlError>
+#include <QVariant>
+
+#include <chrono>
+#include <memory>
+
+namespace {
+const int kDefaultMaxRows = 200;
+const int kDefaultMaxDelayMs = 250;
+const qint64 kSlowCommitMs = 200;
+}
+
+TerminalLogQueue::TerminalLogQueue(const QString& dbPath)
+    : m_dbPath(dbPath),
+      m_connectionName(QString("terminal_log_writer_%1").arg(reinterpret_cast<quintptr>(this))),
+      m_maxRows(kDefaultMaxRows),
+      m_maxDelayMs(kDefaultMaxDelayMs)
+{
+}
+
+TerminalLogQueue::~TerminalLogQueue()
+{
+    stop();
+}
+
+bool TerminalLogQueue::start()
+{
+    if (m_running.load()) {
+        return true;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopRequested = false;
+        m_flushRequested = false;
+    }
+
+    std::promise<bool> started;
+    std::future<bool> result = started.get_future();
+    m_thread = std::thread(&TerminalLogQueue::writerLoop, this, &started);
+
+    if (!result.get()) {
+        m_thread.join();
+        return false;
+    }
+
+    m_running.store(true);
+    return true;
+}
+
+void TerminalLogQueue::stop()
+{
+    if (!m_thread.joinable()) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopRequested = true;
+    }
+    m_wake.notify_one();
+    m_thread.join();
+    m_running.store(false);
+}
+
+bool TerminalLogQueue::enqueue(Row row)
+{
+    if (!m_running.load()) {
+        return false;
+    }
+
+    bool wakeWriter = false;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_stopRequested) {
+            return false;
+        }
+        m_pending.append(std::move(row));
+        ++m_enqueuedSeq;
+        wakeWriter = m_pending.size() == 1 || m_pending.size() >= m_maxRows.load();
+    }
+
+    if (wakeWriter) {
+        m_wake.notify_one();
+    }
+    return true;
+}
+
+bool TerminalLogQueue::flush()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if (!m_running.load() || m_committedSeq >= m_enqueuedSeq) {
+        return m_lastBatchOk;
+    }
+
+    const quint64 target = m_enqueuedSeq;
+    m_flushRequested = true;
+    m_wake.notify_one();
+    m_committed.wait(lock, [this, target] {
+        return m_committedSeq >= target || !m_running.load();
+    });
+    return m_lastBatchOk;
+}
+
+void TerminalLogQueue::setBatchPolicy(int maxRows, int maxDelayMs)
+{
+    m_maxRows.store(qMax(1, maxRows));
+    m_maxDelayMs.store(qMax(1, maxDelayMs));
+    m_wake.notify_one();
+}
+
+int TerminalLogQueue::queueDepth() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_pending.size();
+}
+
+void TerminalLogQueue::writerLoop(std::promise<bool>* started)
+{
+    {
+        QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", m_connectionName);
+        db.setDatabaseName(m_dbPath);
+
+        std::unique_ptr<QSqlQuery> insert;
+        bool ready = db.open();
+        if (ready) {
+            // journal_mode is persistent and set by DatabaseManager; these are per connection
+            QSqlQuery pragma(db);
+            pragma.exec("PRAGMA synchronous=NORMAL");
+            pragma.exec("PRAGMA busy_timeout=5000");
+            pragma.finish();
+
+            insert.reset(new QSqlQuery(db));
+            ready = insert->prepare("INSERT INTO terminal_logs (tab_name, year, month, week, timestamp, message) "
+                                    "VALUES (?, ?, ?, ?, ?, ?)");
+            if (!ready) {
+                qDebug() << "Terminal log writer failed to prepare insert:" << insert->lastError().text();
+            }
+        } else {
+            qDebug() << "Terminal log writer failed to open database:" << db.lastError().text();
+        }
+
+        started->set_value(ready);
+        if (ready) {
+            runBatches(db, *insert);
+        }
+
+        insert.reset();
+        db.close();
+    }
+    QSqlDatabase::removeDatabase(m_connectionName);
+
+    // Release any flush() callers still waiting
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_running.store(false);
+    m_committed.notify_all();
+}
+
+void TerminalLogQueue::runBatches(QSqlDatabase& db, QSqlQuery& insert)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    for (;;) {
+        // Sleep until there is work, then give the batch up to maxDelay to fill
+        m_wake.wait(lock, [this] {
+            return m_stopRequested || m_flushRequested || !m_pending.isEmpty();
+        });
+        if (!m_stopRequested && !m_flushRequested) {
+            m_wake.wait_for(lock, std::chrono::milliseconds(m_maxDelayMs.load()), [this] {
+                return m_stopRequested || m_flushRequested || m_pending.size() >= m_maxRows.load();
+            });
+        }
+
+        QVector<Row> batch;
+        batch.swap(m_pending);
+        const quint64 seq = m_enqueuedSeq;
+        m_flushRequested = false;
+
+        bool ok = true;
+        if (!batch.isEmpty()) {
+            lock.unlock();
+            ok = commitBatch(db, insert, batch);
+            lock.lock();
+        }
+
+        m_committedSeq = seq;
+        m_lastBatchOk = ok;
+        m_committed.notify_all();
+
+        if (m_stopRequested && m_pending.isEmpty()) {
+            return;
+        }
+    }
+}
+
+bool TerminalLogQueue::commitBatch(QSqlDatabase& db, QSqlQuery& insert, const QVector<Row>& rows)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    QVariantList tabNames, years, months, weeks, timestamps, messages;
+    tabNames.reserve(rows.size());
+    years.reserve(rows.size());
+    months.reserve(rows.size());
+    weeks.reserve(rows.size());
+    timestamps.reserve(rows.size());
+    messages.reserve(rows.size());
+    for (const Row& row : rows) {
+        tabNames.append(row.tabName);
+        years.append(row.year);
+        months.append(row.month);
+        weeks.append(row.week);
+        timestamps.append(row.timestamp);
+        messages.append(row.message);
+    }
+
+    insert.addBindValue(tabNames);
+    insert.addBindValue(years);
+    insert.addBindValue(months);
+    insert.addBindValue(weeks);
+    insert.addBindValue(timestamps);
+    insert.addBindValue(messages);
+
+    const bool inTransaction = db.transaction();
+    bool ok = insert.execBatch();
+    if (inTransaction) {
+        if (ok) {
+            ok = db.commit();
+        } else {
+            db.rollback();
+        }
+    }
+
+    const qint64 elapsed = timer.elapsed();
+    m_lastCommitMs.store(elapsed);
+
+    if (!ok) {
+        m_failedRows.fetch_add(static_cast<quint64>(rows.size()));
+        qDebug() << "Terminal log batch of" << rows.size() << "rows failed:" << insert.lastError().text();
+        return false;
+    }
+
+    m_committedRows.fetch_add(static_cast<quint64>(rows.size()));
+    if (elapsed >= kSlowCommitMs) {
+        qDebug() << "Slow terminal log commit:" << rows.size() << "rows in" << elapsed
+                 << "ms, queue depth" << queueDepth();
+    }
+    return true;
+}
@@ -0,0 +1,105 @@
+#ifndef TERMINALLOGQUEUE_H
+#define TERMINALLOGQUEUE_H
+
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QString>
+#include <QVector>
+
+#include <atomic>
+#include <condition_variable>
+#include <future>
+#include <mutex>
+#include <thread>
+
+/**
+ * @brief Background group-commit writer for the terminal_logs table
+ *
+ * Rows are appended from any thread and written by a dedicated thread with
+ * its own SQLite connection. Pending rows are committed in one transaction
+ * once the batch size is reached or the flush interval elapses, so script
+ * output no longer costs one synced transaction per line on the GUI thread.
+ */
+class TerminalLogQueue
+{
+public:
+    struct Row {
+        QString tabName;
+        QString year;
+        QString month;
+        QString week;
+        QString timestamp;
+        QString message;
+    };
+
+    explicit TerminalLogQueue(const QString& dbPath);
+    ~TerminalLogQueue();
+
+    TerminalLogQueue(const TerminalLogQueue&) = delete;
+    TerminalLogQueue& operator=(const TerminalLogQueue&) = delete;
+
+    /**
+     * @brief Open the writer connection and start the background thread
+     * @return True if the writer is running
+     */
+    bool start();
+
+    /**
+     * @brief Commit all pending rows and stop the background thread
+     */
+    void stop();
+
+    bool isRunning() const { return m_running.load(); }
+
+    /**
+     * @brief Queue a row for the next group commit
+     * @return False if the writer is not running (the caller should insert directly)
+     */
+    bool enqueue(Row row);
+
+    /**
+     * @brief Block until every row queued so far has been committed
+     * @return False if some of those rows could not be written
+     */
+    bool flush();
+
+    /**
+     * @brief Set when a batch is committed
+     * @param maxRows Commit as soon as this many rows are pending
+     * @param maxDelayMs Commit pending rows at least this often
+     */
+    void setBatchPolicy(int maxRows, int maxDelayMs);
+
+    int queueDepth() const;
+    qint64 lastCommitLatencyMs() const { return m_lastCommitMs.load(); }
+    quint64 committedRowCount() const { return m_committedRows.load(); }
+    quint64 failedRowCount() const { return m_failedRows.load(); }
+
+private:
+    void writerLoop(std::promise<bool>* started);
+    void runBatches(QSqlDatabase& db, QSqlQuery& insert);
+    bool commitBatch(QSqlDatabase& db, QSqlQuery& insert, const QVector<Row>& rows);
+
+    QString m_dbPath;
+    QString m_connectionName;
+
+    std::thread m_thread;
+    mutable std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::condition_variable m_committed;
+    QVector<Row> m_pending;
+    bool m_stopRequested = false;
+    bool m_flushRequested = false;
+    quint64 m_enqueuedSeq = 0;
+    quint64 m_committedSeq = 0;
+    bool m_lastBatchOk = true;
+
+    std::atomic<bool> m_running { false };
+    std::atomic<int> m_maxRows;
+    std::atomic<int> m_maxDelayMs;
+    std::atomic<qint64> m_lastCommitMs { 0 };
+    std::atomic<quint64> m_committedRows { 0 };
+    std::atomic<quint64> m_failedRows { 0 };
+};
+
+#endif // TERMINALLOGQUEUE_H
@@ -1,11 +1,23 @@
 #include "terminaloutputhelper.h"
 
 #include <QPalette>
+#include <QPointer>
+#include <QStringList>
 #include <QTextCharFormat>
 #include <QTextCursor>
 #include <QTextEdit>
 
 namespace {
+// Lines held back by open BatchScopes, in append order; consecutive lines
+// for the same terminal share one entry
+struct PendingBatch {
+    QPointer<QTextEdit> terminal;
+    QStringList htmlLines;
+};
+
+int s_batchDepth = 0;
+QList<PendingBatch> s_pendingBatches;
+
 QString severityToken(TerminalSeverity severity)
 {
     switch (severity) {
@@ -119,20 +131,60 @@ void TerminalOutputHelper::append(QTextEdit* terminal,
         return;
     }
 
+    const QString html = formatHtmlLine(message, severity);
+    if (s_batchDepth > 0) {
+        if (s_pendingBatches.isEmpty() || s_pendingBatches.last().terminal != terminal) {
+            s_pendingBatches.append(PendingBatch{ terminal, QStringList() });
+        }
+        s_pendingBatches.last().htmlLines.append(html);
+        return;
+    }
+
+    insertHtml(terminal, QStringList{ html });
+}
+
+void TerminalOutputHelper::insertHtml(QTextEdit* terminal, const QStringList& htmlLines)
+{
     QTextCharFormat neutralFormat = terminal->currentCharFormat();
     neutralFormat.clearForeground();
     neutralFormat.setForeground(terminal->palette().color(QPalette::Text));
 
-    // Prevent severity color state from carrying into subsequent plain/info lines.
-    terminal->setCurrentCharFormat(neutralFormat);
-    terminal->append(formatHtmlLine(message, severity));
+    // One edit block: the document is laid out once for the whole batch
+    QTextCursor block(terminal->document());
+    block.beginEditBlock();
+    for (const QString& html : htmlLines) {
+        // Prevent severity color state from carrying into subsequent plain/info lines.
+        terminal->setCurrentCharFormat(neutralFormat);
+        terminal->append(html);
+    }
     terminal->setCurrentCharFormat(neutralFormat);
+    block.endEditBlock();
 
     QTextCursor cursor = terminal->textCursor();
     cursor.movePosition(QTextCursor::End);
     terminal->setTextCursor(cursor);
 }
 
+TerminalOutputHelper::BatchScope::BatchScope()
+{
+    ++s_batchDepth;
+}
+
+TerminalOutputHelper::BatchScope::~BatchScope()
+{
+    if (--s_batchDepth > 0) {
+        return;
+    }
+
+    const QList<PendingBatch> batches = s_pendingBatches;
+    s_pendingBatches.clear();
+    for (const PendingBatch& batch : batches) {
+        if (batch.terminal) {
+            insertHtml(batch.terminal, batch.htmlLines);
+        }
+    }
+}
+
 QString TerminalOutputHelper::severityPrefix(TerminalSeverity severity)
 {
     switch (severity) {
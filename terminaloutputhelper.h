@@ -3,6 +3,7 @@
 
 #include <QDateTime>
 #include <QString>
+#include <QStringList>
 
 class QTextEdit;
 
@@ -24,7 +25,25 @@ public:
                        const QString& message,
                        TerminalSeverity severity = TerminalSeverity::Info);
 
+    /**
+     * @brief Collects append() calls made while it is alive into one document update per terminal
+     *
+     * Scopes nest; the outermost one writes the collected lines when it ends.
+     * GUI thread only.
+     */
+    class BatchScope
+    {
+    public:
+        BatchScope();
+        ~BatchScope();
+
+    private:
+        BatchScope(const BatchScope&) = delete;
+        BatchScope& operator=(const BatchScope&) = delete;
+    };
+
 private:
+    static void insertHtml(QTextEdit* terminal, const QStringList& htmlLines);
     static QString severityPrefix(TerminalSeverity severity);
     static QString severityClass(TerminalSeverity severity);
 };
@@ -1709,11 +1709,13 @@ void TMBrokenController::autoSaveAndCloseCurrentJob()
             // Move files to home folder when closing the job
             outputToTerminal("Moving files to HOME directory...", Info);
             if (m_fileManager) {
-                if (m_fileManager->moveFilesToHomeDirectory(currentYear, currentMonth)) {
-                    outputToTerminal("Files moved successfully to HOME directory", Success);
-                } else {
-                    outputToTerminal("Warning: Some files may not have been moved properly", Warning);
-                }
+                m_fileManager->moveFilesToHomeDirectory(currentYear, currentMonth, this, [this](bool ok) {
+                    if (ok) {
+                        outputToTerminal("Files moved successfully to HOME directory", Success);
+                    } else {
+                        outputToTerminal("Warning: Some files may not have been moved properly", Warning);
+                    }
+                });
             }
             
             // Clear current job state
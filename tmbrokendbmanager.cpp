@@ -1,6 +1,7 @@
 #include "tmbrokendbmanager.h"
 #include "logger.h"
 #include "DatabaseManager.h"
+#include "tracer.h"
 #include <QSqlDatabase>
 #include <QSqlQuery>
 #include <QSqlError>
@@ -46,6 +47,7 @@ TMBrokenDBManager::~TMBrokenDBManager()
 
 bool TMBrokenDBManager::initializeDatabase()
 {
+    TRACE_FUNCTION("db");
     if (m_initialized) {
         return true;
     }
@@ -62,20 +64,35 @@ bool TMBrokenDBManager::initializeDatabase()
     // Use the shared database connection instead of opening a local file
     m_database = m_dbManager->getDatabase();
 
-    // Tables must still be created if missing (only once)
-    if (!createTables()) {
-        m_lastError = "Failed to create database tables";
-        Logger::instance().error("TMBrokenDBManager: " + m_lastError);
-        return false;
-    }
-
-    if (!createIndexes()) {
-        m_lastError = "Failed to create database indexes";
+    // Schema changes run once per database; later launches skip straight past them
+    m_lastError.clear();
+    const bool migrated = m_dbManager->applyMigrations("tm_broken", {
+        {1, "Job data and log tables, year/month log columns, indexes", [this]() {
+            if (!createTables()) {
+                m_lastError = "Failed to create database tables";
+                return false;
+            }
+            if (!createIndexes()) {
+                m_lastError = "Failed to create database indexes";
+                return false;
+            }
+            return true;
+        }},
+        {2, "Rebuild job data table keyed UNIQUE(job_number, year, month) if it predates that key", [this]() {
+            return rebuildJobDataTable();
+        }}
+    });
+    if (!migrated) {
+        if (m_lastError.isEmpty()) {
+            m_lastError = "Failed to apply schema migrations";
+        }
         Logger::instance().error("TMBrokenDBManager: " + m_lastError);
         return false;
     }
 
     m_initialized = true;
+    // Anything loaded before the database was ready is stale
+    m_jobIndex.invalidate();
     Logger::instance().info("TMBrokenDBManager: Database initialized using shared goji.db");
     return true;
 }
@@ -188,6 +205,91 @@ bool TMBrokenDBManager::createIndexes()
     return true;
 }
 
+bool TMBrokenDBManager::rebuildJobDataTable()
+{
+    QSqlDatabase db = m_dbManager->getDatabase();
+
+    QSqlQuery checkQuery(db);
+    if (!checkQuery.exec(QString("SELECT sql FROM sqlite_master WHERE type='table' AND name='%1'").arg(JOB_DATA_TABLE))
+        || !checkQuery.next()) {
+        return true;
+    }
+
+    // Older databases keyed job data on (year, month) only, so a second job in a month overwrote the first
+    const QString createSql = checkQuery.value(0).toString();
+    if (createSql.contains("UNIQUE(job_number, year, month)") || createSql.contains("UNIQUE(job_number,year,month)")
+        || !(createSql.contains("UNIQUE(year, month)") || createSql.contains("UNIQUE(year,month)"))) {
+        return true;
+    }
+    checkQuery.finish();
+
+    Logger::instance().info("TMBrokenDBManager: Rebuilding job data table with UNIQUE(job_number, year, month)");
+
+    // Savepoint rather than a transaction: this runs inside the schema migration transaction
+    QSqlQuery savepoint(db);
+    if (!savepoint.exec("SAVEPOINT tm_broken_job_data_rebuild")) {
+        m_lastError = "Failed to start rebuild savepoint: " + savepoint.lastError().text();
+        Logger::instance().error("TMBrokenDBManager: " + m_lastError);
+        return false;
+    }
+
+    const QStringList steps = {
+        QString("ALTER TABLE %1 RENAME TO %1_old").arg(JOB_DATA_TABLE),
+        QString(
+            "CREATE TABLE %1 ("
+            "id INTEGER PRIMARY KEY AUTOINCREMENT, "
+            "job_number VARCHAR(50) NOT NULL, "
+            "year VARCHAR(4) NOT NULL, "
+            "month VARCHAR(2) NOT NULL, "
+            "postage TEXT, "
+            "count TEXT, "
+            "job_data_locked INTEGER DEFAULT 0, "
+            "postage_data_locked INTEGER DEFAULT 0, "
+            "html_display_state TEXT, "
+            "last_executed_script TEXT, "
+            "created_at DATETIME DEFAULT CURRENT_TIMESTAMP, "
+            "updated_at DATETIME DEFAULT CURRENT_TIMESTAMP, "
+            "UNIQUE(job_number, year, month)"
+            ")"
+        ).arg(JOB_DATA_TABLE),
+        QString(
+            "INSERT INTO %1 (job_number, year, month, postage, count, "
+            "job_data_locked, postage_data_locked, html_display_state, "
+            "last_executed_script, created_at, updated_at) "
+            "SELECT job_number, year, month, postage, count, "
+            "job_data_locked, postage_data_locked, html_display_state, "
+            "last_executed_script, created_at, updated_at "
+            "FROM %1_old"
+        ).arg(JOB_DATA_TABLE),
+        QString("DROP TABLE %1_old").arg(JOB_DATA_TABLE),
+        // The old table's indexes went with it
+        QString("CREATE INDEX IF NOT EXISTS idx_%1_year_month ON %1(year, month)").arg(JOB_DATA_TABLE),
+        QString("CREATE INDEX IF NOT EXISTS idx_%1_job_number ON %1(job_number)").arg(JOB_DATA_TABLE)
+    };
+
+    QSqlQuery query(db);
+    for (const QString& sql : steps) {
+        if (!query.exec(sql)) {
+            m_lastError = "Failed to rebuild job data table: " + query.lastError().text();
+            savepoint.exec("ROLLBACK TO tm_broken_job_data_rebuild");
+            savepoint.exec("RELEASE tm_broken_job_data_rebuild");
+            Logger::instance().error("TMBrokenDBManager: " + m_lastError);
+            return false;
+        }
+    }
+
+    if (!savepoint.exec("RELEASE tm_broken_job_data_rebuild")) {
+        m_lastError = "Failed to release rebuild savepoint: " + savepoint.lastError().text();
+        savepoint.exec("ROLLBACK TO tm_broken_job_data_rebuild");
+        savepoint.exec("RELEASE tm_broken_job_data_rebuild");
+        Logger::instance().error("TMBrokenDBManager: " + m_lastError);
+        return false;
+    }
+
+    Logger::instance().info("TMBrokenDBManager: Job data table rebuilt with UNIQUE(job_number, year, month)");
+    return true;
+}
+
 bool TMBrokenDBManager::saveJob(const QString& jobNumber, const QString& year, const QString& month)
 {
     if (!m_initialized) {
@@ -238,6 +340,7 @@ bool TMBrokenDBManager::saveJob(const QString& jobNumber, const QString& year, c
     }
 
     Logger::instance().info(QString("TMBroken job saved: %1 for %2/%3").arg(jobNumber, year, month));
+    m_jobIndex.upsert({{"job_number", jobNumber}, {"year", year}, {"month", month}});
     return true;
 }
 
@@ -310,6 +413,7 @@ bool TMBrokenDBManager::saveJobData(const QVariantMap& jobData)
         }
     }
 
+    m_jobIndex.upsert({{"job_number", jobNumber}, {"year", year}, {"month", month}});
     return true;
 }
 
@@ -367,6 +471,7 @@ bool TMBrokenDBManager::deleteJobData(const QString& year, const QString& month)
         return false;
     }
 
+    m_jobIndex.remove({{"year", year}, {"month", month}});
     return true;
 }
 
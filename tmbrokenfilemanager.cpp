@@ -1,4 +1,6 @@
 #include "tmbrokenfilemanager.h"
+#include "filetransfer.h"
+#include "hashservice.h"
 #include "logger.h"
 #include <QDir>
 #include <QFileInfo>
@@ -179,37 +181,49 @@ bool TMBrokenFileManager::copyFilesToJobDirectory(const QString& year, const QSt
     return true;
 }
 
-bool TMBrokenFileManager::moveFilesToHomeDirectory(const QString& year, const QString& month)
+void TMBrokenFileManager::moveFilesToHomeDirectory(const QString& year, const QString& month, QObject* context,
+                                                     std::function<void(bool ok)> onFinished)
 {
     const QString jobOutputDir = getJobOutputDirectory(year, month);
 
     if (!QDir(jobOutputDir).exists()) {
         Logger::instance().warning("Job output directory does not exist: " + jobOutputDir);
-        return true; // Nothing to move
+        if (onFinished) {
+            onFinished(true); // Nothing to move
+        }
+        return;
     }
 
     if (!ensureDirectoryExists(m_homeDirectory)) {
         Logger::instance().error("Failed to create home directory: " + m_homeDirectory);
-        return false;
-    }
-
-    QDir outputDir(jobOutputDir);
-    const QStringList files = outputDir.entryList(QDir::Files);
-
-    // Use const iterators to avoid QList/QStringList detachment
-    for (auto it = files.cbegin(); it != files.cend(); ++it) {
-        const QString& fileName = *it;
-        const QString sourcePath = jobOutputDir + "/" + fileName;
-        const QString destPath   = m_homeDirectory + "/" + fileName;
-
-        if (!moveFileWithBackup(sourcePath, destPath)) {
-            Logger::instance().error("Failed to move file from " + sourcePath + " to " + destPath);
-            return false;
+        if (onFinished) {
+            onFinished(false);
         }
+        return;
     }
 
-    Logger::instance().info("Moved files to HOME directory for " + year + "-" + month);
-    return true;
+    // Replaced HOME files are kept as timestamped backups, as moveFileWithBackup() did
+    const QString homeDirectory = m_homeDirectory;
+    FileTransferQueue::instance()->enqueue("Moving files to HOME",
+        [this, jobOutputDir, homeDirectory]() {
+            FileTransferPlan plan;
+            plan.mode = FileTransferPlan::Mode::Move;
+            plan.backupPathFor = [this](const QString& destination) {
+                return generateBackupFileName(destination);
+            };
+            plan.addFolder(jobOutputDir, homeDirectory);
+            return plan;
+        },
+        context, [year, month, onFinished](const FileTransferResult& result) {
+            if (!result.ok) {
+                Logger::instance().error("Failed to move files to HOME directory: " + result.summary("Moved"));
+            } else {
+                Logger::instance().info(result.summary("Moved") + " to HOME directory for " + year + "-" + month);
+            }
+            if (onFinished) {
+                onFinished(result.ok);
+            }
+        });
 }
 
 bool TMBrokenFileManager::archiveJobFiles(const QString& year, const QString& month)
@@ -391,14 +405,8 @@ QFileInfo TMBrokenFileManager::getFileInfo(const QString& filePath) const
 
 QString TMBrokenFileManager::getFileChecksum(const QString& filePath) const
 {
-    QFile file(filePath);
-    if (!file.open(QIODevice::ReadOnly)) {
-        return QString();
-    }
-
-    QCryptographicHash hash(QCryptographicHash::Sha256);
-    hash.addData(&file);
-    return hash.result().toHex();
+    // Empty on failure; unchanged files are answered from the digest cache
+    return HashService::instance().hashFile(filePath).hex;
 }
 
 qint64 TMBrokenFileManager::getDirectorySize(const QString& directoryPath) const
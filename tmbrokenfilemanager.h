@@ -13,6 +13,8 @@
 #include <QHash>
 #include <QMap>
 
+#include <functional>
+
 class TMBrokenFileManager : public QObject, public BaseFileSystemManager
 {
     Q_OBJECT
@@ -42,7 +44,12 @@ public:
     // File operations
     bool createJobStructure(const QString& year, const QString& month);
     bool copyFilesToJobDirectory(const QString& year, const QString& month);
-    bool moveFilesToHomeDirectory(const QString& year, const QString& month);
+    /**
+     * @brief Queue the move of the job's output files to HOME on FileTransferQueue
+     * @param onFinished Called on the GUI thread with the outcome; dropped if context is destroyed first
+     */
+    void moveFilesToHomeDirectory(const QString& year, const QString& month, QObject* context,
+                                  std::function<void(bool ok)> onFinished);
     bool archiveJobFiles(const QString& year, const QString& month);
     bool cleanupJobDirectory(const QString& year, const QString& month);
     
@@ -1,5 +1,6 @@
 #include "tmcadbmanager.h"
 #include "logger.h"
+#include "tracer.h"
 
 #include <QSqlQuery>
 #include <QSqlError>
@@ -25,16 +26,22 @@ TMCADBManager::TMCADBManager(QObject *parent)
 
 bool TMCADBManager::initializeTables()
 {
+    TRACE_FUNCTION("db");
     if (!m_dbManager || !m_dbManager->isInitialized()) {
         Logger::instance().error("Database manager not initialized for TMCA");
         return false;
     }
 
-    bool success = createTables();
+    bool success = m_dbManager->applyMigrations("tm_ca", {
+        {1, "Job and log tables, job key UNIQUE(job_number, year, month), legacy rows preserved", [this]() { return createTables(); }}
+    });
     if (!success) {
         return false;
     }
 
+    // Anything loaded before the database was ready is stale
+    m_jobIndex.invalidate();
+
     if (m_trackerModel) {
         delete m_trackerModel;
         m_trackerModel = nullptr;
@@ -114,12 +121,13 @@ bool TMCADBManager::createTables()
             if (hasOldUnique && !hasNewUnique) {
                 Logger::instance().info("TMCA: migrating tm_ca_jobs to UNIQUE(job_number, year, month)");
 
+                // Savepoint rather than a transaction: this runs inside the schema migration transaction
                 QSqlDatabase db = m_dbManager->getDatabase();
-                if (!db.transaction()) {
-                    Logger::instance().error("TMCA: schema migration — could not begin transaction: " +
-                                             db.lastError().text());
+                QSqlQuery mig(db);
+                if (!mig.exec("SAVEPOINT tm_ca_jobs_rebuild")) {
+                    Logger::instance().error("TMCA: schema migration — could not begin savepoint: " +
+                                             mig.lastError().text());
                 } else {
-                    QSqlQuery mig(db);
 
                     // Step 0: Drop any leftover temp table from a previous interrupted migration
                     mig.exec("DROP TABLE IF EXISTS tm_ca_jobs_new");
@@ -178,12 +186,13 @@ bool TMCADBManager::createTables()
                     if (ok) ok = mig.exec("ALTER TABLE tm_ca_jobs_new RENAME TO tm_ca_jobs");
 
                     if (ok) {
-                        db.commit();
+                        mig.exec("RELEASE tm_ca_jobs_rebuild");
                         Logger::instance().info("TMCA: schema migration completed successfully");
                     } else {
-                        db.rollback();
-                        Logger::instance().error("TMCA: schema migration failed — rolled back: " +
-                                                 mig.lastError().text());
+                        const QString error = mig.lastError().text();
+                        mig.exec("ROLLBACK TO tm_ca_jobs_rebuild");
+                        mig.exec("RELEASE tm_ca_jobs_rebuild");
+                        Logger::instance().error("TMCA: schema migration failed — rolled back: " + error);
                     }
                 }
             }
@@ -246,6 +255,7 @@ bool TMCADBManager::saveJob(const QString& jobNumber, const QString& year, const
     }
 
     Logger::instance().info(QString("TMCA job saved: %1 for %2/%3").arg(jobNumber, year, month));
+    m_jobIndex.upsert({{"job_number", jobNumber}, {"year", year}, {"month", month}});
     return true;
 }
 
@@ -307,6 +317,8 @@ bool TMCADBManager::deleteJob(const QString& year, const QString& month)
     if (!success) {
         Logger::instance().error(QString("Failed to delete TMCA job for %1/%2: %3")
                                  .arg(year, month, query.lastError().text()));
+    } else {
+        m_jobIndex.remove({{"year", year}, {"month", month}});
     }
     return success;
 }
@@ -429,6 +441,7 @@ bool TMCADBManager::saveJobState(const QString& jobNumber, const QString& year,
                                      .arg(jobNumber, year, month, query.lastError().text()));
             return false;
         }
+        m_jobIndex.upsert({{"job_number", jobNumber}, {"year", year}, {"month", month}});
     }
 
     return true;
@@ -9,6 +9,8 @@
 #include <QMap>
 #include <QVariant>
 
+#include "jobindex.h"
+
 /**
  * @brief Database manager for TM CA (CA EDR/BA)
  *
@@ -36,6 +38,7 @@ public:
     bool deleteJob(const QString& year, const QString& month);
     bool jobExists(const QString& year, const QString& month);
     QList<QMap<QString, QString>> getAllJobs();
+    JobIndex& jobIndex() { return m_jobIndex; }   // cached getAllJobs() for the Open Job menu
 
     // Job state operations (UI persistence) - keyed by job_number + year + month
     bool saveJobState(const QString& jobNumber, const QString& year, const QString& month,
@@ -82,6 +85,8 @@ private:
     bool createTables();
 
     const QString TAB_NAME = "TM_CA";
+
+    JobIndex m_jobIndex { {"year", "month", "job_number"}, [this]() { return getAllJobs(); } };
 };
 
 #endif // TMCADBMANGER_H
@@ -2,6 +2,7 @@
 #include "logger.h"
 #include "databasemanager.h"
 #include "fileutils.h"
+#include "tracer.h"
 
 #include <QSqlQuery>
 #include <QSqlError>
@@ -51,8 +52,17 @@ TMFarmDBManager::TMFarmDBManager(QObject *parent)
         m_db = dbm->getDatabase();
     }
 
-    m_initialized = ensureTables();
+    // Versioned only on the shared database; the local fallback has no schema_migrations table
+    if (dbm && dbm->isInitialized()) {
+        m_initialized = dbm->applyMigrations("tm_farm", {
+            {1, "Job, state and log tables", [this]() { return ensureTables(); }}
+        });
+    } else {
+        m_initialized = ensureTables();
+    }
     if (m_initialized) {
+        // Anything loaded before the database was ready is stale
+        m_jobIndex.invalidate();
         Logger::instance().info("TM FARMWORKERS database initialized");
     } else {
         Logger::instance().error("TM FARMWORKERS database failed to initialize");
@@ -73,6 +83,7 @@ static bool execQuery(QSqlQuery& q, const QString& sql)
 
 bool TMFarmDBManager::ensureTables()
 {
+    TRACE_FUNCTION("db");
     QSqlQuery q(m_db);
     bool ok = true;
 
@@ -135,6 +146,7 @@ bool TMFarmDBManager::saveJob(const QString& jobNumber, const QString& year, con
         return false;
     }
     Logger::instance().info(QString("Saved FARMWORKERS job %1 for %2/%3").arg(jobNumber, year, quarter));
+    m_jobIndex.upsert({{"job_number", jobNumber}, {"year", year}, {"quarter", quarter}});
     return true;
 }
 
@@ -307,6 +319,9 @@ bool TMFarmDBManager::updateLogJobNumber(const QString& oldJobNumber, const QStr
         Logger::instance().error("updateLogJobNumber (job table) failed: " + q2.lastError().text());
         return false;
     }
+    if (q2.numRowsAffected() != 0) {
+        m_jobIndex.invalidate();
+    }
     return true;
 }
 
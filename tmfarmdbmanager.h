@@ -8,6 +8,8 @@
 #include <QMap>
 #include <QString>
 
+#include "jobindex.h"
+
 class TMFarmDBManager : public QObject
 {
     Q_OBJECT
@@ -53,10 +55,13 @@ public:
 
     // Open Job menu helper
     QList<QMap<QString, QString>> getAllJobs() const;
+    JobIndex& jobIndex() { return m_jobIndex; }   // cached getAllJobs() for the Open Job menu
 
 private:
     QSqlDatabase m_db;
     bool m_initialized{false};
+
+    JobIndex m_jobIndex { {"year", "quarter"}, [this]() { return getAllJobs(); } };
 };
 
 #endif // TMFARMDBMANAGER_H
@@ -1,5 +1,6 @@
 #include "tmflercontroller.h"
 #include "logger.h"
+#include "filetransfer.h"
 #include "naslinkdialog.h"
 #include "dropwindow.h"
 #include "dropbindinghelper.h"
@@ -71,7 +72,8 @@ TMFLERController::TMFLERController(QObject *parent)
     , m_postageDataLocked(false)
     , m_currentHtmlState(UninitializedState)
     , m_capturingNASPath(false)
-    , m_waitingForEmailConfirmation(false)
+    , m_nasPathEventSeen(false)
+    , m_emailPauseRequested(false)
     , m_emailDialog(nullptr)
     , m_trackerModel(nullptr)
     , m_lastYear(-1)
@@ -145,6 +147,10 @@ void TMFLERController::connectSignals()
             this,
             [this](const QString& output) { onScriptOutput(output); },
             [this](int exitCode, QProcess::ExitStatus exitStatus) { onScriptFinished(exitCode, exitStatus); });
+
+        // 02 FINAL PROCESS reports its DATA folder and the email pause as events
+        connect(m_scriptRunner, &ScriptRunner::scriptFileProduced, this, &TMFLERController::onScriptFileProduced);
+        connect(m_scriptRunner, &ScriptRunner::scriptEvent, this, &TMFLERController::onScriptEvent);
     }
 }
 
@@ -154,7 +160,7 @@ void TMFLERController::setupInitialState()
     m_jobDataLocked = false;
     m_postageDataLocked = false;
     m_currentHtmlState = UninitializedState;
-    m_waitingForEmailConfirmation = false;
+    m_emailPauseRequested = false;
 
     // Update UI states
     updateLockStates();
@@ -317,6 +323,11 @@ void TMFLERController::setDropWindow(DropWindow* dropWindow)
     }
 }
 
+void TMFLERController::setScriptProgressBar(QProgressBar* progressBar)
+{
+    ScriptRunnerBindingHelper::bindProgressBar(m_scriptRunner, progressBar);
+}
+
 // Public getters
 QString TMFLERController::getJobNumber() const
 {
@@ -675,8 +686,7 @@ void TMFLERController::executeScript(const QString& scriptName)
     }
 
     m_lastExecutedScript = scriptName;
-    m_capturedNASPath.clear();
-    m_capturingNASPath = false;
+    clearScriptCapture();
 
     outputToTerminal(QString("Executing script: %1").arg(scriptName), Info);
     outputToTerminal(QString("Script path: %1").arg(scriptPath), Info);
@@ -704,47 +714,60 @@ void TMFLERController::onScriptOutput(const QString &output)
     // Always log script output
     outputToTerminal(output, Info);
 
-    // 1) NAS path capture
-    if (output.trimmed() == "=== NAS_FOLDER_PATH ===") {
+    // Stdout markers are the fallback for runs without the event channel
+    const QString line = output.trimmed();
+    if (line == "=== NAS_FOLDER_PATH ===") {
         m_capturingNASPath = true;
-        m_capturedNASPath.clear();
         return;
     }
-    if (output.trimmed() == "=== END_NAS_FOLDER_PATH ===") {
+    if (line == "=== END_NAS_FOLDER_PATH ===") {
         m_capturingNASPath = false;
-        if (!m_capturedNASPath.isEmpty()) {
+        if (!m_nasPathEventSeen && !m_capturedNASPath.isEmpty()) {
             outputToTerminal("Captured NAS folder path: " + m_capturedNASPath, Info);
         }
         return;
     }
     if (m_capturingNASPath) {
-        const QString line = output.trimmed();
-        if (!line.isEmpty())
+        if (!line.isEmpty() && !m_nasPathEventSeen)
             m_capturedNASPath = line;
         return;
     }
 
-    // 2) HEALTHY-style pause marker
-    if (output.contains("=== PAUSE_FOR_EMAIL ===")) {
-        outputToTerminal("Detected PAUSE_FOR_EMAIL. Opening FL ER email dialog...", Info);
-
-        QString nasPath = m_capturedNASPath;
-        if (nasPath.isEmpty() && m_fileManager) {
-            nasPath = m_fileManager->getDataPath(); // fallback
-        }
-        const QString jobNumber = m_jobNumberBox ? m_jobNumberBox->text().trimmed() : QString();
-
-        showEmailDialog(nasPath, jobNumber);
+    if (line.contains("=== PAUSE_FOR_EMAIL ===")) {
+        m_emailPauseRequested = true;
         return;
     }
 
-    // 3) Resume notification
-    if (output.contains("=== RESUME_PROCESSING ===")) {
+    if (line.contains("=== RESUME_PROCESSING ===")) {
         outputToTerminal("Script indicates resume processing.", Info);
         return;
     }
 }
 
+void TMFLERController::onScriptFileProduced(const QString& path, const QString& kind)
+{
+    if (kind == "output_dir") {
+        m_nasPathEventSeen = true;
+        m_capturedNASPath = path;
+        outputToTerminal("Captured NAS folder path: " + m_capturedNASPath, Info);
+    }
+}
+
+void TMFLERController::onScriptEvent(const QJsonObject& event)
+{
+    if (event.value("event").toString() == "pause_for_email") {
+        m_emailPauseRequested = true;
+    }
+}
+
+void TMFLERController::clearScriptCapture()
+{
+    m_capturedNASPath.clear();
+    m_capturingNASPath = false;
+    m_nasPathEventSeen = false;
+    m_emailPauseRequested = false;
+}
+
 void TMFLERController::onScriptFinished(int exitCode, QProcess::ExitStatus exitStatus)
 {
     if (exitStatus == QProcess::CrashExit) {
@@ -762,50 +785,21 @@ void TMFLERController::onScriptFinished(int exitCode, QProcess::ExitStatus exitS
                 m_trackerModel->select();
             }
         }
-    } else {
-        outputToTerminal(QString("Script failed with exit code: %1").arg(exitCode), Error);
-    }
-}
 
-void TMFLERController::parseScriptOutput(const QString& output)
-{
-    // Look for email dialog markers
-    if (output.contains("=== SHOW_EMAIL_DIALOG ===")) {
-        m_waitingForEmailConfirmation = true;
-        return;
-    }
+        // The prearchive phase has exited, so the archive run the dialog starts cannot collide with it
+        if (m_emailPauseRequested) {
+            m_emailPauseRequested = false;
+            outputToTerminal("Prearchive complete. Opening FL ER email dialog...", Info);
 
-    if (output.contains("=== END_SHOW_EMAIL_DIALOG ===")) {
-        m_waitingForEmailConfirmation = false;
-        // Show the email confirmation dialog
-        if (!m_emailDialogPath.isEmpty()) {
-            showEmailConfirmationDialog(m_emailDialogPath);
+            QString nasPath = m_capturedNASPath;
+            if (nasPath.isEmpty() && m_fileManager) {
+                nasPath = m_fileManager->getDataPath(); // fallback
+            }
+            const QString jobNumber = m_jobNumberBox ? m_jobNumberBox->text().trimmed() : QString();
+            showEmailDialog(nasPath, jobNumber);
         }
-        return;
-    }
-
-    // Capture email dialog path
-    if (m_waitingForEmailConfirmation && !output.trimmed().isEmpty()) {
-        m_emailDialogPath = output.trimmed();
-        outputToTerminal("Email dialog path captured: " + m_emailDialogPath, Info);
-        return;
-    }
-
-    // Look for NAS path markers
-    if (output.contains("=== NAS_FOLDER_PATH ===")) {
-        m_capturingNASPath = true;
-        return;
-    }
-
-    if (output.contains("=== END_NAS_FOLDER_PATH ===")) {
-        m_capturingNASPath = false;
-        return;
-    }
-
-    // Capture the NAS path
-    if (m_capturingNASPath && !output.trimmed().isEmpty()) {
-        m_capturedNASPath = output.trimmed();
-        outputToTerminal("Captured NAS path: " + m_capturedNASPath, Success);
+    } else {
+        outputToTerminal(QString("Script failed with exit code: %1").arg(exitCode), Error);
     }
 }
 
@@ -1207,8 +1201,8 @@ bool TMFLERController::loadJob(const QString& jobNumber, const QString& year, co
 
         // If job data is locked, handle file operations and auto-save
         if (m_jobDataLocked) {
+            outputToTerminal("Copying files from ARCHIVE to DATA folder...", Info);
             copyFilesFromHomeFolder();
-            outputToTerminal("Files copied from ARCHIVE to DATA folder", Info);
 
             // Start auto-save timer since job is locked/open
             emit jobOpened();
@@ -1247,10 +1241,7 @@ void TMFLERController::resetToDefaults()
     m_jobDataLocked = false;
     m_postageDataLocked = false;
     m_lastExecutedScript.clear();
-    m_capturedNASPath.clear();
-    m_capturingNASPath = false;
-    m_waitingForEmailConfirmation = false;
-    m_emailDialogPath.clear();
+    clearScriptCapture();
 
     // Clear cache on reset
     m_lastYear = -1;
@@ -1762,19 +1753,19 @@ void TMFLERController::onFileDropError(const QString& errorMessage)
     outputToTerminal(QString("File drop error: %1").arg(errorMessage), Warning);
 }
 
-bool TMFLERController::moveFilesToHomeFolder()
+void TMFLERController::moveFilesToHomeFolder()
 {
     QString year = m_yearDDbox ? m_yearDDbox->currentText() : "";
     QString month = m_monthDDbox ? m_monthDDbox->currentText() : "";
 
     if (year.isEmpty() || month.isEmpty()) {
-        return false;
+        return;
     }
 
     const QString basePath = m_fileManager ? m_fileManager->getBasePath() : QString();
     if (basePath.isEmpty()) {
         outputToTerminal("Base path unavailable for TM FL ER", Error);
-        return false;
+        return;
     }
     QString homeFolder = month + " " + year; // FLER uses "MM YYYY" format
     QString jobFolder = basePath + "/DATA";
@@ -1785,52 +1776,40 @@ bool TMFLERController::moveFilesToHomeFolder()
     if (!homeDir.exists()) {
         if (!homeDir.mkpath(".")) {
             outputToTerminal("Failed to create HOME folder: " + homeFolderPath, Error);
-            return false;
+            return;
         }
     }
 
     // Move files from DATA folder to HOME folder
-    QDir sourceDir(jobFolder);
-    if (sourceDir.exists()) {
-        const QStringList files = sourceDir.entryList(QDir::Files);
-        bool allMoved = true;
-        for (auto it = files.cbegin(); it != files.cend(); ++it) {
-            const QString& fileName = *it;
-            QString sourcePath = jobFolder + "/" + fileName;
-            QString destPath = homeFolderPath + "/" + fileName;
-
-            // Remove existing file in destination if it exists
-            if (QFile::exists(destPath)) {
-                QFile::remove(destPath);
-            }
-
-            // Move file (rename)
-            if (!QFile::rename(sourcePath, destPath)) {
-                outputToTerminal("Failed to move file: " + sourcePath, Error);
-                allMoved = false;
-            } else {
-                outputToTerminal("Moved file: " + fileName + " to ARCHIVE", Info);
+    FileTransferQueue::instance()->enqueue("Moving files to ARCHIVE",
+        [jobFolder, homeFolderPath]() {
+            FileTransferPlan plan;
+            plan.mode = FileTransferPlan::Mode::Move;
+            plan.addFolder(jobFolder, homeFolderPath);
+            return plan;
+        },
+        this, [this](const FileTransferResult& result) {
+            outputToTerminal(result.summary("Moved"),
+                             !result.ok ? Error : (result.filesTransferred > 0 ? Success : Info));
+            if (!result.ok) {
+                outputToTerminal("Warning: Some files may not have been moved properly", Warning);
             }
-        }
-        return allMoved;
-    }
-
-    return true;
+        });
 }
 
-bool TMFLERController::copyFilesFromHomeFolder()
+void TMFLERController::copyFilesFromHomeFolder()
 {
     QString year = m_yearDDbox ? m_yearDDbox->currentText() : "";
     QString month = m_monthDDbox ? m_monthDDbox->currentText() : "";
 
     if (year.isEmpty() || month.isEmpty()) {
-        return false;
+        return;
     }
 
     const QString basePath = m_fileManager ? m_fileManager->getBasePath() : QString();
     if (basePath.isEmpty()) {
         outputToTerminal("Base path unavailable for TM FL ER", Error);
-        return false;
+        return;
     }
     QString homeFolder = month + " " + year; // FLER uses "MM YYYY" format
     QString jobFolder = basePath + "/DATA";
@@ -1840,39 +1819,21 @@ bool TMFLERController::copyFilesFromHomeFolder()
     QDir homeDir(homeFolderPath);
     if (!homeDir.exists()) {
         outputToTerminal("HOME folder does not exist: " + homeFolderPath, Warning);
-        return true; // Not an error if no previous job exists
-    }
-
-    // Create DATA folder if it doesn't exist
-    QDir dataDir(jobFolder);
-    if (!dataDir.exists() && !dataDir.mkpath(".")) {
-        outputToTerminal("Failed to create DATA folder: " + jobFolder, Error);
-        return false;
-    }
-
-    // Copy files from HOME folder to DATA folder
-    const QStringList files = homeDir.entryList(QDir::Files);
-    bool allCopied = true;
-    for (auto it = files.cbegin(); it != files.cend(); ++it) {
-            const QString& fileName = *it;
-        QString sourcePath = homeFolderPath + "/" + fileName;
-        QString destPath = jobFolder + "/" + fileName;
-
-        // Remove existing file in destination if it exists
-        if (QFile::exists(destPath)) {
-            QFile::remove(destPath);
-        }
-
-        // Copy file
-        if (!QFile::copy(sourcePath, destPath)) {
-            outputToTerminal("Failed to copy file: " + sourcePath, Error);
-            allCopied = false;
-        } else {
-            outputToTerminal("Copied file: " + fileName + " to DATA", Info);
-        }
-    }
-
-    return allCopied;
+        return; // Not an error if no previous job exists
+    }
+
+    // Copy files from HOME folder to DATA folder (the plan creates the folder if needed)
+    FileTransferQueue::instance()->enqueue("Copying files from ARCHIVE",
+        [homeFolderPath, jobFolder]() {
+            FileTransferPlan plan;
+            plan.mode = FileTransferPlan::Mode::Copy;
+            plan.addFolder(homeFolderPath, jobFolder);
+            return plan;
+        },
+        this, [this](const FileTransferResult& result) {
+            outputToTerminal(result.summary("Copied"),
+                             !result.ok ? Error : (result.filesTransferred > 0 ? Success : Info));
+        });
 }
 
 bool TMFLERController::createExcelAndCopy(const QStringList& headers, const QStringList& rowData)
@@ -2113,11 +2074,7 @@ void TMFLERController::autoSaveAndCloseCurrentJob()
                 }
 
                 outputToTerminal("Moving files from DATA folder back to ARCHIVE folder...", Info);
-                if (moveFilesToHomeFolder()) {
-                    outputToTerminal("Files moved successfully from DATA to ARCHIVE folder", Success);
-                } else {
-                    outputToTerminal("Warning: Some files may not have been moved properly", Warning);
-                }
+                moveFilesToHomeFolder();
 
                 m_jobDataLocked = false;
                 m_postageDataLocked = false;
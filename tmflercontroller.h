@@ -21,6 +21,7 @@
 #include <QDesktopServices>
 #include <QUrl>
 #include <QToolButton>
+#include <QProgressBar>
 
 // Forward declarations
 class EmailConfirmationDialog;
@@ -59,6 +60,7 @@ public:
     void setTextBrowser(QTextBrowser* textBrowser);
     void setTracker(QTableView* tableView);
     void setDropWindow(DropWindow* dropWindow);
+    void setScriptProgressBar(QProgressBar* progressBar);
 
     // Job management
     bool loadJob(const QString& jobNumber, const QString& year, const QString& month);
@@ -122,6 +124,8 @@ private slots:
     // Script runner handlers
     void onScriptOutput(const QString& output);
     void onScriptFinished(int exitCode, QProcess::ExitStatus exitStatus);
+    void onScriptFileProduced(const QString& path, const QString& kind);
+    void onScriptEvent(const QJsonObject& event);
 
     // File system handlers
     void onFileSystemChanged();
@@ -175,10 +179,10 @@ private:
     QString m_lastExecutedScript;
     QString m_capturedNASPath;
     bool m_capturingNASPath;
+    bool m_nasPathEventSeen;            // the event wins over the stdout marker
 
     // Email dialog support
-    bool m_waitingForEmailConfirmation;
-    QString m_emailDialogPath;
+    bool m_emailPauseRequested;         // opened once the prearchive run has exited
     EmailConfirmationDialog* m_emailDialog;
 
     // Tracker model
@@ -210,7 +214,7 @@ private:
     void executeScript(const QString& scriptName);
 
     // Script output parsing
-    void parseScriptOutput(const QString& output);
+    void clearScriptCapture();
     void showNASLinkDialog(const QString& nasPath);
     void showEmailConfirmationDialog(const QString& directoryPath);
 
@@ -241,9 +245,9 @@ private:
     // Excel copy functionality
     bool createExcelAndCopy(const QStringList& headers, const QStringList& rowData);
 
-    // File management
-    bool moveFilesToHomeFolder();
-    bool copyFilesFromHomeFolder();
+    // File management (queued on FileTransferQueue; outcome reported to the terminal)
+    void moveFilesToHomeFolder();
+    void copyFilesFromHomeFolder();
 
     // Opens the modal FL ER email dialog and resumes the script on close.
     void showEmailDialog(const QString &nasPath, const QString &jobNumber);
@@ -1,5 +1,6 @@
 #include "tmflerdbmanager.h"
 #include "logger.h"
+#include "tracer.h"
 #include <QSqlQuery>
 #include <QSqlError>
 #include <QDateTime>
@@ -36,13 +37,19 @@ TMFLERDBManager* TMFLERDBManager::instance()
 
 bool TMFLERDBManager::initializeTables()
 {
+    TRACE_FUNCTION("db");
     if (!m_dbManager || !m_dbManager->isInitialized()) {
         Logger::instance().error("Database manager not initialized for TMFLER");
         return false;
     }
 
-    bool success = createTables();
+    bool success = m_dbManager->applyMigrations("tm_fler", {
+        {1, "Job, log and count tables; tm_fler_log rebuilt to the current columns", [this]() { return createTables(); }}
+    });
     if (success) {
+        // Anything loaded before the database was ready is stale
+        m_jobIndex.invalidate();
+
         // Create tracker model
         m_trackerModel = new QSqlTableModel(this, m_dbManager->getDatabase());
         m_trackerModel->setTable("tm_fler_log");
@@ -273,6 +280,7 @@ bool TMFLERDBManager::saveJob(const QString& jobNumber, const QString& year, con
     }
 
     Logger::instance().info(QString("TMFLER job saved: %1 for %2/%3").arg(jobNumber, year, month));
+    m_jobIndex.upsert({{"job_number", jobNumber}, {"year", year}, {"month", month}});
     return true;
 }
 
@@ -316,6 +324,7 @@ bool TMFLERDBManager::deleteJob(int year, int month)
     bool success = m_dbManager->executeQuery(query);
     if (success) {
         Logger::instance().info(QString("TMFLER job deleted for %1/%2").arg(QString::number(year), QString("%1").arg(month, 2, 10, QChar('0'))));
+        m_jobIndex.remove({{"year", QString::number(year)}, {"month", QString::number(month)}});
     } else {
         Logger::instance().error(QString("Failed to delete TMFLER job for %1/%2").arg(QString::number(year), QString("%1").arg(month, 2, 10, QChar('0'))));
     }
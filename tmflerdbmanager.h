@@ -5,6 +5,8 @@
 #include <QSqlTableModel>
 #include <QObject>
 
+#include "jobindex.h"
+
 /**
 * @brief Database manager for TM FL ER tab operations
 *
@@ -60,6 +62,7 @@ public:
     * @return List of job data maps containing job_number, year, month
     */
     QList<QMap<QString, QString>> getAllJobs();
+    JobIndex& jobIndex() { return m_jobIndex; }   // cached getAllJobs() for the Open Job menu
 
     /**
     * @brief Enhanced job state operations with postage data (like TMTERM)
@@ -205,6 +208,8 @@ private:
     * @return True if tables created successfully
     */
     bool createTables();
+
+    JobIndex m_jobIndex { {"year", "month"}, [this]() { return getAllJobs(); } };
 };
 
 #endif // TMFLERDBMANAGER_H
@@ -1,6 +1,7 @@
 #include "tmhealthydbmanager.h"
 #include "logger.h"
 #include "DatabaseManager.h"
+#include "tracer.h"
 #include <QSqlDatabase>
 #include <QSqlQuery>
 #include <QSqlError>
@@ -47,6 +48,7 @@ TMHealthyDBManager::~TMHealthyDBManager()
 
 bool TMHealthyDBManager::initializeDatabase()
 {
+    TRACE_FUNCTION("db");
     if (m_initialized) {
         return true;
     }
@@ -63,20 +65,32 @@ bool TMHealthyDBManager::initializeDatabase()
     // Use the shared database connection instead of opening a local file
     m_database = m_dbManager->getDatabase();
 
-    // Tables must still be created if missing (only once)
-    if (!createTables()) {
-        m_lastError = "Failed to create database tables";
-        Logger::instance().error("TMHealthyDBManager: " + m_lastError);
-        return false;
-    }
-
-    if (!createIndexes()) {
-        m_lastError = "Failed to create database indexes";
+    // Schema changes run once per database; later launches skip straight past them
+    m_lastError.clear();
+    const bool migrated = m_dbManager->applyMigrations("tm_healthy", {
+        {1, "Canonical tables, job key UNIQUE(job_number, year, month), indexes", [this]() {
+            if (!createTables()) {
+                m_lastError = "Failed to create database tables";
+                return false;
+            }
+            if (!createIndexes()) {
+                m_lastError = "Failed to create database indexes";
+                return false;
+            }
+            return true;
+        }}
+    });
+    if (!migrated) {
+        if (m_lastError.isEmpty()) {
+            m_lastError = "Failed to apply schema migrations";
+        }
         Logger::instance().error("TMHealthyDBManager: " + m_lastError);
         return false;
     }
 
     m_initialized = true;
+    // Anything loaded before the database was ready is stale
+    m_jobIndex.invalidate();
     Logger::instance().info("TMHealthyDBManager: Database initialized using shared goji.db");
     return true;
 }
@@ -351,19 +365,24 @@ bool TMHealthyDBManager::migrateTMHealthyJobDataTable()
         qDebug() << "[MIGRATION CHECK] Detected old schema with UNIQUE(year, month), starting migration...";
         Logger::instance().info("TMHealthyDBManager: Detected old schema with UNIQUE(year, month), starting migration...");
         
-        // Start transaction
-        if (!db.transaction()) {
-            m_lastError = "Failed to start migration transaction";
+        // Savepoint rather than a transaction: this runs inside the schema migration transaction
+        QSqlQuery savepoint(db);
+        if (!savepoint.exec("SAVEPOINT tm_healthy_job_data_rebuild")) {
+            m_lastError = "Failed to start migration savepoint: " + savepoint.lastError().text();
             qDebug() << "[MIGRATION ERROR]" << m_lastError;
             Logger::instance().error("TMHealthyDBManager: " + m_lastError);
             return false;
         }
+        auto rollbackRebuild = [&savepoint]() {
+            savepoint.exec("ROLLBACK TO tm_healthy_job_data_rebuild");
+            savepoint.exec("RELEASE tm_healthy_job_data_rebuild");
+        };
         
         QSqlQuery query(db);
         
         // Step 1: Rename old table
         if (!query.exec(QString("ALTER TABLE %1 RENAME TO %1_old").arg(JOB_DATA_TABLE))) {
-            db.rollback();
+            rollbackRebuild();
             m_lastError = "Failed to rename old table: " + query.lastError().text();
             qDebug() << "[MIGRATION ERROR]" << m_lastError;
             Logger::instance().error("TMHealthyDBManager: " + m_lastError);
@@ -392,7 +411,7 @@ bool TMHealthyDBManager::migrateTMHealthyJobDataTable()
         ).arg(JOB_DATA_TABLE);
         
         if (!query.exec(newTableSql)) {
-            db.rollback();
+            rollbackRebuild();
             m_lastError = "Failed to create new table: " + query.lastError().text();
             qDebug() << "[MIGRATION ERROR]" << m_lastError;
             Logger::instance().error("TMHealthyDBManager: " + m_lastError);
@@ -413,7 +432,7 @@ bool TMHealthyDBManager::migrateTMHealthyJobDataTable()
         ).arg(JOB_DATA_TABLE);
         
         if (!query.exec(copySql)) {
-            db.rollback();
+            rollbackRebuild();
             m_lastError = "Failed to copy data: " + query.lastError().text();
             qDebug() << "[MIGRATION ERROR]" << m_lastError;
             Logger::instance().error("TMHealthyDBManager: " + m_lastError);
@@ -426,7 +445,7 @@ bool TMHealthyDBManager::migrateTMHealthyJobDataTable()
         
         // Step 4: Drop old table
         if (!query.exec(QString("DROP TABLE %1_old").arg(JOB_DATA_TABLE))) {
-            db.rollback();
+            rollbackRebuild();
             m_lastError = "Failed to drop old table: " + query.lastError().text();
             qDebug() << "[MIGRATION ERROR]" << m_lastError;
             Logger::instance().error("TMHealthyDBManager: " + m_lastError);
@@ -435,10 +454,10 @@ bool TMHealthyDBManager::migrateTMHealthyJobDataTable()
         qDebug() << "[MIGRATION] Step 4: Old table dropped";
         Logger::instance().info("TMHealthyDBManager: Old table dropped");
         
-        // Step 5: Commit transaction
-        if (!db.commit()) {
-            db.rollback();
-            m_lastError = "Failed to commit migration transaction";
+        // Step 5: Release the savepoint
+        if (!savepoint.exec("RELEASE tm_healthy_job_data_rebuild")) {
+            rollbackRebuild();
+            m_lastError = "Failed to release migration savepoint";
             qDebug() << "[MIGRATION ERROR]" << m_lastError;
             Logger::instance().error("TMHealthyDBManager: " + m_lastError);
             return false;
@@ -505,6 +524,7 @@ bool TMHealthyDBManager::saveJob(const QString& jobNumber, const QString& year,
     }
 
     Logger::instance().info(QString("TMHealthy job saved: %1 for %2/%3").arg(jobNumber, year, month));
+    m_jobIndex.upsert({{"job_number", jobNumber}, {"year", year}, {"month", month}});
     return true;
 }
 
@@ -577,6 +597,7 @@ bool TMHealthyDBManager::saveJobData(const QVariantMap& jobData)
         }
     }
 
+    m_jobIndex.upsert({{"job_number", jobNumber}, {"year", year}, {"month", month}});
     return true;
 }
 
@@ -636,6 +657,7 @@ bool TMHealthyDBManager::deleteJobData(const QString& jobNumber, const QString&
         return false;
     }
 
+    m_jobIndex.remove({{"job_number", jobNumber}, {"year", year}, {"month", month}});
     return true;
 }
 
@@ -650,8 +672,6 @@ bool TMHealthyDBManager::addLogEntry(const QVariantMap& logEntry)
     QString description = logEntry["description"].toString();
     // Removed unused QString 'date'
 
-    QSqlQuery query(m_dbManager->getDatabase());
-
     // First, try to update an existing entry with the same job identifier
     QString updateSql = QString(
                             "UPDATE %1 SET postage = ?, count = ?, per_piece = ?, "
@@ -659,27 +679,32 @@ bool TMHealthyDBManager::addLogEntry(const QVariantMap& logEntry)
                             "WHERE job_number = ? AND description = ?"
                             ).arg(LOG_TABLE);
 
-    query.prepare(updateSql);
-    query.addBindValue(logEntry["postage"]);
-    query.addBindValue(logEntry["count"]);
-    query.addBindValue(logEntry["per_piece"]);
-    query.addBindValue(logEntry["mail_class"]);
-    query.addBindValue(logEntry["shape"]);
-    query.addBindValue(logEntry["permit"]);
-    query.addBindValue(logEntry["date"]);
-    query.addBindValue(logEntry["year"]);
-    query.addBindValue(logEntry["month"]);
-    query.addBindValue(jobNumber);
-    query.addBindValue(description);
-
-    if (!query.exec()) {
-        m_lastError = "Failed to update log entry: " + query.lastError().text();
+    QSqlQuery* query = m_dbManager->preparedQuery("tmhealthy.updateLogEntry", updateSql);
+    if (!query) {
+        m_lastError = "Failed to prepare log entry update";
+        Logger::instance().error("TMHealthyDBManager: " + m_lastError);
+        return false;
+    }
+    query->addBindValue(logEntry["postage"]);
+    query->addBindValue(logEntry["count"]);
+    query->addBindValue(logEntry["per_piece"]);
+    query->addBindValue(logEntry["mail_class"]);
+    query->addBindValue(logEntry["shape"]);
+    query->addBindValue(logEntry["permit"]);
+    query->addBindValue(logEntry["date"]);
+    query->addBindValue(logEntry["year"]);
+    query->addBindValue(logEntry["month"]);
+    query->addBindValue(jobNumber);
+    query->addBindValue(description);
+
+    if (!m_dbManager->executeQuery(*query)) {
+        m_lastError = "Failed to update log entry: " + query->lastError().text();
         Logger::instance().error("TMHealthyDBManager: " + m_lastError);
         return false;
     }
 
     // Check if any rows were updated
-    if (query.numRowsAffected() > 0) {
+    if (query->numRowsAffected() > 0) {
         Logger::instance().info(QString("TMHealthy log entry updated: Job %1").arg(jobNumber));
         return true;
     }
@@ -690,21 +715,26 @@ bool TMHealthyDBManager::addLogEntry(const QVariantMap& logEntry)
                             "VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)"
                             ).arg(LOG_TABLE);
 
-    query.prepare(insertSql);
-    query.addBindValue(logEntry["job_number"]);
-    query.addBindValue(logEntry["description"]);
-    query.addBindValue(logEntry["postage"]);
-    query.addBindValue(logEntry["count"]);
-    query.addBindValue(logEntry["per_piece"]);
-    query.addBindValue(logEntry["mail_class"]);
-    query.addBindValue(logEntry["shape"]);
-    query.addBindValue(logEntry["permit"]);
-    query.addBindValue(logEntry["date"]);
-    query.addBindValue(logEntry["year"]);
-    query.addBindValue(logEntry["month"]);
-
-    if (!query.exec()) {
-        m_lastError = "Failed to add log entry: " + query.lastError().text();
+    query = m_dbManager->preparedQuery("tmhealthy.insertLogEntry", insertSql);
+    if (!query) {
+        m_lastError = "Failed to prepare log entry insert";
+        Logger::instance().error("TMHealthyDBManager: " + m_lastError);
+        return false;
+    }
+    query->addBindValue(logEntry["job_number"]);
+    query->addBindValue(logEntry["description"]);
+    query->addBindValue(logEntry["postage"]);
+    query->addBindValue(logEntry["count"]);
+    query->addBindValue(logEntry["per_piece"]);
+    query->addBindValue(logEntry["mail_class"]);
+    query->addBindValue(logEntry["shape"]);
+    query->addBindValue(logEntry["permit"]);
+    query->addBindValue(logEntry["date"]);
+    query->addBindValue(logEntry["year"]);
+    query->addBindValue(logEntry["month"]);
+
+    if (!m_dbManager->executeQuery(*query)) {
+        m_lastError = "Failed to add log entry: " + query->lastError().text();
         Logger::instance().error("TMHealthyDBManager: " + m_lastError);
         return false;
     }
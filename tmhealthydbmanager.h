@@ -10,6 +10,8 @@
 #include <QStringList>
 #include <QMutex>
 
+#include "jobindex.h"
+
 // ✅ Forward declaration outside the class
 class DatabaseManager;
 
@@ -46,6 +48,7 @@ public:
     QStringList getAvailableYears();
     QStringList getAvailableMonths(const QString& year);
     QList<QMap<QString, QString>> getAllJobs();
+    JobIndex& jobIndex() { return m_jobIndex; }   // cached getAllJobs() for the Open Job menu
 
     // Database maintenance
     bool backupDatabase(const QString& backupPath);
@@ -91,6 +94,8 @@ private:
     // Table names
     static const QString JOB_DATA_TABLE;
     static const QString LOG_TABLE;
+
+    JobIndex m_jobIndex { {"year", "month", "job_number"}, [this]() { return getAllJobs(); } };
 };
 
 #endif // TMHEALTHYDBMANAGER_H
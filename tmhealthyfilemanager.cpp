@@ -1,4 +1,6 @@
 #include "tmhealthyfilemanager.h"
+#include "filetransfer.h"
+#include "hashservice.h"
 #include "logger.h"
 #include "fileutils.h"
 #include <QDir>
@@ -173,37 +175,49 @@ bool TMHealthyFileManager::copyFilesToJobDirectory(const QString& year, const QS
     return true;
 }
 
-bool TMHealthyFileManager::moveFilesToHomeDirectory(const QString& year, const QString& month)
+void TMHealthyFileManager::moveFilesToHomeDirectory(const QString& year, const QString& month, QObject* context,
+                                                      std::function<void(bool ok)> onFinished)
 {
     QString jobOutputDir = getJobOutputDirectory(year, month);
 
     if (!QDir(jobOutputDir).exists()) {
         Logger::instance().warning("Job output directory does not exist: " + jobOutputDir);
-        return true; // Nothing to move
+        if (onFinished) {
+            onFinished(true); // Nothing to move
+        }
+        return;
     }
 
     if (!ensureDirectoryExists(m_homeDirectory)) {
         Logger::instance().error("Failed to create home directory: " + m_homeDirectory);
-        return false;
-    }
-
-    QDir outputDir(jobOutputDir);
-    QStringList files = outputDir.entryList(QDir::Files);
-
-    // ✅ Indexed loop to avoid QStringList detach
-    for (int i = 0; i < files.size(); ++i) {
-        const QString& fileName = files.at(i);
-        QString sourcePath = jobOutputDir + "/" + fileName;
-        QString destPath = m_homeDirectory + "/" + fileName;
-
-        if (!moveFileWithBackup(sourcePath, destPath)) {
-            Logger::instance().error("Failed to move file from " + sourcePath + " to " + destPath);
-            return false;
+        if (onFinished) {
+            onFinished(false);
         }
+        return;
     }
 
-    Logger::instance().info("Moved files to HOME directory for " + year + "-" + month);
-    return true;
+    // Replaced HOME files are kept as timestamped backups, as moveFileWithBackup() did
+    const QString homeDirectory = m_homeDirectory;
+    FileTransferQueue::instance()->enqueue("Moving files to HOME",
+        [this, jobOutputDir, homeDirectory]() {
+            FileTransferPlan plan;
+            plan.mode = FileTransferPlan::Mode::Move;
+            plan.backupPathFor = [this](const QString& destination) {
+                return generateBackupFileName(destination);
+            };
+            plan.addFolder(jobOutputDir, homeDirectory);
+            return plan;
+        },
+        context, [year, month, onFinished](const FileTransferResult& result) {
+            if (!result.ok) {
+                Logger::instance().error("Failed to move files to HOME directory: " + result.summary("Moved"));
+            } else {
+                Logger::instance().info(result.summary("Moved") + " to HOME directory for " + year + "-" + month);
+            }
+            if (onFinished) {
+                onFinished(result.ok);
+            }
+        });
 }
 
 bool TMHealthyFileManager::archiveJobFiles(const QString& year, const QString& month)
@@ -385,14 +399,8 @@ QFileInfo TMHealthyFileManager::getFileInfo(const QString& filePath) const
 
 QString TMHealthyFileManager::getFileChecksum(const QString& filePath) const
 {
-    QFile file(filePath);
-    if (!file.open(QIODevice::ReadOnly)) {
-        return QString();
-    }
-
-    QCryptographicHash hash(QCryptographicHash::Sha256);
-    hash.addData(&file);
-    return hash.result().toHex();
+    // Empty on failure; unchanged files are answered from the digest cache
+    return HashService::instance().hashFile(filePath).hex;
 }
 
 qint64 TMHealthyFileManager::getDirectorySize(const QString& directoryPath) const
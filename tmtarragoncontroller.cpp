@@ -31,6 +31,7 @@
 #include <QToolButton>
 
 #include "logger.h"
+#include "filetransfer.h"
 #include "scriptrunnerbindinghelper.h"
 
 class FormattedSqlModel : public QSqlTableModel {
@@ -1231,8 +1232,8 @@ bool TMTarragonController::loadJob(const QString& year, const QString& month, co
 
         // NEW: If job data was locked when saved, copy files back to DATA folder
         if (m_jobDataLocked) {
+            outputToTerminal("Copying files from ARCHIVE to DATA folder...", Info);
             copyFilesFromHomeFolder();
-            outputToTerminal("Files copied from ARCHIVE to DATA folder", Info);
 
             // Start auto-save timer since job is locked/open
             emit jobOpened();
@@ -1307,133 +1308,6 @@ void TMTarragonController::addLogEntry()
     }
 }
 
-bool TMTarragonController::createExcelAndCopy(const QStringList& headers, const QStringList& rowData)
-{
-#ifdef Q_OS_WIN
-    QString tempDir = QStandardPaths::writableLocation(QStandardPaths::TempLocation);
-    QString tempFileName = QDir(tempDir).filePath("goji_temp_copy.xlsx");
-    QString scriptPath = QDir(tempDir).filePath("goji_excel_script.ps1");
-
-    // Remove existing files
-    QFile::remove(tempFileName);
-    QFile::remove(scriptPath);
-
-    // Create PowerShell script that creates Excel file and opens it for copying
-    QString script = "try {\n";
-    script += "  $excel = New-Object -ComObject Excel.Application\n";
-    script += "  $excel.Visible = $false\n";
-    script += "  $excel.DisplayAlerts = $false\n";
-    script += "  $workbook = $excel.Workbooks.Add()\n";
-    script += "  $sheet = $workbook.ActiveSheet\n";
-
-    // Add headers with styling
-    for (int i = 0; i < headers.size(); i++) {
-        script += QString("  $sheet.Cells(%1,%2) = '%3'\n").arg(1).arg(i + 1).arg(headers[i]);
-        script += QString("  $sheet.Cells(%1,%2).Font.Bold = $true\n").arg(1).arg(i + 1);
-        script += QString("  $sheet.Cells(%1,%2).Interior.Color = 14737632\n").arg(1).arg(i + 1);
-    }
-
-    // Add data with formatting
-    for (int i = 0; i < rowData.size(); i++) {
-        QString cellValue = rowData[i];
-        cellValue.replace("'", "''"); // Escape single quotes
-        script += QString("  $sheet.Cells(%1,%2) = '%3'\n").arg(2).arg(i + 1).arg(cellValue);
-
-        // Format specific columns
-        if (i == 2) { // POSTAGE - currency format
-            script += QString("  $sheet.Cells(%1,%2).NumberFormat = '$#,##0.00'\n").arg(2).arg(i + 1);
-            script += QString("  $sheet.Cells(%1,%2).HorizontalAlignment = -4152\n").arg(2).arg(i + 1);
-        } else if (i == 3) { // COUNT - number format
-            script += QString("  $sheet.Cells(%1,%2).NumberFormat = '#,##0'\n").arg(2).arg(i + 1);
-            script += QString("  $sheet.Cells(%1,%2).HorizontalAlignment = -4152\n").arg(2).arg(i + 1);
-        } else if (i == 4) { // AVG RATE - decimal format
-            script += QString("  $sheet.Cells(%1,%2).NumberFormat = '0.000'\n").arg(2).arg(i + 1);
-            script += QString("  $sheet.Cells(%1,%2).HorizontalAlignment = -4152\n").arg(2).arg(i + 1);
-        }
-    }
-
-    // Add borders and formatting
-    script += QString("  $range = $sheet.Range('A1:%1%2')\n").arg(QChar('A' + (char)(headers.size() - 1))).arg(2);
-    script += "  $range.Borders.LineStyle = 1\n";
-    script += "  $range.Borders.Weight = 2\n";
-    script += "  $range.Borders.Color = 0\n";
-
-    // Set column widths
-    script += "  $sheet.Columns.Item(1).ColumnWidth = 8\n";   // JOB
-    script += "  $sheet.Columns.Item(2).ColumnWidth = 25\n";  // DESCRIPTION (wider for TARRAGON)
-    script += "  $sheet.Columns.Item(3).ColumnWidth = 10\n";  // POSTAGE
-    script += "  $sheet.Columns.Item(4).ColumnWidth = 8\n";   // COUNT
-    script += "  $sheet.Columns.Item(5).ColumnWidth = 10\n";  // AVG RATE
-    script += "  $sheet.Columns.Item(6).ColumnWidth = 6\n";   // CLASS
-    script += "  $sheet.Columns.Item(7).ColumnWidth = 6\n";   // SHAPE
-    script += "  $sheet.Columns.Item(8).ColumnWidth = 8\n";   // PERMIT
-
-    // Save file and make Excel visible for copying
-    script += QString("  $workbook.SaveAs('%1')\n").arg(tempFileName.replace('/', '\\'));
-    script += "  $range.Select()\n";
-    script += "  $range.Copy()\n";
-
-    // Important: Keep Excel open briefly so clipboard data persists
-    script += "  Start-Sleep -Seconds 1\n";
-    script += "  $workbook.Close($false)\n";
-    script += "  $excel.Quit()\n";
-
-    // Clean up COM objects
-    script += "  [System.Runtime.Interopservices.Marshal]::ReleaseComObject($range) | Out-Null\n";
-    script += "  [System.Runtime.Interopservices.Marshal]::ReleaseComObject($sheet) | Out-Null\n";
-    script += "  [System.Runtime.Interopservices.Marshal]::ReleaseComObject($workbook) | Out-Null\n";
-    script += "  [System.Runtime.Interopservices.Marshal]::ReleaseComObject($excel) | Out-Null\n";
-    script += "  [System.GC]::Collect()\n";
-
-    script += "  Write-Output 'SUCCESS'\n";
-    script += "} catch {\n";
-    script += "  Write-Output \"ERROR: $_\"\n";
-    script += "}\n";
-
-    // Write script to file
-    QFile scriptFile(scriptPath);
-    if (!scriptFile.open(QIODevice::WriteOnly | QIODevice::Text)) {
-        return false;
-    }
-
-    QTextStream out(&scriptFile);
-    out << script;
-    scriptFile.close();
-
-    // Execute PowerShell script
-    QProcess process;
-    QStringList arguments;
-    arguments << "-ExecutionPolicy" << "Bypass" << "-NoProfile" << "-File" << scriptPath;
-
-    process.start("powershell.exe", arguments);
-    process.waitForFinished(15000); // 15 second timeout
-
-    QString output = process.readAllStandardOutput();
-    QString errorOutput = process.readAllStandardError();
-
-    // Cleanup script file
-    QFile::remove(scriptPath);
-
-    // Cleanup Excel file after a delay
-    QTimer::singleShot(5000, this, [tempFileName]() {
-        QFile::remove(tempFileName);
-    });
-
-    if (output.contains("SUCCESS")) {
-        return true;
-    } else {
-        outputToTerminal(QString("PowerShell error: %1 %2").arg(output, errorOutput), Error);
-        return false;
-    }
-#else
-    // Fallback for non-Windows: create simple TSV
-    QString tsv = headers.join("\t") + "\n" + rowData.join("\t");
-    QClipboard* clipboard = QApplication::clipboard();
-    clipboard->setText(tsv);
-    return true;
-#endif
-}
-
 void TMTarragonController::resetToDefaults()
 {
     // CRITICAL FIX: Save current job state to database BEFORE resetting
@@ -1483,20 +1357,20 @@ void TMTarragonController::resetToDefaults()
     outputToTerminal("Auto-save timer stopped - no job open", Info);
 }
 
-bool TMTarragonController::moveFilesToHomeFolder()
+void TMTarragonController::moveFilesToHomeFolder()
 {
     QString year = m_yearDDbox ? m_yearDDbox->currentText() : "";
     QString month = m_monthDDbox ? m_monthDDbox->currentText() : "";
     QString dropNumber = m_dropNumberDDbox ? m_dropNumberDDbox->currentText() : "";
 
     if (year.isEmpty() || month.isEmpty() || dropNumber.isEmpty()) {
-        return false;
+        return;
     }
 
     const QString basePath = m_fileManager ? m_fileManager->getBasePath() : QString();
     if (basePath.isEmpty()) {
         outputToTerminal("Base path unavailable for TM TARRAGON", Error);
-        return false;
+        return;
     }
     QString homeFolder = month + "." + dropNumber; // TARRAGON uses "MM.DD" format
     QString jobFolder = basePath + "/DATA";
@@ -1507,55 +1381,41 @@ bool TMTarragonController::moveFilesToHomeFolder()
     if (!homeDir.exists()) {
         if (!homeDir.mkpath(".")) {
             outputToTerminal("Failed to create HOME folder: " + homeFolderPath, Error);
-            return false;
+            return;
         }
     }
 
     // Move files from DATA folder to HOME folder
-    QDir sourceDir(jobFolder);
-    if (sourceDir.exists()) {
-        QStringList files = sourceDir.entryList(QDir::Files);
-        bool allMoved = true;
-
-        // ✅ Indexed loop to avoid QStringList detach
-        for (int i = 0; i < files.size(); ++i) {
-            const QString& fileName = files.at(i);
-            QString sourcePath = jobFolder + "/" + fileName;
-            QString destPath = homeFolderPath + "/" + fileName;
-
-            // Remove existing file in destination if it exists
-            if (QFile::exists(destPath)) {
-                QFile::remove(destPath);
-            }
-
-            // Move file (rename)
-            if (!QFile::rename(sourcePath, destPath)) {
-                outputToTerminal("Failed to move file: " + sourcePath, Error);
-                allMoved = false;
-            } else {
-                outputToTerminal("Moved file: " + fileName + " to ARCHIVE", Info);
+    FileTransferQueue::instance()->enqueue("Moving files to ARCHIVE",
+        [jobFolder, homeFolderPath]() {
+            FileTransferPlan plan;
+            plan.mode = FileTransferPlan::Mode::Move;
+            plan.addFolder(jobFolder, homeFolderPath);
+            return plan;
+        },
+        this, [this](const FileTransferResult& result) {
+            outputToTerminal(result.summary("Moved"),
+                             !result.ok ? Error : (result.filesTransferred > 0 ? Success : Info));
+            if (!result.ok) {
+                outputToTerminal("Warning: Some files may not have been moved properly", Warning);
             }
-        }
-        return allMoved;
-    }
-
-    return true;
+        });
 }
 
-bool TMTarragonController::copyFilesFromHomeFolder()
+void TMTarragonController::copyFilesFromHomeFolder()
 {
     QString year = m_yearDDbox ? m_yearDDbox->currentText() : "";
     QString month = m_monthDDbox ? m_monthDDbox->currentText() : "";
     QString dropNumber = m_dropNumberDDbox ? m_dropNumberDDbox->currentText() : "";
 
     if (year.isEmpty() || month.isEmpty() || dropNumber.isEmpty()) {
-        return false;
+        return;
     }
 
     const QString basePath = m_fileManager ? m_fileManager->getBasePath() : QString();
     if (basePath.isEmpty()) {
         outputToTerminal("Base path unavailable for TM TARRAGON", Error);
-        return false;
+        return;
     }
     QString homeFolder = month + "." + dropNumber; // TARRAGON uses "MM.DD" format
     QString jobFolder = basePath + "/DATA";
@@ -1565,41 +1425,21 @@ bool TMTarragonController::copyFilesFromHomeFolder()
     QDir homeDir(homeFolderPath);
     if (!homeDir.exists()) {
         outputToTerminal("HOME folder does not exist: " + homeFolderPath, Warning);
-        return true; // Not an error if no previous job exists
-    }
-
-    // Create DATA folder if it doesn't exist
-    QDir dataDir(jobFolder);
-    if (!dataDir.exists() && !dataDir.mkpath(".")) {
-        outputToTerminal("Failed to create DATA folder: " + jobFolder, Error);
-        return false;
-    }
-
-    // Copy files from HOME folder to DATA folder
-    QStringList files = homeDir.entryList(QDir::Files);
-    bool allCopied = true;
-
-    // ✅ Indexed loop to avoid QStringList detach
-    for (int i = 0; i < files.size(); ++i) {
-        const QString& fileName = files.at(i);
-        QString sourcePath = homeFolderPath + "/" + fileName;
-        QString destPath = jobFolder + "/" + fileName;
-
-        // Remove existing file in destination if it exists
-        if (QFile::exists(destPath)) {
-            QFile::remove(destPath);
-        }
-
-        // Copy file
-        if (!QFile::copy(sourcePath, destPath)) {
-            outputToTerminal("Failed to copy file: " + sourcePath, Error);
-            allCopied = false;
-        } else {
-            outputToTerminal("Copied file: " + fileName + " to DATA", Info);
-        }
-    }
-
-    return allCopied;
+        return; // Not an error if no previous job exists
+    }
+
+    // Copy files from HOME folder to DATA folder (the plan creates the folder if needed)
+    FileTransferQueue::instance()->enqueue("Copying files from ARCHIVE",
+        [homeFolderPath, jobFolder]() {
+            FileTransferPlan plan;
+            plan.mode = FileTransferPlan::Mode::Copy;
+            plan.addFolder(homeFolderPath, jobFolder);
+            return plan;
+        },
+        this, [this](const FileTransferResult& result) {
+            outputToTerminal(result.summary("Copied"),
+                             !result.ok ? Error : (result.filesTransferred > 0 ? Success : Info));
+        });
 }
 
 void TMTarragonController::refreshTrackerTable()
@@ -1636,11 +1476,7 @@ void TMTarragonController::autoSaveAndCloseCurrentJob()
             
             // Move files from JOB folder back to HOME folder before closing
             outputToTerminal("Moving files from DATA folder back to ARCHIVE folder...", Info);
-            if (moveFilesToHomeFolder()) {
-                outputToTerminal("Files moved successfully from DATA to ARCHIVE folder", Success);
-            } else {
-                outputToTerminal("Warning: Some files may not have been moved properly", Warning);
-            }
+            moveFilesToHomeFolder();
             
             // Clear current job state
             m_jobDataLocked = false;
@@ -178,19 +178,20 @@ private:
 
     // Inherited method implementation
     QString copyFormattedRow();
-    bool createExcelAndCopy(const QStringList& headers, const QStringList& rowData);
 
     /**
-     * @brief Move files from JOB folders to HOME folders when closing job
-     * @return True if files were moved successfully
+     * @brief Queue the move of files from JOB folders to HOME folders when closing job
+     *
+     * Runs on FileTransferQueue; the outcome is written to the terminal when it finishes.
      */
-    bool moveFilesToHomeFolder();
+    void moveFilesToHomeFolder();
 
     /**
-     * @brief Copy files from HOME folders to JOB folders when opening job
-     * @return True if files were copied successfully
+     * @brief Queue the copy of files from HOME folders to JOB folders when opening job
+     *
+     * Runs on FileTransferQueue; the outcome is written to the terminal when it finishes.
      */
-    bool copyFilesFromHomeFolder();
+    void copyFilesFromHomeFolder();
 };
 
 #endif // TMTARRAGONCONTROLLER_H
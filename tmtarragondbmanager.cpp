@@ -1,5 +1,6 @@
 #include "tmtarragondbmanager.h"
 #include "logger.h"
+#include "tracer.h"
 #include <QSqlQuery>
 #include <QSqlError>
 #include <QDateTime>
@@ -26,12 +27,20 @@ TMTarragonDBManager* TMTarragonDBManager::instance()
 
 bool TMTarragonDBManager::initialize()
 {
+    TRACE_FUNCTION("db");
     if (!m_dbManager || !m_dbManager->isInitialized()) {
         qDebug() << "Database manager not available or not initialized";
         return false;
     }
 
-    return createTables();
+    const bool migrated = m_dbManager->applyMigrations("tm_tarragon", {
+        {1, "Job and log tables", [this]() { return createTables(); }}
+    });
+    if (migrated) {
+        // Anything loaded before the database was ready is stale
+        m_jobIndex.invalidate();
+    }
+    return migrated;
 }
 
 bool TMTarragonDBManager::createTables()
@@ -143,6 +152,8 @@ bool TMTarragonDBManager::saveJob(const QString& jobNumber, const QString& year,
     if (!success) {
         qDebug() << "Failed to save job:" << query.lastError().text();
         Logger::instance().error("Failed to save TM Tarragon job: " + query.lastError().text());
+    } else {
+        m_jobIndex.upsert({{"job_number", jobNumber}, {"year", year}, {"month", month}, {"drop_number", dropNumber}});
     }
 
     return success;
@@ -188,7 +199,12 @@ bool TMTarragonDBManager::deleteJob(const QString& year, const QString& month, c
     query.bindValue(":month", month);
     query.bindValue(":drop_number", dropNumber);
 
-    return query.exec();
+    if (!query.exec()) {
+        return false;
+    }
+
+    m_jobIndex.remove({{"year", year}, {"month", month}, {"drop_number", dropNumber}});
+    return true;
 }
 
 bool TMTarragonDBManager::jobExists(const QString& year, const QString& month, const QString& dropNumber)
@@ -6,6 +6,7 @@
 #include <QMap>
 #include <QVariant>
 #include "databasemanager.h"
+#include "jobindex.h"
 
 class TMTarragonDBManager
 {
@@ -24,6 +25,7 @@ public:
     bool deleteJob(const QString& year, const QString& month, const QString& dropNumber);
     bool jobExists(const QString& year, const QString& month, const QString& dropNumber);
     QList<QMap<QString, QString>> getAllJobs();
+    JobIndex& jobIndex() { return m_jobIndex; }   // cached getAllJobs() for the Open Job menu
 
     // Job state operations (for UI state persistence)
     bool saveJobState(const QString& year, const QString& month, const QString& dropNumber,
@@ -70,6 +72,8 @@ private:
 
     // Constants
     const QString TAB_NAME = "TM_TARRAGON";
+
+    JobIndex m_jobIndex { {"year", "month", "drop_number"}, [this]() { return getAllJobs(); } };
 };
 
 #endif // TMTARRAGONDBMANAGER_H
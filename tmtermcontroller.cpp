@@ -1,5 +1,6 @@
 #include "tmtermcontroller.h"
 #include "logger.h"
+#include "filetransfer.h"
 #include "tmtermemaildialog.h"
 #include "dropwindow.h"
 #include "scriptrunnerbindinghelper.h"
@@ -495,8 +496,8 @@ bool TMTermController::loadJob(const QString& year, const QString& month)
 
         // If job data is locked, handle file operations and auto-save
         if (m_jobDataLocked) {
+            outputToTerminal("Copying files from ARCHIVE to DATA folder...", Info);
             copyFilesFromHomeFolder();
-            outputToTerminal("Files copied from ARCHIVE to DATA folder", Info);
 
             // Start auto-save timer since job is locked/open
             emit jobOpened();
@@ -1282,27 +1283,27 @@ void TMTermController::debugCheckTables()
     // Add any debug table checking logic here if needed
 }
 
-bool TMTermController::moveFilesToHomeFolder()
+void TMTermController::moveFilesToHomeFolder()
 {
     QString month = m_monthDDbox ? m_monthDDbox->currentText() : "";
     QString jobNumber = m_jobNumberBox ? m_jobNumberBox->text() : "";
 
     if (jobNumber.isEmpty() || month.isEmpty()) {
         outputToTerminal("Cannot move files: missing job number or month", Warning);
-        return false;
+        return;
     }
 
     // Convert month to three-letter abbreviation
     QString monthAbbrev = convertMonthToAbbreviation(month);
     if (monthAbbrev.isEmpty()) {
         outputToTerminal("Cannot move files: invalid month format", Warning);
-        return false;
+        return;
     }
 
     const QString basePath = m_fileManager ? m_fileManager->getBasePath() : QString();
     if (basePath.isEmpty()) {
         outputToTerminal("Base path unavailable for TM TERM", Error);
-        return false;
+        return;
     }
     QString dataFolder = basePath + "/DATA";
     QString homeFolder = jobNumber + " " + monthAbbrev;  // Format: "37580 JUL"
@@ -1313,59 +1314,49 @@ bool TMTermController::moveFilesToHomeFolder()
     if (!homeDir.exists()) {
         if (!homeDir.mkpath(".")) {
             outputToTerminal("Failed to create HOME folder: " + homeFolderPath, Error);
-            return false;
+            return;
         }
         outputToTerminal("Created HOME folder: " + homeFolderPath, Info);
     }
 
     // Move files from DATA to HOME folder
-    QDir dataDir(dataFolder);
-    if (dataDir.exists()) {
-        QStringList files = dataDir.entryList(QDir::Files);
-        for (int i = 0; i < files.size(); ++i) {
-        const QString& fileName = files.at(i);
-            QString sourcePath = dataFolder + "/" + fileName;
-            QString destPath = homeFolderPath + "/" + fileName;
-
-            // Remove existing file in destination if it exists
-            if (QFile::exists(destPath)) {
-                QFile::remove(destPath);
-            }
-
-            // Move file
-            if (!QFile::rename(sourcePath, destPath)) {
-                outputToTerminal("Failed to move file: " + sourcePath, Error);
-                return false;
-            } else {
-                outputToTerminal("Moved file: " + fileName + " to " + homeFolder, Info);
+    FileTransferQueue::instance()->enqueue("Moving files to ARCHIVE",
+        [dataFolder, homeFolderPath]() {
+            FileTransferPlan plan;
+            plan.mode = FileTransferPlan::Mode::Move;
+            plan.addFolder(dataFolder, homeFolderPath);
+            return plan;
+        },
+        this, [this](const FileTransferResult& result) {
+            outputToTerminal(result.summary("Moved"),
+                             !result.ok ? Error : (result.filesTransferred > 0 ? Success : Info));
+            if (!result.ok) {
+                outputToTerminal("Warning: Some files may not have been moved properly", Warning);
             }
-        }
-    }
-
-    return true;
+        });
 }
 
-bool TMTermController::copyFilesFromHomeFolder()
+void TMTermController::copyFilesFromHomeFolder()
 {
     QString month = m_monthDDbox ? m_monthDDbox->currentText() : "";
     QString jobNumber = m_jobNumberBox ? m_jobNumberBox->text() : "";
 
     if (jobNumber.isEmpty() || month.isEmpty()) {
         outputToTerminal("Cannot copy files: missing job number or month", Warning);
-        return false;
+        return;
     }
 
     // Convert month to three-letter abbreviation
     QString monthAbbrev = convertMonthToAbbreviation(month);
     if (monthAbbrev.isEmpty()) {
         outputToTerminal("Cannot copy files: invalid month format", Warning);
-        return false;
+        return;
     }
 
     const QString basePath = m_fileManager ? m_fileManager->getBasePath() : QString();
     if (basePath.isEmpty()) {
         outputToTerminal("Base path unavailable for TM TERM", Error);
-        return false;
+        return;
     }
     QString dataFolder = basePath + "/DATA";
     QString homeFolder = jobNumber + " " + monthAbbrev;  // Format: "37580 JUL"
@@ -1376,40 +1367,21 @@ bool TMTermController::copyFilesFromHomeFolder()
     if (!homeDir.exists()) {
         outputToTerminal("HOME folder does not exist: " + homeFolderPath, Info);
         outputToTerminal("This is normal for new jobs - no files to copy", Info);
-        return true; // Not an error if no previous job exists
-    }
-
-    // Create DATA folder if it doesn't exist
-    QDir dataDir(dataFolder);
-    if (!dataDir.exists()) {
-        if (!dataDir.mkpath(".")) {
-            outputToTerminal("Failed to create DATA folder: " + dataFolder, Error);
-            return false;
-        }
-    }
-
-    // Copy files from HOME to DATA folder
-    QStringList files = homeDir.entryList(QDir::Files);
-    for (int i = 0; i < files.size(); ++i) {
-        const QString& fileName = files.at(i);
-        QString sourcePath = homeFolderPath + "/" + fileName;
-        QString destPath = dataFolder + "/" + fileName;
-
-        // Remove existing file in destination if it exists
-        if (QFile::exists(destPath)) {
-            QFile::remove(destPath);
-        }
-
-        // Copy file
-        if (!QFile::copy(sourcePath, destPath)) {
-            outputToTerminal("Failed to copy file: " + sourcePath, Error);
-            return false;
-        } else {
-            outputToTerminal("Copied file: " + fileName + " from " + homeFolder, Info);
-        }
-    }
-
-    return true;
+        return; // Not an error if no previous job exists
+    }
+
+    // Copy files from HOME to DATA folder (the plan creates the folder if needed)
+    FileTransferQueue::instance()->enqueue("Copying files from ARCHIVE",
+        [homeFolderPath, dataFolder]() {
+            FileTransferPlan plan;
+            plan.mode = FileTransferPlan::Mode::Copy;
+            plan.addFolder(homeFolderPath, dataFolder);
+            return plan;
+        },
+        this, [this](const FileTransferResult& result) {
+            outputToTerminal(result.summary("Copied"),
+                             !result.ok ? Error : (result.filesTransferred > 0 ? Success : Info));
+        });
 }
 
 bool TMTermController::moveFilesToBasicHomeFolder(const QString& year, const QString& month)
@@ -1775,11 +1747,7 @@ void TMTermController::autoSaveAndCloseCurrentJob()
             
             // Move files from JOB folder back to HOME folder before closing
             outputToTerminal("Moving files from DATA folder back to ARCHIVE folder...", Info);
-            if (moveFilesToHomeFolder()) {
-                outputToTerminal("Files moved successfully from DATA to ARCHIVE folder", Success);
-            } else {
-                outputToTerminal("Warning: Some files may not have been moved properly", Warning);
-            }
+            moveFilesToHomeFolder();
             
             // Clear current job state
             m_jobDataLocked = false;
@@ -185,16 +185,18 @@ private:
     void addLogEntry();
 
     /**
-     * @brief Move files from JOB folders to HOME folders when closing job
-     * @return True if files were moved successfully
+     * @brief Queue the move of files from JOB folders to HOME folders when closing job
+     *
+     * Runs on FileTransferQueue; the outcome is written to the terminal when it finishes.
      */
-    bool moveFilesToHomeFolder();
+    void moveFilesToHomeFolder();
 
     /**
-     * @brief Copy files from HOME folders to JOB folders when opening job
-     * @return True if files were copied successfully
+     * @brief Queue the copy of files from HOME folders to JOB folders when opening job
+     *
+     * Runs on FileTransferQueue; the outcome is written to the terminal when it finishes.
      */
-    bool copyFilesFromHomeFolder();
+    void copyFilesFromHomeFolder();
 
     /**
      * @brief Helper method to move files when no job number is available
@@ -9,6 +9,7 @@
 #include <QMap>
 #include <QStringList>
 #include "logger.h"
+#include "tracer.h"
 
 // Initialize static member
 TMTermDBManager* TMTermDBManager::m_instance = nullptr;
@@ -28,13 +29,21 @@ TMTermDBManager::TMTermDBManager()
 
 bool TMTermDBManager::initialize()
 {
+    TRACE_FUNCTION("db");
     if (!m_dbManager->isInitialized()) {
         qDebug() << "Core database manager not initialized";
         Logger::instance().error("Core database manager not initialized for TMTerm");
         return false;
     }
 
-    return createTables();
+    const bool migrated = m_dbManager->applyMigrations("tm_term", {
+        {1, "Job and log tables", [this]() { return createTables(); }}
+    });
+    if (migrated) {
+        // Anything loaded before the database was ready is stale
+        m_jobIndex.invalidate();
+    }
+    return migrated;
 }
 
 // FIXED: Enhanced database table creation with proper schema
@@ -149,6 +158,7 @@ bool TMTermDBManager::saveJob(const QString& jobNumber, const QString& year, con
     }
 
     Logger::instance().info(QString("TMTerm job saved: %1 for %2/%3").arg(jobNumber, year, month));
+    m_jobIndex.upsert({{"job_number", jobNumber}, {"year", year}, {"month", month}});
     return true;
 }
 
@@ -198,6 +208,7 @@ bool TMTermDBManager::deleteJob(const QString& year, const QString& month)
     bool success = m_dbManager->executeQuery(query);
     if (success) {
         Logger::instance().info(QString("TMTerm job deleted for %1/%2").arg(year, month));
+        m_jobIndex.remove({{"year", year}, {"month", month}});
     } else {
         Logger::instance().error(QString("Failed to delete TMTerm job for %1/%2").arg(year, month));
     }
@@ -330,6 +341,7 @@ bool TMTermDBManager::saveJobState(const QString& year, const QString& month,
                                          .arg(year, month, query.lastError().text()));
             return false;
         }
+        m_jobIndex.invalidate();
     }
 
     Logger::instance().info(QString("TMTerm job state saved for %1/%2: postage=%3, count=%4, locked=%5")
@@ -6,6 +6,7 @@
 #include <QMap>
 #include <QVariant>
 #include "databasemanager.h"
+#include "jobindex.h"
 
 class TMTermDBManager
 {
@@ -22,6 +23,7 @@ public:
     bool deleteJob(const QString& year, const QString& month);
     bool jobExists(const QString& year, const QString& month);
     QList<QMap<QString, QString>> getAllJobs();
+    JobIndex& jobIndex() { return m_jobIndex; }   // cached getAllJobs() for the Open Job menu
 
     // Job state operations (for UI state persistence) - UPDATED with postage data
     bool saveJobState(const QString& year, const QString& month,
@@ -72,6 +74,8 @@ private:
 
     // Constants
     const QString TAB_NAME = "TM_TERM";
+
+    JobIndex m_jobIndex { {"year", "month"}, [this]() { return getAllJobs(); } };
 };
 
 #endif // TMTERMDBMANAGER_H
@@ -7,6 +7,9 @@
 #include "tmweeklypcfilemanager.h"
 #include "terminaloutputhelper.h"
 #include "scriptrunnerbindinghelper.h"
+#include "filetransfer.h"
+#include "printmanifeststore.h"
+#include "databaseexecutor.h"
 #include <QSettings>
 #include <QDate>
 #include <QDir>
@@ -27,28 +30,24 @@
 #include <QApplication>
 #include <QHeaderView>
 #include <QDateTime>
-#include <QJsonArray>
-#include <QJsonDocument>
-#include <QJsonObject>
 #include <QIODevice>
 #include <QFontMetrics>
 #include <QFile>
-#include <QStandardPaths>
-#include <QSaveFile>
 #include <QTimer>
 #include <QToolButton>
+#include "configmanager.h"
 #include "logger.h"
 
-class FormattedSqlModel : public QSqlTableModel {
+class FormattedSqlModel : public TrackerTableModel {
 public:
     FormattedSqlModel(QObject *parent, QSqlDatabase db, TMWeeklyPCController *ctrl)
-        : QSqlTableModel(parent, db), controller(ctrl) {}
+        : TrackerTableModel(parent, db), controller(ctrl) {}
     QVariant data(const QModelIndex &idx, int role = Qt::DisplayRole) const override {
         if (role == Qt::DisplayRole) {
-            QVariant val = QSqlTableModel::data(idx, role);
+            QVariant val = TrackerTableModel::data(idx, role);
             return controller->formatCellData(idx.column(), val.toString());
         }
-        return QSqlTableModel::data(idx, role);
+        return TrackerTableModel::data(idx, role);
     }
 private:
     TMWeeklyPCController *controller;
@@ -114,11 +113,10 @@ TMWeeklyPCController::TMWeeklyPCController(QObject *parent)
     m_currentHtmlState(UninitializedState),
     m_lastExecutedScript(),
     m_capturedNASPath(),
-    m_capturingNASPath(false),
     m_capturedPostPrintFiles(),
-    m_capturingPostPrintFiles(false),
     m_printSessionStartUtcMs(0),
-    m_printBaselineManifestPath(),
+    m_printSessionId(0),
+    m_loadJobRequest(0),
     m_postPrintFailureReason(),
     m_trackerModel(nullptr)
 {
@@ -154,6 +152,8 @@ TMWeeklyPCController::TMWeeklyPCController(QObject *parent)
 
     // Create a script runner
     m_scriptRunner = new ScriptRunner(this);
+    // Multi-step workflows benefit most from a warm Python host (opt-in)
+    m_scriptRunner->setWarmPythonEnabled(ConfigManager::instance().getBool("scripts/warmPythonHost", false));
 
     // Get file manager - direct creation instead of using the factory
     // Use a new QSettings instance since DatabaseManager doesn't provide getSettings
@@ -163,10 +163,14 @@ TMWeeklyPCController::TMWeeklyPCController(QObject *parent)
     if (m_dbManager && m_dbManager->isInitialized()) {
         m_trackerModel = new FormattedSqlModel(this, m_dbManager->getDatabase(), this);
         m_trackerModel->setTable("tm_weekly_log");
-        m_trackerModel->setEditStrategy(QSqlTableModel::OnManualSubmit);
         // CRITICAL FIX: Set sort order immediately to show newest entries at top
         m_trackerModel->setSort(0, Qt::DescendingOrder);
         m_trackerModel->select();
+        connect(m_trackerModel, &TrackerTableModel::selectFinished, this, [this](bool ok) {
+            if (!ok) {
+                outputToTerminal("Tracker refresh failed: " + m_trackerModel->lastError(), Error);
+            }
+        });
     } else {
         Logger::instance().warning("Cannot setup tracker model - database not available");
         m_trackerModel = nullptr;
@@ -256,11 +260,6 @@ void TMWeeklyPCController::setupOptimizedTableLayout()
     tableFont.setWeight(QFont::Normal);
     m_tracker->setFont(tableFont);
 
-    // CRITICAL FIX: Always sort by ID in descending order to show newest entries at top
-    // This setting should persist across all operations and not be affected by application state
-    m_trackerModel->setSort(0, Qt::DescendingOrder);
-    m_trackerModel->select();
-
     m_trackerModel->setHeaderData(1, Qt::Horizontal, tr("JOB"));
     m_trackerModel->setHeaderData(2, Qt::Horizontal, tr("DESCRIPTION"));
     m_trackerModel->setHeaderData(3, Qt::Horizontal, tr("POSTAGE"));
@@ -475,6 +474,10 @@ void TMWeeklyPCController::connectSignals()
             this,
             [this](const QString& output) { onScriptOutput(output); },
             [this](int exitCode, QProcess::ExitStatus exitStatus) { onScriptFinished(exitCode, exitStatus); });
+
+        // Post Print reports its outputs and failure reason as events
+        connect(m_scriptRunner, &ScriptRunner::scriptFileProduced, this, &TMWeeklyPCController::onScriptFileProduced);
+        connect(m_scriptRunner, &ScriptRunner::scriptResult, this, &TMWeeklyPCController::onScriptResult);
     }
 
     // FIXED: Connect postage fields to auto-save with null pointer checks
@@ -773,13 +776,21 @@ void TMWeeklyPCController::loadJobState()
         return;
     }
 
-    bool proofApprovalChecked, jobDataLocked, postageDataLocked;
-    int htmlDisplayState;
-    QString postage, count, mailClass, permit;
+    applyJobState(m_tmWeeklyPCDBManager->loadJobState(year, month, week));
+}
 
-    if (m_tmWeeklyPCDBManager->loadJobState(year, month, week, proofApprovalChecked, htmlDisplayState,
-                                            jobDataLocked, postageDataLocked,
-                                            postage, count, mailClass, permit)) {
+void TMWeeklyPCController::applyJobState(const TMWeeklyPCJobState& state)
+{
+    const bool proofApprovalChecked = state.proofApprovalChecked;
+    const int htmlDisplayState = state.htmlDisplayState;
+    const bool jobDataLocked = state.jobDataLocked;
+    const bool postageDataLocked = state.postageDataLocked;
+    const QString& postage = state.postage;
+    const QString& count = state.count;
+    const QString& mailClass = state.mailClass;
+    const QString& permit = state.permit;
+
+    if (state.found) {
         // Restore proof approval checkbox
         if (m_proofApprovalCheckBox) {
             m_proofApprovalCheckBox->setChecked(proofApprovalChecked);
@@ -919,11 +930,7 @@ void TMWeeklyPCController::onLockButtonClicked()
 
         // CRITICAL FIX: Copy files from HOME folder to JOB folder when locking new job
         outputToTerminal("Copying files from HOME to JOB folder...", Info);
-        if (copyFilesFromHomeFolder()) {
-            outputToTerminal("Files copied successfully from HOME to JOB folder", Success);
-        } else {
-            outputToTerminal("No existing files to copy (normal for new jobs)", Info);
-        }
+        copyFilesFromHomeFolder();
 
         // Save to database
         saveJobToDatabase();
@@ -998,8 +1005,7 @@ void TMWeeklyPCController::onPostageLockButtonClicked()
     // Save job state whenever postage lock button is clicked (includes lock state)
     saveJobState();
     updateControlStates();
-    // Ensure tracker reflects DB changes immediately (both lock and unlock)
-    refreshTrackerTable();
+    // The tracker row written by addLogEntry() is applied there; nothing else here touches the log
 }
 
 void TMWeeklyPCController::savePostageData()
@@ -1039,11 +1045,18 @@ void TMWeeklyPCController::loadPostageData(const QString& year, const QString& m
         return;
     }
 
-    QString postage, count, mailClass, permit;
-    bool postageDataLocked;
+    applyPostageData(m_tmWeeklyPCDBManager->loadPostageDataOrLog(actualYear, actualMonth, actualWeek));
+}
+
+void TMWeeklyPCController::applyPostageData(const TMWeeklyPCPostageData& data)
+{
+    const QString& postage = data.postage;
+    const QString& count = data.count;
+    const QString& mailClass = data.mailClass;
+    const QString& permit = data.permit;
+    const bool postageDataLocked = data.locked;
 
-    if (m_tmWeeklyPCDBManager->loadPostageData(actualYear, actualMonth, actualWeek, postage, count,
-                                               mailClass, permit, postageDataLocked)) {
+    if (data.found && !data.fromLog) {
         // CRITICAL DEBUG: Log exactly what data was loaded before setting widgets
         outputToTerminal(QString("DEBUG: About to populate widgets with - Postage: '%1', Count: '%2', Class: '%3', Permit: '%4'")
                            .arg(postage, count, mailClass, permit), Info);
@@ -1093,10 +1106,11 @@ void TMWeeklyPCController::loadPostageData(const QString& year, const QString& m
         // FALLBACK: Try to load postage data from log table if postage table lookup failed
         outputToTerminal("Primary postage data not found, trying fallback from log table...", Warning);
         
-        QString fallbackPostage, fallbackCount, fallbackMailClass, fallbackPermit;
-        if (m_tmWeeklyPCDBManager->loadPostageDataFromLog(actualYear, actualMonth, actualWeek,
-                                                          fallbackPostage, fallbackCount,
-                                                          fallbackMailClass, fallbackPermit)) {
+        const QString& fallbackPostage = data.postage;
+        const QString& fallbackCount = data.count;
+        const QString& fallbackMailClass = data.mailClass;
+        const QString& fallbackPermit = data.permit;
+        if (data.fromLog) {
             // CRITICAL DEBUG: Log what fallback data was found
             outputToTerminal(QString("DEBUG FALLBACK: Found data - Postage: '%1', Count: '%2', Class: '%3', Permit: '%4'")
                                .arg(fallbackPostage, fallbackCount, fallbackMailClass, fallbackPermit), Info);
@@ -1143,18 +1157,52 @@ void TMWeeklyPCController::onScriptStarted()
 
 void TMWeeklyPCController::onScriptOutput(const QString& output)
 {
-    // Parse output for special markers
-    parseScriptOutput(output);
+    if (m_lastExecutedScript == "postprint") {
+        parsePostPrintMarkers(output);
+    }
 
     // Display output in terminal
     outputToTerminal(output, Info);
 }
 
+void TMWeeklyPCController::onScriptFileProduced(const QString& path, const QString& kind)
+{
+    if (kind == "postprint") {
+        m_postPrintOutputEventSeen = true;
+        m_capturedPostPrintFiles.append(path);
+        outputToTerminal("Captured post-print file: " + path, Success);
+    } else if (kind == "output_dir") {
+        m_postPrintOutputEventSeen = true;
+        m_capturedNASPath = path;
+        outputToTerminal("Captured NAS path: " + m_capturedNASPath, Success);
+    }
+}
+
+void TMWeeklyPCController::onScriptResult(const QJsonObject& result)
+{
+    m_postPrintResultEventSeen = true;
+    if (result.value("ok").toBool()) {
+        return;
+    }
+
+    // Same "CODE|detail" form showPostPrintFailureWarning() parses
+    const QString reason = result.value("reason").toString().trimmed();
+    const QString detail = result.value("detail").toString().trimmed();
+    if (!reason.isEmpty()) {
+        m_postPrintFailureReason = detail.isEmpty() ? reason : reason + "|" + detail;
+        outputToTerminal("Captured post-print failure reason: " + m_postPrintFailureReason, Warning);
+    }
+}
+
 void TMWeeklyPCController::onScriptFinished(int exitCode, QProcess::ExitStatus exitStatus)
 {
     // Re-enable run controls according to the current UI state gates.
     updateControlStates();
 
+    if (m_lastExecutedScript == "postprint") {
+        applyPostPrintMarkerFallback();
+    }
+
     if (exitCode == 0 && exitStatus == QProcess::NormalExit) {
         outputToTerminal("Script execution completed successfully.", Success);
 
@@ -1172,17 +1220,17 @@ void TMWeeklyPCController::onScriptFinished(int exitCode, QProcess::ExitStatus e
         // Clear captured path on failure
         m_capturedNASPath.clear();
         m_capturedPostPrintFiles.clear();
-        m_capturingPostPrintFiles = false;
         if (m_lastExecutedScript == "postprint") {
             showPostPrintFailureWarning(m_postPrintFailureReason);
         }
     }
 
     // Reset script tracking
-    m_capturingPostPrintFiles = false;
-    m_capturingNASPath = false;
     m_lastExecutedScript.clear();
     m_postPrintFailureReason.clear();
+    m_postPrintMarkers = PostPrintMarkers();
+    m_postPrintOutputEventSeen = false;
+    m_postPrintResultEventSeen = false;
 }
 
 void TMWeeklyPCController::onRunInitialClicked()
@@ -1375,11 +1423,7 @@ void TMWeeklyPCController::onRunPostPrintClicked()
     QString year = m_yearDDbox->currentText();
 
     // Clear any previously captured NAS path
-    m_capturedNASPath.clear();
-    m_capturingNASPath = false;
-    m_capturedPostPrintFiles.clear();
-    m_capturingPostPrintFiles = false;
-    m_postPrintFailureReason.clear();
+    clearPostPrintCapture();
     m_lastExecutedScript = "postprint";
 
     outputToTerminal(QString("Running Post Print script for job %1, week %2.%3, year %4...")
@@ -1389,6 +1433,14 @@ void TMWeeklyPCController::onRunPostPrintClicked()
     // Tracker should only be updated when runWeeklyMergedTMWPC is clicked
 
     // Run the script
+    // List PRINT before the script reads the session's changes: the watcher may still be
+    // settling a just-written PDF, and it does not report one overwritten in place
+    PrintManifestStore& manifest = PrintManifestStore::instance();
+    QString manifestError;
+    if (m_printSessionId > 0 && !manifest.syncDirectory(m_fileManager->getPrintPath(), &manifestError)) {
+        outputToTerminal("Failed to update print manifest: " + manifestError, Warning);
+    }
+
     QString scriptPath = m_fileManager->getScriptPath("postprint");
     QStringList arguments;
     arguments << jobNumber
@@ -1396,7 +1448,8 @@ void TMWeeklyPCController::onRunPostPrintClicked()
               << week
               << year
               << QString::number(m_printSessionStartUtcMs)
-              << m_printBaselineManifestPath;
+              << manifest.databasePath()
+              << QString::number(m_printSessionId);
 
     m_scriptRunner->runScript(scriptPath, arguments);
 }
@@ -1614,7 +1667,7 @@ QTableView* TMWeeklyPCController::getTrackerWidget() const
     return m_tracker;
 }
 
-QSqlTableModel* TMWeeklyPCController::getTrackerModel() const
+TrackerTableModel* TMWeeklyPCController::getTrackerModel() const
 {
     return m_trackerModel;
 }
@@ -1695,19 +1748,36 @@ void TMWeeklyPCController::saveJobToDatabase()
 }
 
 // FIXED: Enhanced loadJob to restore complete job state AND copy files
-bool TMWeeklyPCController::loadJob(const QString& year, const QString& month, const QString& week)
+void TMWeeklyPCController::loadJob(const QString& year, const QString& month, const QString& week)
 {
     if (!m_tmWeeklyPCDBManager) {
         outputToTerminal("Database manager not available", Error);
-        return false;
+        return;
     }
 
-    QString jobNumber;
-    if (m_tmWeeklyPCDBManager->loadJob(year, month, week, jobNumber)) {
-        outputToTerminal(QString("Loading job: %1 for %2-%3-%4").arg(jobNumber, year, month, week), Info);
+    // The three reads are queued in order on the database thread, so once the
+    // last one has finished the other two have as well
+    const quint64 request = ++m_loadJobRequest;
+    const QFuture<QString> jobFuture = m_tmWeeklyPCDBManager->loadJobAsync(year, month, week);
+    const QFuture<TMWeeklyPCJobState> stateFuture = m_tmWeeklyPCDBManager->loadJobStateAsync(year, month, week);
+    const QFuture<TMWeeklyPCPostageData> postageFuture =
+        m_tmWeeklyPCDBManager->loadPostageDataAsync(year, month, week);
+
+    DatabaseExecutor::then(this, postageFuture, [this, request, year, month, week, jobFuture, stateFuture](
+                               const TMWeeklyPCPostageData& postage) {
+        if (request != m_loadJobRequest) {
+            return;     // superseded by a newer loadJob() or the job was closed
+        }
+        finishLoadJob(year, month, week, jobFuture.result(), stateFuture.result(), postage);
+    });
+}
 
-        // CRITICAL DEBUG: Show what's actually in the database for this year/month
-        m_tmWeeklyPCDBManager->debugDatabaseContents(year, month);
+void TMWeeklyPCController::finishLoadJob(const QString& year, const QString& month, const QString& week,
+                                         const QString& jobNumber, const TMWeeklyPCJobState& state,
+                                         const TMWeeklyPCPostageData& postage)
+{
+    if (!jobNumber.isEmpty()) {
+        outputToTerminal(QString("Loading job: %1 for %2-%3-%4").arg(jobNumber, year, month, week), Info);
 
         // CRITICAL FIX: Block ALL dropdown signals to prevent cascade of events that
         // would cause loadJobState() to be called prematurely and clear widgets
@@ -1732,12 +1802,12 @@ bool TMWeeklyPCController::loadJob(const QString& year, const QString& month, co
         } // Signal blockers automatically released here
 
         // CRITICAL FIX: Load complete job state INCLUDING postage data and lock states
-        // Now that all dropdowns are properly set, load the job state
-        loadJobState();
+        // Now that all dropdowns are properly set, apply the job state
+        applyJobState(state);
         
-        // CRITICAL FIX: Also load postage data separately to ensure all four postage widgets are populated
+        // CRITICAL FIX: Also apply postage data separately to ensure all four postage widgets are populated
         // This is needed because postage data is stored in a separate table from job state
-        loadPostageData(year, month, week);
+        applyPostageData(postage);
 
         // If job wasn't locked when saved, set as locked since it exists in database
         if (!m_jobDataLocked) {
@@ -1747,11 +1817,7 @@ bool TMWeeklyPCController::loadJob(const QString& year, const QString& month, co
 
         // CRITICAL FIX: Copy files from home folder to JOB folder when opening job
         outputToTerminal("Copying files from HOME to JOB folder...", Info);
-        if (copyFilesFromHomeFolder()) {
-            outputToTerminal("Files copied successfully from HOME to JOB folder", Success);
-        } else {
-            outputToTerminal("Some files may not have been copied (this is normal for new jobs)", Warning);
-        }
+        copyFilesFromHomeFolder();
 
         // Update control states AFTER loading job state
         updateControlStates();
@@ -1766,10 +1832,8 @@ bool TMWeeklyPCController::loadJob(const QString& year, const QString& month, co
         outputToTerminal("Auto-save timer started (15 minutes)", Info);
 
         outputToTerminal(QString("Successfully loaded TM Weekly PC job for %1-%2-%3").arg(year, month, week), Success);
-        return true;
     } else {
         outputToTerminal(QString("No job found for %1/%2/%3").arg(year, month, week), Warning);
-        return false;
     }
 }
 
@@ -1808,12 +1872,18 @@ void TMWeeklyPCController::addLogEntry()
     QString date = now.toString("M/d/yyyy");
 
     // Add to database using the tab-specific manager
+    qint64 entryId = 0;
     if (m_tmWeeklyPCDBManager->addLogEntry(jobNumber, description, postage, formattedCount,
-                                           perPieceStr, classAbbrev, shape, permitShort, date)) {
+                                           perPieceStr, classAbbrev, shape, permitShort, date, &entryId)) {
         outputToTerminal("Added log entry to database", Success);
 
-        // Force refresh the table view
-        refreshTrackerTable();
+        // Apply just this row; the rest of the tracker is unchanged
+        if (m_trackerModel) {
+            m_trackerModel->refreshRow(entryId);
+        }
+        if (m_tracker) {
+            m_tracker->scrollToTop();
+        }
     } else {
         outputToTerminal("Failed to add log entry to database", Error);
     }
@@ -1826,17 +1896,14 @@ void TMWeeklyPCController::refreshTrackerTable()
         m_tracker->setModel(m_trackerModel);
     }
     if (m_trackerModel) {
-        // Keep newest entries on top and requery
+        // Keep newest entries on top and requery in the background; ORDER BY id uses the primary key
         m_trackerModel->setSort(0, Qt::DescendingOrder);
-        const bool ok = m_trackerModel->select();
-        if (!ok) {
-            outputToTerminal("Tracker refresh failed (select() returned false).", Error);
+        if (!m_trackerModel->select()) {
+            outputToTerminal("Tracker refresh failed: " + m_trackerModel->lastError(), Error);
             return;
         }
     }
     if (m_tracker) {
-        m_tracker->setSortingEnabled(true);
-        m_tracker->sortByColumn(0, Qt::DescendingOrder);
         m_tracker->scrollToTop();
     }
     outputToTerminal("Tracker table refreshed with newest entries at top", Info);
@@ -1865,57 +1932,60 @@ void TMWeeklyPCController::showTableContextMenu(const QPoint& pos)
     }
 }
 
-void TMWeeklyPCController::parseScriptOutput(const QString& output)
+void TMWeeklyPCController::parsePostPrintMarkers(const QString& output)
 {
+    // Markers printed by 04POSTPRINT.py alongside its events
     const QString trimmedOutput = output.trimmed();
+    PostPrintMarkers& markers = m_postPrintMarkers;
 
     if (trimmedOutput.startsWith("POSTPRINT_FAIL_REASON=")) {
-        m_postPrintFailureReason = trimmedOutput.mid(QString("POSTPRINT_FAIL_REASON=").length()).trimmed();
-        outputToTerminal("Captured post-print failure reason: " + m_postPrintFailureReason, Warning);
-        return;
-    }
-
-    // Capture exact file paths emitted by 04POSTPRINT.py.
-    if (trimmedOutput == "=== POSTPRINT_FILES ===") {
-        m_capturingPostPrintFiles = true;
-        return;
-    }
-
-    if (trimmedOutput == "=== END_POSTPRINT_FILES ===") {
-        m_capturingPostPrintFiles = false;
-        return;
-    }
-
-    if (m_capturingPostPrintFiles) {
-        if (!trimmedOutput.isEmpty()) {
-            m_capturedPostPrintFiles.append(trimmedOutput);
-            outputToTerminal("Captured post-print file: " + trimmedOutput, Success);
+        markers.failureReason = trimmedOutput.mid(QString("POSTPRINT_FAIL_REASON=").length()).trimmed();
+    } else if (trimmedOutput == "=== OUTPUT_PATH ===") {
+        markers.inOutputPath = true;
+    } else if (trimmedOutput == "=== END_OUTPUT_PATH ===") {
+        markers.inOutputPath = false;
+    } else if (trimmedOutput == "=== POSTPRINT_FILES ===") {
+        markers.inFiles = true;
+    } else if (trimmedOutput == "=== END_POSTPRINT_FILES ===") {
+        markers.inFiles = false;
+    } else if (!trimmedOutput.isEmpty()) {
+        if (markers.inOutputPath) {
+            markers.outputPath = trimmedOutput;
+        } else if (markers.inFiles) {
+            markers.files.append(trimmedOutput);
         }
-        return;
     }
+}
 
-    // Look for output path markers from the Post Print script
-    if (output.contains("=== OUTPUT_PATH ===")) {
-        m_capturingNASPath = true;
-        return;
+void TMWeeklyPCController::applyPostPrintMarkerFallback()
+{
+    // Events win; markers only fill in what the event channel did not deliver
+    // (no local socket, or goji_events could not be imported)
+    if (!m_postPrintOutputEventSeen
+        && (!m_postPrintMarkers.outputPath.isEmpty() || !m_postPrintMarkers.files.isEmpty())) {
+        m_capturedNASPath = m_postPrintMarkers.outputPath;
+        m_capturedPostPrintFiles = m_postPrintMarkers.files;
+        outputToTerminal("Post Print events unavailable; using output markers.", Info);
     }
-
-    if (output.contains("=== END_OUTPUT_PATH ===")) {
-        m_capturingNASPath = false;
-        return;
+    if (!m_postPrintResultEventSeen && m_postPrintFailureReason.isEmpty()) {
+        m_postPrintFailureReason = m_postPrintMarkers.failureReason;
     }
+}
 
-    // Capture the NAS path
-    if (m_capturingNASPath && !output.trimmed().isEmpty()) {
-        m_capturedNASPath = output.trimmed();
-        outputToTerminal("Captured NAS path: " + m_capturedNASPath, Success);
-    }
+void TMWeeklyPCController::clearPostPrintCapture()
+{
+    m_capturedNASPath.clear();
+    m_capturedPostPrintFiles.clear();
+    m_postPrintFailureReason.clear();
+    m_postPrintMarkers = PostPrintMarkers();
+    m_postPrintOutputEventSeen = false;
+    m_postPrintResultEventSeen = false;
 }
 
 void TMWeeklyPCController::clearPrintSessionContext()
 {
     m_printSessionStartUtcMs = 0;
-    m_printBaselineManifestPath.clear();
+    m_printSessionId = 0;
 }
 
 bool TMWeeklyPCController::capturePrintSessionBaseline()
@@ -1935,58 +2005,20 @@ bool TMWeeklyPCController::capturePrintSessionBaseline()
     }
 
     const qint64 sessionStartUtcMs = QDateTime::currentDateTimeUtc().toMSecsSinceEpoch();
-    const QFileInfoList pdfFiles = printDir.entryInfoList(
-        QStringList() << "*.pdf" << "*.PDF",
-        QDir::Files | QDir::NoSymLinks,
-        QDir::Name
-        );
-
-    QJsonArray filesJson;
-    for (int i = 0; i < pdfFiles.size(); ++i) {
-        const QFileInfo fileInfo = pdfFiles.at(i);
-        QJsonObject fileJson;
-        fileJson["path"] = QDir::toNativeSeparators(fileInfo.absoluteFilePath());
-        fileJson["size"] = QString::number(fileInfo.size());
-        fileJson["mtime_utc_ms"] = QString::number(fileInfo.lastModified().toUTC().toMSecsSinceEpoch());
-        filesJson.append(fileJson);
-    }
-
-    QJsonObject rootJson;
-    rootJson["session_start_utc_ms"] = QString::number(sessionStartUtcMs);
-    rootJson["files"] = filesJson;
-    const QJsonDocument doc(rootJson);
-
-    QString tempDirectory = QStandardPaths::writableLocation(QStandardPaths::TempLocation);
-    if (tempDirectory.isEmpty()) {
-        tempDirectory = QDir::tempPath();
-    }
-    QDir tempDir(tempDirectory);
-    if (!tempDir.exists() && !tempDir.mkpath(".")) {
-        outputToTerminal("Cannot capture print session baseline: temp directory is unavailable.", Error);
-        return false;
-    }
-
-    const QString manifestPath = tempDir.filePath(
-        QString("goji_tmweeklypc_postprint_baseline_%1.json").arg(sessionStartUtcMs)
-        );
-    QSaveFile manifestFile(manifestPath);
-    if (!manifestFile.open(QIODevice::WriteOnly | QIODevice::Text)) {
-        outputToTerminal("Cannot capture print session baseline: failed to open manifest file.", Error);
-        return false;
-    }
-
-    const QByteArray payload = doc.toJson(QJsonDocument::Compact);
-    if (manifestFile.write(payload) != payload.size() || !manifestFile.commit()) {
-        outputToTerminal("Cannot capture print session baseline: failed to write manifest file.", Error);
+    PrintManifestStore& manifest = PrintManifestStore::instance();
+    QString manifestError;
+    const qint64 sessionId = manifest.beginSession(printPath, sessionStartUtcMs, &manifestError);
+    if (sessionId <= 0) {
+        outputToTerminal("Cannot capture print session baseline: " + manifestError, Error);
         return false;
     }
 
     m_printSessionStartUtcMs = sessionStartUtcMs;
-    m_printBaselineManifestPath = manifestPath;
+    m_printSessionId = sessionId;
 
     outputToTerminal(
         QString("Captured print session baseline at %1 UTC with %2 PDF(s).")
-            .arg(QString::number(sessionStartUtcMs), QString::number(pdfFiles.size())),
+            .arg(QString::number(sessionStartUtcMs), QString::number(manifest.pdfCount(printPath))),
         Info
         );
     return true;
@@ -2032,7 +2064,7 @@ void TMWeeklyPCController::showPostPrintFilesDialog()
     QString outputPath = m_capturedNASPath.trimmed();
 
     if (outputPath.isEmpty()) {
-        outputToTerminal("Post Print popup suppressed: no OUTPUT_PATH marker was captured.", Warning);
+        outputToTerminal("Post Print popup suppressed: the script reported no output folder.", Warning);
         return;
     }
 
@@ -2052,6 +2084,11 @@ void TMWeeklyPCController::setTextBrowser(QTextBrowser* textBrowser)
     }
 }
 
+void TMWeeklyPCController::setScriptProgressBar(QProgressBar* progressBar)
+{
+    ScriptRunnerBindingHelper::bindProgressBar(m_scriptRunner, progressBar);
+}
+
 void TMWeeklyPCController::showNASLinkDialog()
 {
     if (m_capturedNASPath.isEmpty()) {
@@ -2135,6 +2172,7 @@ bool TMWeeklyPCController::validateJobNumber(const QString& jobNumber) const {
 // FIXED: Enhanced resetToDefaults to properly save state before reset and not force default.html
 void TMWeeklyPCController::resetToDefaults()
 {m_initializing = false;
+    ++m_loadJobRequest;     // drop the result of a job still being loaded
     m_selectedYear.clear();
     m_selectedWeek.clear();
     m_lastYear.clear();
@@ -2153,12 +2191,8 @@ void TMWeeklyPCController::resetToDefaults()
     // Reset internal state variables
     m_jobDataLocked = false;
     m_postageDataLocked = false;
-    m_capturedNASPath.clear();
-    m_capturingNASPath = false;
-    m_capturedPostPrintFiles.clear();
-    m_capturingPostPrintFiles = false;
+    clearPostPrintCapture();
     clearPrintSessionContext();
-    m_postPrintFailureReason.clear();
     m_lastExecutedScript.clear();
 
     // Clear all form fields
@@ -2201,7 +2235,7 @@ void TMWeeklyPCController::resetToDefaults()
 }
 
 // FIXED: Enhanced moveFilesToHomeFolder with better reporting
-bool TMWeeklyPCController::moveFilesToHomeFolder()
+void TMWeeklyPCController::moveFilesToHomeFolder()
 {
     QString year = m_yearDDbox ? m_yearDDbox->currentText() : "";
     QString month = m_monthDDbox ? m_monthDDbox->currentText() : "";
@@ -2209,7 +2243,7 @@ bool TMWeeklyPCController::moveFilesToHomeFolder()
 
     if (year.isEmpty() || month.isEmpty() || week.isEmpty()) {
         outputToTerminal("Cannot move files: missing year, month, or week data", Warning);
-        return false;
+        return;
     }
 
     const QString basePath = m_fileManager
@@ -2224,66 +2258,32 @@ bool TMWeeklyPCController::moveFilesToHomeFolder()
     if (!homeDir.exists()) {
         if (!homeDir.mkpath(".")) {
             outputToTerminal("Failed to create HOME folder: " + homeFolderPath, Error);
-            return false;
+            return;
         }
         outputToTerminal("Created HOME folder: " + homeFolderPath, Info);
     }
 
-    // Create subdirectories in HOME folder
-    QStringList subDirs = {"INPUT", "OUTPUT", "PROOF", "PRINT"};
-    for (int i = 0; i < subDirs.size(); ++i) {
-        const QString& subDir = subDirs.at(i);
-        QString subDirPath = homeFolderPath + "/" + subDir;
-        QDir dir(subDirPath);
-        if (!dir.exists() && !dir.mkpath(".")) {
-            outputToTerminal("Failed to create subdirectory: " + subDirPath, Error);
-            return false;
-        }
-    }
-
-    // Move files from JOB subfolders to HOME subfolders
-    bool allMoved = true;
-    int totalFilesMoved = 0;
-
-    for (int i = 0; i < subDirs.size(); ++i) {
-        const QString& subDir = subDirs.at(i);
-        QString jobSubDir = jobFolder + "/" + subDir;
-        QString homeSubDir = homeFolderPath + "/" + subDir;
-
-        QDir sourceDir(jobSubDir);
-        if (sourceDir.exists()) {
-            QStringList files = sourceDir.entryList(QDir::Files);
-            for (int j = 0; j < files.size(); ++j) {
-                const QString& fileName = files.at(j);
-                QString sourcePath = jobSubDir + "/" + fileName;
-                QString destPath = homeSubDir + "/" + fileName;
-
-                // Remove existing file in destination if it exists
-                if (QFile::exists(destPath)) {
-                    if (!QFile::remove(destPath)) {
-                        outputToTerminal("Failed to remove existing file: " + destPath, Warning);
-                    }
-                }
-
-                // Move file (rename)
-                if (!QFile::rename(sourcePath, destPath)) {
-                    outputToTerminal("Failed to move file: " + sourcePath, Error);
-                    allMoved = false;
-                } else {
-                    outputToTerminal("Moved: " + fileName + " (" + subDir + ")", Info);
-                    totalFilesMoved++;
-                }
+    // Move files from JOB subfolders to HOME subfolders (the plan creates missing subfolders)
+    FileTransferQueue::instance()->enqueue("Moving files to HOME",
+        [jobFolder, homeFolderPath]() {
+            FileTransferPlan plan;
+            plan.mode = FileTransferPlan::Mode::Move;
+            plan.addFolders(jobFolder, homeFolderPath, {"INPUT", "OUTPUT", "PROOF", "PRINT"});
+            return plan;
+        },
+        this, [this](const FileTransferResult& result) {
+            if (!result.ok) {
+                outputToTerminal(result.summary("Moved"), result.cancelled ? Warning : Error);
+                outputToTerminal("Warning: Some files may not have been moved properly", Warning);
+                return;
             }
-        }
-    }
-
-    outputToTerminal(QString("File move completed: %1 files moved to HOME folder").arg(totalFilesMoved),
-                     totalFilesMoved > 0 ? Success : Info);
-    return allMoved;
+            outputToTerminal("File move completed: " + result.summary("moved") + " to HOME folder",
+                             result.filesTransferred > 0 ? Success : Info);
+        });
 }
 
 // FIXED: Enhanced copyFilesFromHomeFolder with better error reporting and file counting
-bool TMWeeklyPCController::copyFilesFromHomeFolder()
+void TMWeeklyPCController::copyFilesFromHomeFolder()
 {
     QString year = m_yearDDbox ? m_yearDDbox->currentText() : "";
     QString month = m_monthDDbox ? m_monthDDbox->currentText() : "";
@@ -2291,7 +2291,7 @@ bool TMWeeklyPCController::copyFilesFromHomeFolder()
 
     if (year.isEmpty() || month.isEmpty() || week.isEmpty()) {
         outputToTerminal("Cannot copy files: missing year, month, or week data", Warning);
-        return false;
+        return;
     }
 
     const QString basePath = m_fileManager
@@ -2313,7 +2313,7 @@ bool TMWeeklyPCController::copyFilesFromHomeFolder()
             const QString archiveYearPath = basePath + "/ARCHIVE/" + year;
             if (!QDir().mkpath(archiveYearPath)) {
                 outputToTerminal("Failed to create archive year path: " + archiveYearPath, Error);
-                return false;
+                return;
             }
 
             if (QDir().rename(legacyHomeFolderPath, homeFolderPath)) {
@@ -2327,61 +2327,27 @@ bool TMWeeklyPCController::copyFilesFromHomeFolder()
         } else {
             outputToTerminal("HOME folder does not exist: " + homeFolderPath, Info);
             outputToTerminal("This is normal for new jobs - no files to copy", Info);
-            return true; // Not an error if no previous job exists
-        }
-    }
-
-    // Create JOB subdirectories if they don't exist
-    QStringList subDirs = {"INPUT", "OUTPUT", "PROOF", "PRINT"};
-    for (int i = 0; i < subDirs.size(); ++i) {
-        const QString& subDir = subDirs.at(i);
-        QString subDirPath = jobFolder + "/" + subDir;
-        QDir dir(subDirPath);
-        if (!dir.exists() && !dir.mkpath(".")) {
-            outputToTerminal("Failed to create JOB subdirectory: " + subDirPath, Error);
-            return false;
+            return; // Not an error if no previous job exists
         }
     }
 
-    // Copy files from HOME subfolders to JOB subfolders
-    bool allCopied = true;
-    int totalFilesCopied = 0;
-
-    for (int i = 0; i < subDirs.size(); ++i) {
-        const QString& subDir = subDirs.at(i);
-        QString homeSubDir = homeFolderPath + "/" + subDir;
-        QString jobSubDir = jobFolder + "/" + subDir;
-
-        QDir sourceDir(homeSubDir);
-        if (sourceDir.exists()) {
-            QStringList files = sourceDir.entryList(QDir::Files);
-            for (int j = 0; j < files.size(); ++j) {
-                const QString& fileName = files.at(j);
-                QString sourcePath = homeSubDir + "/" + fileName;
-                QString destPath = jobSubDir + "/" + fileName;
-
-                // Remove existing file in destination if it exists
-                if (QFile::exists(destPath)) {
-                    if (!QFile::remove(destPath)) {
-                        outputToTerminal("Failed to remove existing file: " + destPath, Warning);
-                    }
-                }
-
-                // Copy file
-                if (!QFile::copy(sourcePath, destPath)) {
-                    outputToTerminal("Failed to copy file: " + sourcePath, Error);
-                    allCopied = false;
-                } else {
-                    outputToTerminal("Copied: " + fileName + " (" + subDir + ")", Info);
-                    totalFilesCopied++;
-                }
+    // Copy files from HOME subfolders to JOB subfolders (the plan creates missing subfolders)
+    FileTransferQueue::instance()->enqueue("Copying files from HOME",
+        [homeFolderPath, jobFolder]() {
+            FileTransferPlan plan;
+            plan.mode = FileTransferPlan::Mode::Copy;
+            plan.addFolders(homeFolderPath, jobFolder, {"INPUT", "OUTPUT", "PROOF", "PRINT"});
+            return plan;
+        },
+        this, [this](const FileTransferResult& result) {
+            if (!result.ok) {
+                outputToTerminal(result.summary("Copied"), result.cancelled ? Warning : Error);
+                outputToTerminal("Some files may not have been copied (this is normal for new jobs)", Warning);
+                return;
             }
-        }
-    }
-
-    outputToTerminal(QString("File copy completed: %1 files copied").arg(totalFilesCopied),
-                     totalFilesCopied > 0 ? Success : Info);
-    return allCopied;
+            outputToTerminal("File copy completed: " + result.summary("copied"),
+                             result.filesTransferred > 0 ? Success : Info);
+        });
 }
 
 // CRITICAL FIX: Auto-save and close current job before opening a new one
@@ -2406,11 +2372,7 @@ void TMWeeklyPCController::autoSaveAndCloseCurrentJob()
             
             // CRITICAL FIX: Move files from JOB folder back to HOME folder before closing
             outputToTerminal("Moving files from JOB folder back to HOME folder...", Info);
-            if (moveFilesToHomeFolder()) {
-                outputToTerminal("Files moved successfully from JOB to HOME folder", Success);
-            } else {
-                outputToTerminal("Warning: Some files may not have been moved properly", Warning);
-            }
+            moveFilesToHomeFolder();
             
             // Clear current job state
             m_jobDataLocked = false;
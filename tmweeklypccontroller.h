@@ -12,7 +12,8 @@
 #include <QTableWidget>
 #include <QTextBrowser>
 #include <QCheckBox>
-#include <QSqlTableModel>
+#include <QProgressBar>
+#include "trackertablemodel.h"
 #include <QTimer>
 #include <QRegularExpression>
 #include <QStringList>
@@ -50,9 +51,12 @@ public:
         QTableView* tracker, QTextBrowser* textBrowser, QCheckBox* proofApprovalCheckBox
         );
 
-    // Load saved data
-    bool loadJob(const QString& year, const QString& month, const QString& week);
+    // Load saved data. The database reads run on the DatabaseExecutor thread and
+    // the tab is filled in when they finish; a missing job is reported to the
+    // terminal at that point, which is why there is no success result to return
+    void loadJob(const QString& year, const QString& month, const QString& week);
     void setTextBrowser(QTextBrowser* textBrowser);
+    void setScriptProgressBar(QProgressBar* progressBar);
     void resetToDefaults();
 
     // Public getters for external access
@@ -66,7 +70,7 @@ public:
     // BaseTrackerController implementation
     void outputToTerminal(const QString& message, MessageType type) override;
     QTableView* getTrackerWidget() const override;
-    QSqlTableModel* getTrackerModel() const override;
+    TrackerTableModel* getTrackerModel() const override;
     QStringList getTrackerHeaders() const override;
     QList<int> getVisibleColumns() const override;
     QString formatCellData(int columnIndex, const QString& cellData) const override;
@@ -109,6 +113,8 @@ private slots:
     void onScriptStarted();
     void onScriptOutput(const QString& output);
     void onScriptFinished(int exitCode, QProcess::ExitStatus exitStatus);
+    void onScriptFileProduced(const QString& path, const QString& kind);
+    void onScriptResult(const QJsonObject& result);
     void calculateMeterPostage();
 
 private:
@@ -157,15 +163,27 @@ private:
 HtmlDisplayState m_currentHtmlState;
     QString m_lastExecutedScript;
     QString m_capturedNASPath;
-    bool m_capturingNASPath;
     QStringList m_capturedPostPrintFiles;
-    bool m_capturingPostPrintFiles;
     qint64 m_printSessionStartUtcMs;
-    QString m_printBaselineManifestPath;
+    qint64 m_printSessionId;
+    quint64 m_loadJobRequest;       // bumped per loadJob(); stale async results are dropped
     QString m_postPrintFailureReason;
 
+    // Post Print outputs read from stdout markers; used only when the script's
+    // event channel delivered none (see applyPostPrintMarkerFallback)
+    struct PostPrintMarkers {
+        bool inOutputPath = false;
+        bool inFiles = false;
+        QString outputPath;
+        QStringList files;
+        QString failureReason;
+    };
+    PostPrintMarkers m_postPrintMarkers;
+    bool m_postPrintOutputEventSeen = false;
+    bool m_postPrintResultEventSeen = false;
+
     // Tracker model
-    QSqlTableModel* m_trackerModel;
+    TrackerTableModel* m_trackerModel;
 
     // Private methods
     void connectSignals();
@@ -183,8 +201,13 @@ HtmlDisplayState m_currentHtmlState;
     HtmlDisplayState determineHtmlState() const;
     void saveJobState();
     void loadJobState();
+    void applyJobState(const TMWeeklyPCJobState& state);
     void savePostageData();
     void loadPostageData(const QString& year = "", const QString& month = "", const QString& week = "");
+    void applyPostageData(const TMWeeklyPCPostageData& data);
+    void finishLoadJob(const QString& year, const QString& month, const QString& week,
+                       const QString& jobNumber, const TMWeeklyPCJobState& state,
+                       const TMWeeklyPCPostageData& postage);
     void createBaseDirectories();
     void createJobFolder();
     void saveJobToDatabase();
@@ -193,7 +216,9 @@ HtmlDisplayState m_currentHtmlState;
     void refreshTrackerTable();
 
     // Script output parsing methods
-    void parseScriptOutput(const QString& output);
+    void parsePostPrintMarkers(const QString& output);
+    void applyPostPrintMarkerFallback();
+    void clearPostPrintCapture();
     void showNASLinkDialog();
     void showPostPrintFilesDialog();
     bool capturePrintSessionBaseline();
@@ -205,16 +230,18 @@ HtmlDisplayState m_currentHtmlState;
     bool createExcelAndCopy(const QStringList& headers, const QStringList& rowData);
 
     /**
-     * @brief Move files from JOB folders to HOME folders when closing job
-     * @return True if files were moved successfully
+     * @brief Queue the move of files from JOB folders to HOME folders when closing job
+     *
+     * Runs on FileTransferQueue; the outcome is written to the terminal when it finishes.
      */
-    bool moveFilesToHomeFolder();
+    void moveFilesToHomeFolder();
 
     /**
-     * @brief Copy files from HOME folders to JOB folders when opening job
-     * @return True if files were copied successfully
+     * @brief Queue the copy of files from HOME folders to JOB folders when opening job
+     *
+     * Runs on FileTransferQueue; the outcome is written to the terminal when it finishes.
      */
-    bool copyFilesFromHomeFolder();
+    void copyFilesFromHomeFolder();
 
     /**
      * @brief Show the native Qt file manager dialog
@@ -1,5 +1,7 @@
 #include "tmweeklypcdbmanager.h"
+#include "databaseexecutor.h"
 #include "logger.h"
+#include "tracer.h"
 #include <QDebug>
 #include <QSqlQuery>
 #include <QSqlError>
@@ -24,11 +26,19 @@ TMWeeklyPCDBManager::TMWeeklyPCDBManager()
 
 bool TMWeeklyPCDBManager::initialize()
 {
+    TRACE_FUNCTION("db");
     if (!m_dbManager->isInitialized()) {
         qDebug() << "Core database manager not initialized";
         return false;
     }
-    return createTables();
+    const bool migrated = m_dbManager->applyMigrations("tm_weekly_pc", {
+        {1, "Job, log and postage tables", [this]() { return createTables(); }}
+    });
+    if (migrated) {
+        // Anything loaded before the database was ready is stale
+        m_jobIndex.invalidate();
+    }
+    return migrated;
 }
 
 bool TMWeeklyPCDBManager::createTables()
@@ -201,6 +211,7 @@ bool TMWeeklyPCDBManager::saveJob(const QString& jobNumber, const QString& year,
         qDebug() << "Last error:" << query.lastError().text();
     } else {
         qDebug() << "Job saved successfully";
+        m_jobIndex.upsert({{"job_number", jobNumber}, {"year", year}, {"month", month}, {"week", week}});
     }
 
     return result;
@@ -246,36 +257,39 @@ bool TMWeeklyPCDBManager::saveJobState(const QString& year, const QString& month
         return false;
     }
 
-    QSqlQuery query(m_dbManager->getDatabase());
-    query.prepare("UPDATE tm_weekly_pc_jobs SET "
-                  "proof_approval_checked = :proof_approval_checked, "
-                  "html_display_state = :html_display_state, "
-                  "job_data_locked = :job_data_locked, "
-                  "postage_data_locked = :postage_data_locked, "
-                  "postage = :postage, "
-                  "count = :count, "
-                  "mail_class = :mail_class, "
-                  "permit = :permit, "
-                  "updated_at = :updated_at "
-                  "WHERE year = :year AND month = :month AND week = :week");
+    QSqlQuery* query = m_dbManager->preparedQuery("tmweeklypc.saveJobState",
+                                                  "UPDATE tm_weekly_pc_jobs SET "
+                                                  "proof_approval_checked = :proof_approval_checked, "
+                                                  "html_display_state = :html_display_state, "
+                                                  "job_data_locked = :job_data_locked, "
+                                                  "postage_data_locked = :postage_data_locked, "
+                                                  "postage = :postage, "
+                                                  "count = :count, "
+                                                  "mail_class = :mail_class, "
+                                                  "permit = :permit, "
+                                                  "updated_at = :updated_at "
+                                                  "WHERE year = :year AND month = :month AND week = :week");
+    if (!query) {
+        return false;
+    }
 
-    query.bindValue(":proof_approval_checked", proofApprovalChecked ? 1 : 0);
-    query.bindValue(":html_display_state", htmlDisplayState);
-    query.bindValue(":job_data_locked", jobDataLocked ? 1 : 0);
-    query.bindValue(":postage_data_locked", postageDataLocked ? 1 : 0);
-    query.bindValue(":postage", postage);
-    query.bindValue(":count", count);
-    query.bindValue(":mail_class", mailClass);
-    query.bindValue(":permit", permit);
-    query.bindValue(":updated_at", QDateTime::currentDateTime().toString("yyyy-MM-dd hh:mm:ss"));
-    query.bindValue(":year", year);
-    query.bindValue(":month", month);
-    query.bindValue(":week", week);
+    query->bindValue(":proof_approval_checked", proofApprovalChecked ? 1 : 0);
+    query->bindValue(":html_display_state", htmlDisplayState);
+    query->bindValue(":job_data_locked", jobDataLocked ? 1 : 0);
+    query->bindValue(":postage_data_locked", postageDataLocked ? 1 : 0);
+    query->bindValue(":postage", postage);
+    query->bindValue(":count", count);
+    query->bindValue(":mail_class", mailClass);
+    query->bindValue(":permit", permit);
+    query->bindValue(":updated_at", QDateTime::currentDateTime().toString("yyyy-MM-dd hh:mm:ss"));
+    query->bindValue(":year", year);
+    query->bindValue(":month", month);
+    query->bindValue(":week", week);
 
     // Also save to separate postage table for compatibility
     savePostageData(year, month, week, postage, count, mailClass, permit, postageDataLocked);
 
-    return query.exec();
+    return m_dbManager->executeQuery(*query);
 }
 
 bool TMWeeklyPCDBManager::loadJobState(const QString& year, const QString& month, const QString& week,
@@ -289,21 +303,26 @@ bool TMWeeklyPCDBManager::loadJobState(const QString& year, const QString& month
         return false;
     }
 
-    QSqlQuery query(m_dbManager->getDatabase());
-    query.prepare("SELECT proof_approval_checked, html_display_state, "
-                  "job_data_locked, postage_data_locked, postage, count, mail_class, permit "
-                  "FROM tm_weekly_pc_jobs "
-                  "WHERE year = :year AND month = :month AND week = :week");
+    QSqlQuery* query = m_dbManager->preparedQuery("tmweeklypc.loadJobState",
+                                                  "SELECT proof_approval_checked, html_display_state, "
+                                                  "job_data_locked, postage_data_locked, postage, count, mail_class, permit "
+                                                  "FROM tm_weekly_pc_jobs "
+                                                  "WHERE year = :year AND month = :month AND week = :week");
+    if (!query) {
+        return false;
+    }
 
-    query.bindValue(":year", year);
-    query.bindValue(":month", month);
-    query.bindValue(":week", week);
+    query->bindValue(":year", year);
+    query->bindValue(":month", month);
+    query->bindValue(":week", week);
 
-    if (!query.exec()) {
+    if (!m_dbManager->executeQuery(*query)) {
         return false;
     }
 
-    if (!query.next()) {
+    if (!query->next()) {
+        query->finish();
+
         // No job found in main table, try fallback from log table
         Logger::instance().info(QString("No job state found in main table for %1/%2/%3, trying fallback from log").arg(year, month, week));
         
@@ -340,18 +359,29 @@ bool TMWeeklyPCDBManager::loadJobState(const QString& year, const QString& month
     }
 
     // Main table data found, load normally
-    proofApprovalChecked = query.value("proof_approval_checked").toInt() == 1;
-    htmlDisplayState = query.value("html_display_state").toInt();
-    jobDataLocked = query.value("job_data_locked").toInt() == 1;
-    postageDataLocked = query.value("postage_data_locked").toInt() == 1;
-    postage = query.value("postage").toString();
-    count = query.value("count").toString();
-    mailClass = query.value("mail_class").toString();
-    permit = query.value("permit").toString();
+    proofApprovalChecked = query->value("proof_approval_checked").toInt() == 1;
+    htmlDisplayState = query->value("html_display_state").toInt();
+    jobDataLocked = query->value("job_data_locked").toInt() == 1;
+    postageDataLocked = query->value("postage_data_locked").toInt() == 1;
+    postage = query->value("postage").toString();
+    count = query->value("count").toString();
+    mailClass = query->value("mail_class").toString();
+    permit = query->value("permit").toString();
+    query->finish();
 
     return true;
 }
 
+TMWeeklyPCJobState TMWeeklyPCDBManager::loadJobState(const QString& year, const QString& month,
+                                                     const QString& week)
+{
+    TMWeeklyPCJobState state;
+    state.found = loadJobState(year, month, week, state.proofApprovalChecked, state.htmlDisplayState,
+                               state.jobDataLocked, state.postageDataLocked,
+                               state.postage, state.count, state.mailClass, state.permit);
+    return state;
+}
+
 bool TMWeeklyPCDBManager::savePostageData(const QString& year, const QString& month, const QString& week,
                                           const QString& postage, const QString& count, const QString& mailClass,
                                           const QString& permit, bool locked)
@@ -362,28 +392,30 @@ bool TMWeeklyPCDBManager::savePostageData(const QString& year, const QString& mo
         return false;
     }
 
-    QSqlQuery query(m_dbManager->getDatabase());
-    query.prepare(R"(
+    QSqlQuery* query = m_dbManager->preparedQuery("tmweeklypc.savePostageData", R"(
         INSERT OR REPLACE INTO tm_weekly_pc_postage
         (year, month, week, postage, count, mail_class, permit, locked, updated_at)
         VALUES (:year, :month, :week, :postage, :count, :mail_class, :permit, :locked, :updated_at)
     )");
+    if (!query) {
+        return false;
+    }
 
-    query.bindValue(":year", year);
-    query.bindValue(":month", month);
-    query.bindValue(":week", week);
-    query.bindValue(":postage", postage);
-    query.bindValue(":count", count);
-    query.bindValue(":mail_class", mailClass);
-    query.bindValue(":permit", permit);
-    query.bindValue(":locked", locked ? 1 : 0);
-    query.bindValue(":updated_at", QDateTime::currentDateTime().toString("yyyy-MM-dd hh:mm:ss"));
+    query->bindValue(":year", year);
+    query->bindValue(":month", month);
+    query->bindValue(":week", week);
+    query->bindValue(":postage", postage);
+    query->bindValue(":count", count);
+    query->bindValue(":mail_class", mailClass);
+    query->bindValue(":permit", permit);
+    query->bindValue(":locked", locked ? 1 : 0);
+    query->bindValue(":updated_at", QDateTime::currentDateTime().toString("yyyy-MM-dd hh:mm:ss"));
 
-    bool success = query.exec();
+    bool success = m_dbManager->executeQuery(*query);
     if (success) {
         Logger::instance().info(QString("TMWeeklyPC postage data saved for %1/%2/%3").arg(year, month, week));
     } else {
-        qDebug() << "Query failed:" << query.lastError().text();
+        qDebug() << "Query failed:" << query->lastError().text();
         Logger::instance().error(QString("Failed to save TMWeeklyPC postage data for %1/%2/%3").arg(year, month, week));
     }
 
@@ -450,7 +482,12 @@ bool TMWeeklyPCDBManager::deleteJob(const QString& year, const QString& month, c
     query.bindValue(":month", month);
     query.bindValue(":week", week);
 
-    return query.exec();
+    if (!query.exec()) {
+        return false;
+    }
+
+    m_jobIndex.remove({{"year", year}, {"month", month}, {"week", week}});
+    return true;
 }
 
 bool TMWeeklyPCDBManager::jobExists(const QString& year, const QString& month, const QString& week)
@@ -505,58 +542,72 @@ bool TMWeeklyPCDBManager::addLogEntry(const QString& jobNumber, const QString& d
                                       const QString& postage, const QString& count,
                                       const QString& perPiece, const QString& mailClass,
                                       const QString& shape, const QString& permit,
-                                      const QString& date)
+                                      const QString& date, qint64* entryId)
 {
     if (!m_dbManager->isInitialized()) {
         qDebug() << "Database not initialized";
         return false;
     }
 
-    QSqlQuery query(m_dbManager->getDatabase());
-
     // CRITICAL FIX: Check if an entry for this specific job + description combination already exists
     // This prevents overwriting different dates for the same job number
-    query.prepare("SELECT id FROM tm_weekly_log WHERE job_number = :job_number AND description = :description");
-    query.bindValue(":job_number", jobNumber);
-    query.bindValue(":description", description);
+    QSqlQuery* lookup = m_dbManager->preparedQuery("tmweeklypc.findLogEntry",
+                                                   "SELECT id FROM tm_weekly_log WHERE job_number = :job_number AND description = :description");
+    if (!lookup) {
+        return false;
+    }
 
-    if (!query.exec()) {
-        qDebug() << "Failed to check existing log entry:" << query.lastError().text();
+    lookup->bindValue(":job_number", jobNumber);
+    lookup->bindValue(":description", description);
+
+    if (!m_dbManager->executeQuery(*lookup)) {
+        qDebug() << "Failed to check existing log entry:" << lookup->lastError().text();
         return false;
     }
 
-    if (query.next()) {
+    const bool exists = lookup->next();
+    const int id = exists ? lookup->value(0).toInt() : -1;
+    lookup->finish();
+
+    QSqlQuery* query = nullptr;
+    if (exists) {
         // Entry exists, update it
-        int id = query.value(0).toInt();
-        query.prepare("UPDATE tm_weekly_log SET description = :description, postage = :postage, "
-                      "count = :count, per_piece = :per_piece, class = :class, shape = :shape, "
-                      "permit = :permit, date = :date WHERE id = :id");
-        query.bindValue(":description", description);
-        query.bindValue(":postage", postage);
-        query.bindValue(":count", count);
-        query.bindValue(":per_piece", perPiece);
-        query.bindValue(":class", mailClass);
-        query.bindValue(":shape", shape);
-        query.bindValue(":permit", permit);
-        query.bindValue(":date", date);
-        query.bindValue(":id", id);
+        query = m_dbManager->preparedQuery("tmweeklypc.updateLogEntry",
+                                           "UPDATE tm_weekly_log SET description = :description, postage = :postage, "
+                                           "count = :count, per_piece = :per_piece, class = :class, shape = :shape, "
+                                           "permit = :permit, date = :date WHERE id = :id");
+        if (!query) {
+            return false;
+        }
+        query->bindValue(":id", id);
     } else {
         // No entry exists, insert new one
-        query.prepare("INSERT INTO tm_weekly_log "
-                      "(job_number, description, postage, count, per_piece, class, shape, permit, date) "
-                      "VALUES (:job_number, :description, :postage, :count, :per_piece, :class, :shape, :permit, :date)");
-        query.bindValue(":job_number", jobNumber);
-        query.bindValue(":description", description);
-        query.bindValue(":postage", postage);
-        query.bindValue(":count", count);
-        query.bindValue(":per_piece", perPiece);
-        query.bindValue(":class", mailClass);
-        query.bindValue(":shape", shape);
-        query.bindValue(":permit", permit);
-        query.bindValue(":date", date);
-    }
-
-    return query.exec();
+        query = m_dbManager->preparedQuery("tmweeklypc.insertLogEntry",
+                                           "INSERT INTO tm_weekly_log "
+                                           "(job_number, description, postage, count, per_piece, class, shape, permit, date) "
+                                           "VALUES (:job_number, :description, :postage, :count, :per_piece, :class, :shape, :permit, :date)");
+        if (!query) {
+            return false;
+        }
+        query->bindValue(":job_number", jobNumber);
+    }
+
+    query->bindValue(":description", description);
+    query->bindValue(":postage", postage);
+    query->bindValue(":count", count);
+    query->bindValue(":per_piece", perPiece);
+    query->bindValue(":class", mailClass);
+    query->bindValue(":shape", shape);
+    query->bindValue(":permit", permit);
+    query->bindValue(":date", date);
+
+    if (!m_dbManager->executeQuery(*query)) {
+        return false;
+    }
+    if (entryId) {
+        *entryId = exists ? id : query->lastInsertId().toLongLong();
+    }
+    return true;
 }
 
 QList<QMap<QString, QVariant>> TMWeeklyPCDBManager::getLog()
@@ -744,6 +795,65 @@ bool TMWeeklyPCDBManager::loadPostageDataFromLog(const QString& year, const QStr
     return true;
 }
 
+TMWeeklyPCPostageData TMWeeklyPCDBManager::loadPostageDataOrLog(const QString& year, const QString& month,
+                                                                const QString& week)
+{
+    TMWeeklyPCPostageData data;
+    data.found = loadPostageData(year, month, week, data.postage, data.count, data.mailClass,
+                                 data.permit, data.locked);
+    if (!data.found) {
+        data.locked = false;
+        data.fromLog = loadPostageDataFromLog(year, month, week, data.postage, data.count,
+                                              data.mailClass, data.permit);
+        data.found = data.fromLog;
+    }
+    return data;
+}
+
+QFuture<QString> TMWeeklyPCDBManager::loadJobAsync(const QString& year, const QString& month, const QString& week)
+{
+    return DatabaseExecutor::instance().run("TMWeeklyPCDBManager::loadJobAsync", [this, year, month, week]() {
+        QString jobNumber;
+        return loadJob(year, month, week, jobNumber) ? jobNumber : QString();
+    });
+}
+
+QFuture<TMWeeklyPCJobState> TMWeeklyPCDBManager::loadJobStateAsync(const QString& year, const QString& month,
+                                                                   const QString& week)
+{
+    return DatabaseExecutor::instance().run("TMWeeklyPCDBManager::loadJobStateAsync", [this, year, month, week]() {
+        return loadJobState(year, month, week);
+    });
+}
+
+QFuture<TMWeeklyPCPostageData> TMWeeklyPCDBManager::loadPostageDataAsync(const QString& year, const QString& month,
+                                                                         const QString& week)
+{
+    return DatabaseExecutor::instance().run("TMWeeklyPCDBManager::loadPostageDataAsync", [this, year, month, week]() {
+        return loadPostageDataOrLog(year, month, week);
+    });
+}
+
+QFuture<QList<QMap<QString, QString>>> TMWeeklyPCDBManager::getAllJobsAsync()
+{
+    return DatabaseExecutor::instance().run("TMWeeklyPCDBManager::getAllJobsAsync", [this]() {
+        return getAllJobs();
+    });
+}
+
+void TMWeeklyPCDBManager::primeJobIndexAsync(QObject* context)
+{
+    if (m_jobIndex.isLoaded()) {
+        return;
+    }
+
+    // The index is only touched on the GUI thread; the task just reads rows
+    const quint64 writeCount = m_jobIndex.writeCount();
+    DatabaseExecutor::then(context, getAllJobsAsync(), [this, writeCount](const QList<QMap<QString, QString>>& jobs) {
+        m_jobIndex.prime(jobs, writeCount);
+    });
+}
+
 bool TMWeeklyPCDBManager::updateLogJobNumber(const QString& oldJobNumber, const QString& newJobNumber)
 {
     if (!m_dbManager->isInitialized()) {
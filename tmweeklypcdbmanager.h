@@ -5,7 +5,38 @@
 #include <QList>
 #include <QMap>
 #include <QVariant>
+#include <QFuture>
+#include <QObject>
 #include "databasemanager.h"
+#include "jobindex.h"
+
+/**
+ * @brief Saved UI state of one TM WEEKLY PC job
+ */
+struct TMWeeklyPCJobState {
+    bool found = false;
+    bool proofApprovalChecked = false;
+    int htmlDisplayState = 0;
+    bool jobDataLocked = false;
+    bool postageDataLocked = false;
+    QString postage;
+    QString count;
+    QString mailClass;
+    QString permit;
+};
+
+/**
+ * @brief Postage fields of one week, from the postage table or (fallback) the log
+ */
+struct TMWeeklyPCPostageData {
+    bool found = false;
+    bool fromLog = false;
+    QString postage;
+    QString count;
+    QString mailClass;
+    QString permit;
+    bool locked = false;
+};
 
 class TMWeeklyPCDBManager
 {
@@ -24,6 +55,7 @@ public:
     bool deleteJob(const QString& year, const QString& month, const QString& week);
     bool jobExists(const QString& year, const QString& month, const QString& week);
     QList<QMap<QString, QString>> getAllJobs();
+    JobIndex& jobIndex() { return m_jobIndex; }   // cached getAllJobs() for the Open Job menu
 
     // Job state operations (for UI state persistence)
     bool saveJobState(const QString& year, const QString& month, const QString& week,
@@ -37,6 +69,8 @@ public:
                       QString& postage, QString& count,
                       QString& mailClass, QString& permit);
 
+    TMWeeklyPCJobState loadJobState(const QString& year, const QString& month, const QString& week);
+
     // Postage data operations (for persistent postage field storage)
     bool savePostageData(const QString& year, const QString& month, const QString& week,
                          const QString& postage, const QString& count, const QString& mailClass,
@@ -44,13 +78,25 @@ public:
     bool loadPostageData(const QString& year, const QString& month, const QString& week,
                          QString& postage, QString& count, QString& mailClass,
                          QString& permit, bool& locked);
+    TMWeeklyPCPostageData loadPostageDataOrLog(const QString& year, const QString& month, const QString& week);
+
+    // Async variants: run on the DatabaseExecutor thread; results arrive through
+    // DatabaseExecutor::then() (loadJobAsync yields an empty job number if none)
+    QFuture<QString> loadJobAsync(const QString& year, const QString& month, const QString& week);
+    QFuture<TMWeeklyPCJobState> loadJobStateAsync(const QString& year, const QString& month, const QString& week);
+    QFuture<TMWeeklyPCPostageData> loadPostageDataAsync(const QString& year, const QString& month,
+                                                        const QString& week);
+    QFuture<QList<QMap<QString, QString>>> getAllJobsAsync();
+
+    // Fill jobIndex() from getAllJobsAsync() so the first Open Job menu needs no query
+    void primeJobIndexAsync(QObject* context);
 
     // Log operations - updated signature to match implementation
     bool addLogEntry(const QString& jobNumber, const QString& description,
                      const QString& postage, const QString& count,
                      const QString& perPiece, const QString& mailClass,
                      const QString& shape, const QString& permit,
-                     const QString& date);
+                     const QString& date, qint64* entryId = nullptr);
 
     bool updateLogJobNumber(const QString& oldJobNumber, const QString& newJobNumber);
 
@@ -99,6 +145,8 @@ private:
 
     // Constants
     const QString TAB_NAME = "TM_WEEKLY_PC";
+
+    JobIndex m_jobIndex { {"year", "month", "week"}, [this]() { return getAllJobs(); } };
 };
 
 #endif // TMWEEKLYPCDBMANAGER_H
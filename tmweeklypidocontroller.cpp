@@ -16,6 +16,7 @@
 #include <QRegularExpression>
 #include <memory>  // For std::unique_ptr
 #include <utility> // For std::as_const
+#include "configmanager.h"
 #include "logger.h"
 #include "fileutils.h"
 #include "dropbindinghelper.h"
@@ -75,6 +76,8 @@ TMWeeklyPIDOController::TMWeeklyPIDOController(QObject *parent)
 
     // Create a script runner
     m_scriptRunner = new ScriptRunner(this);
+    // Multi-step workflows benefit most from a warm Python host (opt-in)
+    m_scriptRunner->setWarmPythonEnabled(ConfigManager::instance().getBool("scripts/warmPythonHost", false));
 
     // Create file manager (reusing TM Weekly PC paths for now)
     m_fileManager = new TMWeeklyPCFileManager(new QSettings(QSettings::IniFormat, QSettings::UserScope, "GojiApp", "Goji"));
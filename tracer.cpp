@@ -0,0 +1,308 @@
+#include "tracer.h"
+
+#include <QCoreApplication>
+#include <QDebug>
+#include <QDateTime>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QThread>
+
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// Bounds memory for a long session (roughly 100 bytes per event plus detail)
+const size_t kMaxEventsPerThread = 500000;
+
+struct TraceEvent {
+    const char* category = nullptr;
+    const char* name = nullptr;
+    qint64 startUs = 0;
+    qint64 durationUs = -1;     // -1 marks an instant event
+    QString detail;
+};
+
+struct ThreadBuffer {
+    std::mutex mutex;
+    quint32 threadId = 0;
+    QString threadName;
+    std::vector<TraceEvent> events;
+};
+
+struct Registry {
+    std::mutex mutex;
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    quint32 nextThreadId = 1;
+    std::atomic<qint64> dropped { 0 };
+};
+
+Registry& registry()
+{
+    static Registry instance;
+    return instance;
+}
+
+QElapsedTimer& clock()
+{
+    static QElapsedTimer timer;
+    return timer;
+}
+
+// The tracer is first used from main(), before QApplication exists
+std::thread::id& mainThreadId()
+{
+    static std::thread::id id;
+    return id;
+}
+
+// The registry keeps buffers alive after their thread exits so the events still export
+ThreadBuffer& currentBuffer()
+{
+    thread_local std::shared_ptr<ThreadBuffer> buffer;
+    if (!buffer) {
+        buffer = std::make_shared<ThreadBuffer>();
+
+        QThread* thread = QThread::currentThread();
+        const bool isMain = std::this_thread::get_id() == mainThreadId();
+
+        Registry& reg = registry();
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        buffer->threadId = reg.nextThreadId++;
+        if (isMain) {
+            buffer->threadName = QStringLiteral("Main thread");
+        } else if (thread && !thread->objectName().isEmpty()) {
+            buffer->threadName = thread->objectName();
+        } else {
+            buffer->threadName = QString("Worker %1").arg(buffer->threadId);
+        }
+        reg.buffers.push_back(buffer);
+    }
+    return *buffer;
+}
+
+void record(TraceEvent&& event)
+{
+    ThreadBuffer& buffer = currentBuffer();
+    std::lock_guard<std::mutex> lock(buffer.mutex);
+    if (buffer.events.size() >= kMaxEventsPerThread) {
+        registry().dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    buffer.events.push_back(std::move(event));
+}
+
+void appendJsonString(QByteArray& out, const QString& text)
+{
+    out.append('"');
+    const QByteArray utf8 = text.toUtf8();
+    for (const char c : utf8) {
+        switch (c) {
+        case '"':  out.append("\\\""); break;
+        case '\\': out.append("\\\\"); break;
+        case '\n': out.append("\\n"); break;
+        case '\r': out.append("\\r"); break;
+        case '\t': out.append("\\t"); break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20) {
+                out.append(QString("\\u%1").arg(static_cast<int>(c), 4, 16, QChar('0')).toLatin1());
+            } else {
+                out.append(c);
+            }
+        }
+    }
+    out.append('"');
+}
+
+} // namespace
+
+std::atomic<bool> Tracer::s_enabled { false };
+
+Tracer& Tracer::instance()
+{
+    static Tracer tracer;
+    return tracer;
+}
+
+Tracer::Tracer()
+{
+    mainThreadId() = std::this_thread::get_id();
+    clock().start();
+}
+
+void Tracer::setEnabled(bool enabled)
+{
+    s_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+void Tracer::configureFromEnvironment()
+{
+    const QString value = qEnvironmentVariable("GOJI_TRACE").trimmed();
+    if (value.isEmpty() || value == "0" || value.compare("false", Qt::CaseInsensitive) == 0
+        || value.compare("off", Qt::CaseInsensitive) == 0) {
+        return;
+    }
+
+    m_exitTraceRequested = true;
+    const bool flag = value == "1" || value.compare("true", Qt::CaseInsensitive) == 0
+                      || value.compare("on", Qt::CaseInsensitive) == 0;
+    m_exitTracePath = flag ? QString() : value;
+    setEnabled(true);
+}
+
+QString Tracer::writeExitTrace()
+{
+    if (!m_exitTraceRequested) {
+        return QString();
+    }
+
+    QString path = m_exitTracePath;
+    if (path.isEmpty()) {
+        // Same directory main.cpp uses for the session log
+        const QString logDir = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + "/logs";
+        QDir().mkpath(logDir);
+        path = QString("%1/goji_trace_%2.json")
+                   .arg(logDir, QDateTime::currentDateTime().toString("yyyyMMdd_hhmmss"));
+    }
+
+    QString error;
+    if (!exportChromeTrace(path, &error)) {
+        qWarning() << "Failed to write trace:" << error;
+        return QString();
+    }
+    return path;
+}
+
+qint64 Tracer::nowUs() const
+{
+    return clock().nsecsElapsed() / 1000;
+}
+
+void Tracer::addComplete(const char* category, const char* name, qint64 startUs, qint64 durationUs,
+                         const QString& detail)
+{
+    TraceEvent event;
+    event.category = category;
+    event.name = name;
+    event.startUs = startUs;
+    event.durationUs = durationUs < 0 ? 0 : durationUs;
+    event.detail = detail;
+    record(std::move(event));
+}
+
+void Tracer::addInstant(const char* category, const char* name, const QString& detail)
+{
+    if (!isEnabled()) {
+        return;
+    }
+
+    TraceEvent event;
+    event.category = category;
+    event.name = name;
+    event.startUs = nowUs();
+    event.detail = detail;
+    record(std::move(event));
+}
+
+qint64 Tracer::eventCount() const
+{
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    qint64 count = 0;
+    for (const auto& buffer : reg.buffers) {
+        std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+        count += static_cast<qint64>(buffer->events.size());
+    }
+    return count;
+}
+
+qint64 Tracer::droppedEventCount() const
+{
+    return registry().dropped.load(std::memory_order_relaxed);
+}
+
+void Tracer::clear()
+{
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    for (const auto& buffer : reg.buffers) {
+        std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+        buffer->events.clear();
+    }
+    reg.dropped.store(0, std::memory_order_relaxed);
+}
+
+bool Tracer::exportChromeTrace(const QString& filePath, QString* error) const
+{
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        if (error) {
+            *error = QString("Cannot open %1: %2").arg(filePath, file.errorString());
+        }
+        return false;
+    }
+
+    const QByteArray pid = QByteArray::number(QCoreApplication::applicationPid());
+    QByteArray out;
+    out.reserve(1 << 20);
+    out.append("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    bool first = true;
+
+    const auto flushIfLarge = [&file, &out]() {
+        if (out.size() >= (1 << 20)) {
+            file.write(out);
+            out.clear();
+        }
+    };
+
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    for (const auto& buffer : reg.buffers) {
+        std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+        const QByteArray tid = QByteArray::number(buffer->threadId);
+
+        if (!first) {
+            out.append(",\n");
+        }
+        first = false;
+        out.append("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":").append(pid)
+            .append(",\"tid\":").append(tid).append(",\"args\":{\"name\":");
+        appendJsonString(out, buffer->threadName);
+        out.append("}}");
+
+        for (const TraceEvent& event : buffer->events) {
+            out.append(",\n{\"name\":");
+            appendJsonString(out, QString::fromUtf8(event.name));
+            out.append(",\"cat\":");
+            appendJsonString(out, QString::fromUtf8(event.category));
+            if (event.durationUs >= 0) {
+                out.append(",\"ph\":\"X\",\"ts\":").append(QByteArray::number(event.startUs))
+                    .append(",\"dur\":").append(QByteArray::number(event.durationUs));
+            } else {
+                out.append(",\"ph\":\"i\",\"s\":\"t\",\"ts\":").append(QByteArray::number(event.startUs));
+            }
+            out.append(",\"pid\":").append(pid).append(",\"tid\":").append(tid);
+            if (!event.detail.isEmpty()) {
+                out.append(",\"args\":{\"detail\":");
+                appendJsonString(out, event.detail);
+                out.append('}');
+            }
+            out.append('}');
+            flushIfLarge();
+        }
+    }
+    out.append("\n]}\n");
+    file.write(out);
+
+    if (!file.commit()) {
+        if (error) {
+            *error = QString("Cannot write %1: %2").arg(filePath, file.errorString());
+        }
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,159 @@
+#ifndef TRACER_H
+#define TRACER_H
+
+#include <QString>
+#include <atomic>
+
+/**
+ * @brief Process-wide span recorder with Chrome trace-event export
+ *
+ * Spans are recorded into per-thread buffers, so recording threads never
+ * contend with each other. While tracing is disabled a span costs one
+ * relaxed atomic load. The recorded events can be written as a JSON file
+ * that chrome://tracing, Perfetto or Edge's about:tracing can open.
+ *
+ * Tracing is off by default. Setting GOJI_TRACE=1 enables it from startup
+ * and writes goji_trace_<timestamp>.json to the log directory on exit;
+ * setting GOJI_TRACE to a file path writes the trace there instead.
+ *
+ * Event names and categories must be string literals (or otherwise outlive
+ * the tracer); only the optional detail text is copied.
+ */
+class Tracer
+{
+public:
+    /**
+     * @brief Get the singleton instance
+     * @return Reference to the Tracer instance
+     */
+    static Tracer& instance();
+
+    /**
+     * @brief Whether spans are currently being recorded
+     */
+    static bool isEnabled() { return s_enabled.load(std::memory_order_relaxed); }
+
+    void setEnabled(bool enabled);
+
+    /**
+     * @brief Apply the GOJI_TRACE environment variable
+     *
+     * Call as early as possible in main() so startup is covered.
+     */
+    void configureFromEnvironment();
+
+    /**
+     * @brief Write the trace requested through GOJI_TRACE, if any
+     * @return Path written, or an empty string if nothing was written
+     */
+    QString writeExitTrace();
+
+    /**
+     * @brief Microseconds since the tracer was created (monotonic)
+     */
+    qint64 nowUs() const;
+
+    /**
+     * @brief Record a finished span on the calling thread
+     * @param category Event category (string literal)
+     * @param name Event name (string literal)
+     * @param startUs Start time from nowUs()
+     * @param durationUs Duration in microseconds
+     * @param detail Optional text shown in the event's args
+     */
+    void addComplete(const char* category, const char* name, qint64 startUs, qint64 durationUs,
+                     const QString& detail = QString());
+
+    /**
+     * @brief Record a point-in-time marker on the calling thread
+     */
+    void addInstant(const char* category, const char* name, const QString& detail = QString());
+
+    /**
+     * @brief Number of events currently held across all threads
+     */
+    qint64 eventCount() const;
+
+    /**
+     * @brief Number of events dropped because a thread's buffer was full
+     */
+    qint64 droppedEventCount() const;
+
+    /**
+     * @brief Discard all recorded events
+     */
+    void clear();
+
+    /**
+     * @brief Write all recorded events in Chrome trace-event JSON format
+     * @param filePath Destination file (replaced atomically)
+     * @param error Receives a description on failure
+     * @return True if the file was written
+     */
+    bool exportChromeTrace(const QString& filePath, QString* error = nullptr) const;
+
+private:
+    Tracer();
+    ~Tracer() = default;
+
+    Tracer(const Tracer&) = delete;
+    Tracer& operator=(const Tracer&) = delete;
+
+    static std::atomic<bool> s_enabled;
+    QString m_exitTracePath;
+    bool m_exitTraceRequested = false;
+};
+
+/**
+ * @brief RAII span: records the time between construction and destruction
+ *
+ * Does nothing unless tracing was enabled when the span was created.
+ */
+class TraceSpan
+{
+public:
+    TraceSpan(const char* category, const char* name)
+        : m_category(category)
+        , m_name(name)
+        , m_startUs(Tracer::isEnabled() ? Tracer::instance().nowUs() : -1)
+    {
+    }
+
+    ~TraceSpan()
+    {
+        if (m_startUs >= 0) {
+            Tracer& tracer = Tracer::instance();
+            tracer.addComplete(m_category, m_name, m_startUs, tracer.nowUs() - m_startUs, m_detail);
+        }
+    }
+
+    bool isActive() const { return m_startUs >= 0; }
+    void setDetail(const QString& detail) { m_detail = detail; }
+
+private:
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+
+    const char* m_category;
+    const char* m_name;
+    qint64 m_startUs;
+    QString m_detail;
+};
+
+#define GOJI_TRACE_CONCAT_INNER(a, b) a##b
+#define GOJI_TRACE_CONCAT(a, b) GOJI_TRACE_CONCAT_INNER(a, b)
+
+// Trace the rest of the enclosing scope
+#define TRACE_SCOPE(category, name) \
+    TraceSpan GOJI_TRACE_CONCAT(traceSpan_, __LINE__)(category, name)
+
+// As TRACE_SCOPE; detail is only evaluated while tracing is enabled
+#define TRACE_SCOPE_DETAIL(category, name, detail) \
+    TraceSpan GOJI_TRACE_CONCAT(traceSpan_, __LINE__)(category, name); \
+    if (GOJI_TRACE_CONCAT(traceSpan_, __LINE__).isActive()) \
+        GOJI_TRACE_CONCAT(traceSpan_, __LINE__).setDetail(detail)
+
+// Trace the rest of the enclosing function under its own name
+#define TRACE_FUNCTION(category) TRACE_SCOPE(category, __FUNCTION__)
+
+#endif // TRACER_H
@@ -0,0 +1,357 @@
+#include "trackertablemodel.h"
+#include "databaseexecutor.h"
+#include "querystats.h"
+#include "tracer.h"
+
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QSqlError>
+#include <QSqlIndex>
+#include <QSqlQuery>
+#include <QSqlRecord>
+
+namespace {
+
+QString quoteIdentifier(QString name)
+{
+    return QLatin1Char('"') + name.replace(QLatin1Char('"'), QLatin1String("\"\"")) + QLatin1Char('"');
+}
+
+int compareKeys(const QVariant& a, const QVariant& b)
+{
+    bool okA = false;
+    bool okB = false;
+    const qlonglong numberA = a.toLongLong(&okA);
+    const qlonglong numberB = b.toLongLong(&okB);
+    if (okA && okB) {
+        return numberA < numberB ? -1 : (numberA > numberB ? 1 : 0);
+    }
+    return QString::compare(a.toString(), b.toString());
+}
+
+} // namespace
+
+TrackerTableModel::TrackerTableModel(QObject* parent, const QSqlDatabase& db)
+    : QAbstractTableModel(parent)
+    , m_db(db)
+    , m_databasePath(db.databaseName())
+{
+}
+
+void TrackerTableModel::setTable(const QString& tableName)
+{
+    beginResetModel();
+    ++m_generation;
+    m_rows.clear();
+    m_headers.clear();
+    m_selected = false;
+    m_hasMore = false;
+    m_fetching = false;
+
+    m_tableName = tableName;
+    m_columns.clear();
+    m_keyColumn = -1;
+    const QSqlRecord record = m_db.record(tableName);
+    for (int i = 0; i < record.count(); ++i) {
+        m_columns.append(record.fieldName(i));
+    }
+    const QSqlIndex primaryKey = m_db.primaryIndex(tableName);
+    if (primaryKey.count() == 1) {
+        m_keyColumn = m_columns.indexOf(primaryKey.fieldName(0));
+    }
+    if (m_sortColumn >= m_columns.size()) {
+        m_sortColumn = 0;
+    }
+    endResetModel();
+}
+
+void TrackerTableModel::setSort(int column, Qt::SortOrder order)
+{
+    m_sortColumn = column;
+    m_sortOrder = order;
+}
+
+void TrackerTableModel::setPageSize(int rows)
+{
+    m_pageSize = qMax(1, rows);
+}
+
+bool TrackerTableModel::select()
+{
+    if (m_columns.isEmpty()) {
+        m_lastError = QString("No columns found for table '%1'").arg(m_tableName);
+        return false;
+    }
+
+    // Rows already shown stay until the first page replaces them
+    ++m_generation;
+    m_selected = true;
+    m_lastError.clear();
+    requestPage(true);
+    return true;
+}
+
+void TrackerTableModel::refreshRow(const QVariant& key)
+{
+    if (!m_selected) {
+        return;     // nothing loaded yet; the next select() includes the row
+    }
+    if (!isSortedByKey()) {
+        select();
+        return;
+    }
+
+    const QString sql = selectClause() + QString(" WHERE %1 = ?").arg(quoteIdentifier(m_columns.at(m_keyColumn)));
+    runQuery(sql, QVariantList{key}, [this, key](const QueryResult& result) {
+        applyRow(key, result);
+    });
+}
+
+QString TrackerTableModel::selectClause() const
+{
+    QStringList columns;
+    for (const QString& column : m_columns) {
+        columns.append(quoteIdentifier(column));
+    }
+    return QString("SELECT %1 FROM %2").arg(columns.join(", "), quoteIdentifier(m_tableName));
+}
+
+void TrackerTableModel::requestPage(bool first)
+{
+    const bool descending = m_sortOrder == Qt::DescendingOrder;
+    const QString direction = descending ? "DESC" : "ASC";
+    const int sortColumn = qBound(0, m_sortColumn, m_columns.size() - 1);
+    const QString sortName = quoteIdentifier(m_columns.at(sortColumn));
+
+    QString sql = selectClause();
+    QVariantList bindValues;
+    if (isSortedByKey()) {
+        // Keyset paging: continue below (or above) the last loaded key using the primary key index
+        if (!first && !m_rows.isEmpty()) {
+            sql += QString(" WHERE %1 %2 ?").arg(sortName, descending ? "<" : ">");
+            bindValues.append(m_rows.constLast().at(m_keyColumn));
+        }
+        sql += QString(" ORDER BY %1 %2 LIMIT %3").arg(sortName, direction).arg(m_pageSize);
+    } else {
+        sql += QString(" ORDER BY %1 %2").arg(sortName, direction);
+        if (m_keyColumn >= 0) {
+            sql += QString(", %1 %2").arg(quoteIdentifier(m_columns.at(m_keyColumn)), direction);
+        }
+        sql += QString(" LIMIT %1 OFFSET %2").arg(m_pageSize).arg(first ? 0 : m_rows.size());
+    }
+
+    m_fetching = true;
+    runQuery(sql, bindValues, [this, first](const QueryResult& result) {
+        applyPage(result, first);
+    });
+}
+
+void TrackerTableModel::runQuery(const QString& sql, const QVariantList& bindValues,
+                                 const std::function<void(const QueryResult&)>& apply)
+{
+    const QString databasePath = m_databasePath;
+    const QString tableName = m_tableName;
+    const int columnCount = m_columns.size();
+    const quint64 generation = m_generation;
+    ++m_pendingRequests;
+
+    auto* watcher = new QFutureWatcher<QueryResult>(this);
+    connect(watcher, &QFutureWatcher<QueryResult>::finished, this, [this, watcher, apply]() {
+        --m_pendingRequests;
+        const QueryResult result = watcher->result();
+        watcher->deleteLater();
+        if (result.generation == m_generation) {
+            apply(result);
+        }
+    });
+
+    watcher->setFuture(DatabaseExecutor::instance().run("TrackerTableModel::runQuery", [=]() {
+        TRACE_SCOPE_DETAIL("db", "TrackerTableModel::query", tableName);
+
+        QueryResult result;
+        result.generation = generation;
+        QSqlDatabase db = DatabaseExecutor::connection(databasePath);
+        if (!db.isOpen() && !db.open()) {
+            result.error = db.lastError().text();
+            return result;
+        }
+
+        QSqlQuery query(db);
+        query.setForwardOnly(true);
+        if (!query.prepare(sql)) {
+            result.error = query.lastError().text();
+            return result;
+        }
+        for (const QVariant& value : bindValues) {
+            query.addBindValue(value);
+        }
+        QElapsedTimer timer;
+        timer.start();
+        if (!query.exec()) {
+            QueryStats::instance().record(query, db, timer.nsecsElapsed() / 1000, -1, false);
+            result.error = query.lastError().text();
+            return result;
+        }
+        while (query.next()) {
+            Row row(columnCount);
+            for (int i = 0; i < columnCount; ++i) {
+                row[i] = query.value(i);
+            }
+            result.rows.append(row);
+        }
+        QueryStats::instance().record(query, db, timer.nsecsElapsed() / 1000, result.rows.size(), true);
+        result.ok = true;
+        return result;
+    }));
+}
+
+void TrackerTableModel::applyPage(const QueryResult& result, bool first)
+{
+    m_fetching = false;
+    if (!result.ok) {
+        m_lastError = result.error;
+        m_hasMore = false;
+        qWarning() << "Tracker model: query on" << m_tableName << "failed:" << result.error;
+        if (first) {
+            emit selectFinished(false);
+        }
+        return;
+    }
+
+    m_hasMore = result.rows.size() == m_pageSize;
+    if (first) {
+        beginResetModel();
+        m_rows = result.rows;
+        endResetModel();
+        emit selectFinished(true);
+        return;
+    }
+    if (!result.rows.isEmpty()) {
+        beginInsertRows(QModelIndex(), m_rows.size(), m_rows.size() + result.rows.size() - 1);
+        m_rows += result.rows;
+        endInsertRows();
+    }
+}
+
+void TrackerTableModel::applyRow(const QVariant& key, const QueryResult& result)
+{
+    if (!result.ok) {
+        m_lastError = result.error;
+        qWarning() << "Tracker model: refreshing a row of" << m_tableName << "failed:" << result.error;
+        return;
+    }
+
+    const int row = findRow(key);
+    if (result.rows.isEmpty()) {
+        if (row >= 0) {
+            beginRemoveRows(QModelIndex(), row, row);
+            m_rows.remove(row);
+            endRemoveRows();
+        }
+        return;
+    }
+
+    if (row >= 0) {
+        m_rows[row] = result.rows.constFirst();
+        emit dataChanged(index(row, 0), index(row, m_columns.size() - 1));
+        return;
+    }
+
+    const int position = insertPosition(key);
+    if (position == m_rows.size() && m_hasMore) {
+        return;     // below the loaded pages; fetchMore() reaches it
+    }
+    beginInsertRows(QModelIndex(), position, position);
+    m_rows.insert(position, result.rows.constFirst());
+    endInsertRows();
+}
+
+int TrackerTableModel::findRow(const QVariant& key) const
+{
+    for (int i = 0; i < m_rows.size(); ++i) {
+        if (compareKeys(m_rows.at(i).at(m_keyColumn), key) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+int TrackerTableModel::insertPosition(const QVariant& key) const
+{
+    const bool descending = m_sortOrder == Qt::DescendingOrder;
+    for (int i = 0; i < m_rows.size(); ++i) {
+        const int order = compareKeys(m_rows.at(i).at(m_keyColumn), key);
+        if (descending ? order < 0 : order > 0) {
+            return i;
+        }
+    }
+    return m_rows.size();
+}
+
+int TrackerTableModel::rowCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : m_rows.size();
+}
+
+int TrackerTableModel::columnCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : m_columns.size();
+}
+
+QVariant TrackerTableModel::data(const QModelIndex& index, int role) const
+{
+    if (!index.isValid() || index.row() >= m_rows.size() || index.column() >= m_columns.size()) {
+        return QVariant();
+    }
+    if (role == Qt::DisplayRole || role == Qt::EditRole) {
+        return m_rows.at(index.row()).at(index.column());
+    }
+    return QVariant();
+}
+
+QVariant TrackerTableModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation == Qt::Horizontal && (role == Qt::DisplayRole || role == Qt::EditRole)
+        && section >= 0 && section < m_columns.size()) {
+        return m_headers.value(section, m_columns.at(section));
+    }
+    return QAbstractTableModel::headerData(section, orientation, role);
+}
+
+bool TrackerTableModel::setHeaderData(int section, Qt::Orientation orientation, const QVariant& value, int role)
+{
+    if (orientation != Qt::Horizontal || section < 0 || section >= m_columns.size()
+        || (role != Qt::DisplayRole && role != Qt::EditRole)) {
+        return false;
+    }
+    m_headers.insert(section, value);
+    emit headerDataChanged(orientation, section, section);
+    return true;
+}
+
+bool TrackerTableModel::canFetchMore(const QModelIndex& parent) const
+{
+    return !parent.isValid() && m_hasMore && !m_fetching;
+}
+
+void TrackerTableModel::fetchMore(const QModelIndex& parent)
+{
+    if (!canFetchMore(parent)) {
+        return;
+    }
+    requestPage(false);
+}
+
+void TrackerTableModel::sort(int column, Qt::SortOrder order)
+{
+    if (column < 0 || column >= m_columns.size()) {
+        return;
+    }
+    if (column == m_sortColumn && order == m_sortOrder) {
+        return;     // already ordered this way by SQL
+    }
+    setSort(column, order);
+    if (m_selected) {
+        select();
+    }
+}
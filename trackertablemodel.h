@@ -0,0 +1,119 @@
+#ifndef TRACKERTABLEMODEL_H
+#define TRACKERTABLEMODEL_H
+
+#include <QAbstractTableModel>
+#include <QHash>
+#include <QSqlDatabase>
+#include <QString>
+#include <QStringList>
+#include <QVariant>
+#include <QVector>
+
+#include <functional>
+
+/**
+ * @brief Read-only, paged model over one tracker log table
+ *
+ * Stands in for QSqlTableModel::select() on the GUI thread. Queries run on the
+ * DatabaseExecutor thread with its own connection to the same SQLite file,
+ * and rows arrive in pages through canFetchMore()/fetchMore(). Sorting
+ * is done by SQL ORDER BY; when the sort column is the table's primary key
+ * the index is walked with keyset paging and refreshRow() can apply a single
+ * inserted or updated row without reloading the table.
+ *
+ * Column metadata is read synchronously in setTable(), so column indices,
+ * header data and hidden columns can be set up before any rows are loaded.
+ */
+class TrackerTableModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    explicit TrackerTableModel(QObject* parent, const QSqlDatabase& db);
+
+    /**
+     * @brief Bind the model to a table and read its columns (no rows are loaded)
+     */
+    void setTable(const QString& tableName);
+    QString tableName() const { return m_tableName; }
+
+    /**
+     * @brief Sort order used by the next select()
+     */
+    void setSort(int column, Qt::SortOrder order);
+
+    void setPageSize(int rows);
+    int fieldIndex(const QString& fieldName) const { return m_columns.indexOf(fieldName); }
+
+    /**
+     * @brief Reload from the first page in the background
+     * @return False if no table is set; load errors are reported by selectFinished()
+     */
+    bool select();
+
+    /**
+     * @brief Re-read one row by primary key and update, insert or remove it in place
+     *
+     * Falls back to select() when the model is not sorted by the primary key.
+     */
+    void refreshRow(const QVariant& key);
+
+    bool isLoading() const { return m_pendingRequests > 0; }
+    QString lastError() const { return m_lastError; }
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+    bool setHeaderData(int section, Qt::Orientation orientation, const QVariant& value,
+                       int role = Qt::EditRole) override;
+    bool canFetchMore(const QModelIndex& parent = QModelIndex()) const override;
+    void fetchMore(const QModelIndex& parent = QModelIndex()) override;
+    void sort(int column, Qt::SortOrder order = Qt::AscendingOrder) override;
+
+signals:
+    /**
+     * @brief Emitted when the first page of a select() has been applied (or failed)
+     */
+    void selectFinished(bool ok);
+
+private:
+    using Row = QVector<QVariant>;
+
+    struct QueryResult {
+        quint64 generation = 0;
+        QVector<Row> rows;
+        bool ok = false;
+        QString error;
+    };
+
+    bool isSortedByKey() const { return m_keyColumn >= 0 && m_sortColumn == m_keyColumn; }
+    QString selectClause() const;
+    void requestPage(bool first);
+    void applyPage(const QueryResult& result, bool first);
+    void applyRow(const QVariant& key, const QueryResult& result);
+    int findRow(const QVariant& key) const;
+    int insertPosition(const QVariant& key) const;
+    void runQuery(const QString& sql, const QVariantList& bindValues,
+                  const std::function<void(const QueryResult&)>& apply);
+
+    QSqlDatabase m_db;                  // GUI-thread connection, used for column metadata only
+    QString m_databasePath;
+    QString m_tableName;
+    QStringList m_columns;
+    int m_keyColumn = -1;
+    int m_sortColumn = 0;
+    Qt::SortOrder m_sortOrder = Qt::AscendingOrder;
+    int m_pageSize = 200;
+
+    QVector<Row> m_rows;
+    QHash<int, QVariant> m_headers;
+    bool m_selected = false;
+    bool m_hasMore = false;
+    bool m_fetching = false;
+    quint64 m_generation = 0;
+    int m_pendingRequests = 0;
+    QString m_lastError;
+};
+
+#endif // TRACKERTABLEMODEL_H
@@ -1,6 +1,7 @@
 #include "updatemanager.h"
 #include "fileutils.h"
 #include "errormanager.h"
+#include "hashservice.h"
 #include <QCoreApplication>
 #include <QCryptographicHash>
 #include <QJsonDocument>
@@ -554,19 +555,15 @@ void UpdateManager::onNetworkError(QNetworkReply::NetworkError error)
 
 QString UpdateManager::calculateFileChecksum(const QString& filePath)
 {
-    QFile file(filePath);
-    if (!file.open(QIODevice::ReadOnly)) {
-        emit errorOccurred("Failed to open file for checksum: " + filePath);
+    // Always read the package itself: this is a verification, so a cached digest won't do
+    const FileDigest digest = HashService::instance().hashFile(filePath, QCryptographicHash::Sha256,
+                                                               HashService::CachePolicy::Bypass);
+    if (!digest.ok) {
+        emit errorOccurred(QString("Failed to compute checksum for: %1 (%2)").arg(filePath, digest.error));
         return QString();
     }
 
-    QCryptographicHash hash(QCryptographicHash::Sha256);
-    if (!hash.addData(&file)) {
-        emit errorOccurred("Failed to compute checksum for: " + filePath);
-        return QString();
-    }
-
-    return hash.result().toHex();
+    return digest.hex;
 }
 
 bool UpdateManager::extractUpdateFile()